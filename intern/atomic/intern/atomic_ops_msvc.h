@@ -164,6 +164,28 @@ ATOMIC_INLINE int32_t atomic_fetch_and_and_int32(int32_t *p, int32_t x)
   return InterlockedAnd((long *)p, x);
 }
 
+/* Sequentially consistent load and store.
+ * Volatile reads have acquire semantics with the default /volatile:ms on x86 and x64. */
+ATOMIC_INLINE uint32_t atomic_load_uint32(const uint32_t *v)
+{
+  return *(volatile const uint32_t *)v;
+}
+
+ATOMIC_INLINE void atomic_store_uint32(uint32_t *p, uint32_t v)
+{
+  InterlockedExchange((long *)p, v);
+}
+
+ATOMIC_INLINE void *atomic_load_ptr(void *const *v)
+{
+  return *(void *volatile const *)v;
+}
+
+ATOMIC_INLINE void atomic_store_ptr(void **p, void *v)
+{
+  InterlockedExchangePointer(p, v);
+}
+
 /******************************************************************************/
 /* 8-bit operations. */
 
@@ -85,6 +85,9 @@ class CyclesRender(bpy.types.RenderEngine):
     def bake(self, depsgraph, obj, pass_type, pass_filter, object_id, pixel_array, num_pixels, depth, result):
         engine.bake(self, depsgraph, obj, pass_type, pass_filter, object_id, pixel_array, num_pixels, depth, result)
 
+    def bake_batch_end(self):
+        engine.bake_batch_end(self)
+
     # viewport render
     def view_update(self, context, depsgraph):
         if not self.session:
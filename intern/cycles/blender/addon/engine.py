@@ -175,6 +175,13 @@ def bake(engine, depsgraph, obj, pass_type, pass_filter, object_id, pixel_array,
         _cycles.bake(engine.session, depsgraph.as_pointer(), obj.as_pointer(), pass_type, pass_filter, object_id, pixel_array.as_pointer(), num_pixels, depth, result.as_pointer())
 
 
+def bake_batch_end(engine):
+    import _cycles
+    session = getattr(engine, "session", None)
+    if session is not None:
+        _cycles.bake_batch_end(engine.session)
+
+
 def reset(engine, data, depsgraph):
     import _cycles
     import bpy
@@ -18,7 +18,7 @@
 
 import bpy
 from bpy.types import Operator
-from bpy.props import StringProperty
+from bpy.props import IntProperty, StringProperty
 
 from bpy.app.translations import pgettext_tip as tip_
 
@@ -195,12 +195,55 @@ class CYCLES_OT_merge_images(Operator):
         return {'FINISHED'}
 
 
+class CYCLES_OT_convert_texture(Operator):
+    "Convert an image into a tiled and mipmapped texture, which the " \
+    "texture cache reads from disk on demand while rendering"
+    bl_idname = "cycles.convert_texture"
+    bl_label = "Convert Texture"
+
+    input_filepath: StringProperty(
+        name='Input Filepath',
+        description='File path for image to convert',
+        default='',
+        subtype='FILE_PATH')
+
+    output_filepath: StringProperty(
+        name='Output Filepath',
+        description='File path for converted texture, next to the input image if empty',
+        default='',
+        subtype='FILE_PATH')
+
+    tile_size: IntProperty(
+        name='Tile Size',
+        description='Tile size of the converted texture, in pixels',
+        default=64,
+        min=8, max=1024)
+
+    def execute(self, context):
+        import os
+        in_filepath = bpy.path.abspath(self.input_filepath)
+        out_filepath = bpy.path.abspath(self.output_filepath)
+        if not out_filepath:
+            out_filepath = os.path.splitext(in_filepath)[0] + ".tx"
+
+        import _cycles
+        try:
+            _cycles.convert_texture(input=in_filepath, output=out_filepath,
+                                    tile_size=self.tile_size)
+        except Exception as e:
+            self.report({'ERROR'}, str(e))
+            return {'CANCELLED'}
+
+        return {'FINISHED'}
+
+
 classes = (
     CYCLES_OT_use_shading_nodes,
     CYCLES_OT_add_aov,
     CYCLES_OT_remove_aov,
     CYCLES_OT_denoise_animation,
-    CYCLES_OT_merge_images
+    CYCLES_OT_merge_images,
+    CYCLES_OT_convert_texture
 )
 
 def register():
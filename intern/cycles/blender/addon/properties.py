@@ -70,6 +70,11 @@ enum_filter_types = (
     ('BLACKMAN_HARRIS', "Blackman-Harris", "Blackman-Harris filter"),
 )
 
+enum_denoiser = (
+    ('NLM', "NLM", "Non-local means filter, guided by the feature passes"),
+    ('OPENIMAGEDENOISE', "OpenImageDenoise", "Intel OpenImageDenoise AI denoiser, guided by the albedo and normal passes. Only available on CPU devices, others fall back to NLM"),
+)
+
 enum_panorama_types = (
     ('EQUIRECTANGULAR', "Equirectangular", "Render the scene with a spherical camera, also known as Lat Long panorama"),
     ('FISHEYE_EQUIDISTANT', "Fisheye Equidistant", "Ideal for fulldomes, ignore the sensor dimensions"),
@@ -310,6 +315,27 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default='SOBOL',
     )
 
+    use_adaptive_sampling: BoolProperty(
+        name="Use Adaptive Sampling",
+        description="Stop sampling pixels once their noise is below the threshold (CPU only)",
+        default=False,
+    )
+    adaptive_threshold: FloatProperty(
+        name="Adaptive Sampling Threshold",
+        description="Noise level at which a pixel is considered converged, lower values take longer to converge",
+        min=0.0001, max=1.0,
+        soft_min=0.001,
+        default=0.01,
+        precision=4,
+    )
+    adaptive_min_samples: IntProperty(
+        name="Adaptive Min Samples",
+        description="Minimum number of samples for every pixel before adaptive sampling may stop it, "
+        "automatic if 0",
+        min=0, max=4096,
+        default=0,
+    )
+
     use_layer_samples: EnumProperty(
         name="Layer Samples",
         description="How to use per view layer sample settings",
@@ -328,6 +354,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         description="Sample all lights (for indirect samples), rather than randomly picking one",
         default=True,
     )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Pick lights based on their distance and orientation to the shading point, "
+        "which reduces noise in scenes with many lights (path tracing only)",
+        default=False,
+    )
     light_sampling_threshold: FloatProperty(
         name="Light Sampling Threshold",
         description="Probabilistically terminate light samples when the light contribution is below this threshold (more noise but faster rendering). "
@@ -711,6 +743,44 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_texture_limit
     )
 
+    use_bvh_refit: BoolProperty(
+        name="Refit BVH",
+        description="Keep the BVH of each mesh between frames with persistent data, and refit it when only the shape of the mesh changed instead of building it again. "
+        "Speeds up rendering animations of deforming meshes, at the cost of slightly slower ray tracing",
+        default=False,
+    )
+
+    use_texture_cache: BoolProperty(
+        name="Texture Cache",
+        description="Read image textures from disk while rendering, only keeping the parts that are used in memory (CPU only)",
+        default=False,
+    )
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        description="Maximum memory used by the texture cache, in megabytes",
+        default=1024,
+        min=64, max=65536,
+        subtype='UNSIGNED',
+    )
+    texture_auto_convert: BoolProperty(
+        name="Auto Convert",
+        description="Convert image textures that are not tiled and mipmapped before rendering",
+        default=True,
+    )
+    texture_tile_size: IntProperty(
+        name="Tile Size",
+        description="Tile size of converted textures, in pixels",
+        default=64,
+        min=8, max=1024,
+        subtype='PIXEL',
+    )
+    texture_cache_path: StringProperty(
+        name="Cache Path",
+        description="Directory for converted textures, next to the original images if empty",
+        default="",
+        subtype='DIR_PATH',
+    )
+
     ao_bounces: IntProperty(
         name="AO Bounces",
         default=0,
@@ -743,6 +813,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default='BVH8',
     )
     debug_use_cpu_split_kernel: BoolProperty(name="Split Kernel", default=False)
+    debug_use_cpu_ray_stream: BoolProperty(
+        name="Ray Stream",
+        description="Trace camera rays of neighboring pixels together, faster for coherent rays with the BVH8 layout",
+        default=False,
+    )
 
     debug_use_cuda_adaptive_compile: BoolProperty(name="Adaptive Compile", default=False)
     debug_use_cuda_split_kernel: BoolProperty(name="Split Kernel", default=False)
@@ -1298,6 +1373,12 @@ class CyclesRenderLayerSettings(bpy.types.PropertyGroup):
         default=False,
         update=update_render_passes,
     )
+    denoiser: EnumProperty(
+        name="Denoiser",
+        description="Denoising algorithm to use",
+        items=enum_denoiser,
+        default='NLM',
+    )
     denoising_diffuse_direct: BoolProperty(
         name="Diffuse Direct",
         description="Denoise the direct diffuse lighting",
@@ -32,10 +32,15 @@
 #include "util/util_hash.h"
 #include "util/util_logging.h"
 #include "util/util_math.h"
+#include "util/util_murmurhash.h"
 #include "util/util_disjoint_set.h"
+#include "util/util_task.h"
 
 #include "mikktspace.h"
 
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
 CCL_NAMESPACE_BEGIN
 
 /* Tangent Space */
@@ -353,6 +358,10 @@ static void attr_create_vertex_color(Scene *scene, Mesh *mesh, BL::Mesh &b_mesh,
     }
   }
   else {
+    const ::Mesh *me = (const ::Mesh *)b_mesh.ptr.data;
+    const MLoopTri *looptris = me->runtime.looptris.array;
+    const int num_looptris = me->runtime.looptris.len;
+
     BL::Mesh::vertex_colors_iterator l;
     for (b_mesh.vertex_colors.begin(l); l != b_mesh.vertex_colors.end(); ++l) {
       if (!mesh->need_attribute(scene, ustring(l->name().c_str())))
@@ -361,19 +370,17 @@ static void attr_create_vertex_color(Scene *scene, Mesh *mesh, BL::Mesh &b_mesh,
       Attribute *attr = mesh->attributes.add(
           ustring(l->name().c_str()), TypeRGBA, ATTR_ELEMENT_CORNER_BYTE);
 
-      BL::Mesh::loop_triangles_iterator t;
+      const MLoopCol *mloopcols = (const MLoopCol *)l->data[0].ptr.data;
       uchar4 *cdata = attr->data_uchar4();
 
-      for (b_mesh.loop_triangles.begin(t); t != b_mesh.loop_triangles.end(); ++t) {
-        int3 li = get_int3(t->loops());
-        float4 c1 = get_float4(l->data[li[0]].color());
-        float4 c2 = get_float4(l->data[li[1]].color());
-        float4 c3 = get_float4(l->data[li[2]].color());
+      for (int i = 0; i < num_looptris; i++) {
+        for (int j = 0; j < 3; j++) {
+          const MLoopCol &col = mloopcols[looptris[i].tri[j]];
+          float4 c = make_float4(col.r, col.g, col.b, col.a) * (1.0f / 255.0f);
 
-        /* Compress/encode vertex color using the sRGB curve. */
-        cdata[0] = color_float4_to_uchar4(color_srgb_to_linear_v4(c1));
-        cdata[1] = color_float4_to_uchar4(color_srgb_to_linear_v4(c2));
-        cdata[2] = color_float4_to_uchar4(color_srgb_to_linear_v4(c3));
+          /* Compress/encode vertex color using the sRGB curve. */
+          cdata[j] = color_float4_to_uchar4(color_srgb_to_linear_v4(c));
+        }
         cdata += 3;
       }
     }
@@ -413,15 +420,16 @@ static void attr_create_uv_map(Scene *scene, Mesh *mesh, BL::Mesh &b_mesh)
           uv_attr = mesh->attributes.add(uv_name, TypeFloat2, ATTR_ELEMENT_CORNER);
         }
 
-        BL::Mesh::loop_triangles_iterator t;
+        const ::Mesh *me = (const ::Mesh *)b_mesh.ptr.data;
+        const MLoopTri *looptris = me->runtime.looptris.array;
+        const MLoopUV *mloopuvs = (const MLoopUV *)l->data[0].ptr.data;
         float2 *fdata = uv_attr->data_float2();
 
-        for (b_mesh.loop_triangles.begin(t); t != b_mesh.loop_triangles.end(); ++t) {
-          int3 li = get_int3(t->loops());
-          fdata[0] = get_float2(l->data[li[0]].uv());
-          fdata[1] = get_float2(l->data[li[1]].uv());
-          fdata[2] = get_float2(l->data[li[2]].uv());
-          fdata += 3;
+        for (int i = 0; i < me->runtime.looptris.len; i++, fdata += 3) {
+          for (int j = 0; j < 3; j++) {
+            const float *uv = mloopuvs[looptris[i].tri[j]].uv;
+            fdata[j] = make_float2(uv[0], uv[1]);
+          }
         }
       }
 
@@ -732,6 +740,125 @@ static void attr_create_random_per_island(Scene *scene,
 
 /* Create Mesh */
 
+/* Direct Mesh Array Access
+ *
+ * Going through RNA for every vertex and triangle dominates sync time for large meshes, so
+ * without subdivision the evaluated mesh arrays are read directly, in chunks on the task
+ * scheduler. */
+
+static void mesh_parallel_range(int num, const function<void(int, int)> &func)
+{
+  const int chunk_size = 65536;
+
+  if (num <= chunk_size) {
+    func(0, num);
+    return;
+  }
+
+  TaskPool pool;
+  for (int start = 0; start < num; start += chunk_size) {
+    pool.push(function_bind(func, start, min(start + chunk_size, num)));
+  }
+  pool.wait_work();
+}
+
+static void create_mesh_vertices(const MVert *mverts, float3 *P, float3 *N, int start, int end)
+{
+  for (int i = start; i < end; i++) {
+    const MVert &mvert = mverts[i];
+    P[i] = make_float3(mvert.co[0], mvert.co[1], mvert.co[2]);
+    N[i] = make_float3(mvert.no[0], mvert.no[1], mvert.no[2]) * (1.0f / 32767.0f);
+  }
+}
+
+static void create_mesh_triangles(const MLoopTri *looptris,
+                                  const MLoop *mloops,
+                                  const MPoly *mpolys,
+                                  int max_shader,
+                                  bool use_loop_normals,
+                                  int *triangles,
+                                  int *shader,
+                                  bool *smooth,
+                                  int start,
+                                  int end)
+{
+  for (int i = start; i < end; i++) {
+    const MLoopTri &looptri = looptris[i];
+    const MPoly &mpoly = mpolys[looptri.poly];
+
+    triangles[i * 3 + 0] = mloops[looptri.tri[0]].v;
+    triangles[i * 3 + 1] = mloops[looptri.tri[1]].v;
+    triangles[i * 3 + 2] = mloops[looptri.tri[2]].v;
+    shader[i] = clamp((int)mpoly.mat_nr, 0, max_shader);
+    /* NOTE: Autosmooth is already taken care about. */
+    smooth[i] = (mpoly.flag & ME_SMOOTH) || use_loop_normals;
+  }
+}
+
+static const void *mesh_custom_data_layer(const CustomData &data, int type)
+{
+  for (int i = 0; i < data.totlayer; i++) {
+    if (data.layers[i].type == type) {
+      return data.layers[i].data;
+    }
+  }
+  return NULL;
+}
+
+/* Hash of all evaluated mesh data read by create_mesh(), to detect whether a mesh tagged for
+ * update by the depsgraph actually changed since it was last exported. */
+static uint mesh_fingerprint(BL::Mesh &b_mesh, uint seed)
+{
+  const ::Mesh *me = (const ::Mesh *)b_mesh.ptr.data;
+  uint hash = seed;
+
+  const int sizes[4] = {me->totvert, me->totloop, me->totpoly, me->runtime.looptris.len};
+  hash = util_murmur_hash3(sizes, sizeof(sizes), hash);
+  hash = util_murmur_hash3(me->mvert, sizeof(MVert) * me->totvert, hash);
+  hash = util_murmur_hash3(me->mloop, sizeof(MLoop) * me->totloop, hash);
+  hash = util_murmur_hash3(me->mpoly, sizeof(MPoly) * me->totpoly, hash);
+  hash = util_murmur_hash3(me->runtime.looptris.array,
+                           sizeof(MLoopTri) * me->runtime.looptris.len,
+                           hash);
+
+  /* Texture space and auto smooth settings. */
+  hash = util_murmur_hash3(me->loc, sizeof(me->loc), hash);
+  hash = util_murmur_hash3(me->size, sizeof(me->size), hash);
+  const int use_auto_smooth = (me->flag & ME_AUTOSMOOTH) != 0;
+  hash = util_murmur_hash3(&use_auto_smooth, sizeof(use_auto_smooth), hash);
+
+  const void *orco = mesh_custom_data_layer(me->vdata, CD_ORCO);
+  if (orco) {
+    hash = util_murmur_hash3(orco, sizeof(float) * 3 * me->totvert, hash);
+  }
+
+  /* Corner attributes, including their names which shaders refer to. */
+  for (int i = 0; i < me->ldata.totlayer; i++) {
+    const CustomDataLayer &layer = me->ldata.layers[i];
+    size_t size;
+
+    switch (layer.type) {
+      case CD_MLOOPUV:
+        size = sizeof(MLoopUV);
+        break;
+      case CD_MLOOPCOL:
+        size = sizeof(MLoopCol);
+        break;
+      case CD_NORMAL:
+        size = sizeof(float) * 3;
+        break;
+      default:
+        continue;
+    }
+
+    hash = util_murmur_hash3(layer.name, strlen(layer.name), hash);
+    hash = util_murmur_hash3(&layer.flag, sizeof(layer.flag), hash);
+    hash = util_murmur_hash3(layer.data, size * me->totloop, hash);
+  }
+
+  return hash;
+}
+
 static void create_mesh(Scene *scene,
                         Mesh *mesh,
                         BL::Mesh &b_mesh,
@@ -764,22 +891,36 @@ static void create_mesh(Scene *scene,
     }
   }
 
-  /* allocate memory */
-  mesh->reserve_mesh(numverts, numtris);
-  mesh->reserve_subd_faces(numfaces, numngons, numcorners);
+  const ::Mesh *me = (const ::Mesh *)b_mesh.ptr.data;
+  AttributeSet &attributes = (subdivision) ? mesh->subd_attributes : mesh->attributes;
+  BL::Mesh::vertices_iterator v;
+  Attribute *attr_N;
+  float3 *N;
 
   /* create vertex coordinates and normals */
-  BL::Mesh::vertices_iterator v;
-  for (b_mesh.vertices.begin(v); v != b_mesh.vertices.end(); ++v)
-    mesh->add_vertex(get_float3(v->co()));
+  if (!subdivision) {
+    mesh->resize_mesh(numverts, numtris);
 
-  AttributeSet &attributes = (subdivision) ? mesh->subd_attributes : mesh->attributes;
-  Attribute *attr_N = attributes.add(ATTR_STD_VERTEX_NORMAL);
-  float3 *N = attr_N->data_float3();
+    attr_N = attributes.add(ATTR_STD_VERTEX_NORMAL);
+    N = attr_N->data_float3();
+
+    mesh_parallel_range(
+        numverts, function_bind(&create_mesh_vertices, me->mvert, mesh->verts.data(), N, _1, _2));
+  }
+  else {
+    mesh->reserve_mesh(numverts, numtris);
+    mesh->reserve_subd_faces(numfaces, numngons, numcorners);
+
+    for (b_mesh.vertices.begin(v); v != b_mesh.vertices.end(); ++v)
+      mesh->add_vertex(get_float3(v->co()));
 
-  for (b_mesh.vertices.begin(v); v != b_mesh.vertices.end(); ++v, ++N)
-    *N = get_float3(v->normal());
-  N = attr_N->data_float3();
+    attr_N = attributes.add(ATTR_STD_VERTEX_NORMAL);
+    N = attr_N->data_float3();
+
+    for (b_mesh.vertices.begin(v); v != b_mesh.vertices.end(); ++v, ++N)
+      *N = get_float3(v->normal());
+    N = attr_N->data_float3();
+  }
 
   /* create generated coordinates from undeformed coordinates */
   const bool need_default_tangent = (subdivision == false) && (b_mesh.uv_layers.length() == 0) &&
@@ -801,28 +942,26 @@ static void create_mesh(Scene *scene,
 
   /* create faces */
   if (!subdivision) {
-    BL::Mesh::loop_triangles_iterator t;
-
-    for (b_mesh.loop_triangles.begin(t); t != b_mesh.loop_triangles.end(); ++t) {
-      BL::MeshPolygon p = b_mesh.polygons[t->polygon_index()];
-      int3 vi = get_int3(t->vertices());
-
-      int shader = clamp(p.material_index(), 0, used_shaders.size() - 1);
-      bool smooth = p.use_smooth() || use_loop_normals;
-
-      if (use_loop_normals) {
-        BL::Array<float, 9> loop_normals = t->split_normals();
-        for (int i = 0; i < 3; i++) {
-          N[vi[i]] = make_float3(
-              loop_normals[i * 3], loop_normals[i * 3 + 1], loop_normals[i * 3 + 2]);
-        }
+    mesh_parallel_range(numtris,
+                        function_bind(&create_mesh_triangles,
+                                      me->runtime.looptris.array,
+                                      me->mloop,
+                                      me->mpoly,
+                                      (int)used_shaders.size() - 1,
+                                      use_loop_normals,
+                                      mesh->triangles.data(),
+                                      mesh->shader.data(),
+                                      mesh->smooth.data(),
+                                      _1,
+                                      _2));
+
+    /* Faces are split by auto smooth, so corners sharing a vertex share the normal too. */
+    const float *loop_normals = (const float *)mesh_custom_data_layer(me->ldata, CD_NORMAL);
+    if (use_loop_normals && loop_normals) {
+      for (int i = 0; i < me->totloop; i++) {
+        const float *lN = loop_normals + i * 3;
+        N[me->mloop[i].v] = make_float3(lN[0], lN[1], lN[2]);
       }
-
-      /* Create triangles.
-       *
-       * NOTE: Autosmooth is already taken care about.
-       */
-      mesh->add_triangle(vi[0], vi[1], vi[2], shader, smooth);
     }
   }
   else {
@@ -968,7 +1107,8 @@ Mesh *BlenderSync::sync_mesh(BL::Depsgraph &b_depsgraph,
                              BL::Object &b_ob_instance,
                              bool object_updated,
                              bool show_self,
-                             bool show_particles)
+                             bool show_particles,
+                             TaskPool *task_pool)
 {
   /* test if we can instance or if the object is modified */
   BL::ID b_ob_data = b_ob.data();
@@ -1006,29 +1146,22 @@ Mesh *BlenderSync::sync_mesh(BL::Depsgraph &b_depsgraph,
   }
   Mesh *mesh;
 
-  if (!mesh_map.sync(&mesh, key)) {
-    /* if transform was applied to mesh, need full update */
-    if (object_updated && mesh->transform_applied)
-      ;
-    /* test if shaders changed, these can be object level so mesh
-     * does not get tagged for recalc */
-    else if (mesh->used_shaders != used_shaders)
-      ;
-    else if (requested_geometry_flags != mesh->geometry_flags)
-      ;
-    else {
-      /* even if not tagged for recalc, we may need to sync anyway
-       * because the shader needs different mesh attributes */
-      bool attribute_recalc = false;
-
-      foreach (Shader *shader, mesh->used_shaders)
-        if (shader->need_update_mesh)
-          attribute_recalc = true;
-
-      if (!attribute_recalc)
-        return mesh;
-    }
-  }
+  const bool mesh_recalc = mesh_map.sync(&mesh, key);
+
+  /* if transform was applied to mesh, need full update */
+  bool settings_changed = object_updated && mesh->transform_applied;
+  /* test if shaders changed, these can be object level so mesh
+   * does not get tagged for recalc */
+  settings_changed |= mesh->used_shaders != used_shaders;
+  settings_changed |= requested_geometry_flags != mesh->geometry_flags;
+  /* even if not tagged for recalc, we may need to sync anyway
+   * because the shader needs different mesh attributes */
+  foreach (Shader *shader, mesh->used_shaders)
+    if (shader->need_update_mesh)
+      settings_changed = true;
+
+  if (!mesh_recalc && !settings_changed)
+    return mesh;
 
   /* ensure we only sync instanced meshes once */
   if (mesh_synced.find(mesh) != mesh_synced.end())
@@ -1038,78 +1171,159 @@ Mesh *BlenderSync::sync_mesh(BL::Depsgraph &b_depsgraph,
 
   mesh_synced.insert(mesh);
 
+  /* Adaptive subdivision setup. Not for baking since that requires
+   * exact mapping to the Blender mesh. */
+  Mesh::SubdivisionType subdivision_type = Mesh::SUBDIVISION_NONE;
+  if (!scene->bake_manager->get_baking()) {
+    subdivision_type = object_subdivision_type(b_ob, preview, experimental);
+  }
+
+  /* Fluid domains and hair depend on more than the mesh data, and adaptive subdivision on
+   * object settings, so those are always exported. Fluid domains also add motion data and
+   * images, which is not safe to do in parallel. */
+  const bool has_fluid_domain = (bool)object_fluid_domain_find(b_ob);
+  const bool use_fingerprint = (requested_geometry_flags != Mesh::GEOMETRY_NONE) &&
+                               (subdivision_type == Mesh::SUBDIVISION_NONE) &&
+                               !has_fluid_domain &&
+                               !(view_layer.use_hair && b_ob.particle_systems.length());
+
+  BL::Mesh b_mesh(PointerRNA_NULL);
+
+  /* Objects often get tagged for an update without their geometry changing, e.g. when only
+   * the transform is animated. Compare the evaluated mesh against the last export first. */
+  if (use_fingerprint && !settings_changed && mesh_fingerprints.count(mesh)) {
+    /* For some reason, meshes do not need this... */
+    bool need_undeformed = mesh->need_attribute(scene, ATTR_STD_GENERATED);
+
+    b_mesh = object_to_mesh(b_data, b_ob, b_depsgraph, need_undeformed, subdivision_type);
+
+    if (b_mesh && mesh_fingerprint(b_mesh, show_self + 2 * show_particles) ==
+                      mesh_fingerprints[mesh]) {
+      free_object_to_mesh(b_data, b_ob, b_mesh);
+      return mesh;
+    }
+  }
+
   /* create derived mesh */
-  array<int> oldtriangles;
-  array<Mesh::SubdFace> oldsubd_faces;
-  array<int> oldsubd_face_corners;
-  oldtriangles.steal_data(mesh->triangles);
-  oldsubd_faces.steal_data(mesh->subd_faces);
-  oldsubd_face_corners.steal_data(mesh->subd_face_corners);
+  MeshExport *mesh_export = new MeshExport(
+      b_ob, b_mesh, mesh, show_self, show_particles, use_fingerprint);
+  mesh_export->oldtriangles.steal_data(mesh->triangles);
+  mesh_export->oldsubd_faces.steal_data(mesh->subd_faces);
+  mesh_export->oldsubd_face_corners.steal_data(mesh->subd_face_corners);
 
   /* compares curve_keys rather than strands in order to handle quick hair
    * adjustments in dynamic BVH - other methods could probably do this better*/
-  array<float3> oldcurve_keys;
-  array<float> oldcurve_radius;
-  oldcurve_keys.steal_data(mesh->curve_keys);
-  oldcurve_radius.steal_data(mesh->curve_radius);
+  mesh_export->oldcurve_keys.steal_data(mesh->curve_keys);
+  mesh_export->oldcurve_radius.steal_data(mesh->curve_radius);
 
   /* ensure bvh rebuild (instead of refit) if has_voxel_attributes() changed */
-  bool oldhas_voxel_attributes = mesh->has_voxel_attributes();
+  mesh_export->oldhas_voxel_attributes = mesh->has_voxel_attributes();
 
   mesh->clear();
   mesh->used_shaders = used_shaders;
   mesh->name = ustring(b_ob_data.name().c_str());
 
   if (requested_geometry_flags != Mesh::GEOMETRY_NONE) {
-    /* Adaptive subdivision setup. Not for baking since that requires
-     * exact mapping to the Blender mesh. */
-    if (scene->bake_manager->get_baking()) {
-      mesh->subdivision_type = Mesh::SUBDIVISION_NONE;
-    }
-    else {
-      mesh->subdivision_type = object_subdivision_type(b_ob, preview, experimental);
+    mesh->subdivision_type = subdivision_type;
+
+    if (!mesh_export->b_mesh) {
+      /* For some reason, meshes do not need this... */
+      bool need_undeformed = mesh->need_attribute(scene, ATTR_STD_GENERATED);
+
+      mesh_export->b_mesh = object_to_mesh(
+          b_data, b_ob, b_depsgraph, need_undeformed, mesh->subdivision_type);
     }
+  }
+  mesh->geometry_flags = requested_geometry_flags;
 
-    /* For some reason, meshes do not need this... */
-    bool need_undeformed = mesh->need_attribute(scene, ATTR_STD_GENERATED);
+  /* Tag for update right away so objects using the mesh get synced, whether the BVH needs
+   * a rebuild is only known after the export. */
+  mesh->tag_update(scene, false);
 
-    BL::Mesh b_mesh = object_to_mesh(
-        b_data, b_ob, b_depsgraph, need_undeformed, mesh->subdivision_type);
+  if (task_pool && !has_fluid_domain) {
+    mesh_exports.push_back(mesh_export);
+    task_pool->push(function_bind(&BlenderSync::sync_mesh_export, this, mesh_export));
+  }
+  else {
+    sync_mesh_export(mesh_export);
 
-    if (b_mesh) {
-      /* Sync mesh itself. */
-      if (view_layer.use_surfaces && show_self) {
-        if (mesh->subdivision_type != Mesh::SUBDIVISION_NONE)
-          create_subd_mesh(scene, mesh, b_ob, b_mesh, used_shaders, dicing_rate, max_subdivisions);
-        else
-          create_mesh(scene, mesh, b_mesh, used_shaders, false);
+    if (mesh_export->b_mesh) {
+      free_object_to_mesh(b_data, mesh_export->b_ob, mesh_export->b_mesh);
+    }
+    mesh->tag_update(scene, mesh_export->rebuild);
+    if (mesh_export->use_fingerprint) {
+      mesh_fingerprints[mesh] = mesh_export->fingerprint;
+    }
+    delete mesh_export;
+  }
 
-        create_mesh_volume_attributes(scene, b_ob, mesh, b_scene.frame_current());
-      }
+  return mesh;
+}
 
-      /* Sync hair curves. */
-      if (view_layer.use_hair && show_particles &&
-          mesh->subdivision_type == Mesh::SUBDIVISION_NONE) {
-        sync_curves(mesh, b_mesh, b_ob, false);
-      }
+void BlenderSync::sync_mesh_export(MeshExport *mesh_export)
+{
+  BL::Object &b_ob = mesh_export->b_ob;
+  BL::Mesh &b_mesh = mesh_export->b_mesh;
+  Mesh *mesh = mesh_export->mesh;
+
+  if (b_mesh) {
+    /* Sync mesh itself. */
+    if (view_layer.use_surfaces && mesh_export->show_self) {
+      if (mesh->subdivision_type != Mesh::SUBDIVISION_NONE)
+        create_subd_mesh(
+            scene, mesh, b_ob, b_mesh, mesh->used_shaders, dicing_rate, max_subdivisions);
+      else
+        create_mesh(scene, mesh, b_mesh, mesh->used_shaders, false);
+
+      create_mesh_volume_attributes(scene, b_ob, mesh, b_scene.frame_current());
+    }
 
-      free_object_to_mesh(b_data, b_ob, b_mesh);
+    /* Sync hair curves. */
+    if (view_layer.use_hair && mesh_export->show_particles &&
+        mesh->subdivision_type == Mesh::SUBDIVISION_NONE) {
+      sync_curves(mesh, b_mesh, b_ob, false);
+    }
+
+    if (mesh_export->use_fingerprint) {
+      mesh_export->fingerprint = mesh_fingerprint(
+          b_mesh, mesh_export->show_self + 2 * mesh_export->show_particles);
     }
   }
-  mesh->geometry_flags = requested_geometry_flags;
 
   /* mesh fluid motion mantaflow */
   sync_mesh_fluid_motion(b_ob, scene, mesh);
 
   /* tag update */
-  bool rebuild = (oldtriangles != mesh->triangles) || (oldsubd_faces != mesh->subd_faces) ||
-                 (oldsubd_face_corners != mesh->subd_face_corners) ||
-                 (oldcurve_keys != mesh->curve_keys) || (oldcurve_radius != mesh->curve_radius) ||
-                 (oldhas_voxel_attributes != mesh->has_voxel_attributes());
+  mesh_export->rebuild = (mesh_export->oldtriangles != mesh->triangles) ||
+                         (mesh_export->oldsubd_faces != mesh->subd_faces) ||
+                         (mesh_export->oldsubd_face_corners != mesh->subd_face_corners) ||
+                         (mesh_export->oldcurve_keys != mesh->curve_keys) ||
+                         (mesh_export->oldcurve_radius != mesh->curve_radius) ||
+                         (mesh_export->oldhas_voxel_attributes != mesh->has_voxel_attributes());
+}
 
-  mesh->tag_update(scene, rebuild);
+void BlenderSync::sync_mesh_exports_wait(TaskPool &task_pool)
+{
+  task_pool.wait_work();
 
-  return mesh;
+  /* Blender meshes are freed and updates tagged on the main thread. */
+  foreach (MeshExport *mesh_export, mesh_exports) {
+    Mesh *mesh = mesh_export->mesh;
+
+    if (mesh_export->b_mesh) {
+      free_object_to_mesh(b_data, mesh_export->b_ob, mesh_export->b_mesh);
+    }
+    if (mesh_export->rebuild) {
+      mesh->tag_update(scene, true);
+    }
+    if (mesh_export->use_fingerprint) {
+      mesh_fingerprints[mesh] = mesh_export->fingerprint;
+    }
+
+    delete mesh_export;
+  }
+
+  mesh_exports.clear();
 }
 
 void BlenderSync::sync_mesh_motion(BL::Depsgraph &b_depsgraph,
@@ -299,7 +299,8 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
                                  bool show_particles,
                                  bool show_lights,
                                  BlenderObjectCulling &culling,
-                                 bool *use_portal)
+                                 bool *use_portal,
+                                 TaskPool *geom_task_pool)
 {
   const bool is_instance = b_instance.is_instance();
   BL::Object b_ob = b_instance.object();
@@ -407,8 +408,13 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
     object_updated = true;
 
   /* mesh sync */
-  object->mesh = sync_mesh(
-      b_depsgraph, b_ob, b_ob_instance, object_updated, show_self, show_particles);
+  object->mesh = sync_mesh(b_depsgraph,
+                           b_ob,
+                           b_ob_instance,
+                           object_updated,
+                           show_self,
+                           show_particles,
+                           geom_task_pool);
 
   /* special case not tracked by object update flags */
 
@@ -545,6 +551,9 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
 
   BL::ViewLayer b_view_layer = b_depsgraph.view_layer_eval();
 
+  /* Meshes are exported in parallel. */
+  TaskPool geom_task_pool;
+
   BL::Depsgraph::object_instances_iterator b_instance_iter;
   for (b_depsgraph.object_instances.begin(b_instance_iter);
        b_instance_iter != b_depsgraph.object_instances.end() && !cancel;
@@ -570,12 +579,15 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
                   show_particles,
                   show_lights,
                   culling,
-                  &use_portal);
+                  &use_portal,
+                  &geom_task_pool);
     }
 
     cancel = progress.get_cancel();
   }
 
+  sync_mesh_exports_wait(geom_task_pool);
+
   progress.set_sync_status("");
 
   if (!cancel && !motion) {
@@ -584,8 +596,35 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
     /* handle removed data and modified pointers */
     if (light_map.post_sync())
       scene->light_manager->tag_update(scene);
-    if (mesh_map.post_sync())
+
+    if (scene->params.use_bvh_refit) {
+      /* Renders with persistent data sync all meshes anew, let them take over the BVH of the
+       * mesh from the previous render that they replace. */
+      vector<Mesh *> removed_meshes, added_meshes;
+      foreach (Mesh *mesh, scene->meshes) {
+        if (mesh_synced.find(mesh) == mesh_synced.end())
+          removed_meshes.push_back(mesh);
+        else
+          added_meshes.push_back(mesh);
+      }
+      scene->mesh_manager->reuse_bvhs(removed_meshes, added_meshes);
+    }
+
+    if (mesh_map.post_sync()) {
       scene->mesh_manager->tag_update(scene);
+
+      /* Forget about deleted meshes, new ones may be allocated at the same address. */
+      set<Mesh *> meshes(scene->meshes.begin(), scene->meshes.end());
+      for (map<Mesh *, uint>::iterator it = mesh_fingerprints.begin();
+           it != mesh_fingerprints.end();) {
+        if (meshes.find(it->first) == meshes.end()) {
+          it = mesh_fingerprints.erase(it);
+        }
+        else {
+          ++it;
+        }
+      }
+    }
     if (object_map.post_sync())
       scene->object_manager->tag_update(scene);
     if (particle_system_map.post_sync())
@@ -24,6 +24,7 @@
 
 #include "render/denoising.h"
 #include "render/merge.h"
+#include "render/texture_cache.h"
 
 #include "util/util_debug.h"
 #include "util/util_foreach.h"
@@ -78,6 +79,7 @@ bool debug_flags_sync_from_scene(BL::Scene b_scene)
   flags.cpu.sse2 = get_boolean(cscene, "debug_use_cpu_sse2");
   flags.cpu.bvh_layout = (BVHLayout)get_enum(cscene, "debug_bvh_layout");
   flags.cpu.split_kernel = get_boolean(cscene, "debug_use_cpu_split_kernel");
+  flags.cpu.ray_stream = get_boolean(cscene, "debug_use_cpu_ray_stream");
   /* Synchronize CUDA flags. */
   flags.cuda.adaptive_compile = get_boolean(cscene, "debug_use_cuda_adaptive_compile");
   flags.cuda.split_kernel = get_boolean(cscene, "debug_use_cuda_split_kernel");
@@ -342,6 +344,19 @@ static PyObject *bake_func(PyObject * /*self*/, PyObject *args)
   Py_RETURN_NONE;
 }
 
+static PyObject *bake_batch_end_func(PyObject * /*self*/, PyObject *value)
+{
+  BlenderSession *session = (BlenderSession *)PyLong_AsVoidPtr(value);
+
+  python_thread_state_save(&session->python_thread_state);
+
+  session->bake_batch_end();
+
+  python_thread_state_restore(&session->python_thread_state);
+
+  Py_RETURN_NONE;
+}
+
 static PyObject *draw_func(PyObject * /*self*/, PyObject *args)
 {
   PyObject *pysession, *pygraph, *pyv3d, *pyrv3d;
@@ -750,6 +765,7 @@ static PyObject *denoise_func(PyObject * /*self*/, PyObject *args, PyObject *key
   PointerRNA cviewlayer = RNA_pointer_get(&viewlayerptr, "cycles");
 
   DenoiseParams params;
+  params.type = (DenoiserType)get_enum(cviewlayer, "denoiser", DENOISER_NUM, DENOISER_NLM);
   params.radius = get_int(cviewlayer, "denoising_radius");
   params.strength = get_float(cviewlayer, "denoising_strength");
   params.feature_strength = get_float(cviewlayer, "denoising_feature_strength");
@@ -839,6 +855,32 @@ static PyObject *merge_func(PyObject * /*self*/, PyObject *args, PyObject *keywo
   Py_RETURN_NONE;
 }
 
+static PyObject *convert_texture_func(PyObject * /*self*/, PyObject *args, PyObject *keywords)
+{
+  static const char *keyword_list[] = {"input", "output", "tile_size", NULL};
+  const char *input = NULL, *output = NULL;
+  int tile_size = 64;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, keywords, "ss|i", (char **)keyword_list, &input, &output, &tile_size)) {
+    return NULL;
+  }
+
+  /* Convert, always overwriting the output. */
+  TextureConverter converter;
+  converter.input = input;
+  converter.output = output;
+  converter.tile_size = tile_size;
+  converter.only_if_outdated = false;
+
+  if (!converter.run()) {
+    PyErr_SetString(PyExc_ValueError, converter.error.c_str());
+    return NULL;
+  }
+
+  Py_RETURN_NONE;
+}
+
 static PyObject *debug_flags_update_func(PyObject * /*self*/, PyObject *args)
 {
   PyObject *pyscene;
@@ -982,6 +1024,7 @@ static PyMethodDef methods[] = {
     {"free", free_func, METH_O, ""},
     {"render", render_func, METH_VARARGS, ""},
     {"bake", bake_func, METH_VARARGS, ""},
+    {"bake_batch_end", bake_batch_end_func, METH_O, ""},
     {"draw", draw_func, METH_VARARGS, ""},
     {"sync", sync_func, METH_VARARGS, ""},
     {"reset", reset_func, METH_VARARGS, ""},
@@ -1000,6 +1043,9 @@ static PyMethodDef methods[] = {
     {"denoise", (PyCFunction)denoise_func, METH_VARARGS | METH_KEYWORDS, ""},
     {"merge", (PyCFunction)merge_func, METH_VARARGS | METH_KEYWORDS, ""},
 
+    /* Texture cache */
+    {"convert_texture", (PyCFunction)convert_texture_func, METH_VARARGS | METH_KEYWORDS, ""},
+
     /* Debugging routines */
     {"debug_flags_update", debug_flags_update_func, METH_VARARGS, ""},
     {"debug_flags_reset", debug_flags_reset_func, METH_NOARGS, ""},
@@ -71,7 +71,8 @@ BlenderSession::BlenderSession(BL::RenderEngine &b_engine,
       width(0),
       height(0),
       preview_osl(preview_osl),
-      python_thread_state(NULL)
+      python_thread_state(NULL),
+      bake_scene_synced(false)
 {
   /* offline render */
   background = true;
@@ -100,7 +101,8 @@ BlenderSession::BlenderSession(BL::RenderEngine &b_engine,
       width(width),
       height(height),
       preview_osl(false),
-      python_thread_state(NULL)
+      python_thread_state(NULL),
+      bake_scene_synced(false)
 {
   /* 3d view render */
   background = false;
@@ -118,7 +120,7 @@ void BlenderSession::create_session()
 {
   SessionParams session_params = BlenderSync::get_session_params(
       b_engine, b_userpref, b_scene, background);
-  SceneParams scene_params = BlenderSync::get_scene_params(b_scene, background);
+  SceneParams scene_params = BlenderSync::get_scene_params(b_data, b_scene, background);
   bool session_pause = BlenderSync::get_session_pause(b_scene, background);
 
   /* reset status/progress */
@@ -126,6 +128,7 @@ void BlenderSession::create_session()
   last_error = "";
   last_progress = -1.0f;
   start_resize_time = 0.0;
+  bake_scene_synced = false;
 
   /* create session */
   session = new Session(session_params);
@@ -145,6 +148,8 @@ void BlenderSession::create_session()
       &BlenderSession::builtin_image_pixels, this, _1, _2, _3, _4, _5, _6, _7);
   scene->image_manager->builtin_image_float_pixels_cb = function_bind(
       &BlenderSession::builtin_image_float_pixels, this, _1, _2, _3, _4, _5, _6, _7);
+  scene->image_manager->builtin_image_float_voxels_cb = function_bind(
+      &BlenderSession::builtin_image_float_voxels, this, _1, _2, _3, _4, _5, _6);
 
   session->scene = scene;
 
@@ -211,7 +216,7 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
 
   SessionParams session_params = BlenderSync::get_session_params(
       b_engine, b_userpref, b_scene, background);
-  SceneParams scene_params = BlenderSync::get_scene_params(b_scene, background);
+  SceneParams scene_params = BlenderSync::get_scene_params(b_data, b_scene, background);
 
   if (scene->params.modified(scene_params) || session->params.modified(session_params) ||
       !scene_params.persistent_data) {
@@ -227,6 +232,7 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
 
   session->progress.reset();
   scene->reset();
+  bake_scene_synced = false;
 
   session->tile_manager.set_tile_order(session_params.tile_order);
 
@@ -239,6 +245,7 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
    * See note on create_session().
    */
   /* sync object should be re-created */
+  delete sync;
   sync = new BlenderSync(b_engine, b_data, b_scene, scene, !background, session->progress);
 
   BL::SpaceView3D b_null_space_view3d(PointerRNA_NULL);
@@ -491,6 +498,8 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
   session->params.run_denoising = run_denoising;
   session->params.full_denoising = full_denoising;
   session->params.write_denoising_passes = write_denoising_passes;
+  session->params.denoising.type = (DenoiserType)get_enum(
+      crl, "denoiser", DENOISER_NUM, DENOISER_NLM);
   session->params.denoising.radius = get_int(crl, "denoising_radius");
   session->params.denoising.strength = get_float(crl, "denoising_strength");
   session->params.denoising.feature_strength = get_float(crl, "denoising_feature_strength");
@@ -660,6 +669,12 @@ void BlenderSession::bake(BL::Depsgraph &b_depsgraph_,
                           const int /*depth*/,
                           float result[])
 {
+  /* Within a batch Blender keeps the engine and depsgraph between bakes, so the scene only
+   * needs to be synced for the first one. */
+  if (b_depsgraph.ptr.data != b_depsgraph_.ptr.data) {
+    bake_scene_synced = false;
+  }
+
   b_depsgraph = b_depsgraph_;
 
   ShaderEvalType shader_type = get_shader_type(pass_type);
@@ -689,13 +704,14 @@ void BlenderSession::bake(BL::Depsgraph &b_depsgraph_,
   scene->film->tag_update(scene);
   scene->integrator->tag_update(scene);
 
-  if (!session->progress.get_cancel()) {
+  if (!session->progress.get_cancel() && !bake_scene_synced) {
     /* update scene */
     BL::Object b_camera_override(b_engine.camera_override());
     sync->sync_camera(b_render, b_camera_override, width, height, "");
     sync->sync_data(
         b_render, b_depsgraph, b_v3d, b_camera_override, width, height, &python_thread_state);
     builtin_images_load();
+    bake_scene_synced = true;
   }
 
   BakeData *bake_data = NULL;
@@ -756,14 +772,23 @@ void BlenderSession::bake(BL::Depsgraph &b_depsgraph_,
                               result);
   }
 
+  /* Keep the scene for the next bake of the batch, it is freed when the batch ends. */
+  if (!b_engine.is_bake_batch()) {
+    bake_batch_end();
+  }
+}
+
+void BlenderSession::bake_batch_end()
+{
   /* free all memory used (host and device), so we wouldn't leave render
-   * engine with extra memory allocated
+   * engine with extra memory allocated, it may be kept for persistent data
    */
 
   session->device_free();
 
   delete sync;
   sync = NULL;
+  bake_scene_synced = false;
 }
 
 void BlenderSession::do_write_update_render_result(BL::RenderLayer &b_rlay,
@@ -841,7 +866,7 @@ void BlenderSession::synchronize(BL::Depsgraph &b_depsgraph_)
   /* on session/scene parameter changes, we recreate session entirely */
   SessionParams session_params = BlenderSync::get_session_params(
       b_engine, b_userpref, b_scene, background);
-  SceneParams scene_params = BlenderSync::get_scene_params(b_scene, background);
+  SceneParams scene_params = BlenderSync::get_scene_params(b_data, b_scene, background);
   bool session_pause = BlenderSync::get_session_pause(b_scene, background);
 
   if (session->params.modified(session_params) || scene->params.modified(scene_params)) {
@@ -1431,6 +1456,37 @@ bool BlenderSession::builtin_image_float_pixels(const string &builtin_name,
   return false;
 }
 
+bool BlenderSession::builtin_image_float_voxels(const string &builtin_name,
+                                                void *builtin_data,
+                                                int z_begin,
+                                                int z_end,
+                                                float *voxels,
+                                                const size_t voxels_size)
+{
+  if (!builtin_data) {
+    return false;
+  }
+
+  PointerRNA ptr;
+  RNA_id_pointer_create((ID *)builtin_data, &ptr);
+  BL::ID b_id(ptr);
+
+  if (!b_id.is_a(&RNA_Object)) {
+    return false;
+  }
+
+  /* Smoke volume data, read directly from the grids of the domain. */
+  BL::Object b_ob(b_id);
+  BL::FluidDomainSettings b_domain = object_fluid_domain_find(b_ob);
+
+  if (!b_domain) {
+    return false;
+  }
+
+  return BKE_fluid_domain_grid_get_slices(
+      b_domain.ptr.data, builtin_name.c_str(), z_begin, z_end, voxels, voxels_size);
+}
+
 void BlenderSession::builtin_images_load()
 {
   /* Force builtin images to be loaded along with Blender data sync. This
@@ -67,6 +67,7 @@ class BlenderSession {
             const size_t num_pixels,
             const int depth,
             float pixels[]);
+  void bake_batch_end();
 
   void write_render_result(BL::RenderLayer &b_rlay, RenderTile &rtile);
   void write_render_tile(RenderTile &rtile);
@@ -121,6 +122,9 @@ class BlenderSession {
 
   void *python_thread_state;
 
+  /* Scene was synced for baking, it is kept for following bakes of the same batch. */
+  bool bake_scene_synced;
+
   /* Global state which is common for all render sessions created from Blender.
    * Usually denotes command line arguments.
    */
@@ -169,6 +173,12 @@ class BlenderSession {
                                   const size_t pixels_size,
                                   const bool associate_alpha,
                                   const bool free_cache);
+  bool builtin_image_float_voxels(const string &builtin_name,
+                                  void *builtin_data,
+                                  int z_begin,
+                                  int z_end,
+                                  float *voxels,
+                                  const size_t voxels_size);
   void builtin_images_load();
 
   /* Update tile manager to reflect resumable render settings. */
@@ -273,6 +273,9 @@ void BlenderSync::sync_integrator()
   integrator->sampling_pattern = (SamplingPattern)get_enum(
       cscene, "sampling_pattern", SAMPLING_NUM_PATTERNS, SAMPLING_PATTERN_SOBOL);
 
+  integrator->adaptive_threshold = get_float(cscene, "adaptive_threshold");
+  integrator->adaptive_min_samples = get_int(cscene, "adaptive_min_samples");
+
   integrator->sample_clamp_direct = get_float(cscene, "sample_clamp_direct");
   integrator->sample_clamp_indirect = get_float(cscene, "sample_clamp_indirect");
   if (!preview) {
@@ -284,8 +287,17 @@ void BlenderSync::sync_integrator()
     integrator->motion_blur = r.use_motion_blur();
   }
 
-  integrator->method = (Integrator::Method)get_enum(
+  Integrator::Method method = (Integrator::Method)get_enum(
       cscene, "progressive", Integrator::NUM_METHODS, Integrator::PATH);
+  bool use_light_tree = get_boolean(cscene, "use_light_tree");
+
+  /* The light distribution is built differently when the light tree is in use. */
+  if (integrator->method != method || integrator->use_light_tree != use_light_tree) {
+    scene->light_manager->tag_update(scene);
+  }
+
+  integrator->method = method;
+  integrator->use_light_tree = use_light_tree;
 
   integrator->sample_all_lights_direct = get_boolean(cscene, "sample_all_lights_direct");
   integrator->sample_all_lights_indirect = get_boolean(cscene, "sample_all_lights_indirect");
@@ -635,6 +647,14 @@ vector<Pass> BlenderSync::sync_render_passes(BL::RenderLayer &b_rlay, BL::ViewLa
                                                         CRYPT_ACCURATE);
   }
 
+  /* Adaptive sampling needs a half sample buffer for its noise estimate and the number of
+   * samples each pixel received, neither is written out to Blender. */
+  PointerRNA cscene = RNA_pointer_get(&b_scene.ptr, "cycles");
+  if (get_boolean(cscene, "use_adaptive_sampling")) {
+    Pass::add(PASS_ADAPTIVE_AUX_BUFFER, passes);
+    Pass::add(PASS_SAMPLE_COUNT, passes);
+  }
+
   RNA_BEGIN (&crp, b_aov, "aovs") {
     bool is_color = (get_enum(b_aov, "type") == 1);
     string name = get_string(b_aov, "name");
@@ -675,7 +695,9 @@ void BlenderSync::free_data_after_sync(BL::Depsgraph &b_depsgraph)
 
 /* Scene Parameters */
 
-SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
+SceneParams BlenderSync::get_scene_params(BL::BlendData &b_data,
+                                          BL::Scene &b_scene,
+                                          bool background)
 {
   BL::RenderSettings r = b_scene.render();
   SceneParams params;
@@ -701,6 +723,8 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
   else
     params.persistent_data = false;
 
+  params.use_bvh_refit = params.persistent_data && RNA_boolean_get(&cscene, "use_bvh_refit");
+
   int texture_limit;
   if (background) {
     texture_limit = RNA_enum_get(&cscene, "texture_limit_render");
@@ -715,6 +739,13 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
     params.texture_limit = 0;
   }
 
+  params.texture_cache.use_cache = RNA_boolean_get(&cscene, "use_texture_cache");
+  params.texture_cache.cache_size = RNA_int_get(&cscene, "texture_cache_size");
+  params.texture_cache.auto_convert = RNA_boolean_get(&cscene, "texture_auto_convert");
+  params.texture_cache.tile_size = RNA_int_get(&cscene, "texture_tile_size");
+  params.texture_cache.cache_path = blender_absolute_path(
+      b_data, b_scene, get_string(cscene, "texture_cache_path"));
+
   /* TODO(sergey): Once OSL supports per-microarchitecture optimization get
    * rid of this.
    */
@@ -30,6 +30,7 @@
 
 #include "util/util_map.h"
 #include "util/util_set.h"
+#include "util/util_task.h"
 #include "util/util_transform.h"
 #include "util/util_vector.h"
 
@@ -88,7 +89,7 @@ class BlenderSync {
   }
 
   /* get parameters */
-  static SceneParams get_scene_params(BL::Scene &b_scene, bool background);
+  static SceneParams get_scene_params(BL::BlendData &b_data, BL::Scene &b_scene, bool background);
   static SessionParams get_session_params(BL::RenderEngine &b_engine,
                                           BL::Preferences &b_userpref,
                                           BL::Scene &b_scene,
@@ -128,7 +129,8 @@ class BlenderSync {
                   BL::Object &b_ob_instance,
                   bool object_updated,
                   bool show_self,
-                  bool show_particles);
+                  bool show_particles,
+                  TaskPool *task_pool);
   void sync_curves(
       Mesh *mesh, BL::Mesh &b_mesh, BL::Object &b_ob, bool motion, int motion_step = 0);
   Object *sync_object(BL::Depsgraph &b_depsgraph,
@@ -139,7 +141,8 @@ class BlenderSync {
                       bool show_particles,
                       bool show_lights,
                       BlenderObjectCulling &culling,
-                      bool *use_portal);
+                      bool *use_portal,
+                      TaskPool *geom_task_pool);
   void sync_light(BL::Object &b_parent,
                   int persistent_id[OBJECT_PERSISTENT_ID_SIZE],
                   BL::Object &b_ob,
@@ -155,6 +158,48 @@ class BlenderSync {
   void sync_camera_motion(
       BL::RenderSettings &b_render, BL::Object &b_ob, int width, int height, float motion_time);
 
+  /* Mesh export that runs in a task pool, while Blender data is evaluated on the main thread. */
+  struct MeshExport {
+    MeshExport(BL::Object &b_ob,
+               BL::Mesh &b_mesh,
+               Mesh *mesh,
+               bool show_self,
+               bool show_particles,
+               bool use_fingerprint)
+        : b_ob(b_ob),
+          b_mesh(b_mesh),
+          mesh(mesh),
+          show_self(show_self),
+          show_particles(show_particles),
+          use_fingerprint(use_fingerprint),
+          oldhas_voxel_attributes(false),
+          rebuild(false),
+          fingerprint(0)
+    {
+    }
+
+    BL::Object b_ob;
+    BL::Mesh b_mesh;
+    Mesh *mesh;
+    bool show_self;
+    bool show_particles;
+    bool use_fingerprint;
+
+    /* Geometry before the export, to detect whether the BVH needs a rebuild. */
+    array<int> oldtriangles;
+    array<Mesh::SubdFace> oldsubd_faces;
+    array<int> oldsubd_face_corners;
+    array<float3> oldcurve_keys;
+    array<float> oldcurve_radius;
+    bool oldhas_voxel_attributes;
+
+    bool rebuild;
+    uint fingerprint;
+  };
+
+  void sync_mesh_export(MeshExport *mesh_export);
+  void sync_mesh_exports_wait(TaskPool &task_pool);
+
   /* particles */
   bool sync_dupli_particle(BL::Object &b_ob,
                            BL::DepsgraphObjectInstance &b_instance,
@@ -184,6 +229,9 @@ class BlenderSync {
   id_map<ParticleSystemKey, ParticleSystem> particle_system_map;
   set<Mesh *> mesh_synced;
   set<Mesh *> mesh_motion_synced;
+  vector<MeshExport *> mesh_exports;
+  /* Fingerprint of the Blender mesh data of the last export, see mesh_fingerprint(). */
+  map<Mesh *, uint> mesh_fingerprints;
   set<float> motion_times;
   void *world_map;
   bool world_recalc;
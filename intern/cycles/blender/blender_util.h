@@ -36,6 +36,8 @@ void BKE_image_user_frame_calc(void *ima, void *iuser, int cfra);
 void BKE_image_user_file_path(void *iuser, void *ima, char *path);
 unsigned char *BKE_image_get_pixels_for_frame(void *image, int frame, int tile);
 float *BKE_image_get_float_pixels_for_frame(void *image, int frame, int tile);
+bool BKE_fluid_domain_grid_get_slices(
+    void *mds, const char *name, int z_begin, int z_end, float *values, size_t values_len);
 }
 
 CCL_NAMESPACE_BEGIN
@@ -100,7 +100,12 @@ int BVHStackEntry::encodeIdx() const
 /* BVH */
 
 BVH::BVH(const BVHParams &params_, const vector<Mesh *> &meshes_, const vector<Object *> &objects_)
-    : params(params_), meshes(meshes_), objects(objects_)
+    : params(params_),
+      meshes(meshes_),
+      objects(objects_),
+      leaf_cost(0.0f),
+      build_leaf_cost(0.0f),
+      leaf_area(0.0f)
 {
 }
 
@@ -185,6 +190,15 @@ void BVH::build(Progress &progress, Stats *)
   progress.set_substatus("Packing BVH nodes");
   pack_nodes(root);
 
+  /* Measure leaves the same way refitting does, spatial splits clip primitives to the leaf
+   * bounds which a refit can not do. Only object BVHs are ever refitted. */
+  if (!params.top_level) {
+    leaf_cost_begin();
+    build_leaf_cost_recursive(root);
+    leaf_cost_end();
+    build_leaf_cost = leaf_cost;
+  }
+
   /* free build nodes */
   root->deleteSubtree();
 }
@@ -200,11 +214,47 @@ void BVH::refit(Progress &progress)
     return;
 
   progress.set_substatus("Refitting BVH nodes");
+  leaf_cost_begin();
   refit_nodes();
+  leaf_cost_end();
+}
+
+bool BVH::refit_degraded() const
+{
+  return build_leaf_cost > 0.0f && leaf_cost > build_leaf_cost * params.max_refit_cost_ratio;
+}
+
+void BVH::leaf_cost_begin()
+{
+  leaf_area = 0.0f;
+  leaf_bounds = BoundBox::empty;
+}
+
+void BVH::leaf_cost_end()
+{
+  const float area = leaf_bounds.safe_area();
+  leaf_cost = (area > 0.0f) ? leaf_area / area : 0.0f;
+}
+
+void BVH::build_leaf_cost_recursive(const BVHNode *node)
+{
+  if (node->is_leaf()) {
+    const LeafNode *leaf = (const LeafNode *)node;
+    BoundBox bbox = BoundBox::empty;
+    uint visibility = 0;
+    refit_primitives(leaf->lo, leaf->hi, bbox, visibility);
+    return;
+  }
+
+  for (int i = 0; i < node->num_children(); i++) {
+    build_leaf_cost_recursive(node->get_child(i));
+  }
 }
 
-void BVH::refit_primitives(int start, int end, BoundBox &bbox, uint &visibility)
+void BVH::refit_primitives(int start, int end, BoundBox &leaf_bbox, uint &visibility)
 {
+  BoundBox bbox = BoundBox::empty;
+
   /* Refit range of primitives. */
   for (int prim = start; prim < end; prim++) {
     int pidx = pack.prim_index[prim];
@@ -268,6 +318,10 @@ void BVH::refit_primitives(int start, int end, BoundBox &bbox, uint &visibility)
     }
     visibility |= ob->visibility_for_tracing();
   }
+
+  leaf_area += bbox.safe_area() * (end - start);
+  leaf_bounds.grow(bbox);
+  leaf_bbox.grow(bbox);
 }
 
 /* Triangles */
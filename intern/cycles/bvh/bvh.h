@@ -87,6 +87,12 @@ class BVH {
   vector<Mesh *> meshes;
   vector<Object *> objects;
 
+  /* Surface area of the leaves weighted by their number of primitives, relative to the bounds
+   * of the whole tree. Only computed for BVH layouts packed by Cycles itself, zero otherwise. */
+  float leaf_cost;
+  /* Leaf cost right after building, refitting deforming geometry makes it grow. */
+  float build_leaf_cost;
+
   static BVH *create(const BVHParams &params,
                      const vector<Mesh *> &meshes,
                      const vector<Object *> &objects);
@@ -101,12 +107,23 @@ class BVH {
 
   void refit(Progress &progress);
 
+  /* Check whether refitting made the tree too much slower to traverse than a new one. */
+  bool refit_degraded() const;
+
  protected:
   BVH(const BVHParams &params, const vector<Mesh *> &meshes, const vector<Object *> &objects);
 
   /* Refit range of primitives. */
   void refit_primitives(int start, int end, BoundBox &bbox, uint &visibility);
 
+  /* Accumulated by refit_primitives() to compute the leaf cost. */
+  void leaf_cost_begin();
+  void leaf_cost_end();
+  void build_leaf_cost_recursive(const BVHNode *node);
+
+  float leaf_area;
+  BoundBox leaf_bounds;
+
   /* triangles and strands */
   void pack_primitives();
   void pack_triangle(int idx, float4 storage[3]);
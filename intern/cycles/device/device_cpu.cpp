@@ -24,6 +24,10 @@
 #  include <OSL/oslexec.h>
 #endif
 
+#ifdef WITH_OPENIMAGEDENOISE
+#  include <OpenImageDenoise/oidn.hpp>
+#endif
+
 #include "device/device.h"
 #include "device/device_denoising.h"
 #include "device/device_intern.h"
@@ -34,6 +38,8 @@
 #include "kernel/kernel_types.h"
 #include "kernel/split/kernel_split_data.h"
 #include "kernel/kernel_globals.h"
+#include "kernel/kernel_adaptive_sampling.h"
+#include "kernel/bvh/bvh_types.h"
 
 #include "kernel/filter/filter.h"
 
@@ -174,11 +180,19 @@ class CPUDevice : public Device {
   OSLGlobals osl_globals;
 #endif
 
+#ifdef WITH_OPENIMAGEDENOISE
+  /* Created on first use and shared by all denoising threads. */
+  oidn::DeviceRef oidn_device;
+  thread_mutex oidn_mutex;
+#endif
+
   bool use_split_kernel;
 
   DeviceRequestedFeatures requested_features;
 
   KernelFunctions<void (*)(KernelGlobals *, float *, int, int, int, int, int)> path_trace_kernel;
+  KernelFunctions<void (*)(KernelGlobals *, float *, int, int, int, int, int, int)>
+      path_trace_stream_kernel;
   KernelFunctions<void (*)(KernelGlobals *, uchar4 *, float *, float, int, int, int, int)>
       convert_to_half_float_kernel;
   KernelFunctions<void (*)(KernelGlobals *, uchar4 *, float *, float, int, int, int, int)>
@@ -264,6 +278,7 @@ class CPUDevice : public Device {
         texture_info(this, "__texture_info", MEM_TEXTURE),
 #define REGISTER_KERNEL(name) name##_kernel(KERNEL_FUNCTIONS(name))
         REGISTER_KERNEL(path_trace),
+        REGISTER_KERNEL(path_trace_stream),
         REGISTER_KERNEL(convert_to_half_float),
         REGISTER_KERNEL(convert_to_byte),
         REGISTER_KERNEL(shader),
@@ -819,6 +834,112 @@ class CPUDevice : public Device {
     return true;
   }
 
+#ifdef WITH_OPENIMAGEDENOISE
+  bool denoising_openimagedenoise(device_ptr output_ptr, DenoisingTask *task)
+  {
+    const TileInfo *tile_info = task->tile_info;
+
+    /* Denoise the neighboring tiles along with the center tile, so the network sees the
+     * surrounding image and tiles blend without visible seams. */
+    const int4 rect = make_int4(
+        tile_info->x[0], tile_info->y[0], tile_info->x[3], tile_info->y[3]);
+    const int w = rect.z - rect.x;
+    const int h = rect.w - rect.y;
+
+    /* Passes straight from rendering hold sums over all samples, while the standalone
+     * denoiser reads averaged passes from files. */
+    int color_offset, albedo_offset, normal_offset;
+    float scale;
+    if (tile_info->from_render) {
+      color_offset = DENOISING_PASS_COLOR;
+      albedo_offset = DENOISING_PASS_ALBEDO;
+      normal_offset = DENOISING_PASS_NORMAL;
+      scale = 1.0f / task->render_buffer.samples;
+    }
+    else {
+      color_offset = DENOISING_PASS_PREFILTERED_COLOR;
+      albedo_offset = DENOISING_PASS_PREFILTERED_ALBEDO;
+      normal_offset = DENOISING_PASS_PREFILTERED_NORMAL;
+      scale = 1.0f;
+    }
+
+    vector<float> color(3 * w * h), albedo(3 * w * h), normal(3 * w * h), output(3 * w * h);
+
+    for (int y = rect.y; y < rect.w; y++) {
+      const int ytile = (y < tile_info->y[1]) ? 0 : ((y < tile_info->y[2]) ? 1 : 2);
+      for (int x = rect.x; x < rect.z; x++) {
+        const int xtile = (x < tile_info->x[1]) ? 0 : ((x < tile_info->x[2]) ? 1 : 2);
+        const int tile = ytile * 3 + xtile;
+        const float *buffer = (const float *)tile_info->buffers[tile] +
+                              (tile_info->offsets[tile] + y * tile_info->strides[tile] + x) *
+                                  task->render_buffer.pass_stride +
+                              task->render_buffer.offset;
+
+        const int idx = 3 * ((y - rect.y) * w + (x - rect.x));
+        for (int i = 0; i < 3; i++) {
+          color[idx + i] = scale * buffer[color_offset + i];
+          albedo[idx + i] = scale * buffer[albedo_offset + i];
+          normal[idx + i] = scale * buffer[normal_offset + i];
+        }
+      }
+    }
+
+    {
+      /* Since it's memory intensive, only run one instance at a time. OpenImageDenoise is
+       * multithreaded internally and uses all cores nonetheless. */
+      thread_scoped_lock lock(oidn_mutex);
+
+      if (!oidn_device) {
+        oidn_device = oidn::newDevice();
+        oidn_device.commit();
+      }
+
+      oidn::FilterRef filter = oidn_device.newFilter("RT");
+      filter.setImage("color", color.data(), oidn::Format::Float3, w, h);
+      filter.setImage("albedo", albedo.data(), oidn::Format::Float3, w, h);
+      filter.setImage("normal", normal.data(), oidn::Format::Float3, w, h);
+      filter.setImage("output", output.data(), oidn::Format::Float3, w, h);
+      filter.set("hdr", true);
+      filter.set("srgb", false);
+      filter.commit();
+      filter.execute();
+
+      const char *error_message;
+      if (oidn_device.getError(error_message) != oidn::Error::None) {
+        set_error(string_printf("OpenImageDenoise error: %s", error_message));
+        return false;
+      }
+    }
+
+    /* Write the center tile back in the same way as the NLM reconstruction does. */
+    const int4 &area = task->filter_area;
+    const int clean_offset = task->target_buffer.denoising_clean_offset;
+    for (int y = area.y; y < area.y + area.w; y++) {
+      for (int x = area.x; x < area.x + area.z; x++) {
+        const int idx = 3 * ((y - rect.y) * w + (x - rect.x));
+        float3 result = make_float3(output[idx], output[idx + 1], output[idx + 2]);
+        result = max(result, make_float3(0.0f, 0.0f, 0.0f));
+
+        float *target = (float *)output_ptr +
+                        (task->target_buffer.offset + y * task->target_buffer.stride + x) *
+                            task->target_buffer.pass_stride;
+        if (clean_offset >= 0) {
+          result *= task->render_buffer.samples;
+          if (clean_offset > 0) {
+            result += make_float3(
+                target[clean_offset], target[clean_offset + 1], target[clean_offset + 2]);
+          }
+        }
+        target[0] = result.x;
+        target[1] = result.y;
+        target[2] = result.z;
+      }
+    }
+
+    return true;
+  }
+#endif
+
   void path_trace(DeviceTask &task, RenderTile &tile, KernelGlobals *kg)
   {
     const bool use_coverage = kernel_data.film.cryptomatte_passes & CRYPT_ACCURATE;
@@ -837,6 +958,12 @@ class CPUDevice : public Device {
     /* Needed for Embree. */
     SIMD_SET_FLUSH_TO_ZERO;
 
+    /* Trace the camera rays of pixels in a row together, only the 8-wide BVH has a stream
+     * traversal. */
+    const bool use_stream = DebugFlags().cpu.ray_stream && !use_coverage &&
+                            !kernel_data.integrator.branched &&
+                            kernel_data.bvh.bvh_layout == BVH_LAYOUT_BVH8;
+
     for (int sample = start_sample; sample < end_sample; sample++) {
       if (task.get_cancel() || task_pool.canceled()) {
         if (task.need_finish_queue == false)
@@ -844,6 +971,15 @@ class CPUDevice : public Device {
       }
 
       for (int y = tile.y; y < tile.y + tile.h; y++) {
+        if (use_stream) {
+          for (int x = tile.x; x < tile.x + tile.w; x += BVH_STREAM_SIZE) {
+            const int num_pixels = min(BVH_STREAM_SIZE, tile.x + tile.w - x);
+            path_trace_stream_kernel()(
+                kg, render_buffer, sample, x, y, num_pixels, tile.offset, tile.stride);
+          }
+          continue;
+        }
+
         for (int x = tile.x; x < tile.x + tile.w; x++) {
           if (use_coverage) {
             coverage.init_pixel(x, y);
@@ -855,10 +991,113 @@ class CPUDevice : public Device {
       tile.sample = sample + 1;
 
       task.update_progress(&tile, tile.w * tile.h);
+
+      if (task.adaptive_sampling.need_filter(sample)) {
+        if (adaptive_sampling_filter(kg, tile)) {
+          /* Every pixel in the tile has converged, retire it early. The remaining samples
+           * are still reported so the overall progress stays consistent. */
+          task.update_progress(&tile, tile.w * tile.h * (end_sample - tile.sample));
+          tile.sample = end_sample;
+          break;
+        }
+      }
     }
     if (use_coverage) {
       coverage.finalize();
     }
+    if (task.adaptive_sampling.use) {
+      adaptive_sampling_post(kg, tile);
+    }
+  }
+
+  /* Runs the convergence test on all pixels of the tile and grows the unconverged regions by
+   * one pixel. Returns true when the whole tile has converged. */
+  bool adaptive_sampling_filter(KernelGlobals *kg, RenderTile &tile)
+  {
+    float *render_buffer = (float *)tile.buffer;
+    const int pass_stride = kernel_data.film.pass_stride;
+
+    for (int y = tile.y; y < tile.y + tile.h; y++) {
+      for (int x = tile.x; x < tile.x + tile.w; x++) {
+        int index = tile.offset + x + y * tile.stride;
+        kernel_do_adaptive_stopping(kg, render_buffer + index * pass_stride);
+      }
+    }
+
+    bool any = false;
+    for (int y = tile.y; y < tile.y + tile.h; y++) {
+      any |= kernel_do_adaptive_filter_x(
+          kg, render_buffer, y, tile.x, tile.w, tile.offset, tile.stride);
+    }
+    for (int x = tile.x; x < tile.x + tile.w; x++) {
+      any |= kernel_do_adaptive_filter_y(
+          kg, render_buffer, x, tile.y, tile.h, tile.offset, tile.stride);
+    }
+
+    return !any;
+  }
+
+  /* Pixels that stopped early hold fewer samples than the rest of the tile. Scale their
+   * accumulated passes up to the tile sample count, so that everything reading the buffers
+   * can keep normalizing with a single sample count. */
+  void adaptive_sampling_post(KernelGlobals *kg, RenderTile &tile)
+  {
+    float *render_buffer = (float *)tile.buffer;
+    const BufferParams &params = tile.buffers->params;
+    const int pass_stride = kernel_data.film.pass_stride;
+
+    for (int y = tile.y; y < tile.y + tile.h; y++) {
+      for (int x = tile.x; x < tile.x + tile.w; x++) {
+        int index = tile.offset + x + y * tile.stride;
+        float *buffer = render_buffer + index * pass_stride;
+        float *sample_count = buffer + kernel_data.film.pass_sample_count;
+
+        if (*sample_count == 0.0f || *sample_count >= (float)tile.sample) {
+          continue;
+        }
+
+        const float multiplier = (float)tile.sample / *sample_count;
+        int pass_offset = 0;
+
+        foreach (const Pass &pass, params.passes) {
+          float *in = buffer + pass_offset;
+          pass_offset += pass.components;
+
+          if (!pass.filter) {
+            continue;
+          }
+
+          if (pass.type == PASS_CRYPTOMATTE) {
+            /* Only the weights are accumulated, IDs stay as they are. */
+            in[1] *= multiplier;
+            in[3] *= multiplier;
+          }
+          else if (pass.type == PASS_ADAPTIVE_AUX_BUFFER) {
+            /* The fourth component holds the convergence flag. */
+            in[0] *= multiplier;
+            in[1] *= multiplier;
+            in[2] *= multiplier;
+          }
+          else {
+            for (int i = 0; i < pass.components; i++) {
+              in[i] *= multiplier;
+            }
+          }
+        }
+
+        if (params.denoising_data_pass) {
+          int size = DENOISING_PASS_SIZE_BASE;
+          if (params.denoising_clean_pass) {
+            size += DENOISING_PASS_SIZE_CLEAN;
+          }
+          for (int i = 0; i < size; i++) {
+            buffer[pass_offset + i] *= multiplier;
+          }
+        }
+
+        *sample_count = (float)tile.sample;
+      }
+    }
   }
 
   void denoise(DenoisingTask &denoising, RenderTile &tile)
@@ -884,6 +1123,12 @@ class CPUDevice : public Device {
         &CPUDevice::denoising_write_feature, this, _1, _2, _3, &denoising);
     denoising.functions.detect_outliers = function_bind(
         &CPUDevice::denoising_detect_outliers, this, _1, _2, _3, _4, &denoising);
+#ifdef WITH_OPENIMAGEDENOISE
+    if (system_cpu_support_sse41()) {
+      denoising.functions.openimagedenoise = function_bind(
+          &CPUDevice::denoising_openimagedenoise, this, _1, &denoising);
+    }
+#endif
 
     denoising.filter_area = make_int4(tile.x, tile.y, tile.w, tile.h);
     denoising.render_buffer.samples = tile.sample;
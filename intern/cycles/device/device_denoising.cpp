@@ -27,6 +27,7 @@ DenoisingTask::DenoisingTask(Device *device, const DeviceTask &task)
       buffer(device),
       device(device)
 {
+  type = task.denoising.type;
   radius = task.denoising.radius;
   nlm_k_2 = powf(2.0f, lerp(-5.0f, 3.0f, task.denoising.strength));
   if (task.denoising.relative_pca) {
@@ -327,20 +328,33 @@ void DenoisingTask::run_denoising(RenderTile *tile)
   functions.map_neighbor_tiles(rtiles);
   set_render_buffer(rtiles);
 
-  setup_denoising_buffer();
+  /* Devices without OpenImageDenoise support fall back to NLM. */
+  const bool use_openimagedenoise = (type == DENOISER_OPENIMAGEDENOISE) &&
+                                    functions.openimagedenoise;
 
-  if (tile_info->from_render) {
-    prefilter_shadowing();
-    prefilter_features();
-    prefilter_color();
-  }
-  else {
-    load_buffer();
+  /* The prefiltered feature passes are still needed when they are written out, e.g. for
+   * denoising animations later. */
+  if (!use_openimagedenoise || write_passes) {
+    setup_denoising_buffer();
+
+    if (tile_info->from_render) {
+      prefilter_shadowing();
+      prefilter_features();
+      prefilter_color();
+    }
+    else {
+      load_buffer();
+    }
   }
 
   if (do_filter) {
-    construct_transform();
-    reconstruct();
+    if (use_openimagedenoise) {
+      functions.openimagedenoise(target_buffer.ptr);
+    }
+    else {
+      construct_transform();
+      reconstruct();
+    }
   }
 
   if (write_passes) {
@@ -30,6 +30,7 @@ CCL_NAMESPACE_BEGIN
 class DenoisingTask {
  public:
   /* Parameters of the denoising algorithm. */
+  DenoiserType type;
   int radius;
   float nlm_k_2;
   float pca_threshold;
@@ -102,6 +103,9 @@ class DenoisingTask {
                   device_ptr output_ptr)>
         detect_outliers;
     function<bool(int out_offset, device_ptr frop_ptr, device_ptr buffer_ptr)> write_feature;
+    /* Only set on devices that support OpenImageDenoise, which reads the render buffers of the
+     * neighboring tiles directly and writes the denoised image into the target buffer. */
+    function<bool(device_ptr output_ptr)> openimagedenoise;
     function<void(RenderTile *rtiles)> map_neighbor_tiles;
     function<void(RenderTile *rtiles)> unmap_neighbor_tiles;
   } functions;
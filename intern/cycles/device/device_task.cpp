@@ -136,4 +136,21 @@ void DeviceTask::update_progress(RenderTile *rtile, int pixel_samples)
   }
 }
 
+/* Adaptive Sampling */
+
+AdaptiveSampling::AdaptiveSampling() : use(false), adaptive_step(4), min_samples(0)
+{
+}
+
+/* Returns true when the convergence test should run after the given sample has been
+ * rendered. Testing only after an even number of samples keeps the auxiliary half buffer
+ * balanced against the combined pass. */
+bool AdaptiveSampling::need_filter(int sample) const
+{
+  if (!use || sample + 1 < min_samples) {
+    return false;
+  }
+  return (sample & (adaptive_step - 1)) == (adaptive_step - 1);
+}
+
 CCL_NAMESPACE_END
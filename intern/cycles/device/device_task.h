@@ -32,8 +32,19 @@ class RenderBuffers;
 class RenderTile;
 class Tile;
 
+enum DenoiserType {
+  /* Non-local means filter with feature-space regression, on all devices. */
+  DENOISER_NLM = 0,
+  /* Intel OpenImageDenoise, on CPU devices only. Falls back to NLM elsewhere. */
+  DENOISER_OPENIMAGEDENOISE = 1,
+  DENOISER_NUM,
+};
+
 class DenoiseParams {
  public:
+  /* Denoising algorithm to use. */
+  DenoiserType type;
+
   /* Pixel radius for neighboring pixels to take into account. */
   int radius;
   /* Controls neighbor pixel weighting for the denoising filter. */
@@ -50,6 +61,7 @@ class DenoiseParams {
 
   DenoiseParams()
   {
+    type = DENOISER_NLM;
     radius = 8;
     strength = 0.5f;
     feature_strength = 0.5f;
@@ -59,6 +71,20 @@ class DenoiseParams {
   }
 };
 
+class AdaptiveSampling {
+ public:
+  AdaptiveSampling();
+
+  bool need_filter(int sample) const;
+
+  /* Whether the per-pixel convergence test runs during rendering. */
+  bool use;
+  /* Number of samples between two convergence tests, must be a power of two. */
+  int adaptive_step;
+  /* Samples every pixel receives before it may be considered converged. */
+  int min_samples;
+};
+
 class DeviceTask : public Task {
  public:
   typedef enum { RENDER, FILM_CONVERT, SHADER } Type;
@@ -110,6 +136,7 @@ class DeviceTask : public Task {
 
   bool need_finish_queue;
   bool integrator_branched;
+  AdaptiveSampling adaptive_sampling;
   int2 requested_tile_size;
 
  protected:
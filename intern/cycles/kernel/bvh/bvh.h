@@ -75,6 +75,40 @@ CCL_NAMESPACE_BEGIN
 #    include "kernel/bvh/bvh_traversal.h"
 #  endif
 
+/* Ray stream BVH traversal, for coherent rays on the CPU */
+
+#  if defined(__QBVH__) && defined(__KERNEL_AVX2__)
+#    define __BVH_STREAM__
+
+#    define BVH_FUNCTION_NAME bvh_intersect_stream
+#    define BVH_FUNCTION_FEATURES 0
+#    include "kernel/bvh/obvh_stream.h"
+
+#    if defined(__INSTANCING__)
+#      define BVH_FUNCTION_NAME bvh_intersect_stream_instancing
+#      define BVH_FUNCTION_FEATURES BVH_INSTANCING
+#      include "kernel/bvh/obvh_stream.h"
+#    endif
+
+#    if defined(__HAIR__)
+#      define BVH_FUNCTION_NAME bvh_intersect_stream_hair
+#      define BVH_FUNCTION_FEATURES BVH_INSTANCING | BVH_HAIR
+#      include "kernel/bvh/obvh_stream.h"
+#    endif
+
+#    if defined(__OBJECT_MOTION__)
+#      define BVH_FUNCTION_NAME bvh_intersect_stream_motion
+#      define BVH_FUNCTION_FEATURES BVH_INSTANCING | BVH_MOTION
+#      include "kernel/bvh/obvh_stream.h"
+#    endif
+
+#    if defined(__HAIR__) && defined(__OBJECT_MOTION__)
+#      define BVH_FUNCTION_NAME bvh_intersect_stream_hair_motion
+#      define BVH_FUNCTION_FEATURES BVH_INSTANCING | BVH_HAIR | BVH_MOTION
+#      include "kernel/bvh/obvh_stream.h"
+#    endif
+#  endif /* __QBVH__ && __KERNEL_AVX2__ */
+
 /* Subsurface scattering BVH traversal */
 
 #  if defined(__BVH_LOCAL__)
@@ -281,6 +315,104 @@ ccl_device_intersect bool scene_intersect(KernelGlobals *kg,
 #endif     /* __KERNEL_OPTIX__ */
 }
 
+#ifdef __BVH_STREAM__
+ccl_device_inline void scene_intersect_stream_obvh(KernelGlobals *kg,
+                                                   const Ray *rays,
+                                                   uint ray_mask,
+                                                   const uint visibility,
+                                                   Intersection *isects)
+{
+#  ifdef __OBJECT_MOTION__
+  if (kernel_data.bvh.have_motion) {
+#    ifdef __HAIR__
+    if (kernel_data.bvh.have_curves) {
+      OBVH_bvh_intersect_stream_hair_motion(kg, rays, isects, ray_mask, visibility);
+      return;
+    }
+#    endif /* __HAIR__ */
+
+    OBVH_bvh_intersect_stream_motion(kg, rays, isects, ray_mask, visibility);
+    return;
+  }
+#  endif /* __OBJECT_MOTION__ */
+
+#  ifdef __HAIR__
+  if (kernel_data.bvh.have_curves) {
+    OBVH_bvh_intersect_stream_hair(kg, rays, isects, ray_mask, visibility);
+    return;
+  }
+#  endif /* __HAIR__ */
+
+#  ifdef __INSTANCING__
+  if (kernel_data.bvh.have_instancing) {
+    OBVH_bvh_intersect_stream_instancing(kg, rays, isects, ray_mask, visibility);
+    return;
+  }
+#  endif /* __INSTANCING__ */
+
+  OBVH_bvh_intersect_stream(kg, rays, isects, ray_mask, visibility);
+}
+#endif /* __BVH_STREAM__ */
+
+#ifdef __KERNEL_CPU__
+/* Intersect a stream of up to BVH_STREAM_SIZE rays with the same visibility, for the rays in
+ * ray_mask. Coherent rays are traversed together if the BVH layout supports it, which is a lot
+ * faster than tracing them one at a time. Returns the mask of rays that hit something. */
+ccl_device_intersect uint scene_intersect_stream(KernelGlobals *kg,
+                                                 const Ray *rays,
+                                                 uint ray_mask,
+                                                 const uint visibility,
+                                                 Intersection *isects)
+{
+  bool use_stream = false;
+#  ifdef __BVH_STREAM__
+  use_stream = (kernel_data.bvh.bvh_layout == BVH_LAYOUT_BVH8);
+#    ifdef __EMBREE__
+  use_stream = use_stream && !kernel_data.bvh.scene;
+#    endif
+#  endif
+
+  uint stream_mask = 0;
+  uint hit_mask = 0;
+  for (int i = 0; i < BVH_STREAM_SIZE; i++) {
+    if (!(ray_mask & (1u << i))) {
+      continue;
+    }
+
+    if (!scene_intersect_valid(&rays[i])) {
+      isects[i].t = rays[i].t;
+      isects[i].prim = PRIM_NONE;
+      isects[i].object = OBJECT_NONE;
+    }
+    else if (use_stream) {
+      stream_mask |= (1u << i);
+    }
+    else if (scene_intersect(kg, &rays[i], visibility, &isects[i])) {
+      /* Trace rays one by one for other BVH layouts. */
+      hit_mask |= (1u << i);
+    }
+    else {
+      isects[i].prim = PRIM_NONE;
+    }
+  }
+
+#  ifdef __BVH_STREAM__
+  if (stream_mask != 0) {
+    PROFILING_INIT(kg, PROFILING_INTERSECT);
+    scene_intersect_stream_obvh(kg, rays, stream_mask, visibility, isects);
+
+    for (int i = 0; i < BVH_STREAM_SIZE; i++) {
+      if ((stream_mask & (1u << i)) && isects[i].prim != PRIM_NONE) {
+        hit_mask |= (1u << i);
+      }
+    }
+  }
+#  endif
+
+  return hit_mask;
+}
+#endif /* __KERNEL_CPU__ */
+
 #ifdef __BVH_LOCAL__
 ccl_device_intersect bool scene_intersect_local(KernelGlobals *kg,
                                                 const Ray *ray,
@@ -33,6 +33,8 @@ CCL_NAMESPACE_BEGIN
 #define BVH_STACK_SIZE 192
 #define BVH_QSTACK_SIZE 384
 #define BVH_OSTACK_SIZE 768
+/* Maximum number of rays traversed together as a stream, one bit in a mask each. */
+#define BVH_STREAM_SIZE 32
 /* BVH intersection function variations */
 
 #define BVH_INSTANCING 1
@@ -21,6 +21,23 @@ struct OBVHStackItem {
   float dist;
 };
 
+/* Ray of a stream traversed together with other rays, in the space of the object that is
+ * currently being traversed. */
+struct OBVHStreamRay {
+  float3 P;
+  float3 dir;
+  float3 idir;
+  int near_x, near_y, near_z;
+  int far_x, far_y, far_z;
+};
+
+/* Node to visit, along with the rays of the stream that still have to visit it. */
+struct OBVHStreamStackItem {
+  int addr;
+  uint ray_mask;
+  float dist;
+};
+
 ccl_device_inline void obvh_near_far_idx_calc(const float3 &idir,
                                               int *ccl_restrict near_x,
                                               int *ccl_restrict near_y,
@@ -78,6 +95,17 @@ ccl_device_inline void obvh_near_far_idx_calc(const float3 &idir,
 #endif
 }
 
+ccl_device_inline void obvh_stream_ray_update(OBVHStreamRay *sray)
+{
+  obvh_near_far_idx_calc(sray->idir,
+                         &sray->near_x,
+                         &sray->near_y,
+                         &sray->near_z,
+                         &sray->far_x,
+                         &sray->far_y,
+                         &sray->far_z);
+}
+
 ccl_device_inline void obvh_item_swap(OBVHStackItem *ccl_restrict a, OBVHStackItem *ccl_restrict b)
 {
   OBVHStackItem tmp = *a;
@@ -0,0 +1,356 @@
+/*
+ * Copyright 2011-2019 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* This is a template BVH traversal function for a stream of rays, where
+ * various features can be enabled/disabled. This way we can compile optimized
+ * versions for each case without new features slowing things down.
+ *
+ * BVH_INSTANCING: object instancing
+ * BVH_HAIR: hair curve rendering
+ * BVH_MOTION: motion blur rendering
+ *
+ * All rays of the stream traverse the tree together: every node is fetched
+ * once and tested against all the rays that reached it, each test still
+ * covering the eight children at once. Coherent rays like camera rays visit
+ * mostly the same nodes, so this saves a lot of memory traffic compared to
+ * tracing them one by one. */
+
+#if BVH_FEATURE(BVH_HAIR)
+#  define NODE_INTERSECT obvh_node_intersect
+#else
+#  define NODE_INTERSECT obvh_aligned_node_intersect
+#endif
+
+ccl_device void BVH_FUNCTION_FULL_NAME(OBVH)(KernelGlobals *kg,
+                                             const Ray *rays,
+                                             Intersection *isects,
+                                             uint ray_mask,
+                                             const uint visibility)
+{
+  /* Rays in the space of the current object. */
+  OBVHStreamRay stream[BVH_STREAM_SIZE];
+#if BVH_FEATURE(BVH_MOTION)
+  Transform ob_itfm[BVH_STREAM_SIZE];
+#endif
+
+  for (uint mask = ray_mask; mask != 0;) {
+    const uint i = __bscf(mask);
+    const Ray *ray = &rays[i];
+    Intersection *isect = &isects[i];
+
+    isect->t = ray->t;
+    isect->u = 0.0f;
+    isect->v = 0.0f;
+    isect->prim = PRIM_NONE;
+    isect->object = OBJECT_NONE;
+    BVH_DEBUG_INIT();
+
+    stream[i].P = ray->P;
+    stream[i].dir = bvh_clamp_direction(ray->D);
+    stream[i].idir = bvh_inverse_direction(stream[i].dir);
+    obvh_stream_ray_update(&stream[i]);
+  }
+
+  /* Rays that found an occluder and need no further traversal. */
+  uint terminated = 0;
+  int object = OBJECT_NONE;
+
+  OBVHStreamStackItem traversal_stack[BVH_OSTACK_SIZE];
+  int stack_ptr = 0;
+  traversal_stack[0].addr = kernel_data.bvh.root;
+  traversal_stack[0].ray_mask = ray_mask;
+  traversal_stack[0].dist = -FLT_MAX;
+
+  while (stack_ptr >= 0) {
+    const int node_addr = traversal_stack[stack_ptr].addr;
+    const uint stack_rays = traversal_stack[stack_ptr].ray_mask;
+    uint node_rays = stack_rays & ~terminated;
+    --stack_ptr;
+
+#if BVH_FEATURE(BVH_INSTANCING)
+    if (node_addr == ENTRYPOINT_SENTINEL) {
+      kernel_assert(object != OBJECT_NONE);
+
+      /* Instance pop, also for rays terminated inside the instance, so their distance is
+       * scaled back to world space. */
+      for (uint mask = stack_rays; mask != 0;) {
+        const uint i = __bscf(mask);
+        OBVHStreamRay *sray = &stream[i];
+#  if BVH_FEATURE(BVH_MOTION)
+        isects[i].t = bvh_instance_motion_pop(
+            kg, object, &rays[i], &sray->P, &sray->dir, &sray->idir, isects[i].t, &ob_itfm[i]);
+#  else
+        isects[i].t = bvh_instance_pop(
+            kg, object, &rays[i], &sray->P, &sray->dir, &sray->idir, isects[i].t);
+#  endif
+        obvh_stream_ray_update(sray);
+      }
+
+      object = OBJECT_NONE;
+      continue;
+    }
+#endif /* FEATURE(BVH_INSTANCING) */
+
+    if (node_rays == 0) {
+      continue;
+    }
+
+    if (node_addr >= 0) {
+      /* Traverse internal node, finding which rays hit each of the children. */
+      float4 inodes = kernel_tex_fetch(__bvh_nodes, node_addr + 0);
+      (void)inodes;
+
+#ifdef __VISIBILITY_FLAG__
+      if ((__float_as_uint(inodes.x) & visibility) == 0) {
+        continue;
+      }
+#endif
+
+      uint child_rays[8];
+      float child_dist[8];
+      for (int c = 0; c < 8; c++) {
+        child_rays[c] = 0;
+        child_dist[c] = FLT_MAX;
+      }
+      int hit_children = 0;
+
+      for (uint mask = node_rays; mask != 0;) {
+        const uint i = __bscf(mask);
+        const OBVHStreamRay *sray = &stream[i];
+        Intersection *isect = &isects[i];
+
+#if BVH_FEATURE(BVH_MOTION)
+        if (UNLIKELY(rays[i].time < inodes.y) || UNLIKELY(rays[i].time > inodes.z)) {
+          continue;
+        }
+#endif
+
+        BVH_DEBUG_NEXT_NODE();
+
+        const float3 P_idir = sray->P * sray->idir;
+        avxf dist;
+        int child_mask = NODE_INTERSECT(
+            kg,
+            avxf(0.0f),
+            avxf(isect->t),
+            avx3f(avxf(P_idir.x), avxf(P_idir.y), avxf(P_idir.z)),
+#if BVH_FEATURE(BVH_HAIR)
+            avx3f(avxf(sray->P.x), avxf(sray->P.y), avxf(sray->P.z)),
+            avx3f(avxf(sray->dir.x), avxf(sray->dir.y), avxf(sray->dir.z)),
+#endif
+            avx3f(avxf(sray->idir.x), avxf(sray->idir.y), avxf(sray->idir.z)),
+            sray->near_x,
+            sray->near_y,
+            sray->near_z,
+            sray->far_x,
+            sray->far_y,
+            sray->far_z,
+            node_addr,
+            &dist);
+
+        hit_children |= child_mask;
+        while (child_mask != 0) {
+          const int c = __bscf(child_mask);
+          child_rays[c] |= (1u << i);
+          child_dist[c] = min(child_dist[c], ((float *)&dist)[c]);
+        }
+      }
+
+      if (hit_children == 0) {
+        continue;
+      }
+
+      avxf cnodes;
+#if BVH_FEATURE(BVH_HAIR)
+      if (__float_as_uint(inodes.x) & PATH_RAY_NODE_UNALIGNED) {
+        cnodes = kernel_tex_fetch_avxf(__bvh_nodes, node_addr + 26);
+      }
+      else
+#endif
+      {
+        cnodes = kernel_tex_fetch_avxf(__bvh_nodes, node_addr + 14);
+      }
+
+      /* Sort the hit children from far to near by the distance of the closest ray, and push
+       * them in that order so the nearest child is visited first. */
+      OBVHStreamStackItem children[8];
+      int num_children = 0;
+      while (hit_children != 0) {
+        const int c = __bscf(hit_children);
+        OBVHStreamStackItem item;
+        item.addr = __float_as_int(cnodes[c]);
+        item.ray_mask = child_rays[c];
+        item.dist = child_dist[c];
+
+        int j = num_children++;
+        for (; j > 0 && children[j - 1].dist < item.dist; j--) {
+          children[j] = children[j - 1];
+        }
+        children[j] = item;
+      }
+
+      for (int j = 0; j < num_children; j++) {
+        ++stack_ptr;
+        kernel_assert(stack_ptr < BVH_OSTACK_SIZE);
+        traversal_stack[stack_ptr] = children[j];
+      }
+      continue;
+    }
+
+    /* If node is leaf, fetch triangle list. */
+    float4 leaf = kernel_tex_fetch(__bvh_leaf_nodes, (-node_addr - 1));
+
+#ifdef __VISIBILITY_FLAG__
+    if ((__float_as_uint(leaf.z) & visibility) == 0) {
+      continue;
+    }
+#endif
+
+    const int leaf_prim_addr = __float_as_int(leaf.x);
+
+#if BVH_FEATURE(BVH_INSTANCING)
+    if (leaf_prim_addr >= 0) {
+#endif
+      const int prim_addr2 = __float_as_int(leaf.y);
+      const uint type = __float_as_int(leaf.w);
+
+      /* Primitive intersection. */
+      for (uint mask = node_rays; mask != 0;) {
+        const uint i = __bscf(mask);
+        const OBVHStreamRay *sray = &stream[i];
+        Intersection *isect = &isects[i];
+        bool hit = false;
+
+        switch (type & PRIMITIVE_ALL) {
+          case PRIMITIVE_TRIANGLE: {
+            int prim_count = prim_addr2 - leaf_prim_addr;
+            if (prim_count < 3) {
+              for (int prim_addr = leaf_prim_addr; prim_addr < prim_addr2; prim_addr++) {
+                BVH_DEBUG_NEXT_INTERSECTION();
+                kernel_assert(kernel_tex_fetch(__prim_type, prim_addr) == type);
+                hit |= triangle_intersect(
+                    kg, isect, sray->P, sray->dir, visibility, object, prim_addr);
+              }
+            }
+            else {
+              kernel_assert(kernel_tex_fetch(__prim_type, leaf_prim_addr) == type);
+              hit = triangle_intersect8(kg,
+                                        &isect,
+                                        sray->P,
+                                        sray->dir,
+                                        visibility,
+                                        object,
+                                        leaf_prim_addr,
+                                        prim_count,
+                                        0,
+                                        0,
+                                        NULL,
+                                        0.0f);
+            }
+            break;
+          }
+#if BVH_FEATURE(BVH_MOTION)
+          case PRIMITIVE_MOTION_TRIANGLE: {
+            for (int prim_addr = leaf_prim_addr; prim_addr < prim_addr2; prim_addr++) {
+              BVH_DEBUG_NEXT_INTERSECTION();
+              kernel_assert(kernel_tex_fetch(__prim_type, prim_addr) == type);
+              hit |= motion_triangle_intersect(
+                  kg, isect, sray->P, sray->dir, rays[i].time, visibility, object, prim_addr);
+            }
+            break;
+          }
+#endif /* BVH_FEATURE(BVH_MOTION) */
+#if BVH_FEATURE(BVH_HAIR)
+          case PRIMITIVE_CURVE:
+          case PRIMITIVE_MOTION_CURVE: {
+            for (int prim_addr = leaf_prim_addr; prim_addr < prim_addr2; prim_addr++) {
+              BVH_DEBUG_NEXT_INTERSECTION();
+              const uint curve_type = kernel_tex_fetch(__prim_type, prim_addr);
+              kernel_assert((curve_type & PRIMITIVE_ALL) == (type & PRIMITIVE_ALL));
+              if (kernel_data.curve.curveflags & CURVE_KN_INTERPOLATE) {
+                hit |= cardinal_curve_intersect(kg,
+                                                isect,
+                                                sray->P,
+                                                sray->dir,
+                                                visibility,
+                                                object,
+                                                prim_addr,
+                                                rays[i].time,
+                                                curve_type);
+              }
+              else {
+                hit |= curve_intersect(kg,
+                                       isect,
+                                       sray->P,
+                                       sray->dir,
+                                       visibility,
+                                       object,
+                                       prim_addr,
+                                       rays[i].time,
+                                       curve_type);
+              }
+            }
+            break;
+          }
+#endif /* BVH_FEATURE(BVH_HAIR) */
+        }
+
+        /* Shadow ray early termination. */
+        if (hit && visibility == PATH_RAY_SHADOW_OPAQUE) {
+          terminated |= (1u << i);
+        }
+      }
+#if BVH_FEATURE(BVH_INSTANCING)
+    }
+    else {
+      /* Instance push, all rays that reached this leaf enter the object together. */
+      object = kernel_tex_fetch(__prim_object, -leaf_prim_addr - 1);
+
+      for (uint mask = node_rays; mask != 0;) {
+        const uint i = __bscf(mask);
+        OBVHStreamRay *sray = &stream[i];
+        Intersection *isect = &isects[i];
+#  if BVH_FEATURE(BVH_MOTION)
+        isect->t = bvh_instance_motion_push(
+            kg, object, &rays[i], &sray->P, &sray->dir, &sray->idir, isect->t, &ob_itfm[i]);
+#  else
+        isect->t = bvh_instance_push(
+            kg, object, &rays[i], &sray->P, &sray->dir, &sray->idir, isect->t);
+#  endif
+        obvh_stream_ray_update(sray);
+
+        BVH_DEBUG_NEXT_INSTANCE();
+      }
+
+      ++stack_ptr;
+      kernel_assert(stack_ptr < BVH_OSTACK_SIZE);
+      traversal_stack[stack_ptr].addr = ENTRYPOINT_SENTINEL;
+      traversal_stack[stack_ptr].ray_mask = node_rays;
+      traversal_stack[stack_ptr].dist = -FLT_MAX;
+
+      ++stack_ptr;
+      kernel_assert(stack_ptr < BVH_OSTACK_SIZE);
+      traversal_stack[stack_ptr].addr = kernel_tex_fetch(__object_node, object);
+      traversal_stack[stack_ptr].ray_mask = node_rays;
+      traversal_stack[stack_ptr].dist = -FLT_MAX;
+    }
+#endif /* FEATURE(BVH_INSTANCING) */
+  }
+}
+
+#undef NODE_INTERSECT
+#undef BVH_FUNCTION_NAME
+#undef BVH_FUNCTION_FEATURES
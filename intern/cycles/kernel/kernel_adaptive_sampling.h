@@ -0,0 +1,154 @@
+/*
+ * Copyright 2019 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+CCL_NAMESPACE_BEGIN
+
+/* Adaptive sampling
+ *
+ * The auxiliary buffer accumulates every second sample with double weight, so that comparing
+ * it against the combined pass gives a per-pixel estimate of the remaining noise. Its fourth
+ * component is non-zero once the pixel has converged, after which the path tracing kernels
+ * skip it. */
+
+ccl_device_inline bool kernel_adaptive_pixel_converged(KernelGlobals *kg,
+                                                       ccl_global float *buffer)
+{
+  if (!kernel_data.film.pass_adaptive_aux_buffer) {
+    return false;
+  }
+
+  return buffer[kernel_data.film.pass_adaptive_aux_buffer + 3] != 0.0f;
+}
+
+/* Count the sample about to be taken for this pixel. */
+ccl_device_inline void kernel_adaptive_count_sample(KernelGlobals *kg, ccl_global float *buffer)
+{
+  if (kernel_data.film.pass_sample_count) {
+    buffer[kernel_data.film.pass_sample_count] += 1.0f;
+  }
+}
+
+ccl_device_inline void kernel_write_adaptive_aux_buffer(KernelGlobals *kg,
+                                                        ccl_global float *buffer,
+                                                        int sample,
+                                                        float3 L_sum)
+{
+  if (kernel_data.film.pass_adaptive_aux_buffer && (sample & 1)) {
+    ccl_global float *aux = buffer + kernel_data.film.pass_adaptive_aux_buffer;
+    aux[0] += 2.0f * L_sum.x;
+    aux[1] += 2.0f * L_sum.y;
+    aux[2] += 2.0f * L_sum.z;
+  }
+}
+
+/* Mark the pixel as converged when the difference between the full and the half sample
+ * estimate, relative to the square root of its brightness, is below the noise threshold. */
+ccl_device void kernel_do_adaptive_stopping(KernelGlobals *kg, ccl_global float *buffer)
+{
+  ccl_global float *aux = buffer + kernel_data.film.pass_adaptive_aux_buffer;
+  float sample = buffer[kernel_data.film.pass_sample_count];
+  if (aux[3] != 0.0f || sample == 0.0f) {
+    return;
+  }
+
+  float inv_sample = 1.0f / sample;
+  float3 I = make_float3(buffer[0], buffer[1], buffer[2]) * inv_sample;
+  float3 A = make_float3(aux[0], aux[1], aux[2]) * inv_sample;
+
+  /* A small epsilon keeps black pixels from dividing by zero. */
+  float error = (fabsf(I.x - A.x) + fabsf(I.y - A.y) + fabsf(I.z - A.z)) /
+                (1e-4f + sqrtf(max(I.x + I.y + I.z, 0.0f)));
+
+  if (error < kernel_data.integrator.adaptive_threshold) {
+    aux[3] = 1.0f;
+  }
+}
+
+/* Dilate the set of unconverged pixels by one pixel along a row, so that converged pixels
+ * bordering noisy areas keep being sampled. Returns true if any pixel in the row has not
+ * converged yet. */
+ccl_device bool kernel_do_adaptive_filter_x(KernelGlobals *kg,
+                                            ccl_global float *tile_buffer,
+                                            int y,
+                                            int tile_x,
+                                            int tile_w,
+                                            int offset,
+                                            int stride)
+{
+  int pass_stride = kernel_data.film.pass_stride;
+  int aux_offset = kernel_data.film.pass_adaptive_aux_buffer + 3;
+  bool any = false;
+  bool prev = false;
+
+  for (int x = tile_x; x < tile_x + tile_w; x++) {
+    int index = offset + x + y * stride;
+    ccl_global float *converged = tile_buffer + index * pass_stride + aux_offset;
+
+    if (*converged == 0.0f) {
+      any = true;
+      if (x > tile_x && !prev) {
+        converged[-pass_stride] = 0.0f;
+      }
+      prev = true;
+    }
+    else {
+      if (prev) {
+        *converged = 0.0f;
+      }
+      prev = false;
+    }
+  }
+
+  return any;
+}
+
+/* Same as above, along a column. */
+ccl_device bool kernel_do_adaptive_filter_y(KernelGlobals *kg,
+                                            ccl_global float *tile_buffer,
+                                            int x,
+                                            int tile_y,
+                                            int tile_h,
+                                            int offset,
+                                            int stride)
+{
+  int pass_stride = kernel_data.film.pass_stride;
+  int aux_offset = kernel_data.film.pass_adaptive_aux_buffer + 3;
+  bool any = false;
+  bool prev = false;
+
+  for (int y = tile_y; y < tile_y + tile_h; y++) {
+    int index = offset + x + y * stride;
+    ccl_global float *converged = tile_buffer + index * pass_stride + aux_offset;
+
+    if (*converged == 0.0f) {
+      any = true;
+      if (y > tile_y && !prev) {
+        converged[-stride * pass_stride] = 0.0f;
+      }
+      prev = true;
+    }
+    else {
+      if (prev) {
+        *converged = 0.0f;
+      }
+      prev = false;
+    }
+  }
+
+  return any;
+}
+
+CCL_NAMESPACE_END
@@ -1102,6 +1102,187 @@ ccl_device int light_distribution_sample(KernelGlobals *kg, float *randu)
   return index;
 }
 
+/* Light Tree
+ *
+ * Lights and emissive triangles with a position are organized in a tree that is traversed
+ * towards the emitters that are likely to contribute most to the shading point, based on
+ * their energy, distance and orientation. Distant and background lights are stored after the
+ * local emitters in the distribution and are still picked from the flat distribution.
+ *
+ * The selection probabilities of the flat distribution are already folded into the light
+ * sampling and evaluation PDFs, so the tree only provides a correction factor for them. */
+
+ccl_device float light_tree_node_importance(KernelGlobals *kg, int node_index, float3 P)
+{
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes,
+                                                                  node_index);
+  const float energy = knode->bbox_min_energy.w;
+  if (energy == 0.0f) {
+    return 0.0f;
+  }
+
+  const float3 bbox_min = float4_to_float3(knode->bbox_min_energy);
+  const float3 bbox_max = float4_to_float3(knode->bbox_max_theta_o);
+  const float radius = 0.5f * len(bbox_max - bbox_min);
+
+  float distance;
+  const float3 point_to_node = normalize_len(P - 0.5f * (bbox_min + bbox_max), &distance);
+
+  /* Inside the bounding sphere any orientation can face the shading point, clamp the distance
+   * to avoid the singularity. */
+  if (distance <= radius) {
+    return energy / max(radius * radius, 1e-8f);
+  }
+
+  const float theta_o = knode->bbox_max_theta_o.w;
+  const float theta_e = knode->axis_theta_e.w;
+  const float3 axis = float4_to_float3(knode->axis_theta_e);
+
+  const float theta = fast_acosf(clamp(dot(axis, point_to_node), -1.0f, 1.0f));
+  const float theta_u = fast_asinf(radius / distance);
+  const float theta_prime = max(theta - theta_o - theta_u, 0.0f);
+  if (theta_prime > theta_e) {
+    return 0.0f;
+  }
+
+  return energy * fast_cosf(theta_prime) / (distance * distance);
+}
+
+/* Probability of descending into the left child of an inner node. */
+ccl_device float light_tree_probability_left(KernelGlobals *kg,
+                                             int node_index,
+                                             int right_child,
+                                             float3 P)
+{
+  float importance_left = light_tree_node_importance(kg, node_index + 1, P);
+  float importance_right = light_tree_node_importance(kg, right_child, P);
+
+  if (importance_left + importance_right == 0.0f) {
+    /* Keep every emitter reachable, otherwise sampling and evaluation would disagree. */
+    importance_left = kernel_tex_fetch(__light_tree_nodes, node_index + 1).bbox_min_energy.w;
+    importance_right = kernel_tex_fetch(__light_tree_nodes, right_child).bbox_min_energy.w;
+  }
+
+  return importance_left / (importance_left + importance_right);
+}
+
+/* Pick an emitter for shading point P, returning its index in the light distribution along
+ * with the factor to convert the flat distribution PDF to the light tree PDF. */
+ccl_device int light_tree_sample(KernelGlobals *kg, float3 P, float *randu, float *pdf_factor)
+{
+  const int num_local = kernel_data.integrator.light_tree_num_local;
+  const float local_cdf = kernel_tex_fetch(__light_distribution, num_local).totarea;
+  float r = *randu;
+
+  if (r >= local_cdf) {
+    *pdf_factor = 1.0f;
+    return light_distribution_sample(kg, randu);
+  }
+
+  r /= local_cdf;
+  float pdf = local_cdf;
+  int node_index = 0;
+
+  while (true) {
+    const int right_child = kernel_tex_fetch(__light_tree_nodes, node_index).right_child;
+    if (right_child == -1) {
+      break;
+    }
+
+    const float probability_left = light_tree_probability_left(kg, node_index, right_child, P);
+    if (r < probability_left || probability_left == 1.0f) {
+      r /= probability_left;
+      pdf *= probability_left;
+      node_index = node_index + 1;
+    }
+    else {
+      r = (r - probability_left) / (1.0f - probability_left);
+      pdf *= 1.0f - probability_left;
+      node_index = right_child;
+    }
+  }
+
+  /* Emitters within a leaf are picked proportional to their weight in the flat
+   * distribution. */
+  const ccl_global KernelLightTreeNode *kleaf = &kernel_tex_fetch(__light_tree_nodes,
+                                                                  node_index);
+  const int first = kleaf->first_emitter;
+  const int last = first + kleaf->num_emitters - 1;
+  const float leaf_min = kernel_tex_fetch(__light_distribution, first).totarea;
+  const float leaf_max = kernel_tex_fetch(__light_distribution, last + 1).totarea;
+  const float target = leaf_min + r * (leaf_max - leaf_min);
+
+  int index = first;
+  while (index < last && target >= kernel_tex_fetch(__light_distribution, index + 1).totarea) {
+    index++;
+  }
+
+  const float distr_min = kernel_tex_fetch(__light_distribution, index).totarea;
+  const float distr_max = kernel_tex_fetch(__light_distribution, index + 1).totarea;
+  *randu = saturate((target - distr_min) / (distr_max - distr_min));
+  *pdf_factor = pdf / (leaf_max - leaf_min);
+
+  return index;
+}
+
+/* Correction factor for the PDF of an emitter hit from shading point P. */
+ccl_device float light_tree_pdf_factor(KernelGlobals *kg, float3 P, int index)
+{
+  const int num_local = kernel_data.integrator.light_tree_num_local;
+  if (index >= num_local) {
+    return 1.0f;
+  }
+
+  float pdf = kernel_tex_fetch(__light_distribution, num_local).totarea;
+  int node_index = 0;
+
+  while (true) {
+    const int right_child = kernel_tex_fetch(__light_tree_nodes, node_index).right_child;
+    if (right_child == -1) {
+      break;
+    }
+
+    const float probability_left = light_tree_probability_left(kg, node_index, right_child, P);
+    if (index < kernel_tex_fetch(__light_tree_nodes, right_child).first_emitter) {
+      pdf *= probability_left;
+      node_index = node_index + 1;
+    }
+    else {
+      pdf *= 1.0f - probability_left;
+      node_index = right_child;
+    }
+  }
+
+  const ccl_global KernelLightTreeNode *kleaf = &kernel_tex_fetch(__light_tree_nodes,
+                                                                  node_index);
+  const int first = kleaf->first_emitter;
+  const float leaf_min = kernel_tex_fetch(__light_distribution, first).totarea;
+  const float leaf_max =
+      kernel_tex_fetch(__light_distribution, first + kleaf->num_emitters).totarea;
+  if (leaf_max <= leaf_min) {
+    return 1.0f;
+  }
+
+  return pdf / (leaf_max - leaf_min);
+}
+
+ccl_device_inline float light_tree_triangle_pdf_factor(KernelGlobals *kg, float3 P, int prim)
+{
+  if (!kernel_data.integrator.use_light_tree) {
+    return 1.0f;
+  }
+  return light_tree_pdf_factor(kg, P, kernel_tex_fetch(__light_tree_index, prim));
+}
+
+ccl_device_inline float light_tree_lamp_pdf_factor(KernelGlobals *kg, float3 P, int lamp)
+{
+  if (!kernel_data.integrator.use_light_tree) {
+    return 1.0f;
+  }
+  const int offset = kernel_data.integrator.light_tree_lamp_offset;
+  return light_tree_pdf_factor(kg, P, kernel_tex_fetch(__light_tree_index, offset + lamp));
+}
+
 /* Generic Light */
 
 ccl_device_inline bool light_select_reached_max_bounces(KernelGlobals *kg, int index, int bounce)
@@ -1118,9 +1299,13 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
                                       int bounce,
                                       LightSample *ls)
 {
+  float pdf_factor = 1.0f;
+
   if (lamp < 0) {
     /* sample index */
-    int index = light_distribution_sample(kg, &randu);
+    int index = (kernel_data.integrator.use_light_tree) ?
+                    light_tree_sample(kg, P, &randu, &pdf_factor) :
+                    light_distribution_sample(kg, &randu);
 
     /* fetch light data */
     const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(
@@ -1133,6 +1318,7 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
 
       triangle_light_sample(kg, prim, object, randu, randv, time, ls, P);
       ls->shader |= shader_flag;
+      ls->pdf *= pdf_factor;
       return (ls->pdf > 0.0f);
     }
 
@@ -1143,7 +1329,12 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
     return false;
   }
 
-  return lamp_light_sample(kg, lamp, randu, randv, P, ls);
+  if (!lamp_light_sample(kg, lamp, randu, randv, P, ls)) {
+    return false;
+  }
+
+  ls->pdf *= pdf_factor;
+  return true;
 }
 
 ccl_device_inline int light_select_num_samples(KernelGlobals *kg, int index)
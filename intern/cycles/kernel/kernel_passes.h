@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "kernel/kernel_adaptive_sampling.h"
 #include "kernel/kernel_id_passes.h"
 
 CCL_NAMESPACE_BEGIN
@@ -337,6 +338,8 @@ ccl_device_inline void kernel_write_result(KernelGlobals *kg,
     kernel_write_pass_float4(buffer, make_float4(L_sum.x, L_sum.y, L_sum.z, alpha));
   }
 
+  kernel_write_adaptive_aux_buffer(kg, buffer, sample, L_sum);
+
   kernel_write_light_passes(kg, buffer, L);
 
 #ifdef __DENOISING_FEATURES__
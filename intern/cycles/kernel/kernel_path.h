@@ -517,7 +517,8 @@ ccl_device_forceinline void kernel_path_integrate(KernelGlobals *kg,
                                                   Ray *ray,
                                                   PathRadiance *L,
                                                   ccl_global float *buffer,
-                                                  ShaderData *emission_sd)
+                                                  ShaderData *emission_sd,
+                                                  const Intersection *first_isect)
 {
   PROFILING_INIT(kg, PROFILING_PATH_INTEGRATE);
 
@@ -533,9 +534,24 @@ ccl_device_forceinline void kernel_path_integrate(KernelGlobals *kg,
 
     /* path iteration */
     for (;;) {
-      /* Find intersection with objects in scene. */
+      /* Find intersection with objects in scene, unless it was already found together with
+       * other camera rays. */
       Intersection isect;
-      bool hit = kernel_path_scene_intersect(kg, state, ray, &isect, L);
+      bool hit;
+      if (first_isect != NULL) {
+        isect = *first_isect;
+        hit = (isect.prim != PRIM_NONE);
+        first_isect = NULL;
+#  ifdef __KERNEL_DEBUG__
+        L->debug_data.num_bvh_traversed_nodes += isect.num_traversed_nodes;
+        L->debug_data.num_bvh_traversed_instances += isect.num_traversed_instances;
+        L->debug_data.num_bvh_intersections += isect.num_intersections;
+        L->debug_data.num_ray_bounces++;
+#  endif /* __KERNEL_DEBUG__ */
+      }
+      else {
+        hit = kernel_path_scene_intersect(kg, state, ray, &isect, L);
+      }
 
       /* Find intersection with lamps and compute emission for MIS. */
       kernel_path_lamp_emission(kg, state, ray, throughput, &isect, &sd, L);
@@ -656,6 +672,11 @@ ccl_device void kernel_path_trace(
 
   buffer += index * pass_stride;
 
+  if (kernel_adaptive_pixel_converged(kg, buffer)) {
+    return;
+  }
+  kernel_adaptive_count_sample(kg, buffer);
+
   /* Initialize random numbers and sample ray. */
   uint rng_hash;
   Ray ray;
@@ -688,11 +709,88 @@ ccl_device void kernel_path_trace(
 #  endif
 
   /* Integrate. */
-  kernel_path_integrate(kg, &state, throughput, &ray, &L, buffer, emission_sd);
+  kernel_path_integrate(kg, &state, throughput, &ray, &L, buffer, emission_sd, NULL);
 
   kernel_write_result(kg, buffer, sample, &L);
 }
 
+#  ifdef __KERNEL_CPU__
+/* Path trace a row of up to BVH_STREAM_SIZE pixels, tracing their camera rays together as a
+ * stream since they are coherent. */
+ccl_device void kernel_path_trace_stream(KernelGlobals *kg,
+                                         ccl_global float *buffer,
+                                         int sample,
+                                         int x,
+                                         int y,
+                                         int num_pixels,
+                                         int offset,
+                                         int stride)
+{
+  PROFILING_INIT(kg, PROFILING_RAY_SETUP);
+
+  kernel_assert(num_pixels <= BVH_STREAM_SIZE);
+
+  int pass_stride = kernel_data.film.pass_stride;
+
+  ShaderDataTinyStorage emission_sd_storage;
+  ShaderData *emission_sd = AS_SHADER_DATA(&emission_sd_storage);
+
+  /* Initialize random numbers, camera rays and state of all pixels. */
+  Ray rays[BVH_STREAM_SIZE];
+  PathState states[BVH_STREAM_SIZE];
+  Intersection isects[BVH_STREAM_SIZE];
+  uint pixel_mask = 0;
+  uint stream_mask = 0;
+
+  for (int i = 0; i < num_pixels; i++) {
+    int index = offset + x + i + y * stride;
+    ccl_global float *pixel_buffer = buffer + index * pass_stride;
+
+    if (kernel_adaptive_pixel_converged(kg, pixel_buffer)) {
+      continue;
+    }
+    kernel_adaptive_count_sample(kg, pixel_buffer);
+
+    uint rng_hash;
+    kernel_path_trace_setup(kg, sample, x + i, y, &rng_hash, &rays[i]);
+
+    if (rays[i].t == 0.0f) {
+      continue;
+    }
+
+    path_state_init(kg, emission_sd, &states[i], rng_hash, sample, &rays[i]);
+    pixel_mask |= (1u << i);
+
+    if (path_state_ray_visibility(kg, &states[i]) == PATH_RAY_CAMERA) {
+      stream_mask |= (1u << i);
+    }
+  }
+
+  scene_intersect_stream(kg, rays, stream_mask, PATH_RAY_CAMERA, isects);
+
+  /* Integrate. */
+  for (int i = 0; i < num_pixels; i++) {
+    if (!(pixel_mask & (1u << i))) {
+      continue;
+    }
+
+    int index = offset + x + i + y * stride;
+    ccl_global float *pixel_buffer = buffer + index * pass_stride;
+
+    float3 throughput = make_float3(1.0f, 1.0f, 1.0f);
+
+    PathRadiance L;
+    path_radiance_init(kg, &L);
+
+    const Intersection *first_isect = (stream_mask & (1u << i)) ? &isects[i] : NULL;
+    kernel_path_integrate(
+        kg, &states[i], throughput, &rays[i], &L, pixel_buffer, emission_sd, first_isect);
+
+    kernel_write_result(kg, pixel_buffer, sample, &L);
+  }
+}
+#  endif /* __KERNEL_CPU__ */
+
 #endif /* __SPLIT_KERNEL__ */
 
 CCL_NAMESPACE_END
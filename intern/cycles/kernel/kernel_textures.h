@@ -65,6 +65,8 @@ KERNEL_TEX(KernelLightDistribution, __light_distribution)
 KERNEL_TEX(KernelLight, __lights)
 KERNEL_TEX(float2, __light_background_marginal_cdf)
 KERNEL_TEX(float2, __light_background_conditional_cdf)
+KERNEL_TEX(KernelLightTreeNode, __light_tree_nodes)
+KERNEL_TEX(uint, __light_tree_index)
 
 /* particles */
 KERNEL_TEX(KernelParticle, __particles)
@@ -375,6 +375,8 @@ typedef enum PassType {
   PASS_CRYPTOMATTE,
   PASS_AOV_COLOR,
   PASS_AOV_VALUE,
+  PASS_ADAPTIVE_AUX_BUFFER,
+  PASS_SAMPLE_COUNT,
   PASS_CATEGORY_MAIN_END = 31,
 
   PASS_MIST = 32,
@@ -1250,8 +1252,8 @@ typedef struct KernelFilm {
 
   int pass_aov_color;
   int pass_aov_value;
-  int pad1;
-  int pad2;
+  int pass_adaptive_aux_buffer;
+  int pass_sample_count;
 
   /* XYZ to rendering color space transform. float4 instead of float3 to
    * ensure consistent padding/alignment across devices. */
@@ -1355,6 +1357,15 @@ typedef struct KernelIntegrator {
   int sampling_pattern;
   int aa_samples;
 
+  /* adaptive sampling */
+  float adaptive_threshold;
+
+  /* light tree */
+  int use_light_tree;
+  int light_tree_num_local;
+  int light_tree_lamp_offset;
+  int pad1;
+
   /* volume render */
   int use_volumes;
   int volume_max_steps;
@@ -1364,8 +1375,6 @@ typedef struct KernelIntegrator {
   int start_sample;
 
   int max_closures;
-
-  int pad1;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
 
@@ -1534,6 +1543,23 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+/* Node of the light tree, stored depth first so the left child directly follows its parent.
+ * Every node covers a contiguous range of the light distribution. */
+typedef struct KernelLightTreeNode {
+  /* xyz: bounding box minimum, w: energy of all emitters below this node. */
+  float4 bbox_min_energy;
+  /* xyz: bounding box maximum, w: angle bounding the emitter normals around the axis. */
+  float4 bbox_max_theta_o;
+  /* xyz: orientation axis, w: angle over which emission falls off around each normal. */
+  float4 axis_theta_e;
+  int first_emitter;
+  int num_emitters;
+  /* Index of the right child, -1 for leaf nodes. */
+  int right_child;
+  int pad;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
@@ -19,6 +19,15 @@
 void KERNEL_FUNCTION_FULL_NAME(path_trace)(
     KernelGlobals *kg, float *buffer, int sample, int x, int y, int offset, int stride);
 
+void KERNEL_FUNCTION_FULL_NAME(path_trace_stream)(KernelGlobals *kg,
+                                                  float *buffer,
+                                                  int sample,
+                                                  int x,
+                                                  int y,
+                                                  int num_pixels,
+                                                  int offset,
+                                                  int stride);
+
 void KERNEL_FUNCTION_FULL_NAME(convert_to_byte)(KernelGlobals *kg,
                                                 uchar4 *rgba,
                                                 float *buffer,
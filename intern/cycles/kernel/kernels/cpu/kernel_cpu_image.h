@@ -470,6 +470,142 @@ template<typename T> struct TextureInterpolator {
 #undef SET_CUBIC_SPLINE_WEIGHTS
 };
 
+/* Sparse volumes, interpolated one voxel at a time since neighbors may be in different tiles.
+ * See util_texture.h for the memory layout. */
+template<typename T> struct SparseTextureInterpolator {
+  typedef TextureInterpolator<T> Dense;
+
+  static ccl_always_inline float4 read(const TextureInfo &info, int x, int y, int z)
+  {
+    const uint *tile_index = (const uint *)info.data;
+    const int tiles_x = tex_sparse_num_tiles(info.width);
+    const int tiles_y = tex_sparse_num_tiles(info.height);
+    const int tiles_z = tex_sparse_num_tiles(info.depth);
+    const T *tiles = (const T *)((const float *)info.data +
+                                 tex_sparse_header_size(tiles_x * tiles_y * tiles_z));
+
+    const uint tile = tile_index[(x >> TEX_SPARSE_TILE_SHIFT) +
+                                 tiles_x * ((y >> TEX_SPARSE_TILE_SHIFT) +
+                                            tiles_y * (z >> TEX_SPARSE_TILE_SHIFT))];
+    const int voxel = (x & TEX_SPARSE_TILE_MASK) +
+                      TEX_SPARSE_TILE_SIZE * ((y & TEX_SPARSE_TILE_MASK) +
+                                              TEX_SPARSE_TILE_SIZE * (z & TEX_SPARSE_TILE_MASK));
+
+    /* Large volumes have more voxels in their tiles than fit in an int. */
+    return Dense::read(tiles[(size_t)tile * TEX_SPARSE_TILE_VOXELS + voxel]);
+  }
+
+  static ccl_always_inline int wrap(int x, int size, uint extension)
+  {
+    return (extension == EXTENSION_REPEAT) ? Dense::wrap_periodic(x, size) :
+                                             Dense::wrap_clamp(x, size);
+  }
+
+  static ccl_always_inline void cubic_weights(float t, float w[4])
+  {
+    w[0] = (((-1.0f / 6.0f) * t + 0.5f) * t - 0.5f) * t + (1.0f / 6.0f);
+    w[1] = ((0.5f * t - 1.0f) * t) * t + (2.0f / 3.0f);
+    w[2] = ((-0.5f * t + 0.5f) * t + 0.5f) * t + (1.0f / 6.0f);
+    w[3] = (1.0f / 6.0f) * t * t * t;
+  }
+
+  static ccl_always_inline float4
+  interp_3d(const TextureInfo &info, float x, float y, float z, InterpolationType interp)
+  {
+    if (UNLIKELY(!info.data))
+      return make_float4(0.0f, 0.0f, 0.0f, 0.0f);
+
+    if (info.extension == EXTENSION_CLIP) {
+      if (x < 0.0f || y < 0.0f || z < 0.0f || x > 1.0f || y > 1.0f || z > 1.0f) {
+        return make_float4(0.0f, 0.0f, 0.0f, 0.0f);
+      }
+    }
+
+    const int width = info.width;
+    const int height = info.height;
+    const int depth = info.depth;
+    const uint extension = info.extension;
+    int ix, iy, iz;
+
+    switch ((interp == INTERPOLATION_NONE) ? info.interpolation : interp) {
+      case INTERPOLATION_CLOSEST: {
+        Dense::frac(x * (float)width, &ix);
+        Dense::frac(y * (float)height, &iy);
+        Dense::frac(z * (float)depth, &iz);
+        ix = wrap(ix, width, extension);
+        iy = wrap(iy, height, extension);
+        iz = wrap(iz, depth, extension);
+        return read(info, ix, iy, iz);
+      }
+      case INTERPOLATION_LINEAR: {
+        const float tx = Dense::frac(x * (float)width - 0.5f, &ix);
+        const float ty = Dense::frac(y * (float)height - 0.5f, &iy);
+        const float tz = Dense::frac(z * (float)depth - 0.5f, &iz);
+        const int xc[2] = {wrap(ix, width, extension), wrap(ix + 1, width, extension)};
+        const int yc[2] = {wrap(iy, height, extension), wrap(iy + 1, height, extension)};
+        const int zc[2] = {wrap(iz, depth, extension), wrap(iz + 1, depth, extension)};
+        const float u[2] = {1.0f - tx, tx};
+        const float v[2] = {1.0f - ty, ty};
+        const float w[2] = {1.0f - tz, tz};
+
+        float4 r = make_float4(0.0f, 0.0f, 0.0f, 0.0f);
+        for (int k = 0; k < 2; k++) {
+          for (int j = 0; j < 2; j++) {
+            for (int i = 0; i < 2; i++) {
+              r += (w[k] * v[j] * u[i]) * read(info, xc[i], yc[j], zc[k]);
+            }
+          }
+        }
+        return r;
+      }
+      default: {
+        /* Tricubic b-spline interpolation. */
+        const float tx = Dense::frac(x * (float)width - 0.5f, &ix);
+        const float ty = Dense::frac(y * (float)height - 0.5f, &iy);
+        const float tz = Dense::frac(z * (float)depth - 0.5f, &iz);
+        int xc[4], yc[4], zc[4];
+        for (int i = 0; i < 4; i++) {
+          xc[i] = wrap(ix + i - 1, width, extension);
+          yc[i] = wrap(iy + i - 1, height, extension);
+          zc[i] = wrap(iz + i - 1, depth, extension);
+        }
+        float u[4], v[4], w[4];
+        cubic_weights(tx, u);
+        cubic_weights(ty, v);
+        cubic_weights(tz, w);
+
+        float4 r = make_float4(0.0f, 0.0f, 0.0f, 0.0f);
+        for (int k = 0; k < 4; k++) {
+          for (int j = 0; j < 4; j++) {
+            for (int i = 0; i < 4; i++) {
+              r += (w[k] * v[j] * u[i]) * read(info, xc[i], yc[j], zc[k]);
+            }
+          }
+        }
+        return r;
+      }
+    }
+  }
+};
+
+/* Lookup in the texture cache, where the derivatives of the texture coordinates select the
+ * mipmap level and filter footprint. */
+ccl_device float4 kernel_tex_image_interp_cache(
+    KernelGlobals *kg, int id, float x, float y, float2 dx, float2 dy)
+{
+  const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
+  const TextureCacheHandle *handle = (const TextureCacheHandle *)info.data;
+
+  float4 r;
+  if (UNLIKELY(!handle || !handle->texture_handle) ||
+      !handle->lookup(handle, info, x, y, dx.x, dx.y, dy.x, dy.y, &r.x)) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  return r;
+}
+
 ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, float y)
 {
   const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
@@ -491,6 +627,9 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, fl
       return TextureInterpolator<ushort4>::interp(info, x, y);
     case IMAGE_DATA_TYPE_FLOAT4:
       return TextureInterpolator<float4>::interp(info, x, y);
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      return kernel_tex_image_interp_cache(
+          kg, id, x, y, make_float2(0.0f, 0.0f), make_float2(0.0f, 0.0f));
     default:
       assert(0);
       return make_float4(
@@ -520,6 +659,10 @@ ccl_device float4 kernel_tex_image_interp_3d(
       return TextureInterpolator<ushort4>::interp_3d(info, x, y, z, interp);
     case IMAGE_DATA_TYPE_FLOAT4:
       return TextureInterpolator<float4>::interp_3d(info, x, y, z, interp);
+    case IMAGE_DATA_TYPE_FLOAT_SPARSE:
+      return SparseTextureInterpolator<float>::interp_3d(info, x, y, z, interp);
+    case IMAGE_DATA_TYPE_FLOAT4_SPARSE:
+      return SparseTextureInterpolator<float4>::interp_3d(info, x, y, z, interp);
     default:
       assert(0);
       return make_float4(
@@ -92,6 +92,22 @@ void KERNEL_FUNCTION_FULL_NAME(path_trace)(
 #  endif /* KERNEL_STUB */
 }
 
+void KERNEL_FUNCTION_FULL_NAME(path_trace_stream)(KernelGlobals *kg,
+                                                  float *buffer,
+                                                  int sample,
+                                                  int x,
+                                                  int y,
+                                                  int num_pixels,
+                                                  int offset,
+                                                  int stride)
+{
+#  ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, path_trace_stream);
+#  else
+  kernel_path_trace_stream(kg, buffer, sample, x, y, num_pixels, offset, stride);
+#  endif /* KERNEL_STUB */
+}
+
 /* Film */
 
 void KERNEL_FUNCTION_FULL_NAME(convert_to_byte)(KernelGlobals *kg,
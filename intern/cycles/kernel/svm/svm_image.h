@@ -18,14 +18,22 @@ CCL_NAMESPACE_BEGIN
 
 #ifdef __TEXTURES__
 
-ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y, uint flags)
+ccl_device float4 svm_image_texture(
+    KernelGlobals *kg, int id, float x, float y, float2 dx, float2 dy, uint flags)
 {
   if (id == -1) {
     return make_float4(
         TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
   }
 
+#ifdef __KERNEL_CPU__
+  /* Only the texture cache filters using the derivatives. */
+  float4 r = (kernel_tex_type(id) == IMAGE_DATA_TYPE_TEXTURE_CACHE) ?
+                 kernel_tex_image_interp_cache(kg, id, x, y, dx, dy) :
+                 kernel_tex_image_interp(kg, id, x, y);
+#else
   float4 r = kernel_tex_image_interp(kg, id, x, y);
+#endif
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -50,6 +58,32 @@ ccl_device_inline float3 texco_remap_square(float3 co)
   return (co - make_float3(0.5f, 0.5f, 0.5f)) * 2.0f;
 }
 
+ccl_device_inline float2 svm_image_project(float3 co, uint projection)
+{
+  if (projection == NODE_IMAGE_PROJ_SPHERE) {
+    return map_to_sphere(texco_remap_square(co));
+  }
+  else if (projection == NODE_IMAGE_PROJ_TUBE) {
+    return map_to_tube(texco_remap_square(co));
+  }
+  else {
+    return make_float2(co.x, co.y);
+  }
+}
+
+/* Difference between projected texture coordinates, ignoring the seam of spherical and
+ * tubular projections. */
+ccl_device_inline float2 svm_image_project_differential(float2 tex_co,
+                                                        float3 co_offset,
+                                                        uint projection)
+{
+  float2 d = svm_image_project(co_offset, projection) - tex_co;
+  if (projection == NODE_IMAGE_PROJ_SPHERE || projection == NODE_IMAGE_PROJ_TUBE) {
+    d.x -= floorf(d.x + 0.5f);
+  }
+  return d;
+}
+
 ccl_device void svm_node_tex_image(
     KernelGlobals *kg, ShaderData *sd, float *stack, uint4 node, int *offset)
 {
@@ -58,17 +92,17 @@ ccl_device void svm_node_tex_image(
   svm_unpack_node_uchar4(node.z, &co_offset, &out_offset, &alpha_offset, &flags);
 
   float3 co = stack_load_float3(stack, co_offset);
-  float2 tex_co;
-  if (node.w == NODE_IMAGE_PROJ_SPHERE) {
-    co = texco_remap_square(co);
-    tex_co = map_to_sphere(co);
-  }
-  else if (node.w == NODE_IMAGE_PROJ_TUBE) {
-    co = texco_remap_square(co);
-    tex_co = map_to_tube(co);
-  }
-  else {
-    tex_co = make_float2(co.x, co.y);
+  float2 tex_co = svm_image_project(co, node.w);
+
+  /* Texture coordinates of neighboring pixels, from ray differentials. */
+  float2 tex_dx = make_float2(0.0f, 0.0f);
+  float2 tex_dy = make_float2(0.0f, 0.0f);
+  if (flags & NODE_IMAGE_USE_DIFFERENTIALS) {
+    uint4 differential_node = read_node(kg, offset);
+    tex_dx = svm_image_project_differential(
+        tex_co, stack_load_float3(stack, differential_node.x), node.w);
+    tex_dy = svm_image_project_differential(
+        tex_co, stack_load_float3(stack, differential_node.y), node.w);
   }
 
   /* TODO(lukas): Consider moving tile information out of the SVM node.
@@ -114,7 +148,7 @@ ccl_device void svm_node_tex_image(
     id = -num_nodes;
   }
 
-  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, tex_dx, tex_dy, flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -204,15 +238,18 @@ ccl_device void svm_node_tex_image_box(KernelGlobals *kg, ShaderData *sd, float
   /* Map so that no textures are flipped, rotation is somewhat arbitrary. */
   if (weight.x > 0.0f) {
     float2 uv = make_float2((signed_N.x < 0.0f) ? 1.0f - co.y : co.y, co.z);
-    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.x * svm_image_texture(
+        kg, id, uv.x, uv.y, make_float2(0.0f, 0.0f), make_float2(0.0f, 0.0f), flags);
   }
   if (weight.y > 0.0f) {
     float2 uv = make_float2((signed_N.y > 0.0f) ? 1.0f - co.x : co.x, co.z);
-    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.y * svm_image_texture(
+        kg, id, uv.x, uv.y, make_float2(0.0f, 0.0f), make_float2(0.0f, 0.0f), flags);
   }
   if (weight.z > 0.0f) {
     float2 uv = make_float2((signed_N.z > 0.0f) ? 1.0f - co.y : co.y, co.x);
-    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.z * svm_image_texture(
+        kg, id, uv.x, uv.y, make_float2(0.0f, 0.0f), make_float2(0.0f, 0.0f), flags);
   }
 
   if (stack_valid(out_offset))
@@ -242,7 +279,8 @@ ccl_device void svm_node_tex_environment(KernelGlobals *kg,
   else
     uv = direction_to_mirrorball(co);
 
-  float4 f = svm_image_texture(kg, id, uv.x, uv.y, flags);
+  float4 f = svm_image_texture(
+      kg, id, uv.x, uv.y, make_float2(0.0f, 0.0f), make_float2(0.0f, 0.0f), flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -446,6 +446,7 @@ typedef enum NodeImageProjection {
 typedef enum NodeImageFlags {
   NODE_IMAGE_COMPRESS_AS_SRGB = 1,
   NODE_IMAGE_ALPHA_UNASSOCIATE = 2,
+  NODE_IMAGE_USE_DIFFERENTIALS = 4,
 } NodeImageFlags;
 
 typedef enum NodeEnvironmentProjection {
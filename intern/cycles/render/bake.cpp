@@ -24,6 +24,9 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Minimum number of pixels per CPU thread in a batch. */
+static const size_t BAKE_CPU_PIXELS_PER_THREAD = 4096;
+
 BakeData::BakeData(const int object, const size_t tri_offset, const size_t num_pixels)
     : m_object(object), m_tri_offset(tri_offset), m_num_pixels(num_pixels)
 {
@@ -117,6 +120,11 @@ void BakeManager::set_baking(const bool value)
 
 BakeData *BakeManager::init(const int object, const size_t tri_offset, const size_t num_pixels)
 {
+  /* Replace the data of the previous bake, the scene is reused for a batch of bakes. */
+  if (m_bake_data) {
+    delete m_bake_data;
+  }
+
   m_bake_data = new BakeData(object, tri_offset, num_pixels);
   return m_bake_data;
 }
@@ -136,44 +144,64 @@ bool BakeManager::bake(Device *device,
                        BakeData *bake_data,
                        float result[])
 {
-  size_t num_pixels = bake_data->size();
+  if (bake_data->size() == 0) {
+    m_is_baking = false;
+    return false;
+  }
+
+  /* Only shade pixels of this object. With selected to active, every object only covers part
+   * of the pixels and the others are baked by separate calls. */
+  vector<size_t> pixels;
+  for (size_t i = 0; i < bake_data->size(); i++) {
+    if (bake_data->is_valid(i)) {
+      pixels.push_back(i);
+    }
+  }
+
+  size_t num_pixels = pixels.size();
 
   int num_samples = aa_samples(scene, bake_data, shader_type);
 
   /* calculate the total pixel samples for the progress bar */
-  total_pixel_samples = 0;
-  for (size_t shader_offset = 0; shader_offset < num_pixels; shader_offset += m_shader_limit) {
-    size_t shader_size = (size_t)fminf(num_pixels - shader_offset, m_shader_limit);
-    total_pixel_samples += shader_size * num_samples;
-  }
+  total_pixel_samples = num_pixels * num_samples;
   progress.reset_sample();
   progress.set_total_pixel_samples(total_pixel_samples);
 
+  if (num_pixels == 0) {
+    m_is_baking = false;
+    return true;
+  }
+
+  /* Each batch ends with waiting for all threads, so make them large enough to keep every
+   * thread busy for a while. On other devices the limit is based on the tile size. */
+  size_t batch_size = m_shader_limit;
+  if (device->info.type == DEVICE_CPU) {
+    batch_size = max(batch_size, device->info.cpu_threads * BAKE_CPU_PIXELS_PER_THREAD);
+  }
+  batch_size = min(batch_size, num_pixels);
+
   /* needs to be up to date for baking specific AA samples */
   dscene->data.integrator.aa_samples = num_samples;
   device->const_copy_to("__data", &dscene->data, sizeof(dscene->data));
 
-  for (size_t shader_offset = 0; shader_offset < num_pixels; shader_offset += m_shader_limit) {
-    size_t shader_size = (size_t)fminf(num_pixels - shader_offset, m_shader_limit);
+  /* setup input and output for device tasks, reused for all batches */
+  device_vector<uint4> d_input(device, "bake_input", MEM_READ_ONLY);
+  device_vector<float4> d_output(device, "bake_output", MEM_READ_WRITE);
+  uint4 *d_input_data = d_input.alloc(batch_size * 2);
+  d_output.alloc(batch_size);
 
-    /* setup input for device task */
-    device_vector<uint4> d_input(device, "bake_input", MEM_READ_ONLY);
-    uint4 *d_input_data = d_input.alloc(shader_size * 2);
-    size_t d_input_size = 0;
+  bool success = true;
 
-    for (size_t i = shader_offset; i < (shader_offset + shader_size); i++) {
-      d_input_data[d_input_size++] = bake_data->data(i);
-      d_input_data[d_input_size++] = bake_data->differentials(i);
-    }
+  for (size_t shader_offset = 0; shader_offset < num_pixels; shader_offset += batch_size) {
+    size_t shader_size = min(num_pixels - shader_offset, batch_size);
 
-    if (d_input_size == 0) {
-      m_is_baking = false;
-      return false;
+    for (size_t k = 0; k < shader_size; k++) {
+      size_t i = pixels[shader_offset + k];
+      d_input_data[k * 2] = bake_data->data(i);
+      d_input_data[k * 2 + 1] = bake_data->differentials(i);
     }
 
     /* run device task */
-    device_vector<float4> d_output(device, "bake_output", MEM_READ_WRITE);
-    d_output.alloc(shader_size);
     d_output.zero_to_device();
     d_input.copy_to_device();
 
@@ -184,7 +212,7 @@ bool BakeManager::bake(Device *device,
     task.shader_filter = pass_filter;
     task.shader_x = 0;
     task.offset = shader_offset;
-    task.shader_w = d_output.size();
+    task.shader_w = shader_size;
     task.num_samples = num_samples;
     task.get_cancel = function_bind(&Progress::get_cancel, &progress);
     task.update_progress_sample = function_bind(&Progress::add_samples_update, &progress, _1, _2);
@@ -193,37 +221,31 @@ bool BakeManager::bake(Device *device,
     device->task_wait();
 
     if (progress.get_cancel()) {
-      d_input.free();
-      d_output.free();
-      m_is_baking = false;
-      return false;
+      success = false;
+      break;
     }
 
-    d_output.copy_from_device(0, 1, d_output.size());
-    d_input.free();
+    d_output.copy_from_device(0, 1, shader_size);
 
     /* read result */
-    int k = 0;
-
     float4 *offset = d_output.data();
 
     size_t depth = 4;
-    for (size_t i = shader_offset; i < (shader_offset + shader_size); i++) {
-      size_t index = i * depth;
-      float4 out = offset[k++];
+    for (size_t k = 0; k < shader_size; k++) {
+      size_t index = pixels[shader_offset + k] * depth;
+      float4 out = offset[k];
 
-      if (bake_data->is_valid(i)) {
-        for (size_t j = 0; j < 4; j++) {
-          result[index + j] = out[j];
-        }
+      for (size_t j = 0; j < 4; j++) {
+        result[index + j] = out[j];
       }
     }
-
-    d_output.free();
   }
 
+  d_input.free();
+  d_output.free();
+
   m_is_baking = false;
-  return true;
+  return success;
 }
 
 void BakeManager::device_update(Device * /*device*/,
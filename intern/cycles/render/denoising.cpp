@@ -233,6 +233,7 @@ DenoiseTask::DenoiseTask(Device *device,
       neighbor_frames(neighbor_frames),
       current_layer(0),
       input_pixels(device, "filter input buffer", MEM_READ_ONLY),
+      tile_size(denoiser->tile_size),
       num_tiles(0)
 {
   image.samples = denoiser->samples_override;
@@ -280,11 +281,10 @@ void DenoiseTask::map_neighboring_tiles(RenderTile *tiles, Device *tile_device)
 
     int dx = (i % 3) - 1;
     int dy = (i / 3) - 1;
-    tiles[i].x = clamp(tiles[4].x + dx * denoiser->tile_size.x, 0, image.width);
-    tiles[i].w = clamp(tiles[4].x + (dx + 1) * denoiser->tile_size.x, 0, image.width) - tiles[i].x;
-    tiles[i].y = clamp(tiles[4].y + dy * denoiser->tile_size.y, 0, image.height);
-    tiles[i].h = clamp(tiles[4].y + (dy + 1) * denoiser->tile_size.y, 0, image.height) -
-                 tiles[i].y;
+    tiles[i].x = clamp(tiles[4].x + dx * tile_size.x, 0, image.width);
+    tiles[i].w = clamp(tiles[4].x + (dx + 1) * tile_size.x, 0, image.width) - tiles[i].x;
+    tiles[i].y = clamp(tiles[4].y + dy * tile_size.y, 0, image.height);
+    tiles[i].h = clamp(tiles[4].y + (dy + 1) * tile_size.y, 0, image.height) - tiles[i].y;
 
     tiles[i].buffer = tiles[4].buffer;
     tiles[i].offset = tiles[4].offset;
@@ -401,16 +401,16 @@ void DenoiseTask::create_task(DeviceTask &task)
   assert(output_pixels.empty());
   output_pixels.clear();
 
-  int tiles_x = divide_up(image.width, denoiser->tile_size.x);
-  int tiles_y = divide_up(image.height, denoiser->tile_size.y);
+  int tiles_x = divide_up(image.width, tile_size.x);
+  int tiles_y = divide_up(image.height, tile_size.y);
 
   for (int ty = 0; ty < tiles_y; ty++) {
     for (int tx = 0; tx < tiles_x; tx++) {
       RenderTile tile;
-      tile.x = tx * denoiser->tile_size.x;
-      tile.y = ty * denoiser->tile_size.y;
-      tile.w = min(image.width - tile.x, denoiser->tile_size.x);
-      tile.h = min(image.height - tile.y, denoiser->tile_size.y);
+      tile.x = tx * tile_size.x;
+      tile.y = ty * tile_size.y;
+      tile.w = min(image.width - tile.x, tile_size.x);
+      tile.h = min(image.height - tile.y, tile_size.y);
       tile.start_sample = 0;
       tile.num_samples = image.layers[current_layer].samples;
       tile.sample = 0;
@@ -462,6 +462,12 @@ bool DenoiseTask::load_input_pixels(int layer)
       }
     }
 
+    /* OpenImageDenoise uses the noisy image and features as they are. */
+    if (denoiser->params.type == DENOISER_OPENIMAGEDENOISE) {
+      buffer_data += frame_stride;
+      continue;
+    }
+
     /* Box blur */
     int r = 5 * denoiser->params.radius;
     float *data = buffer_data + 14;
@@ -531,6 +537,12 @@ bool DenoiseTask::load()
     return false;
   }
 
+  /* OpenImageDenoise is multithreaded internally and gives the best results when it sees the
+   * full frame at once. */
+  if (denoiser->params.type == DENOISER_OPENIMAGEDENOISE) {
+    tile_size = make_int2(image.width, image.height);
+  }
+
   /* Allocate device buffer. */
   int num_frames = image.in_neighbors.size() + 1;
   input_pixels.alloc(image.width * INPUT_NUM_CHANNELS, image.height * num_frames);
@@ -892,8 +904,11 @@ bool Denoiser::run()
     }
 
     /* Determine neighbor frame numbers that should be used for filtering. */
+    /* OpenImageDenoise filters each frame on its own. */
+    const int num_neighbors = (params.type == DENOISER_OPENIMAGEDENOISE) ? 0 :
+                                                                           params.neighbor_frames;
     vector<int> neighbor_frames;
-    for (int f = frame - params.neighbor_frames; f <= frame + params.neighbor_frames; f++) {
+    for (int f = frame - num_neighbors; f <= frame + num_neighbors; f++) {
       if (f >= 0 && f < num_frames && f != frame) {
         neighbor_frames.push_back(f);
       }
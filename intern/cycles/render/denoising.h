@@ -183,6 +183,7 @@ class DenoiseTask {
   device_vector<float> input_pixels;
 
   /* Tiles */
+  int2 tile_size;
   thread_mutex tiles_mutex;
   list<RenderTile> tiles;
   int num_tiles;
@@ -196,6 +196,13 @@ void Pass::add(PassType type, vector<Pass> &passes, const char *name)
     case PASS_AOV_VALUE:
       pass.components = 1;
       break;
+    case PASS_ADAPTIVE_AUX_BUFFER:
+      pass.components = 4;
+      break;
+    case PASS_SAMPLE_COUNT:
+      pass.components = 1;
+      pass.filter = false;
+      break;
     default:
       assert(false);
       break;
@@ -357,6 +364,8 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
   kfilm->light_pass_flag = 0;
   kfilm->pass_stride = 0;
   kfilm->use_light_pass = use_light_visibility;
+  kfilm->pass_adaptive_aux_buffer = 0;
+  kfilm->pass_sample_count = 0;
 
   bool have_cryptomatte = false, have_aov_color = false, have_aov_value = false;
 
@@ -507,6 +516,12 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
           have_aov_value = true;
         }
         break;
+      case PASS_ADAPTIVE_AUX_BUFFER:
+        kfilm->pass_adaptive_aux_buffer = kfilm->pass_stride;
+        break;
+      case PASS_SAMPLE_COUNT:
+        kfilm->pass_sample_count = kfilm->pass_stride;
+        break;
       default:
         assert(false);
         break;
@@ -366,6 +366,10 @@ void ShaderGraph::simplify(Scene *scene)
     clean(scene);
     refine_bump_nodes();
 
+    if (scene->image_manager->use_texture_cache() && !scene->shader_manager->use_osl()) {
+      refine_texture_differentials();
+    }
+
     simplified = true;
   }
 }
@@ -775,6 +779,30 @@ void ShaderGraph::compute_displacement_hash()
   displacement_hash = md5.get_hex();
 }
 
+void ShaderGraph::compute_content_hash()
+{
+  /* Hash of the graph as created by the user, used to look up previously compiled shaders. */
+  MD5Hash md5;
+
+  foreach (ShaderNode *node, nodes) {
+    if (node->has_scene_resources()) {
+      content_hash = "";
+      return;
+    }
+
+    node->hash(md5);
+    foreach (ShaderInput *input, node->inputs) {
+      int link_id = (input->link) ? input->link->parent->id : -1;
+      md5.append((uint8_t *)&link_id, sizeof(link_id));
+      if (input->link) {
+        md5.append(input->link->name().string());
+      }
+    }
+  }
+
+  content_hash = md5.get_hex();
+}
+
 void ShaderGraph::clean(Scene *scene)
 {
   /* Graph simplification */
@@ -953,6 +981,47 @@ void ShaderGraph::refine_bump_nodes()
   }
 }
 
+void ShaderGraph::refine_texture_differentials()
+{
+  /* Image textures read through the texture cache use the derivatives of their texture
+   * coordinates to pick a mipmap level. Like for bump nodes, we copy the sub-graph connected
+   * to the vector input, evaluated at the shading point shifted by the ray differentials. */
+
+  foreach (ShaderNode *node, nodes) {
+    if (node->type != ImageTextureNode::node_type || node->bump != SHADER_BUMP_NONE) {
+      continue;
+    }
+
+    ShaderInput *vector_in = node->input("Vector");
+    if (!vector_in->link) {
+      continue;
+    }
+
+    ShaderNodeSet nodes_vector;
+    ShaderNodeMap nodes_dx;
+    ShaderNodeMap nodes_dy;
+
+    find_dependencies(nodes_vector, vector_in);
+
+    copy_nodes(nodes_vector, nodes_dx);
+    copy_nodes(nodes_vector, nodes_dy);
+
+    foreach (NodePair &pair, nodes_dx)
+      pair.second->bump = SHADER_BUMP_DX;
+    foreach (NodePair &pair, nodes_dy)
+      pair.second->bump = SHADER_BUMP_DY;
+
+    ShaderOutput *out = vector_in->link;
+    connect(nodes_dx[out->parent]->output(out->name()), node->input("VectorDx"));
+    connect(nodes_dy[out->parent]->output(out->name()), node->input("VectorDy"));
+
+    foreach (NodePair &pair, nodes_dx)
+      add(pair.second);
+    foreach (NodePair &pair, nodes_dy)
+      add(pair.second);
+  }
+}
+
 void ShaderGraph::bump_from_displacement(bool use_object_space)
 {
   /* generate bump mapping automatically from displacement. bump mapping is
@@ -224,6 +224,12 @@ class ShaderNode : public Node {
   {
     return false;
   }
+  /* Compiling the node adds images or other data to the scene, so the compiled shader can not be
+   * reused by another scene. */
+  virtual bool has_scene_resources()
+  {
+    return false;
+  }
   vector<ShaderInput *> inputs;
   vector<ShaderOutput *> outputs;
 
@@ -323,6 +329,8 @@ class ShaderGraph {
   bool finalized;
   bool simplified;
   string displacement_hash;
+  /* Hash of all nodes and links before finalizing, empty if the graph can not be cached. */
+  string content_hash;
 
   ShaderGraph();
   ~ShaderGraph();
@@ -339,6 +347,7 @@ class ShaderGraph {
 
   void remove_proxy_nodes();
   void compute_displacement_hash();
+  void compute_content_hash();
   void simplify(Scene *scene);
   void finalize(Scene *scene,
                 bool do_bump = false,
@@ -359,6 +368,7 @@ class ShaderGraph {
   void break_cycles(ShaderNode *node, vector<bool> &visited, vector<bool> &on_stack);
   void bump_from_displacement(bool use_object_space);
   void refine_bump_nodes();
+  void refine_texture_differentials();
   void expand();
   void default_inputs(bool do_osl);
   void transform_multi_closure(ShaderNode *node, ShaderOutput *weight_out, bool volume);
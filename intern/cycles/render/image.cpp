@@ -50,7 +50,7 @@ bool isfinite(uint16_t /*value*/)
   return true;
 }
 
-/* The lower three bits of a device texture slot number indicate its type.
+/* The lower four bits of a device texture slot number indicate its type.
  * These functions convert the slot ids from ImageManager "images" ones
  * to device ones and vice verse.
  */
@@ -84,6 +84,12 @@ const char *name_from_type(ImageDataType type)
       return "ushort4";
     case IMAGE_DATA_TYPE_USHORT:
       return "ushort";
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      return "texture_cache";
+    case IMAGE_DATA_TYPE_FLOAT_SPARSE:
+      return "float_sparse";
+    case IMAGE_DATA_TYPE_FLOAT4_SPARSE:
+      return "float4_sparse";
     case IMAGE_DATA_NUM_TYPES:
       assert(!"System enumerator type, should never be used");
       return "";
@@ -92,6 +98,184 @@ const char *name_from_type(ImageDataType type)
   return "";
 }
 
+/* Builds the sparse layout one slab of TEX_SPARSE_TILE_SIZE slices at a time, leaving out
+ * tiles where all voxels are zero. All slabs are indexed first so the texture can be allocated
+ * at its final size, after which they are passed again to copy their non-empty tiles. */
+class SparseVolumeBuilder {
+ public:
+  SparseVolumeBuilder(int channels, int width, int height, int depth)
+      : channels(channels),
+        width(width),
+        height(height),
+        depth(depth),
+        tiles_x(tex_sparse_num_tiles(width)),
+        tiles_y(tex_sparse_num_tiles(height)),
+        tiles_z(tex_sparse_num_tiles(depth)),
+        tile_index(((size_t)tiles_x) * tiles_y * tiles_z, 0),
+        num_stored_tiles(1),
+        data(NULL)
+  {
+  }
+
+  int num_slabs() const
+  {
+    return tiles_z;
+  }
+
+  int slab_begin(int tz) const
+  {
+    return tz * TEX_SPARSE_TILE_SIZE;
+  }
+
+  int slab_end(int tz) const
+  {
+    return min(slab_begin(tz) + TEX_SPARSE_TILE_SIZE, depth);
+  }
+
+  /* Number of floats in a slab with all channels of the volume. */
+  size_t slab_size(int tz) const
+  {
+    return ((size_t)width) * height * (slab_end(tz) - slab_begin(tz)) * channels;
+  }
+
+  /* Find the non-empty tiles of a slab, tile 0 is reserved for empty ones.
+   * Returns false if all tiles of the slab are empty. */
+  bool index_slab(const float *slab, int tz)
+  {
+    const int z_end = slab_end(tz) - slab_begin(tz);
+    bool found = false;
+
+    for (int ty = 0; ty < tiles_y; ty++) {
+      for (int tx = 0; tx < tiles_x; tx++) {
+        const int x_end = min((tx + 1) * TEX_SPARSE_TILE_SIZE, width);
+        const int y_end = min((ty + 1) * TEX_SPARSE_TILE_SIZE, height);
+        bool empty = true;
+
+        for (int z = 0; z < z_end && empty; z++) {
+          for (int y = ty * TEX_SPARSE_TILE_SIZE; y < y_end && empty; y++) {
+            const float *row = slab + (((size_t)z * height + y) * width) * channels;
+            for (int i = tx * TEX_SPARSE_TILE_SIZE * channels; i < x_end * channels; i++) {
+              if (row[i] != 0.0f) {
+                empty = false;
+                break;
+              }
+            }
+          }
+        }
+
+        if (!empty) {
+          tile_index[tx + tiles_x * (ty + (size_t)tiles_y * tz)] = num_stored_tiles++;
+          found = true;
+        }
+      }
+    }
+
+    return found;
+  }
+
+  /* Allocate the texture for the tiles found by index_slab(). */
+  bool alloc(device_vector<float> &tex_img, thread_mutex &device_mutex)
+  {
+    const size_t num_tiles = tile_index.size();
+    const size_t header_size = tex_sparse_header_size(num_tiles);
+    {
+      thread_scoped_lock device_lock(device_mutex);
+      data = tex_img.alloc(header_size + num_stored_tiles * tile_size());
+    }
+    if (data == NULL) {
+      return false;
+    }
+
+    memset(data, 0, sizeof(float) * tex_img.size());
+    memcpy(data, &tile_index[0], sizeof(uint) * num_tiles);
+    data += header_size;
+
+    /* The kernel needs the resolution of the volume rather than the size of the data. */
+    tex_img.data_width = width;
+    tex_img.data_height = height;
+    tex_img.data_depth = depth;
+
+    VLOG(1) << "Storing " << num_stored_tiles - 1 << " of " << num_tiles
+            << " sparse volume tiles, using "
+            << string_human_readable_size(tex_img.memory_size()) << " instead of "
+            << string_human_readable_size(sizeof(float) * width * height * depth * channels)
+            << ".";
+
+    return true;
+  }
+
+  /* Copy voxels of the non-empty tiles of a slab, voxels outside of the volume stay zero. */
+  void copy_slab(const float *slab, int tz) const
+  {
+    const int z_end = slab_end(tz) - slab_begin(tz);
+
+    for (int ty = 0; ty < tiles_y; ty++) {
+      for (int tx = 0; tx < tiles_x; tx++) {
+        const uint tile = tile_index[tx + tiles_x * (ty + (size_t)tiles_y * tz)];
+        if (tile == 0) {
+          continue;
+        }
+
+        float *tile_data = data + tile * tile_size();
+        const int x_start = tx * TEX_SPARSE_TILE_SIZE;
+        const int x_end = min(x_start + TEX_SPARSE_TILE_SIZE, width);
+        const int y_end = min((ty + 1) * TEX_SPARSE_TILE_SIZE, height);
+
+        for (int z = 0; z < z_end; z++) {
+          for (int y = ty * TEX_SPARSE_TILE_SIZE; y < y_end; y++) {
+            const float *row = slab + (((size_t)z * height + y) * width + x_start) * channels;
+            const int voxel = TEX_SPARSE_TILE_SIZE *
+                              ((y & TEX_SPARSE_TILE_MASK) + TEX_SPARSE_TILE_SIZE * z);
+            memcpy(tile_data + voxel * channels,
+                   row,
+                   sizeof(float) * (x_end - x_start) * channels);
+          }
+        }
+      }
+    }
+  }
+
+ protected:
+  size_t tile_size() const
+  {
+    return ((size_t)TEX_SPARSE_TILE_VOXELS) * channels;
+  }
+
+  int channels;
+  int width, height, depth;
+  int tiles_x, tiles_y, tiles_z;
+  vector<uint> tile_index;
+  size_t num_stored_tiles;
+  float *data;
+};
+
+/* Copy voxels of a dense volume into the sparse layout. */
+bool sparse_from_dense_voxels(const float *voxels,
+                              int channels,
+                              int width,
+                              int height,
+                              int depth,
+                              device_vector<float> &tex_img,
+                              thread_mutex &device_mutex)
+{
+  SparseVolumeBuilder builder(channels, width, height, depth);
+  const size_t slice_size = ((size_t)width) * height * channels;
+
+  for (int tz = 0; tz < builder.num_slabs(); tz++) {
+    builder.index_slab(voxels + builder.slab_begin(tz) * slice_size, tz);
+  }
+
+  if (!builder.alloc(tex_img, device_mutex)) {
+    return false;
+  }
+
+  for (int tz = 0; tz < builder.num_slabs(); tz++) {
+    builder.copy_slab(voxels + builder.slab_begin(tz) * slice_size, tz);
+  }
+
+  return true;
+}
+
 }  // namespace
 
 ImageManager::ImageManager(const DeviceInfo &info)
@@ -103,6 +287,9 @@ ImageManager::ImageManager(const DeviceInfo &info)
   /* Set image limits */
   max_num_images = TEX_NUM_MAX;
   has_half_images = info.has_half_images;
+  has_texture_cache = (info.type == DEVICE_CPU);
+  has_sparse_volumes = (info.type == DEVICE_CPU);
+  texture_cache = NULL;
 
   for (size_t type = 0; type < IMAGE_DATA_NUM_TYPES; type++) {
     tex_num_images[type] = 0;
@@ -115,6 +302,8 @@ ImageManager::~ImageManager()
     for (size_t slot = 0; slot < images[type].size(); slot++)
       assert(!images[type][slot]);
   }
+
+  delete texture_cache;
 }
 
 void ImageManager::set_osl_texture_system(void *texture_system)
@@ -122,6 +311,42 @@ void ImageManager::set_osl_texture_system(void *texture_system)
   osl_texture_system = texture_system;
 }
 
+void ImageManager::set_texture_cache_params(const TextureCacheParams &params)
+{
+  texture_cache_params = params;
+}
+
+bool ImageManager::use_texture_cache() const
+{
+  return has_texture_cache && texture_cache_params.use_cache && !osl_texture_system;
+}
+
+bool ImageManager::image_use_texture_cache(void *builtin_data,
+                                           ImageAlphaType alpha_type,
+                                           ustring colorspace,
+                                           const ImageMetaData &metadata)
+{
+  if (!use_texture_cache() || builtin_data || metadata.depth > 1) {
+    return false;
+  }
+
+  /* The cache returns pixels as stored in the file, only sRGB can be converted to linear in
+   * the kernel. Other color spaces are converted while loading the full image. */
+  if (metadata.colorspace != u_colorspace_raw && metadata.colorspace != u_colorspace_srgb) {
+    return false;
+  }
+
+  /* Alpha is always associated by the cache. */
+  if (metadata.channels == 2 || metadata.channels == 4) {
+    if (ColorSpaceManager::colorspace_is_data(colorspace) || alpha_type == IMAGE_ALPHA_IGNORE ||
+        alpha_type == IMAGE_ALPHA_CHANNEL_PACKED) {
+      return false;
+    }
+  }
+
+  return (metadata.channels >= 1 && metadata.channels <= 4);
+}
+
 bool ImageManager::set_animation_frame_update(int frame)
 {
   if (frame != animation_frame) {
@@ -335,6 +560,21 @@ int ImageManager::add_image(const string &filename,
     }
   }
 
+  /* Read from disk on demand instead of loading the full image. */
+  if (image_use_texture_cache(builtin_data, alpha_type, colorspace, metadata)) {
+    type = IMAGE_DATA_TYPE_TEXTURE_CACHE;
+  }
+
+  /* Leave out empty space of volumes. */
+  if (has_sparse_volumes && metadata.depth > 1) {
+    if (type == IMAGE_DATA_TYPE_FLOAT4) {
+      type = IMAGE_DATA_TYPE_FLOAT4_SPARSE;
+    }
+    else if (type == IMAGE_DATA_TYPE_FLOAT) {
+      type = IMAGE_DATA_TYPE_FLOAT_SPARSE;
+    }
+  }
+
   /* Fnd existing image. */
   for (slot = 0; slot < images[type].size(); slot++) {
     img = images[type][slot];
@@ -547,6 +787,107 @@ bool ImageManager::file_load_image_generic(Image *img, unique_ptr<ImageInput> *i
   return true;
 }
 
+/* Convert pixels as read from the file or callback to the layout of the texture, and fix
+ * up values the kernel can't handle. Pixels must have space for 4 channels if is_rgba. */
+template<TypeDesc::BASETYPE FileFormat, typename StorageType>
+static void image_convert_pixels(ImageManager::Image *img,
+                                 bool is_rgba,
+                                 int components,
+                                 bool cmyk,
+                                 StorageType *pixels,
+                                 int width,
+                                 int height,
+                                 int depth)
+{
+  const size_t num_pixels = ((size_t)width) * height * depth;
+
+  if (is_rgba) {
+    const StorageType one = util_image_cast_from_float<StorageType>(1.0f);
+
+    if (cmyk) {
+      /* CMYK to RGBA. */
+      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
+        float c = util_image_cast_to_float(pixels[i * 4 + 0]);
+        float m = util_image_cast_to_float(pixels[i * 4 + 1]);
+        float y = util_image_cast_to_float(pixels[i * 4 + 2]);
+        float k = util_image_cast_to_float(pixels[i * 4 + 3]);
+        pixels[i * 4 + 0] = util_image_cast_from_float<StorageType>((1.0f - c) * (1.0f - k));
+        pixels[i * 4 + 1] = util_image_cast_from_float<StorageType>((1.0f - m) * (1.0f - k));
+        pixels[i * 4 + 2] = util_image_cast_from_float<StorageType>((1.0f - y) * (1.0f - k));
+        pixels[i * 4 + 3] = one;
+      }
+    }
+    else if (components == 2) {
+      /* Grayscale + alpha to RGBA. */
+      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
+        pixels[i * 4 + 3] = pixels[i * 2 + 1];
+        pixels[i * 4 + 2] = pixels[i * 2 + 0];
+        pixels[i * 4 + 1] = pixels[i * 2 + 0];
+        pixels[i * 4 + 0] = pixels[i * 2 + 0];
+      }
+    }
+    else if (components == 3) {
+      /* RGB to RGBA. */
+      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
+        pixels[i * 4 + 3] = one;
+        pixels[i * 4 + 2] = pixels[i * 3 + 2];
+        pixels[i * 4 + 1] = pixels[i * 3 + 1];
+        pixels[i * 4 + 0] = pixels[i * 3 + 0];
+      }
+    }
+    else if (components == 1) {
+      /* Grayscale to RGBA. */
+      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
+        pixels[i * 4 + 3] = one;
+        pixels[i * 4 + 2] = pixels[i];
+        pixels[i * 4 + 1] = pixels[i];
+        pixels[i * 4 + 0] = pixels[i];
+      }
+    }
+
+    /* Disable alpha if requested by the user. */
+    if (img->alpha_type == IMAGE_ALPHA_IGNORE) {
+      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
+        pixels[i * 4 + 3] = one;
+      }
+    }
+
+    if (img->metadata.colorspace != u_colorspace_raw &&
+        img->metadata.colorspace != u_colorspace_srgb) {
+      /* Convert to scene linear. */
+      ColorSpaceManager::to_scene_linear(
+          img->metadata.colorspace, pixels, width, height, depth, img->metadata.compress_as_srgb);
+    }
+  }
+
+  /* Make sure we don't have buggy values. */
+  if (FileFormat == TypeDesc::FLOAT) {
+    /* For RGBA buffers we put all channels to 0 if either of them is not
+     * finite. This way we avoid possible artifacts caused by fully changed
+     * hue. */
+    if (is_rgba) {
+      for (size_t i = 0; i < num_pixels; i += 4) {
+        StorageType *pixel = &pixels[i * 4];
+        if (!isfinite(pixel[0]) || !isfinite(pixel[1]) || !isfinite(pixel[2]) ||
+            !isfinite(pixel[3])) {
+          pixel[0] = 0;
+          pixel[1] = 0;
+          pixel[2] = 0;
+          pixel[3] = 0;
+        }
+      }
+    }
+    else {
+      for (size_t i = 0; i < num_pixels; ++i) {
+        StorageType *pixel = &pixels[i];
+        if (!isfinite(pixel[0])) {
+          pixel[0] = 0;
+        }
+      }
+    }
+  }
+}
+
 template<TypeDesc::BASETYPE FileFormat, typename StorageType, typename DeviceType>
 bool ImageManager::file_load_image(Image *img,
                                    ImageDataType type,
@@ -655,91 +996,7 @@ bool ImageManager::file_load_image(Image *img,
   bool is_rgba = (type == IMAGE_DATA_TYPE_FLOAT4 || type == IMAGE_DATA_TYPE_HALF4 ||
                   type == IMAGE_DATA_TYPE_BYTE4 || type == IMAGE_DATA_TYPE_USHORT4);
 
-  if (is_rgba) {
-    const StorageType one = util_image_cast_from_float<StorageType>(1.0f);
-
-    if (cmyk) {
-      /* CMYK to RGBA. */
-      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
-        float c = util_image_cast_to_float(pixels[i * 4 + 0]);
-        float m = util_image_cast_to_float(pixels[i * 4 + 1]);
-        float y = util_image_cast_to_float(pixels[i * 4 + 2]);
-        float k = util_image_cast_to_float(pixels[i * 4 + 3]);
-        pixels[i * 4 + 0] = util_image_cast_from_float<StorageType>((1.0f - c) * (1.0f - k));
-        pixels[i * 4 + 1] = util_image_cast_from_float<StorageType>((1.0f - m) * (1.0f - k));
-        pixels[i * 4 + 2] = util_image_cast_from_float<StorageType>((1.0f - y) * (1.0f - k));
-        pixels[i * 4 + 3] = one;
-      }
-    }
-    else if (components == 2) {
-      /* Grayscale + alpha to RGBA. */
-      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
-        pixels[i * 4 + 3] = pixels[i * 2 + 1];
-        pixels[i * 4 + 2] = pixels[i * 2 + 0];
-        pixels[i * 4 + 1] = pixels[i * 2 + 0];
-        pixels[i * 4 + 0] = pixels[i * 2 + 0];
-      }
-    }
-    else if (components == 3) {
-      /* RGB to RGBA. */
-      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
-        pixels[i * 4 + 3] = one;
-        pixels[i * 4 + 2] = pixels[i * 3 + 2];
-        pixels[i * 4 + 1] = pixels[i * 3 + 1];
-        pixels[i * 4 + 0] = pixels[i * 3 + 0];
-      }
-    }
-    else if (components == 1) {
-      /* Grayscale to RGBA. */
-      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
-        pixels[i * 4 + 3] = one;
-        pixels[i * 4 + 2] = pixels[i];
-        pixels[i * 4 + 1] = pixels[i];
-        pixels[i * 4 + 0] = pixels[i];
-      }
-    }
-
-    /* Disable alpha if requested by the user. */
-    if (img->alpha_type == IMAGE_ALPHA_IGNORE) {
-      for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
-        pixels[i * 4 + 3] = one;
-      }
-    }
-
-    if (img->metadata.colorspace != u_colorspace_raw &&
-        img->metadata.colorspace != u_colorspace_srgb) {
-      /* Convert to scene linear. */
-      ColorSpaceManager::to_scene_linear(
-          img->metadata.colorspace, pixels, width, height, depth, img->metadata.compress_as_srgb);
-    }
-  }
-
-  /* Make sure we don't have buggy values. */
-  if (FileFormat == TypeDesc::FLOAT) {
-    /* For RGBA buffers we put all channels to 0 if either of them is not
-     * finite. This way we avoid possible artifacts caused by fully changed
-     * hue. */
-    if (is_rgba) {
-      for (size_t i = 0; i < num_pixels; i += 4) {
-        StorageType *pixel = &pixels[i * 4];
-        if (!isfinite(pixel[0]) || !isfinite(pixel[1]) || !isfinite(pixel[2]) ||
-            !isfinite(pixel[3])) {
-          pixel[0] = 0;
-          pixel[1] = 0;
-          pixel[2] = 0;
-          pixel[3] = 0;
-        }
-      }
-    }
-    else {
-      for (size_t i = 0; i < num_pixels; ++i) {
-        StorageType *pixel = &pixels[i];
-        if (!isfinite(pixel[0])) {
-          pixel[0] = 0;
-        }
-      }
-    }
-  }
+  image_convert_pixels<FileFormat>(img, is_rgba, components, cmyk, pixels, width, height, depth);
 
   /* Scale image down if needed. */
   if (pixels_storage.size() > 0) {
@@ -774,6 +1031,136 @@ bool ImageManager::file_load_image(Image *img,
   return true;
 }
 
+bool ImageManager::file_load_volume_slab(
+    Image *img, bool is_rgba, int z_begin, int z_end, float *voxels)
+{
+  const int width = img->metadata.width;
+  const int height = img->metadata.height;
+  const size_t num_voxels = ((size_t)width) * height * (z_end - z_begin);
+
+  if (!builtin_image_float_voxels_cb(img->filename,
+                                     img->builtin_data,
+                                     z_begin,
+                                     z_end,
+                                     voxels,
+                                     num_voxels * img->metadata.channels)) {
+    return false;
+  }
+
+  image_convert_pixels<TypeDesc::FLOAT>(
+      img, is_rgba, img->metadata.channels, false, voxels, width, height, z_end - z_begin);
+  return true;
+}
+
+bool ImageManager::file_load_sparse_volume_slabs(Image *img,
+                                                 ImageDataType type,
+                                                 int texture_limit,
+                                                 device_vector<float> &tex_img)
+{
+  const int width = img->metadata.width;
+  const int height = img->metadata.height;
+  const int depth = img->metadata.depth;
+  const int components = img->metadata.channels;
+  const bool is_rgba = (type == IMAGE_DATA_TYPE_FLOAT4);
+  const int max_size = max(max(width, height), depth);
+
+  /* Only builtin volumes can be read in parts, resizing needs all voxels. */
+  if (!img->builtin_data || !builtin_image_float_voxels_cb || max_size == 0 ||
+      (texture_limit > 0 && max_size > texture_limit)) {
+    return false;
+  }
+  if (components < 1 || components > (is_rgba ? 4 : 1)) {
+    return false;
+  }
+
+  SparseVolumeBuilder builder(is_rgba ? 4 : 1, width, height, depth);
+  vector<float> slab(builder.slab_size(0));
+  vector<bool> slab_is_empty(builder.num_slabs());
+
+  for (int tz = 0; tz < builder.num_slabs(); tz++) {
+    if (!file_load_volume_slab(
+            img, is_rgba, builder.slab_begin(tz), builder.slab_end(tz), &slab[0])) {
+      return false;
+    }
+    slab_is_empty[tz] = !builder.index_slab(&slab[0], tz);
+  }
+
+  if (!builder.alloc(tex_img, device_mutex)) {
+    return false;
+  }
+
+  /* Read the slabs again, the texture is only allocated once the number of tiles is known. */
+  for (int tz = 0; tz < builder.num_slabs(); tz++) {
+    if (slab_is_empty[tz]) {
+      continue;
+    }
+    if (!file_load_volume_slab(
+            img, is_rgba, builder.slab_begin(tz), builder.slab_end(tz), &slab[0])) {
+      return false;
+    }
+    builder.copy_slab(&slab[0], tz);
+  }
+
+  return true;
+}
+
+template<typename DeviceType>
+void ImageManager::file_load_sparse_image(Image *img,
+                                          ImageDataType type,
+                                          int texture_limit,
+                                          device_vector<float> &tex_img)
+{
+  const int channels = (type == IMAGE_DATA_TYPE_FLOAT4) ? 4 : 1;
+
+  /* Build the tiles from a few slices at a time when possible. */
+  if (file_load_sparse_volume_slabs(img, type, texture_limit, tex_img)) {
+    return;
+  }
+  if (tex_img.size()) {
+    thread_scoped_lock device_lock(device_mutex);
+    tex_img.free();
+  }
+
+  /* Otherwise load all voxels first, the dense copy is freed once the tiles are extracted. */
+  device_vector<DeviceType> voxels(tex_img.device, "__tex_image_dense_voxels", MEM_READ_ONLY);
+
+  if (!file_load_image<TypeDesc::FLOAT, float>(img, type, texture_limit, voxels)) {
+    /* on failure to load, we set a 1x1 pixels pink image */
+    thread_scoped_lock device_lock(device_mutex);
+    float *pixels = (float *)voxels.alloc(1, 1);
+
+    pixels[0] = TEX_IMAGE_MISSING_R;
+    if (channels == 4) {
+      pixels[1] = TEX_IMAGE_MISSING_G;
+      pixels[2] = TEX_IMAGE_MISSING_B;
+      pixels[3] = TEX_IMAGE_MISSING_A;
+    }
+  }
+
+  const int width = voxels.data_width;
+  const int height = max((int)voxels.data_height, 1);
+  const int depth = max((int)voxels.data_depth, 1);
+
+  if (!sparse_from_dense_voxels((const float *)voxels.data(),
+                                channels,
+                                width,
+                                height,
+                                depth,
+                                tex_img,
+                                device_mutex)) {
+    /* Fall back to an empty volume when running out of memory. */
+    thread_scoped_lock device_lock(device_mutex);
+    float *data = tex_img.alloc(tex_sparse_header_size(1) + TEX_SPARSE_TILE_VOXELS * channels);
+    if (data) {
+      memset(data, 0, sizeof(float) * tex_img.size());
+    }
+    tex_img.data_width = tex_img.data_height = tex_img.data_depth = 1;
+  }
+
+  thread_scoped_lock device_lock(device_mutex);
+  voxels.free();
+}
+
 void ImageManager::device_load_image(
     Device *device, Scene *scene, ImageDataType type, int slot, Progress *progress)
 {
@@ -966,6 +1353,64 @@ void ImageManager::device_load_image(
     thread_scoped_lock device_lock(device_mutex);
     tex_img->copy_to_device();
   }
+  else if (type == IMAGE_DATA_TYPE_FLOAT_SPARSE) {
+    device_vector<float> *tex_img = new device_vector<float>(
+        device, img->mem_name.c_str(), MEM_TEXTURE);
+
+    file_load_sparse_image<float>(img, IMAGE_DATA_TYPE_FLOAT, texture_limit, *tex_img);
+
+    img->mem = tex_img;
+    img->mem->interpolation = img->interpolation;
+    img->mem->extension = img->extension;
+
+    thread_scoped_lock device_lock(device_mutex);
+    tex_img->copy_to_device();
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4_SPARSE) {
+    device_vector<float> *tex_img = new device_vector<float>(
+        device, img->mem_name.c_str(), MEM_TEXTURE);
+
+    file_load_sparse_image<float4>(img, IMAGE_DATA_TYPE_FLOAT4, texture_limit, *tex_img);
+
+    img->mem = tex_img;
+    img->mem->interpolation = img->interpolation;
+    img->mem->extension = img->extension;
+
+    thread_scoped_lock device_lock(device_mutex);
+    tex_img->copy_to_device();
+  }
+  else if (type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    TextureCacheHandle handle;
+    memset(&handle, 0, sizeof(handle));
+
+    {
+      thread_scoped_lock device_lock(device_mutex);
+      if (!texture_cache) {
+        texture_cache = new TextureCache(texture_cache_params);
+      }
+    }
+
+    /* Make sure a reloaded image is read again. */
+    texture_cache->invalidate(img->filename);
+    if (!texture_cache->get_handle(img->filename, &handle, progress)) {
+      /* On failure the kernel falls back to the missing texture color. */
+      memset(&handle, 0, sizeof(handle));
+    }
+
+    /* Only the handle is stored, pixels stay in the cache. */
+    device_vector<uint64_t> *tex_img = new device_vector<uint64_t>(
+        device, img->mem_name.c_str(), MEM_TEXTURE);
+
+    thread_scoped_lock device_lock(device_mutex);
+    uint64_t *data = tex_img->alloc(divide_up(sizeof(TextureCacheHandle), sizeof(uint64_t)));
+    memcpy(data, &handle, sizeof(handle));
+
+    img->mem = tex_img;
+    img->mem->interpolation = img->interpolation;
+    img->mem->extension = img->extension;
+
+    tex_img->copy_to_device();
+  }
   img->need_load = false;
 }
 
@@ -21,6 +21,7 @@
 #include "device/device_memory.h"
 
 #include "render/colorspace.h"
+#include "render/texture_cache.h"
 
 #include "util/util_image.h"
 #include "util/util_string.h"
@@ -114,6 +115,8 @@ class ImageManager {
   void device_free_builtin(Device *device);
 
   void set_osl_texture_system(void *texture_system);
+  void set_texture_cache_params(const TextureCacheParams &params);
+  bool use_texture_cache() const;
   bool set_animation_frame_update(int frame);
 
   device_memory *image_memory(int flat_slot);
@@ -144,6 +147,15 @@ class ImageManager {
                 const bool associate_alpha,
                 const bool free_cache)>
       builtin_image_float_pixels_cb;
+  /* Optional, reads the voxels of slices z_begin to z_end of a builtin volume. Sparse volumes
+   * are built from a few slices at a time with it, instead of from a copy of the whole volume. */
+  function<bool(const string &filename,
+                void *data,
+                int z_begin,
+                int z_end,
+                float *voxels,
+                const size_t voxels_size)>
+      builtin_image_float_voxels_cb;
 
   struct Image {
     string filename;
@@ -175,6 +187,19 @@ class ImageManager {
   vector<Image *> images[IMAGE_DATA_NUM_TYPES];
   void *osl_texture_system;
 
+  /* On-demand texture cache, only supported on the CPU. */
+  bool has_texture_cache;
+  TextureCacheParams texture_cache_params;
+  TextureCache *texture_cache;
+
+  /* Volumes stored in tiles without empty space, only supported on the CPU. */
+  bool has_sparse_volumes;
+
+  bool image_use_texture_cache(void *builtin_data,
+                               ImageAlphaType alpha_type,
+                               ustring colorspace,
+                               const ImageMetaData &metadata);
+
   bool file_load_image_generic(Image *img, unique_ptr<ImageInput> *in);
 
   template<TypeDesc::BASETYPE FileFormat, typename StorageType, typename DeviceType>
@@ -183,6 +208,17 @@ class ImageManager {
                        int texture_limit,
                        device_vector<DeviceType> &tex_img);
 
+  template<typename DeviceType>
+  void file_load_sparse_image(Image *img,
+                              ImageDataType type,
+                              int texture_limit,
+                              device_vector<float> &tex_img);
+  bool file_load_sparse_volume_slabs(Image *img,
+                                     ImageDataType type,
+                                     int texture_limit,
+                                     device_vector<float> &tex_img);
+  bool file_load_volume_slab(Image *img, bool is_rgba, int z_begin, int z_end, float *voxels);
+
   void metadata_detect_colorspace(ImageMetaData &metadata, const char *file_format);
 
   void device_load_image(
@@ -20,6 +20,7 @@
 #include "render/film.h"
 #include "render/graph.h"
 #include "render/light.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
@@ -255,6 +256,36 @@ bool LightManager::object_usable_as_light(Object *object)
   return false;
 }
 
+/* Bounds of a light with a position, used to build the light tree. */
+static LightTreeEmitter light_tree_lamp_emitter(const Light *light, int index)
+{
+  LightTreeEmitter emitter;
+  emitter.index = index;
+  emitter.bbox = BoundBox(light->co);
+
+  if (light->type == LIGHT_AREA) {
+    const float3 axisu = light->axisu * (light->sizeu * light->size * 0.5f);
+    const float3 axisv = light->axisv * (light->sizev * light->size * 0.5f);
+    emitter.bbox.grow(light->co + axisu + axisv);
+    emitter.bbox.grow(light->co + axisu - axisv);
+    emitter.bbox.grow(light->co - axisu + axisv);
+    emitter.bbox.grow(light->co - axisu - axisv);
+    /* Area lights only emit from their front side. */
+    emitter.bcone = {safe_normalize(light->dir), 0.0f, M_PI_2_F};
+  }
+  else {
+    emitter.bbox.grow(light->co, light->size);
+    if (light->type == LIGHT_SPOT) {
+      emitter.bcone = {safe_normalize(light->dir), light->spot_angle * 0.5f, 0.0f};
+    }
+    else {
+      emitter.bcone = {make_float3(0.0f, 0.0f, 1.0f), M_PI_F, M_PI_2_F};
+    }
+  }
+
+  return emitter;
+}
+
 void LightManager::device_update_distribution(Device *,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -304,6 +335,15 @@ void LightManager::device_update_distribution(Device *,
   size_t num_distribution = num_triangles + num_lights;
   VLOG(1) << "Total " << num_distribution << " of light distribution primitives.";
 
+  /* Only regular path tracing picks a single light per sample, branched path tracing
+   * samples lights individually. */
+  const bool use_light_tree = scene->integrator->use_light_tree &&
+                              scene->integrator->method == Integrator::PATH;
+  vector<LightTreeEmitter> emitters;
+  if (use_light_tree) {
+    emitters.reserve(num_distribution);
+  }
+
   /* emission area */
   KernelLightDistribution *distribution = dscene->light_distribution.alloc(num_distribution + 1);
   float totarea = 0.0f;
@@ -372,7 +412,21 @@ void LightManager::device_update_distribution(Device *,
           p3 = transform_point(&tfm, p3);
         }
 
-        totarea += triangle_area(p1, p2, p3);
+        const float area = triangle_area(p1, p2, p3);
+
+        if (use_light_tree) {
+          /* Mesh lights emit from both sides. */
+          LightTreeEmitter emitter;
+          emitter.index = offset - 1;
+          emitter.bbox = BoundBox(p1);
+          emitter.bbox.grow(p2);
+          emitter.bbox.grow(p3);
+          emitter.bcone = {safe_normalize(cross(p2 - p1, p3 - p1)), M_PI_F, M_PI_2_F};
+          emitter.energy = area;
+          emitters.push_back(emitter);
+        }
+
+        totarea += area;
       }
     }
 
@@ -396,6 +450,13 @@ void LightManager::device_update_distribution(Device *,
     distribution[offset].lamp.size = light->size;
     totarea += lightarea;
 
+    if (use_light_tree &&
+        (light->type == LIGHT_POINT || light->type == LIGHT_SPOT || light->type == LIGHT_AREA)) {
+      LightTreeEmitter emitter = light_tree_lamp_emitter(light, offset);
+      emitter.energy = lightarea;
+      emitters.push_back(emitter);
+    }
+
     if (light->type == LIGHT_DISTANT) {
       use_lamp_mis |= (light->angle > 0.0f && light->use_mis);
     }
@@ -420,6 +481,16 @@ void LightManager::device_update_distribution(Device *,
   distribution[num_distribution].lamp.pad = 0.0f;
   distribution[num_distribution].lamp.size = 0.0f;
 
+  size_t num_light_tree_local = 0;
+  if (use_light_tree && !emitters.empty()) {
+    num_light_tree_local = emitters.size();
+    device_update_light_tree(dscene, scene, distribution, num_distribution, emitters);
+  }
+  else {
+    dscene->light_tree_nodes.free();
+    dscene->light_tree_index.free();
+  }
+
   if (totarea > 0.0f) {
     for (size_t i = 0; i < num_distribution; i++)
       distribution[i].totarea /= totarea;
@@ -459,6 +530,10 @@ void LightManager::device_update_distribution(Device *,
 
     kintegrator->use_lamp_mis = use_lamp_mis;
 
+    kintegrator->use_light_tree = (num_light_tree_local > 0);
+    kintegrator->light_tree_num_local = num_light_tree_local;
+    kintegrator->light_tree_lamp_offset = dscene->tri_shader.size();
+
     /* bit of an ugly hack to compensate for emitting triangles influencing
      * amount of samples we get for this pass */
     kfilm->pass_shadow_scale = 1.0f;
@@ -492,6 +567,9 @@ void LightManager::device_update_distribution(Device *,
     kintegrator->pdf_triangles = 0.0f;
     kintegrator->pdf_lights = 0.0f;
     kintegrator->use_lamp_mis = false;
+    kintegrator->use_light_tree = false;
+    kintegrator->light_tree_num_local = 0;
+    kintegrator->light_tree_lamp_offset = 0;
     kintegrator->num_portals = 0;
     kintegrator->portal_offset = 0;
     kintegrator->portal_pdf = 0.0f;
@@ -500,6 +578,65 @@ void LightManager::device_update_distribution(Device *,
   }
 }
 
+void LightManager::device_update_light_tree(DeviceScene *dscene,
+                                            Scene *scene,
+                                            KernelLightDistribution *distribution,
+                                            size_t num_distribution,
+                                            vector<LightTreeEmitter> &emitters)
+{
+  /* Build the tree, which reorders the emitters spatially. */
+  LightTree light_tree(emitters, 4);
+
+  const vector<KernelLightTreeNode> &nodes = light_tree.get_nodes();
+  KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(nodes.size());
+  memcpy(knodes, &nodes[0], sizeof(KernelLightTreeNode) * nodes.size());
+
+  /* Reorder the distribution to match the tree, local emitters first followed by distant
+   * and background lights, and rebuild the cumulative weights. */
+  vector<KernelLightDistribution> old_distribution(distribution,
+                                                   distribution + num_distribution + 1);
+  vector<bool> is_local(num_distribution, false);
+  vector<int> order;
+  order.reserve(num_distribution);
+
+  foreach (const LightTreeEmitter &emitter, emitters) {
+    order.push_back(emitter.index);
+    is_local[emitter.index] = true;
+  }
+  for (size_t i = 0; i < num_distribution; i++) {
+    if (!is_local[i]) {
+      order.push_back(i);
+    }
+  }
+
+  float totarea = 0.0f;
+  for (size_t i = 0; i < num_distribution; i++) {
+    const int index = order[i];
+    const float weight = old_distribution[index + 1].totarea - old_distribution[index].totarea;
+    distribution[i] = old_distribution[index];
+    distribution[i].totarea = totarea;
+    totarea += weight;
+  }
+  distribution[num_distribution].totarea = totarea;
+
+  /* Map from triangles and lamps to their place in the distribution, to evaluate the tree
+   * PDF when an emitter is hit. */
+  const size_t num_tris = dscene->tri_shader.size();
+  uint *light_tree_index = dscene->light_tree_index.alloc(num_tris + scene->lights.size());
+  memset(light_tree_index, 0, sizeof(uint) * (num_tris + scene->lights.size()));
+
+  for (size_t i = 0; i < num_distribution; i++) {
+    const int prim = distribution[i].prim;
+    light_tree_index[(prim >= 0) ? prim : num_tris + ~prim] = i;
+  }
+
+  dscene->light_tree_nodes.copy_to_device();
+  dscene->light_tree_index.copy_to_device();
+
+  VLOG(1) << "Light tree with " << nodes.size() << " nodes over " << emitters.size()
+          << " emitters.";
+}
+
 static void background_cdf(
     int start, int end, int res_x, int res_y, const vector<float3> *pixels, float2 *cond_cdf)
 {
@@ -932,6 +1069,8 @@ void LightManager::device_update(Device *device,
 void LightManager::device_free(Device *, DeviceScene *dscene)
 {
   dscene->light_distribution.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_index.free();
   dscene->lights.free();
   dscene->light_background_marginal_cdf.free();
   dscene->light_background_conditional_cdf.free();
@@ -30,6 +30,7 @@ CCL_NAMESPACE_BEGIN
 
 class Device;
 class DeviceScene;
+struct LightTreeEmitter;
 class Object;
 class Progress;
 class Scene;
@@ -116,6 +117,11 @@ class LightManager {
                                   DeviceScene *dscene,
                                   Scene *scene,
                                   Progress &progress);
+  void device_update_light_tree(DeviceScene *dscene,
+                                Scene *scene,
+                                KernelLightDistribution *distribution,
+                                size_t num_distribution,
+                                vector<LightTreeEmitter> &emitters);
   void device_update_background(Device *device,
                                 DeviceScene *dscene,
                                 Scene *scene,
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2011-2019 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Orientation Bounds */
+
+OrientationBounds OrientationBounds::merge(const OrientationBounds &a, const OrientationBounds &b)
+{
+  const float theta_e = max(a.theta_e, b.theta_e);
+
+  /* Make sure a is the widest of both cones. */
+  if (a.theta_o < b.theta_o) {
+    return merge(b, a);
+  }
+  if (a.theta_o >= M_PI_F) {
+    return {a.axis, M_PI_F, theta_e};
+  }
+
+  const float theta_d = safe_acosf(dot(a.axis, b.axis));
+  if (min(theta_d + b.theta_o, M_PI_F) <= a.theta_o) {
+    return {a.axis, a.theta_o, theta_e};
+  }
+
+  const float theta_o = (a.theta_o + theta_d + b.theta_o) * 0.5f;
+  if (theta_o >= M_PI_F) {
+    return {a.axis, M_PI_F, theta_e};
+  }
+
+  /* Rotate the axis of a towards b, so that the new cone just encloses both. */
+  const float3 rotation_axis = cross(a.axis, b.axis);
+  if (len_squared(rotation_axis) < 1e-12f) {
+    return {a.axis, M_PI_F, theta_e};
+  }
+  const float3 axis = rotate_around_axis(
+      a.axis, normalize(rotation_axis), theta_o - a.theta_o);
+
+  return {normalize(axis), theta_o, theta_e};
+}
+
+/* Solid angle measure of orientation bounds, used to weigh the cost of a split. See
+ * "Importance Sampling of Many Lights with Adaptive Tree Splitting", Estevez and Kulla. */
+static float orientation_measure(const OrientationBounds &bcone)
+{
+  const float theta_o = bcone.theta_o;
+  const float theta_w = min(theta_o + bcone.theta_e, M_PI_F);
+  const float sin_theta_o = sinf(theta_o);
+  const float cos_theta_o = cosf(theta_o);
+
+  return M_2PI_F * (1.0f - cos_theta_o) +
+         M_PI_2_F * (2.0f * theta_w * sin_theta_o - cosf(theta_o - 2.0f * theta_w) -
+                     2.0f * theta_o * sin_theta_o + cos_theta_o);
+}
+
+/* Light Tree */
+
+LightTree::LightTree(vector<LightTreeEmitter> &emitters_, int max_emitters_in_leaf_)
+    : emitters(emitters_), max_emitters_in_leaf(max_emitters_in_leaf_)
+{
+  if (emitters.empty()) {
+    return;
+  }
+
+  nodes.reserve(2 * emitters.size() / max_emitters_in_leaf + 1);
+  build_recursive(0, emitters.size());
+}
+
+int LightTree::find_split(int start, int end, const BoundBox &centroid_bounds)
+{
+  const int num_buckets = 12;
+  const float3 extent = centroid_bounds.size();
+
+  float min_cost = FLT_MAX;
+  int min_dim = -1;
+  int min_bucket = 0;
+
+  for (int dim = 0; dim < 3; dim++) {
+    if (extent[dim] == 0.0f) {
+      continue;
+    }
+
+    struct Bucket {
+      BoundBox bbox = BoundBox(BoundBox::empty);
+      OrientationBounds bcone;
+      float energy = 0.0f;
+      int count = 0;
+    } buckets[num_buckets];
+
+    const float inv_extent = 1.0f / extent[dim];
+    for (int i = start; i < end; i++) {
+      const LightTreeEmitter &emitter = emitters[i];
+      const float centroid = emitter.bbox.center()[dim];
+      int b = (int)(num_buckets * (centroid - centroid_bounds.min[dim]) * inv_extent);
+      b = clamp(b, 0, num_buckets - 1);
+
+      Bucket &bucket = buckets[b];
+      bucket.bcone = (bucket.count) ? OrientationBounds::merge(bucket.bcone, emitter.bcone) :
+                                      emitter.bcone;
+      bucket.bbox.grow(emitter.bbox);
+      bucket.energy += emitter.energy;
+      bucket.count++;
+    }
+
+    /* Sweep from the right to find the cost of everything after each split. */
+    float right_cost[num_buckets];
+    {
+      BoundBox bbox = BoundBox::empty;
+      OrientationBounds bcone;
+      float energy = 0.0f;
+      int count = 0;
+      for (int b = num_buckets - 1; b > 0; b--) {
+        if (buckets[b].count) {
+          bcone = (count) ? OrientationBounds::merge(bcone, buckets[b].bcone) : buckets[b].bcone;
+          bbox.grow(buckets[b].bbox);
+          energy += buckets[b].energy;
+          count += buckets[b].count;
+        }
+        right_cost[b] = (count) ? energy * bbox.safe_area() * orientation_measure(bcone) : 0.0f;
+      }
+    }
+
+    BoundBox bbox = BoundBox::empty;
+    OrientationBounds bcone;
+    float energy = 0.0f;
+    int count = 0;
+    for (int b = 0; b < num_buckets - 1; b++) {
+      if (buckets[b].count) {
+        bcone = (count) ? OrientationBounds::merge(bcone, buckets[b].bcone) : buckets[b].bcone;
+        bbox.grow(buckets[b].bbox);
+        energy += buckets[b].energy;
+        count += buckets[b].count;
+      }
+      if (count == 0 || count == end - start) {
+        continue;
+      }
+
+      const float cost = energy * bbox.safe_area() * orientation_measure(bcone) +
+                         right_cost[b + 1];
+      if (cost < min_cost) {
+        min_cost = cost;
+        min_dim = dim;
+        min_bucket = b;
+      }
+    }
+  }
+
+  int middle = (start + end) / 2;
+
+  if (min_dim != -1) {
+    const float min = centroid_bounds.min[min_dim];
+    const float inv_extent = 1.0f / extent[min_dim];
+    vector<LightTreeEmitter>::iterator split = std::partition(
+        emitters.begin() + start, emitters.begin() + end, [&](const LightTreeEmitter &emitter) {
+          const float centroid = emitter.bbox.center()[min_dim];
+          int b = (int)(num_buckets * (centroid - min) * inv_extent);
+          return clamp(b, 0, num_buckets - 1) <= min_bucket;
+        });
+    middle = split - emitters.begin();
+  }
+
+  /* All centroids coincide or the split is degenerate, fall back to splitting by count. */
+  if (middle == start || middle == end) {
+    middle = (start + end) / 2;
+  }
+
+  return middle;
+}
+
+int LightTree::build_recursive(int start, int end)
+{
+  BoundBox bbox = BoundBox::empty;
+  BoundBox centroid_bounds = BoundBox::empty;
+  OrientationBounds bcone = emitters[start].bcone;
+  float energy = 0.0f;
+
+  for (int i = start; i < end; i++) {
+    const LightTreeEmitter &emitter = emitters[i];
+    bbox.grow(emitter.bbox);
+    centroid_bounds.grow(emitter.bbox.center());
+    if (i > start) {
+      bcone = OrientationBounds::merge(bcone, emitter.bcone);
+    }
+    energy += emitter.energy;
+  }
+
+  const int node_index = nodes.size();
+  nodes.push_back(KernelLightTreeNode());
+
+  KernelLightTreeNode &knode = nodes[node_index];
+  knode.bbox_min_energy = make_float4(bbox.min.x, bbox.min.y, bbox.min.z, energy);
+  knode.bbox_max_theta_o = make_float4(bbox.max.x, bbox.max.y, bbox.max.z, bcone.theta_o);
+  knode.axis_theta_e = make_float4(bcone.axis.x, bcone.axis.y, bcone.axis.z, bcone.theta_e);
+  knode.first_emitter = start;
+  knode.num_emitters = end - start;
+  knode.right_child = -1;
+  knode.pad = 0;
+
+  if (end - start <= max_emitters_in_leaf) {
+    return node_index;
+  }
+
+  const int middle = find_split(start, end, centroid_bounds);
+
+  /* Left child is stored right after its parent. */
+  build_recursive(start, middle);
+  const int right_child = build_recursive(middle, end);
+  nodes[node_index].right_child = right_child;
+
+  return node_index;
+}
+
+CCL_NAMESPACE_END
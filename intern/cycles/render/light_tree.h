@@ -0,0 +1,70 @@
+/*
+ * Copyright 2011-2019 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Bounds on the emission directions of a group of emitters: all normals lie within theta_o of
+ * the axis, and each of them emits over at most theta_e around it. */
+struct OrientationBounds {
+  float3 axis;
+  float theta_o;
+  float theta_e;
+
+  static OrientationBounds merge(const OrientationBounds &a, const OrientationBounds &b);
+};
+
+/* Emitter with a position in the scene, a light or an emissive triangle. */
+struct LightTreeEmitter {
+  BoundBox bbox;
+  OrientationBounds bcone;
+  float energy;
+  /* Index into the list of emitters before building. */
+  int index;
+};
+
+/* Bounding volume hierarchy over emitters, used to sample lights close to and facing the
+ * shading point with higher probability. */
+class LightTree {
+ public:
+  /* Builds the tree, reordering emitters so that every node covers a contiguous range. */
+  LightTree(vector<LightTreeEmitter> &emitters, int max_emitters_in_leaf);
+
+  const vector<KernelLightTreeNode> &get_nodes() const
+  {
+    return nodes;
+  }
+
+ protected:
+  int build_recursive(int start, int end);
+  int find_split(int start, int end, const BoundBox &centroid_bounds);
+
+  vector<LightTreeEmitter> &emitters;
+  vector<KernelLightTreeNode> nodes;
+  int max_emitters_in_leaf;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
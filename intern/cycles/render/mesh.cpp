@@ -36,6 +36,7 @@
 
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
+#include "util/util_map.h"
 #include "util/util_progress.h"
 #include "util/util_set.h"
 
@@ -1079,15 +1080,24 @@ void Mesh::compute_bvh(
     vector<Object *> objects;
     objects.push_back(&object);
 
-    if (bvh && !need_update_rebuild) {
+    bool rebuild = (bvh == NULL || need_update_rebuild);
+
+    if (!rebuild) {
       progress->set_status(msg, "Refitting BVH");
 
       bvh->meshes = meshes;
       bvh->objects = objects;
 
       bvh->refit(*progress);
+
+      /* Deformation can stretch leaves to overlap much more than in a new tree. */
+      if (bvh->refit_degraded()) {
+        VLOG(1) << "Refitted BVH of mesh " << name << " degraded, building a new one.";
+        rebuild = true;
+      }
     }
-    else {
+
+    if (rebuild) {
       progress->set_status(msg, "Building BVH");
 
       BVHParams bparams;
@@ -2406,6 +2416,53 @@ void MeshManager::tag_update(Scene *scene)
   scene->object_manager->need_update = true;
 }
 
+static bool mesh_bvh_reusable(const Mesh *from, const Mesh *to)
+{
+  return from->bvh && !from->transform_applied && !to->transform_applied &&
+         from->subdivision_type == Mesh::SUBDIVISION_NONE &&
+         to->subdivision_type == Mesh::SUBDIVISION_NONE && from->name == to->name &&
+         from->use_motion_blur == to->use_motion_blur &&
+         from->motion_steps == to->motion_steps && from->verts.size() == to->verts.size() &&
+         from->triangles == to->triangles && from->curve_keys.size() == to->curve_keys.size() &&
+         from->curve_first_key == to->curve_first_key;
+}
+
+void MeshManager::reuse_bvhs(const vector<Mesh *> &removed_meshes,
+                             const vector<Mesh *> &added_meshes)
+{
+  /* Only meshes with the same name can match, look them up by name. */
+  typedef unordered_map<ustring, vector<Mesh *>, ustringHash> MeshNameMap;
+  MeshNameMap removed_by_name;
+  foreach (Mesh *from, removed_meshes) {
+    if (from->bvh) {
+      removed_by_name[from->name].push_back(from);
+    }
+  }
+  if (removed_by_name.empty()) {
+    return;
+  }
+
+  foreach (Mesh *to, added_meshes) {
+    if (to->bvh) {
+      continue;
+    }
+
+    MeshNameMap::iterator it = removed_by_name.find(to->name);
+    if (it == removed_by_name.end()) {
+      continue;
+    }
+
+    foreach (Mesh *from, it->second) {
+      if (mesh_bvh_reusable(from, to)) {
+        to->bvh = from->bvh;
+        to->need_update_rebuild = false;
+        from->bvh = NULL;
+        break;
+      }
+    }
+  }
+}
+
 void MeshManager::collect_statistics(const Scene *scene, RenderStats *stats)
 {
   foreach (Mesh *mesh, scene->meshes) {
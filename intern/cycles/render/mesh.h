@@ -394,6 +394,10 @@ class MeshManager {
 
   void tag_update(Scene *scene);
 
+  /* Move the BVHs of meshes that are about to be removed to added meshes with the same name
+   * and topology, so they get refitted instead of built from scratch. */
+  void reuse_bvhs(const vector<Mesh *> &removed_meshes, const vector<Mesh *> &added_meshes);
+
   void create_volume_mesh(Scene *scene, Mesh *mesh, Progress &progress);
 
   void collect_statistics(const Scene *scene, RenderStats *stats);
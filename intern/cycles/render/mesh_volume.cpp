@@ -360,8 +360,67 @@ void VolumeMeshBuilder::convert_quads_to_tris(const vector<QuadData> &quads,
 struct VoxelAttributeGrid {
   float *data;
   int channels;
+  /* Only non-empty tiles are stored, see util_texture.h for the layout. */
+  bool sparse;
 };
 
+static bool voxel_active(const float *voxel, int channels, float isovalue)
+{
+  for (int c = 0; c < channels; c++) {
+    if (voxel[c] >= isovalue) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Add nodes for active voxels of a sparse grid, skipping over empty tiles at once. */
+static void add_sparse_grid_nodes(VolumeMeshBuilder &builder,
+                                  const VoxelAttributeGrid &voxel_grid,
+                                  const int3 &resolution,
+                                  float isovalue)
+{
+  const int channels = voxel_grid.channels;
+  const int tiles_x = tex_sparse_num_tiles(resolution.x);
+  const int tiles_y = tex_sparse_num_tiles(resolution.y);
+  const int tiles_z = tex_sparse_num_tiles(resolution.z);
+  const uint *tile_index = (const uint *)voxel_grid.data;
+  const float *tiles = voxel_grid.data + tex_sparse_header_size(tiles_x * tiles_y * tiles_z);
+  const bool empty_active = (0.0f >= isovalue);
+
+  for (int tz = 0; tz < tiles_z; tz++) {
+    for (int ty = 0; ty < tiles_y; ty++) {
+      for (int tx = 0; tx < tiles_x; tx++) {
+        const uint tile = tile_index[tx + tiles_x * (ty + tiles_y * tz)];
+        if (tile == 0 && !empty_active) {
+          continue;
+        }
+
+        const float *tile_data = tiles + (size_t)tile * TEX_SPARSE_TILE_VOXELS * channels;
+        const int x_start = tx * TEX_SPARSE_TILE_SIZE;
+        const int y_start = ty * TEX_SPARSE_TILE_SIZE;
+        const int z_start = tz * TEX_SPARSE_TILE_SIZE;
+        const int x_end = min(x_start + TEX_SPARSE_TILE_SIZE, resolution.x);
+        const int y_end = min(y_start + TEX_SPARSE_TILE_SIZE, resolution.y);
+        const int z_end = min(z_start + TEX_SPARSE_TILE_SIZE, resolution.z);
+
+        for (int z = z_start; z < z_end; ++z) {
+          for (int y = y_start; y < y_end; ++y) {
+            for (int x = x_start; x < x_end; ++x) {
+              const int voxel = (x - x_start) +
+                                TEX_SPARSE_TILE_SIZE *
+                                    ((y - y_start) + TEX_SPARSE_TILE_SIZE * (z - z_start));
+              if (voxel_active(tile_data + voxel * channels, channels, isovalue)) {
+                builder.add_node_with_padding(x, y, z);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 void MeshManager::create_volume_mesh(Scene *scene, Mesh *mesh, Progress &progress)
 {
   string msg = string_printf("Computing Volume Mesh %s", mesh->name.c_str());
@@ -394,6 +453,14 @@ void MeshManager::create_volume_mesh(Scene *scene, Mesh *mesh, Progress &progres
     VoxelAttributeGrid voxel_grid;
     voxel_grid.data = static_cast<float *>(image_memory->host_pointer);
     voxel_grid.channels = image_memory->data_elements;
+    voxel_grid.sparse = false;
+
+    const ImageDataType type = (ImageDataType)kernel_tex_type(voxel->slot);
+    if (type == IMAGE_DATA_TYPE_FLOAT_SPARSE || type == IMAGE_DATA_TYPE_FLOAT4_SPARSE) {
+      voxel_grid.channels = (type == IMAGE_DATA_TYPE_FLOAT4_SPARSE) ? 4 : 1;
+      voxel_grid.sparse = true;
+    }
+
     voxel_grids.push_back(voxel_grid);
   }
 
@@ -447,20 +514,22 @@ void MeshManager::create_volume_mesh(Scene *scene, Mesh *mesh, Progress &progres
   VolumeMeshBuilder builder(&volume_params);
   const float isovalue = mesh->volume_isovalue;
 
-  for (int z = 0; z < resolution.z; ++z) {
-    for (int y = 0; y < resolution.y; ++y) {
-      for (int x = 0; x < resolution.x; ++x) {
-        size_t voxel_index = compute_voxel_index(resolution, x, y, z);
+  for (size_t i = 0; i < voxel_grids.size(); ++i) {
+    const VoxelAttributeGrid &voxel_grid = voxel_grids[i];
+    const int channels = voxel_grid.channels;
+
+    if (voxel_grid.sparse) {
+      add_sparse_grid_nodes(builder, voxel_grid, resolution, isovalue);
+      continue;
+    }
 
-        for (size_t i = 0; i < voxel_grids.size(); ++i) {
-          const VoxelAttributeGrid &voxel_grid = voxel_grids[i];
-          const int channels = voxel_grid.channels;
+    for (int z = 0; z < resolution.z; ++z) {
+      for (int y = 0; y < resolution.y; ++y) {
+        for (int x = 0; x < resolution.x; ++x) {
+          size_t voxel_index = compute_voxel_index(resolution, x, y, z);
 
-          for (int c = 0; c < channels; c++) {
-            if (voxel_grid.data[voxel_index * channels + c] >= isovalue) {
-              builder.add_node_with_padding(x, y, z);
-              break;
-            }
+          if (voxel_active(voxel_grid.data + voxel_index * channels, channels, isovalue)) {
+            builder.add_node_with_padding(x, y, z);
           }
         }
       }
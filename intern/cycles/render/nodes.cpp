@@ -266,6 +266,11 @@ NODE_DEFINE(ImageTextureNode)
   SOCKET_FLOAT(projection_blend, "Projection Blend", 0.0f);
 
   SOCKET_IN_POINT(vector, "Vector", make_float3(0.0f, 0.0f, 0.0f), SocketType::LINK_TEXTURE_UV);
+  /* Vector shifted by the ray differentials, linked when reading from the texture cache. */
+  SOCKET_IN_POINT(
+      vector_dx, "VectorDx", make_float3(0.0f, 0.0f, 0.0f), SocketType::SVM_INTERNAL);
+  SOCKET_IN_POINT(
+      vector_dy, "VectorDy", make_float3(0.0f, 0.0f, 0.0f), SocketType::SVM_INTERNAL);
 
   SOCKET_OUT_COLOR(color, "Color");
   SOCKET_OUT_FLOAT(alpha, "Alpha");
@@ -428,6 +433,27 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
       }
     }
 
+    /* Texture coordinate derivatives, only used by images in the texture cache. */
+    ShaderInput *vector_dx_in = input("VectorDx");
+    ShaderInput *vector_dy_in = input("VectorDy");
+    bool use_differentials = false;
+    if (projection != NODE_IMAGE_PROJ_BOX && vector_dx_in->link && vector_dy_in->link) {
+      foreach (int slot, slots) {
+        if (slot != -1 && kernel_tex_type(slot) == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+          use_differentials = true;
+          break;
+        }
+      }
+    }
+
+    int vector_dx_offset = SVM_STACK_INVALID;
+    int vector_dy_offset = SVM_STACK_INVALID;
+    if (use_differentials) {
+      vector_dx_offset = tex_mapping.compile_begin(compiler, vector_dx_in);
+      vector_dy_offset = tex_mapping.compile_begin(compiler, vector_dy_in);
+      flags |= NODE_IMAGE_USE_DIFFERENTIALS;
+    }
+
     if (projection != NODE_IMAGE_PROJ_BOX) {
       /* If there only is one image (a very common case), we encode it as a negative value. */
       int num_nodes;
@@ -446,6 +472,10 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
                                                flags),
                         projection);
 
+      if (use_differentials) {
+        compiler.add_node(vector_dx_offset, vector_dy_offset, 0, 0);
+      }
+
       if (num_nodes > 0) {
         for (int i = 0; i < num_nodes; i++) {
           int4 node;
@@ -474,6 +504,10 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
                         __float_as_int(projection_blend));
     }
 
+    if (use_differentials) {
+      tex_mapping.compile_end(compiler, vector_dx_in, vector_dx_offset);
+      tex_mapping.compile_end(compiler, vector_dy_in, vector_dy_offset);
+    }
     tex_mapping.compile_end(compiler, vector_in, vector_offset);
   }
   else {
@@ -81,6 +81,10 @@ class ImageSlotTextureNode : public TextureNode {
   }
   ~ImageSlotTextureNode();
   void add_image_user() const;
+  bool has_scene_resources()
+  {
+    return true;
+  }
   ImageManager *image_manager;
   vector<int> slots;
 };
@@ -113,6 +117,8 @@ class ImageTextureNode : public ImageSlotTextureNode {
   float projection_blend;
   bool animated;
   float3 vector;
+  float3 vector_dx;
+  float3 vector_dy;
   ccl::vector<int> tiles;
 
   /* Runtime. */
@@ -197,6 +203,10 @@ class OutputAOVNode : public ShaderNode {
  public:
   SHADER_NODE_CLASS(OutputAOVNode)
   virtual void simplify_settings(Scene *scene);
+  bool has_scene_resources()
+  {
+    return true;
+  }
 
   float value;
   float3 color;
@@ -362,6 +372,10 @@ class PointDensityTextureNode : public ShaderNode {
   {
     return true;
   }
+  bool has_scene_resources()
+  {
+    return true;
+  }
 
   void add_image();
 
@@ -394,6 +408,10 @@ class IESLightNode : public TextureNode {
   {
     return NODE_GROUP_LEVEL_2;
   }
+  bool has_scene_resources()
+  {
+    return true;
+  }
 
   ustring filename;
   ustring ies;
@@ -1496,6 +1514,10 @@ class OSLNode : public ShaderNode {
   {
     return true;
   }
+  bool has_scene_resources()
+  {
+    return true;
+  }
 
   virtual bool equals(const ShaderNode & /*other*/)
   {
@@ -656,7 +656,8 @@ void ObjectManager::device_update(Device *device,
 
   /* prepare for static BVH building */
   /* todo: do before to support getting object level coords? */
-  if (scene->params.bvh_type == SceneParams::BVH_STATIC) {
+  /* Meshes with applied transforms are part of the top level BVH and can not be refitted. */
+  if (scene->params.bvh_type == SceneParams::BVH_STATIC && !scene->params.use_bvh_refit) {
     progress.set_status("Updating Objects", "Applying Static Transformations");
     apply_static_transforms(dscene, scene, progress);
   }
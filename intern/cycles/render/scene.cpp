@@ -70,6 +70,8 @@ DeviceScene::DeviceScene(Device *device)
       attributes_float3(device, "__attributes_float3", MEM_TEXTURE),
       attributes_uchar4(device, "__attributes_uchar4", MEM_TEXTURE),
       light_distribution(device, "__light_distribution", MEM_TEXTURE),
+      light_tree_nodes(device, "__light_tree_nodes", MEM_TEXTURE),
+      light_tree_index(device, "__light_tree_index", MEM_TEXTURE),
       lights(device, "__lights", MEM_TEXTURE),
       light_background_marginal_cdf(device, "__light_background_marginal_cdf", MEM_TEXTURE),
       light_background_conditional_cdf(device, "__light_background_conditional_cdf", MEM_TEXTURE),
@@ -98,6 +100,7 @@ Scene::Scene(const SceneParams &params_, Device *device)
   object_manager = new ObjectManager();
   integrator = new Integrator();
   image_manager = new ImageManager(device->info);
+  image_manager->set_texture_cache_params(params.texture_cache);
   particle_system_manager = new ParticleSystemManager();
   curve_system_manager = new CurveSystemManager();
   bake_manager = new BakeManager();
@@ -104,6 +104,8 @@ class DeviceScene {
 
   /* lights */
   device_vector<KernelLightDistribution> light_distribution;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<uint> light_tree_index;
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
@@ -168,7 +170,11 @@ class SceneParams {
   bool use_bvh_unaligned_nodes;
   int num_bvh_time_steps;
   bool persistent_data;
+  /* Keep the BVH of every mesh between renders with persistent data and refit it when only
+   * vertex positions changed, so only the top level BVH over instances is built again. */
+  bool use_bvh_refit;
   int texture_limit;
+  TextureCacheParams texture_cache;
 
   bool background;
 
@@ -181,6 +187,7 @@ class SceneParams {
     use_bvh_unaligned_nodes = true;
     num_bvh_time_steps = 0;
     persistent_data = false;
+    use_bvh_refit = false;
     texture_limit = 0;
     background = true;
   }
@@ -192,7 +199,9 @@ class SceneParams {
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
-             persistent_data == params.persistent_data && texture_limit == params.texture_limit);
+             persistent_data == params.persistent_data &&
+             use_bvh_refit == params.use_bvh_refit && texture_limit == params.texture_limit &&
+             !texture_cache.modified(params.texture_cache));
   }
 };
 
@@ -1024,6 +1024,16 @@ void Session::render()
   task.update_progress_sample = function_bind(&Progress::add_samples, &this->progress, _1, _2);
   task.need_finish_queue = params.progressive_refine;
   task.integrator_branched = scene->integrator->method == Integrator::BRANCHED_PATH;
+  task.adaptive_sampling.use = Pass::contains(scene->film->passes, PASS_ADAPTIVE_AUX_BUFFER);
+  if (task.adaptive_sampling.use) {
+    /* Without an explicit minimum, scale it with the sample count so that sparse features
+     * are found before any pixel is allowed to stop. */
+    int min_samples = scene->integrator->adaptive_min_samples;
+    if (min_samples == 0) {
+      min_samples = max(4, (int)sqrtf((float)scene->integrator->aa_samples));
+    }
+    task.adaptive_sampling.min_samples = min_samples;
+  }
   task.requested_tile_size = params.tile_size;
   task.passes_size = tile_manager.params.get_passes_size();
 
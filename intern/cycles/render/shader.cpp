@@ -29,6 +29,7 @@
 #include "render/scene.h"
 #include "render/shader.h"
 #include "render/svm.h"
+#include "render/svm_cache.h"
 #include "render/tables.h"
 
 #include "util/util_foreach.h"
@@ -45,6 +46,10 @@ thread_mutex ShaderManager::lookup_table_mutex;
 vector<float> ShaderManager::beckmann_table;
 bool ShaderManager::beckmann_table_ready = false;
 
+ShaderManager::AttributeIDMap ShaderManager::unique_attribute_id;
+uint ShaderManager::next_attribute_id = (uint)ATTR_STD_NUM;
+thread_spin_lock ShaderManager::attribute_lock_;
+
 /* Beckmann sampling precomputed table, see bsdf_microfacet.h */
 
 /* 2D slope distribution (alpha = 1.0) */
@@ -276,6 +281,7 @@ void Shader::set_graph(ShaderGraph *graph_)
    * are connected but proxy nodes should not count */
   if (graph_) {
     graph_->remove_proxy_nodes();
+    graph_->compute_content_hash();
 
     if (displacement_method != DISPLACE_BUMP) {
       graph_->compute_displacement_hash();
@@ -445,11 +451,30 @@ uint ShaderManager::get_attribute_id(ustring name)
   if (it != unique_attribute_id.end())
     return it->second;
 
-  uint id = (uint)ATTR_STD_NUM + unique_attribute_id.size();
+  uint id = next_attribute_id++;
   unique_attribute_id[name] = id;
   return id;
 }
 
+bool ShaderManager::claim_attribute_id(ustring name, uint id)
+{
+  thread_scoped_spin_lock lock(attribute_lock_);
+
+  AttributeIDMap::iterator it = unique_attribute_id.find(name);
+
+  if (it != unique_attribute_id.end())
+    return it->second == id;
+
+  /* Ids below the next one may have been skipped by an earlier claim, but are considered taken
+   * to keep this simple. */
+  if (id < next_attribute_id)
+    return false;
+
+  next_attribute_id = id + 1;
+  unique_attribute_id[name] = id;
+  return true;
+}
+
 uint ShaderManager::get_attribute_id(AttributeStandard std)
 {
   return (uint)std;
@@ -730,6 +755,7 @@ void ShaderManager::free_memory()
 #endif
 
   ColorSpaceManager::free_memory();
+  SVMShaderCache::free_memory();
 }
 
 float ShaderManager::linear_rgb_to_gray(float3 c)
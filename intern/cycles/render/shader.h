@@ -187,6 +187,9 @@ class ShaderManager {
   /* get globally unique id for a type of attribute */
   uint get_attribute_id(ustring name);
   uint get_attribute_id(AttributeStandard std);
+  /* Give an attribute the id it had when a cached shader was compiled. Returns false if either
+   * the name or the id are already used for something else. */
+  bool claim_attribute_id(ustring name, uint id);
 
   /* get shader id for mesh faces */
   int get_shader_id(Shader *shader, bool smooth = false);
@@ -207,8 +210,12 @@ class ShaderManager {
  protected:
   ShaderManager();
 
+  /* Attribute ids are shared by all scenes in the process, so that compiled shaders stay valid
+   * across renders. */
   typedef unordered_map<ustring, uint, ustringHash> AttributeIDMap;
-  AttributeIDMap unique_attribute_id;
+  static AttributeIDMap unique_attribute_id;
+  static uint next_attribute_id;
+  static thread_spin_lock attribute_lock_;
 
   static thread_mutex lookup_table_mutex;
   static vector<float> beckmann_table;
@@ -219,8 +226,6 @@ class ShaderManager {
   void get_requested_graph_features(ShaderGraph *graph,
                                     DeviceRequestedFeatures *requested_features);
 
-  thread_spin_lock attribute_lock_;
-
   float3 xyz_to_r;
   float3 xyz_to_g;
   float3 xyz_to_b;
@@ -16,17 +16,21 @@
 
 #include "device/device.h"
 #include "render/graph.h"
+#include "render/integrator.h"
 #include "render/light.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/scene.h"
 #include "render/shader.h"
 #include "render/svm.h"
+#include "render/svm_cache.h"
 
 #include "util/util_logging.h"
 #include "util/util_foreach.h"
+#include "util/util_md5.h"
 #include "util/util_progress.h"
 #include "util/util_task.h"
+#include "util/util_version.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -54,16 +58,73 @@ void SVMShaderManager::device_update_shader(Scene *scene,
   }
   assert(shader->graph);
 
+  const bool background = (shader == scene->default_background);
+  const string key = shader_cache_key(scene, shader, background);
+
+  SVMShaderCacheEntry entry;
+  if (!key.empty() && SVMShaderCache::find(key, &entry)) {
+    /* Attribute ids are baked into the nodes, so they must match the ones of this scene. */
+    bool valid = true;
+    for (size_t i = 0; i < entry.attribute_names.size() && valid; i++) {
+      valid = claim_attribute_id(entry.attribute_names[i], entry.attribute_ids[i]);
+    }
+
+    if (valid) {
+      entry.restore_flags(shader);
+      svm_nodes->steal_data(entry.svm_nodes);
+      VLOG(2) << "Using cached SVM nodes for shader " << shader->name << ".";
+      return;
+    }
+  }
+
   svm_nodes->push_back_slow(make_int4(NODE_SHADER_JUMP, 0, 0, 0));
 
   SVMCompiler::Summary summary;
   SVMCompiler compiler(scene);
-  compiler.background = (shader == scene->default_background);
+  compiler.background = background;
   compiler.compile(shader, *svm_nodes, 0, &summary);
 
   VLOG(2) << "Compilation summary:\n"
           << "Shader name: " << shader->name << "\n"
           << summary.full_report();
+
+  if (!key.empty()) {
+    entry.svm_nodes = *svm_nodes;
+    entry.store_flags(shader);
+    entry.attribute_names = compiler.attribute_names;
+    entry.attribute_ids = compiler.attribute_ids;
+    SVMShaderCache::add(key, entry);
+  }
+}
+
+string SVMShaderManager::shader_cache_key(Scene *scene, Shader *shader, bool background)
+{
+  /* Graphs adding images or other data to the scene while compiling are not cached. */
+  if (shader->graph->content_hash.empty()) {
+    return "";
+  }
+
+  MD5Hash md5;
+  md5.append(CYCLES_VERSION_STRING);
+  md5.append(shader->graph->content_hash);
+  shader->hash(md5);
+
+  /* Everything else that affects graph optimization or node generation. */
+  const int state[2] = {shader->used, background};
+  md5.append((const uint8_t *)state, sizeof(state));
+  md5.append((const uint8_t *)&rgb_to_y, sizeof(rgb_to_y));
+
+  /* Integrator settings read by nodes when simplifying the graph. Nodes are queried here
+   * rather than using the shader flag, which is only known after compiling. */
+  foreach (ShaderNode *node, shader->graph->nodes) {
+    if (node->has_integrator_dependency()) {
+      const int filter_glossy = (scene->integrator->filter_glossy == 0.0f);
+      md5.append((const uint8_t *)&filter_glossy, sizeof(filter_glossy));
+      break;
+    }
+  }
+
+  return md5.get_hex();
 }
 
 void SVMShaderManager::device_update(Device *device,
@@ -403,7 +464,10 @@ void SVMCompiler::add_node(const float4 &f)
 
 uint SVMCompiler::attribute(ustring name)
 {
-  return scene->shader_manager->get_attribute_id(name);
+  uint id = scene->shader_manager->get_attribute_id(name);
+  attribute_names.push_back(name);
+  attribute_ids.push_back(id);
+  return id;
 }
 
 uint SVMCompiler::attribute(AttributeStandard std)
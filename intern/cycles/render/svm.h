@@ -54,6 +54,9 @@ class SVMShaderManager : public ShaderManager {
                             Shader *shader,
                             Progress *progress,
                             array<int4> *svm_nodes);
+
+  /* Key to look up the compiled shader in the cache, empty if it can not be cached. */
+  string shader_cache_key(Scene *scene, Shader *shader, bool background);
 };
 
 /* Graph Compiler */
@@ -127,6 +130,10 @@ class SVMCompiler {
   ShaderGraph *current_graph;
   bool background;
 
+  /* Custom attributes used by the compiled nodes, with their ids. */
+  vector<ustring> attribute_names;
+  vector<uint> attribute_ids;
+
  protected:
   /* stack */
   struct Stack {
@@ -0,0 +1,264 @@
+/*
+ * Copyright 2011-2019 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/svm_cache.h"
+#include "render/shader.h"
+
+#include "util/util_logging.h"
+#include "util/util_path.h"
+
+#include <OpenImageIO/filesystem.h>
+
+CCL_NAMESPACE_BEGIN
+
+/* Maximum number of shaders kept in memory. */
+static const size_t SVM_CACHE_MAX_ENTRIES = 8192;
+
+/* Written at the start of files on disk, increase when changing the file layout. */
+static const uint SVM_CACHE_FILE_MAGIC = 0x434d5653; /* "SVMC" */
+static const uint SVM_CACHE_FILE_VERSION = 1;
+
+enum SVMShaderCacheFlag {
+  SVM_CACHE_HAS_SURFACE = (1 << 0),
+  SVM_CACHE_HAS_SURFACE_EMISSION = (1 << 1),
+  SVM_CACHE_HAS_SURFACE_TRANSPARENT = (1 << 2),
+  SVM_CACHE_HAS_SURFACE_BSSRDF = (1 << 3),
+  SVM_CACHE_HAS_BUMP = (1 << 4),
+  SVM_CACHE_HAS_BSSRDF_BUMP = (1 << 5),
+  SVM_CACHE_HAS_VOLUME = (1 << 6),
+  SVM_CACHE_HAS_DISPLACEMENT = (1 << 7),
+  SVM_CACHE_HAS_SURFACE_SPATIAL_VARYING = (1 << 8),
+  SVM_CACHE_HAS_VOLUME_SPATIAL_VARYING = (1 << 9),
+  SVM_CACHE_HAS_OBJECT_DEPENDENCY = (1 << 10),
+  SVM_CACHE_HAS_ATTRIBUTE_DEPENDENCY = (1 << 11),
+  SVM_CACHE_HAS_INTEGRATOR_DEPENDENCY = (1 << 12),
+};
+
+/* Cache Entry */
+
+SVMShaderCacheEntry::SVMShaderCacheEntry() : flags(0)
+{
+}
+
+void SVMShaderCacheEntry::store_flags(const Shader *shader)
+{
+  flags = 0;
+  flags |= (shader->has_surface) ? SVM_CACHE_HAS_SURFACE : 0;
+  flags |= (shader->has_surface_emission) ? SVM_CACHE_HAS_SURFACE_EMISSION : 0;
+  flags |= (shader->has_surface_transparent) ? SVM_CACHE_HAS_SURFACE_TRANSPARENT : 0;
+  flags |= (shader->has_surface_bssrdf) ? SVM_CACHE_HAS_SURFACE_BSSRDF : 0;
+  flags |= (shader->has_bump) ? SVM_CACHE_HAS_BUMP : 0;
+  flags |= (shader->has_bssrdf_bump) ? SVM_CACHE_HAS_BSSRDF_BUMP : 0;
+  flags |= (shader->has_volume) ? SVM_CACHE_HAS_VOLUME : 0;
+  flags |= (shader->has_displacement) ? SVM_CACHE_HAS_DISPLACEMENT : 0;
+  flags |= (shader->has_surface_spatial_varying) ? SVM_CACHE_HAS_SURFACE_SPATIAL_VARYING : 0;
+  flags |= (shader->has_volume_spatial_varying) ? SVM_CACHE_HAS_VOLUME_SPATIAL_VARYING : 0;
+  flags |= (shader->has_object_dependency) ? SVM_CACHE_HAS_OBJECT_DEPENDENCY : 0;
+  flags |= (shader->has_attribute_dependency) ? SVM_CACHE_HAS_ATTRIBUTE_DEPENDENCY : 0;
+  flags |= (shader->has_integrator_dependency) ? SVM_CACHE_HAS_INTEGRATOR_DEPENDENCY : 0;
+}
+
+void SVMShaderCacheEntry::restore_flags(Shader *shader) const
+{
+  shader->has_surface = (flags & SVM_CACHE_HAS_SURFACE) != 0;
+  shader->has_surface_emission = (flags & SVM_CACHE_HAS_SURFACE_EMISSION) != 0;
+  shader->has_surface_transparent = (flags & SVM_CACHE_HAS_SURFACE_TRANSPARENT) != 0;
+  shader->has_surface_bssrdf = (flags & SVM_CACHE_HAS_SURFACE_BSSRDF) != 0;
+  shader->has_bump = (flags & SVM_CACHE_HAS_BUMP) != 0;
+  shader->has_bssrdf_bump = (flags & SVM_CACHE_HAS_BSSRDF_BUMP) != 0;
+  shader->has_volume = (flags & SVM_CACHE_HAS_VOLUME) != 0;
+  shader->has_displacement = (flags & SVM_CACHE_HAS_DISPLACEMENT) != 0;
+  shader->has_surface_spatial_varying = (flags & SVM_CACHE_HAS_SURFACE_SPATIAL_VARYING) != 0;
+  shader->has_volume_spatial_varying = (flags & SVM_CACHE_HAS_VOLUME_SPATIAL_VARYING) != 0;
+  shader->has_object_dependency = (flags & SVM_CACHE_HAS_OBJECT_DEPENDENCY) != 0;
+  shader->has_attribute_dependency = (flags & SVM_CACHE_HAS_ATTRIBUTE_DEPENDENCY) != 0;
+  shader->has_integrator_dependency = (flags & SVM_CACHE_HAS_INTEGRATOR_DEPENDENCY) != 0;
+}
+
+/* Disk Storage */
+
+static void write_data(vector<uint8_t> &binary, const void *data, size_t size)
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+  binary.insert(binary.end(), bytes, bytes + size);
+}
+
+static void write_uint(vector<uint8_t> &binary, uint value)
+{
+  write_data(binary, &value, sizeof(value));
+}
+
+static bool read_data(const vector<uint8_t> &binary, size_t &offset, void *data, size_t size)
+{
+  if (offset + size > binary.size()) {
+    return false;
+  }
+  if (size > 0) {
+    memcpy(data, &binary[offset], size);
+  }
+  offset += size;
+  return true;
+}
+
+static bool read_uint(const vector<uint8_t> &binary, size_t &offset, uint *value)
+{
+  return read_data(binary, offset, value, sizeof(*value));
+}
+
+/* Shader Cache */
+
+SVMShaderCache::EntryMap SVMShaderCache::entries;
+deque<string> SVMShaderCache::entries_order;
+thread_mutex SVMShaderCache::entries_mutex;
+
+string SVMShaderCache::disk_filepath(const string &key)
+{
+  static const char *cache_path = getenv("CYCLES_SVM_CACHE_PATH");
+  if (cache_path == NULL || cache_path[0] == '\0') {
+    return "";
+  }
+
+  return path_join(cache_path, key + ".svm");
+}
+
+bool SVMShaderCache::read_entry(const string &filepath, SVMShaderCacheEntry *entry)
+{
+  vector<uint8_t> binary;
+  if (!path_exists(filepath) || !path_read_binary(filepath, binary)) {
+    return false;
+  }
+
+  size_t offset = 0;
+  uint magic, version, num_nodes, num_attributes;
+  if (!read_uint(binary, offset, &magic) || magic != SVM_CACHE_FILE_MAGIC ||
+      !read_uint(binary, offset, &version) || version != SVM_CACHE_FILE_VERSION) {
+    return false;
+  }
+
+  if (!read_uint(binary, offset, &entry->flags) || !read_uint(binary, offset, &num_nodes) ||
+      num_nodes == 0 || offset + num_nodes * sizeof(int4) > binary.size()) {
+    return false;
+  }
+
+  entry->svm_nodes.resize(num_nodes);
+  read_data(binary, offset, entry->svm_nodes.data(), num_nodes * sizeof(int4));
+
+  if (!read_uint(binary, offset, &num_attributes)) {
+    return false;
+  }
+
+  entry->attribute_names.clear();
+  entry->attribute_ids.clear();
+  for (uint i = 0; i < num_attributes; i++) {
+    uint id, name_length;
+    if (!read_uint(binary, offset, &id) || !read_uint(binary, offset, &name_length) ||
+        offset + name_length > binary.size()) {
+      return false;
+    }
+
+    string name((const char *)&binary[0] + offset, name_length);
+    offset += name_length;
+
+    entry->attribute_names.push_back(ustring(name));
+    entry->attribute_ids.push_back(id);
+  }
+
+  return true;
+}
+
+void SVMShaderCache::write_entry(const string &filepath, const SVMShaderCacheEntry &entry)
+{
+  vector<uint8_t> binary;
+  write_uint(binary, SVM_CACHE_FILE_MAGIC);
+  write_uint(binary, SVM_CACHE_FILE_VERSION);
+  write_uint(binary, entry.flags);
+  write_uint(binary, entry.svm_nodes.size());
+  write_data(binary, entry.svm_nodes.data(), entry.svm_nodes.size() * sizeof(int4));
+  write_uint(binary, entry.attribute_names.size());
+  for (size_t i = 0; i < entry.attribute_names.size(); i++) {
+    const string &name = entry.attribute_names[i].string();
+    write_uint(binary, entry.attribute_ids[i]);
+    write_uint(binary, name.size());
+    write_data(binary, name.data(), name.size());
+  }
+
+  /* Write to a temporary file first, other processes may be reading the same entry. */
+  path_create_directories(filepath);
+  string tmp_filepath = filepath + ".tmp-" + OIIO::Filesystem::unique_path();
+
+  string error;
+  if (!path_write_binary(tmp_filepath, binary) ||
+      !OIIO::Filesystem::rename(tmp_filepath, filepath, error)) {
+    VLOG(1) << "Failed to write shader cache file " << filepath << ": " << error;
+    path_remove(tmp_filepath);
+  }
+}
+
+void SVMShaderCache::add_memory_entry(const string &key, const SVMShaderCacheEntry &entry)
+{
+  thread_scoped_lock lock(entries_mutex);
+
+  if (entries.find(key) != entries.end()) {
+    return;
+  }
+
+  while (entries_order.size() >= SVM_CACHE_MAX_ENTRIES) {
+    entries.erase(entries_order.front());
+    entries_order.pop_front();
+  }
+
+  entries[key] = entry;
+  entries_order.push_back(key);
+}
+
+bool SVMShaderCache::find(const string &key, SVMShaderCacheEntry *entry)
+{
+  {
+    thread_scoped_lock lock(entries_mutex);
+    EntryMap::const_iterator it = entries.find(key);
+    if (it != entries.end()) {
+      *entry = it->second;
+      return true;
+    }
+  }
+
+  const string filepath = disk_filepath(key);
+  if (filepath.empty() || !read_entry(filepath, entry)) {
+    return false;
+  }
+
+  add_memory_entry(key, *entry);
+  return true;
+}
+
+void SVMShaderCache::add(const string &key, const SVMShaderCacheEntry &entry)
+{
+  add_memory_entry(key, entry);
+
+  const string filepath = disk_filepath(key);
+  if (!filepath.empty()) {
+    write_entry(filepath, entry);
+  }
+}
+
+void SVMShaderCache::free_memory()
+{
+  thread_scoped_lock lock(entries_mutex);
+  map_free_memory(entries);
+  entries_order.clear();
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2011-2019 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SVM_CACHE_H__
+#define __SVM_CACHE_H__
+
+#include "util/util_array.h"
+#include "util/util_deque.h"
+#include "util/util_map.h"
+#include "util/util_param.h"
+#include "util/util_string.h"
+#include "util/util_thread.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class Shader;
+
+/* Compiled SVM nodes of a shader, along with everything else the compiler derives from the
+ * graph, so that compiling an identical graph again can be skipped. */
+
+class SVMShaderCacheEntry {
+ public:
+  SVMShaderCacheEntry();
+
+  /* Copy the shader flags set by the compiler to and from the entry. */
+  void store_flags(const Shader *shader);
+  void restore_flags(Shader *shader) const;
+
+  /* Nodes of the shader, starting with its local jump node. */
+  array<int4> svm_nodes;
+  /* Shader flags set by the compiler, one bit each. */
+  uint flags;
+  /* Custom attributes used by the nodes, with the ids they had when compiling. */
+  vector<ustring> attribute_names;
+  vector<uint> attribute_ids;
+};
+
+/* Shader Cache
+ *
+ * Entries are kept for the lifetime of the process, so they survive between frames and renders.
+ * If the CYCLES_SVM_CACHE_PATH environment variable is set, they are also written to that
+ * directory, so that other processes rendering the same scene can read them back. */
+
+class SVMShaderCache {
+ public:
+  static bool find(const string &key, SVMShaderCacheEntry *entry);
+  static void add(const string &key, const SVMShaderCacheEntry &entry);
+  static void free_memory();
+
+ protected:
+  static string disk_filepath(const string &key);
+  static bool read_entry(const string &filepath, SVMShaderCacheEntry *entry);
+  static void write_entry(const string &filepath, const SVMShaderCacheEntry &entry);
+  static void add_memory_entry(const string &key, const SVMShaderCacheEntry &entry);
+
+  typedef unordered_map<string, SVMShaderCacheEntry> EntryMap;
+  static EntryMap entries;
+  /* Keys in the order they were added, the oldest entries are removed first. */
+  static deque<string> entries_order;
+  static thread_mutex entries_mutex;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __SVM_CACHE_H__ */
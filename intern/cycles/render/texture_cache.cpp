@@ -0,0 +1,255 @@
+/*
+ * Copyright 2011-2019 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/texture_cache.h"
+
+#include "util/util_logging.h"
+#include "util/util_murmurhash.h"
+#include "util/util_path.h"
+#include "util/util_progress.h"
+#include "util/util_unique_ptr.h"
+
+#include <OpenImageIO/filesystem.h>
+#include <OpenImageIO/imagebufalgo.h>
+#include <OpenImageIO/imageio.h>
+#include <OpenImageIO/texture.h>
+
+#include <sstream>
+
+OIIO_NAMESPACE_USING
+
+CCL_NAMESPACE_BEGIN
+
+/* Kernel Lookup */
+
+static bool texture_cache_lookup(const TextureCacheHandle *handle,
+                                 const TextureInfo &info,
+                                 float s,
+                                 float t,
+                                 float dsdx,
+                                 float dtdx,
+                                 float dsdy,
+                                 float dtdy,
+                                 float *result)
+{
+  TextureSystem *ts = (TextureSystem *)handle->texture_system;
+  TextureSystem::TextureHandle *th = (TextureSystem::TextureHandle *)handle->texture_handle;
+
+  TextureOpt options;
+  switch (info.interpolation) {
+    case INTERPOLATION_CLOSEST:
+      options.interpmode = TextureOpt::InterpClosest;
+      break;
+    case INTERPOLATION_LINEAR:
+      options.interpmode = TextureOpt::InterpBilinear;
+      break;
+    case INTERPOLATION_CUBIC:
+      options.interpmode = TextureOpt::InterpBicubic;
+      break;
+    default:
+      options.interpmode = TextureOpt::InterpSmartBicubic;
+      break;
+  }
+
+  switch (info.extension) {
+    case EXTENSION_EXTEND:
+      options.swrap = options.twrap = TextureOpt::WrapClamp;
+      break;
+    case EXTENSION_CLIP:
+      options.swrap = options.twrap = TextureOpt::WrapBlack;
+      break;
+    default:
+      options.swrap = options.twrap = TextureOpt::WrapPeriodic;
+      break;
+  }
+
+  /* Images without alpha are opaque. */
+  options.fill = 1.0f;
+
+  /* Cycles stores images bottom to top, OpenImageIO top to bottom. The texture system keeps
+   * per-thread data itself, so there is no need to pass it along. */
+  return ts->texture(th, NULL, options, s, 1.0f - t, dsdx, -dtdx, dsdy, -dtdy, 4, result);
+}
+
+/* Texture Cache */
+
+TextureCache::TextureCache(const TextureCacheParams &params_) : params(params_)
+{
+  TextureSystem *ts = TextureSystem::create(false);
+
+  ts->attribute("max_memory_MB", (float)params.cache_size);
+  /* Images that could not be converted are still read in tiles, with mipmaps generated on
+   * the fly. */
+  ts->attribute("autotile", params.tile_size);
+  ts->attribute("automip", 1);
+  ts->attribute("gray_to_rgb", 1);
+
+  texture_system = ts;
+}
+
+TextureCache::~TextureCache()
+{
+  TextureSystem::destroy((TextureSystem *)texture_system);
+}
+
+string TextureCache::converted_filepath(const string &filename) const
+{
+  string name = path_filename(filename);
+  const size_t extension = name.rfind('.');
+  if (extension != string::npos && extension > 0) {
+    name = name.substr(0, extension);
+  }
+
+  if (params.cache_path.empty()) {
+    return path_join(path_dirname(filename), name + ".tx");
+  }
+
+  /* Different directories may contain images with the same name. */
+  const uint32_t hash = util_murmur_hash3(filename.c_str(), filename.size(), 0);
+  return path_join(params.cache_path, string_printf("%s_%08x.tx", name.c_str(), hash));
+}
+
+thread_mutex *TextureCache::converted_file_mutex(const string &filepath)
+{
+  thread_scoped_lock lock(convert_mutexes_mutex);
+  unique_ptr<thread_mutex> &mutex = convert_mutexes[filepath];
+  if (!mutex) {
+    mutex.reset(new thread_mutex());
+  }
+  return mutex.get();
+}
+
+bool TextureCache::get_handle(const string &filename,
+                              TextureCacheHandle *handle,
+                              Progress *progress)
+{
+  TextureSystem *ts = (TextureSystem *)texture_system;
+  string filepath = filename;
+
+  if (params.auto_convert && !TextureConverter::is_tiled_mipmapped(filename)) {
+    TextureConverter converter;
+    converter.input = filename;
+    converter.output = converted_filepath(filename);
+    converter.tile_size = params.tile_size;
+
+    {
+      /* Several slots can use the same file with different settings. */
+      thread_scoped_lock lock(*converted_file_mutex(converter.output));
+      progress->set_status("Updating Images", "Converting " + path_filename(filename));
+
+      if (converter.run()) {
+        filepath = converter.output;
+      }
+      else {
+        VLOG(1) << "Failed to convert " << filename << " for the texture cache: "
+                << converter.error;
+      }
+    }
+  }
+
+  int exists = 0;
+  ts->get_texture_info(ustring(filepath), 0, ustring("exists"), TypeDesc::TypeInt, &exists);
+  if (!exists) {
+    return false;
+  }
+
+  handle->lookup = texture_cache_lookup;
+  handle->texture_system = ts;
+  handle->texture_handle = ts->get_texture_handle(ustring(filepath));
+
+  return (handle->texture_handle != NULL);
+}
+
+void TextureCache::invalidate(const string &filename)
+{
+  TextureSystem *ts = (TextureSystem *)texture_system;
+  ts->invalidate(ustring(filename));
+  if (params.auto_convert) {
+    ts->invalidate(ustring(converted_filepath(filename)));
+  }
+}
+
+/* Texture Converter */
+
+TextureConverter::TextureConverter() : tile_size(64), only_if_outdated(true)
+{
+}
+
+bool TextureConverter::is_tiled_mipmapped(const string &filepath)
+{
+  unique_ptr<ImageInput> in(ImageInput::create(filepath));
+  if (!in) {
+    return false;
+  }
+
+  ImageSpec spec;
+  if (!in->open(filepath, spec)) {
+    return false;
+  }
+
+  const bool tiled = (spec.tile_width > 0 && spec.tile_height > 0);
+  ImageSpec level_spec;
+  const bool mipmapped = in->seek_subimage(0, 1, level_spec);
+
+  in->close();
+
+  return tiled && mipmapped;
+}
+
+bool TextureConverter::run()
+{
+  if (!path_exists(input)) {
+    error = "Couldn't find file: " + input;
+    return false;
+  }
+
+  if (only_if_outdated && path_exists(output) &&
+      path_modified_time(output) >= path_modified_time(input)) {
+    return true;
+  }
+
+  path_create_directories(output);
+
+  /* Write to temporary file path, so renders never read a partially converted texture. */
+  string unique_name = ".convert-tmp-" + OIIO::Filesystem::unique_path();
+  string tmp_filepath = output + unique_name + ".tx";
+
+  ImageSpec config;
+  config.tile_width = tile_size;
+  config.tile_height = tile_size;
+  config.tile_depth = 1;
+
+  std::stringstream log;
+  bool ok = ImageBufAlgo::make_texture(
+      ImageBufAlgo::MakeTxTexture, input, tmp_filepath, config, &log);
+  if (!ok) {
+    error = "Failed to convert " + input + ": " + OIIO::geterror();
+  }
+
+  string rename_error;
+  if (ok && !OIIO::Filesystem::rename(tmp_filepath, output, rename_error)) {
+    error = "Failed to move converted texture to " + output + ": " + rename_error;
+    ok = false;
+  }
+
+  if (!ok) {
+    OIIO::Filesystem::remove(tmp_filepath);
+  }
+
+  return ok;
+}
+
+CCL_NAMESPACE_END
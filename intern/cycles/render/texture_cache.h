@@ -0,0 +1,114 @@
+/*
+ * Copyright 2011-2019 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TEXTURE_CACHE_H__
+#define __TEXTURE_CACHE_H__
+
+#include "util/util_map.h"
+#include "util/util_string.h"
+#include "util/util_texture.h"
+#include "util/util_thread.h"
+#include "util/util_unique_ptr.h"
+
+CCL_NAMESPACE_BEGIN
+
+class Progress;
+
+/* Settings of the on-demand texture cache. */
+
+class TextureCacheParams {
+ public:
+  /* Read image textures tile by tile while rendering instead of loading them fully. */
+  bool use_cache;
+  /* Maximum memory used by tiles in the cache, in megabytes. */
+  int cache_size;
+  /* Tile size for automatically converted textures. */
+  int tile_size;
+  /* Convert images that are not tiled and mipmapped before rendering. */
+  bool auto_convert;
+  /* Directory for converted textures, next to the original image if empty. */
+  string cache_path;
+
+  TextureCacheParams()
+      : use_cache(false), cache_size(1024), tile_size(64), auto_convert(true), cache_path("")
+  {
+  }
+
+  bool modified(const TextureCacheParams &params) const
+  {
+    return !(use_cache == params.use_cache && cache_size == params.cache_size &&
+             tile_size == params.tile_size && auto_convert == params.auto_convert &&
+             cache_path == params.cache_path);
+  }
+};
+
+/* Texture Cache
+ *
+ * Images are opened in an OpenImageIO texture system, which only keeps the tiles of the
+ * mipmap levels that are actually sampled in memory and evicts the least recently used ones
+ * when the memory budget is exceeded. */
+
+class TextureCache {
+ public:
+  explicit TextureCache(const TextureCacheParams &params);
+  ~TextureCache();
+
+  /* Fill in the handle for an image, converting it first if needed. Returns false if the
+   * image can not be read. */
+  bool get_handle(const string &filename, TextureCacheHandle *handle, Progress *progress);
+  void invalidate(const string &filename);
+
+  /* Filepath of the converted texture for an image. */
+  string converted_filepath(const string &filename) const;
+
+ protected:
+  TextureCacheParams params;
+  void *texture_system;
+
+  /* Converting a file is serialized per output file only, so different images convert in
+   * parallel while slots sharing a file wait for its single conversion. */
+  thread_mutex *converted_file_mutex(const string &filepath);
+  thread_mutex convert_mutexes_mutex;
+  map<string, unique_ptr<thread_mutex>> convert_mutexes;
+};
+
+/* Convert an image into a tiled and mipmapped texture, which the texture cache can read on
+ * demand. */
+
+class TextureConverter {
+ public:
+  TextureConverter();
+  bool run();
+
+  /* Check if a file is already tiled and mipmapped. */
+  static bool is_tiled_mipmapped(const string &filepath);
+
+  /* Error message after running, in case of failure. */
+  string error;
+
+  /* Image filepath to convert. */
+  string input;
+  /* Output filepath. */
+  string output;
+  /* Tile size in pixels. */
+  int tile_size;
+  /* Skip the conversion if the output is newer than the input. */
+  bool only_if_outdated;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __TEXTURE_CACHE_H__ */
@@ -32,7 +32,8 @@ DebugFlags::CPU::CPU()
       sse3(true),
       sse2(true),
       bvh_layout(BVH_LAYOUT_DEFAULT),
-      split_kernel(false)
+      split_kernel(false),
+      ray_stream(false)
 {
   reset();
 }
@@ -71,6 +72,7 @@ void DebugFlags::CPU::reset()
   }
 
   split_kernel = false;
+  ray_stream = (getenv("CYCLES_CPU_RAY_STREAM") != NULL);
 }
 
 DebugFlags::CUDA::CUDA() : adaptive_compile(false), split_kernel(false)
@@ -153,7 +155,8 @@ std::ostream &operator<<(std::ostream &os, DebugFlagsConstRef debug_flags)
      << "  SSE3       : " << string_from_bool(debug_flags.cpu.sse3) << "\n"
      << "  SSE2       : " << string_from_bool(debug_flags.cpu.sse2) << "\n"
      << "  BVH layout : " << bvh_layout_name(debug_flags.cpu.bvh_layout) << "\n"
-     << "  Split      : " << string_from_bool(debug_flags.cpu.split_kernel) << "\n";
+     << "  Split      : " << string_from_bool(debug_flags.cpu.split_kernel) << "\n"
+     << "  Ray stream : " << string_from_bool(debug_flags.cpu.ray_stream) << "\n";
 
   os << "CUDA flags:\n"
      << "  Adaptive Compile : " << string_from_bool(debug_flags.cuda.adaptive_compile) << "\n";
@@ -82,6 +82,9 @@ class DebugFlags {
 
     /* Whether split kernel is used */
     bool split_kernel;
+
+    /* Whether camera rays are traced together as streams. */
+    bool ray_stream;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
@@ -55,6 +55,9 @@ typedef enum ImageDataType {
   IMAGE_DATA_TYPE_HALF = 5,
   IMAGE_DATA_TYPE_USHORT4 = 6,
   IMAGE_DATA_TYPE_USHORT = 7,
+  IMAGE_DATA_TYPE_TEXTURE_CACHE = 8,
+  IMAGE_DATA_TYPE_FLOAT_SPARSE = 9,
+  IMAGE_DATA_TYPE_FLOAT4_SPARSE = 10,
 
   IMAGE_DATA_NUM_TYPES
 } ImageDataType;
@@ -71,8 +74,22 @@ typedef enum ImageAlphaType {
   IMAGE_ALPHA_NUM_TYPES,
 } ImageAlphaType;
 
-#define IMAGE_DATA_TYPE_SHIFT 3
-#define IMAGE_DATA_TYPE_MASK 0x7
+#define IMAGE_DATA_TYPE_SHIFT 4
+#define IMAGE_DATA_TYPE_MASK 0xF
+
+/* Sparse volumes, only supported on the CPU.
+ *
+ * Voxels are stored in tiles of TEX_SPARSE_TILE_SIZE^3, leaving out tiles where all voxels are
+ * zero. The data starts with the index of every tile as uint, padded to a multiple of four,
+ * followed by the voxels of the stored tiles. Tile 0 is all zeros and shared by all empty
+ * tiles. */
+#define TEX_SPARSE_TILE_SHIFT 3
+#define TEX_SPARSE_TILE_SIZE (1 << TEX_SPARSE_TILE_SHIFT)
+#define TEX_SPARSE_TILE_MASK (TEX_SPARSE_TILE_SIZE - 1)
+#define TEX_SPARSE_TILE_VOXELS (TEX_SPARSE_TILE_SIZE * TEX_SPARSE_TILE_SIZE * TEX_SPARSE_TILE_SIZE)
+
+#define tex_sparse_num_tiles(size) (((size) + TEX_SPARSE_TILE_MASK) >> TEX_SPARSE_TILE_SHIFT)
+#define tex_sparse_header_size(num_tiles) (((num_tiles) + 3) & ~3)
 
 /* Extension types for textures.
  *
@@ -99,6 +116,25 @@ typedef struct TextureInfo {
   uint width, height, depth;
 } TextureInfo;
 
+#ifndef __KERNEL_GPU__
+/* Image that is read on demand from the texture cache, stored in place of the pixel data of
+ * the texture. Only supported on the CPU. */
+typedef struct TextureCacheHandle {
+  /* Filtered lookup with texture coordinate derivatives, returns false on failure. */
+  bool (*lookup)(const struct TextureCacheHandle *handle,
+                 const TextureInfo &info,
+                 float s,
+                 float t,
+                 float dsdx,
+                 float dtdx,
+                 float dsdy,
+                 float dtdy,
+                 float *result);
+  void *texture_system;
+  void *texture_handle;
+} TextureCacheHandle;
+#endif
+
 CCL_NAMESPACE_END
 
 #endif /* __UTIL_TEXTURE_H__ */
@@ -195,6 +195,14 @@ const UserDef U_default = {
     .filebrowser_display_type = USER_TEMP_SPACE_DISPLAY_WINDOW,
     .viewport_aa = 8,
 
+    .sequencer_disk_cache_flag = 0,
+    .sequencer_disk_cache_compression = USER_SEQ_DISK_CACHE_COMPRESSION_LOW,
+    .sequencer_disk_cache_size_limit = 100,
+    .sequencer_disk_cache_dir = "",
+    .movie_disk_cache_flag = 0,
+    .movie_disk_cache_size_limit = 100,
+    .movie_disk_cache_dir = "",
+
     .walk_navigation =
         {
             .mouse_speed = 1,
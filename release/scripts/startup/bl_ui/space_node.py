@@ -635,6 +635,9 @@ class NODE_PT_quality(bpy.types.Panel):
         col.prop(tree, "use_opencl")
         col.prop(tree, "use_groupnode_buffer")
         col.prop(tree, "use_two_pass")
+        col.prop(tree, "use_area_execution")
+        col.prop(tree, "use_result_cache")
+        col.prop(tree, "use_half_buffers")
         col.prop(tree, "use_viewer_border")
         col.separator()
         col.prop(snode, "use_auto_render")
@@ -25,6 +25,7 @@ extern "C" {
 #endif
 
 struct Main;
+struct MemFile;
 struct MemFileUndoData;
 struct bContext;
 
@@ -32,7 +33,10 @@ struct bContext;
 
 struct MemFileUndoData *BKE_memfile_undo_encode(struct Main *bmain,
                                                 struct MemFileUndoData *mfu_prev);
-bool BKE_memfile_undo_decode(struct MemFileUndoData *mfu, struct bContext *C);
+bool BKE_memfile_undo_decode(struct MemFileUndoData *mfu,
+                             bool reuse_ids,
+                             const struct MemFile *memfile_identical,
+                             struct bContext *C);
 void BKE_memfile_undo_free(struct MemFileUndoData *mfu);
 
 #ifdef __cplusplus
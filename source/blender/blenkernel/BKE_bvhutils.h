@@ -35,7 +35,7 @@ struct MFace;
 struct MVert;
 struct Mesh;
 
-typedef struct LinkNode BVHCache;
+typedef struct BVHCache BVHCache;
 
 /**
  * Struct that stores basic information about a BVHTree built from a edit-mesh.
@@ -237,11 +237,14 @@ enum {
   BVHTREE_FROM_EM_VERTS,
   BVHTREE_FROM_EM_EDGES,
   BVHTREE_FROM_EM_LOOPTRI,
+
+  BVHTREE_MAX_ITEM,
 };
 
-bool bvhcache_find(const BVHCache *cache, int type, BVHTree **r_tree);
+bool bvhcache_find(BVHCache **cache_p, int type, BVHTree **r_tree, bool *r_locked);
+void bvhcache_unlock(BVHCache *cache, int type, bool lock_started);
 bool bvhcache_has_tree(const BVHCache *cache, const BVHTree *tree);
-void bvhcache_insert(BVHCache **cache_p, BVHTree *tree, int type);
+void bvhcache_insert(BVHCache *cache, BVHTree *tree, int type);
 void bvhcache_free(BVHCache **cache_p);
 
 #endif
@@ -89,4 +89,11 @@ void BKE_fluid_flow_behavior_set(struct Object *object,
                                  struct FluidFlowSettings *settings,
                                  int behavior);
 
+bool BKE_fluid_domain_grid_get_slices(struct FluidDomainSettings *mds,
+                                      const char *name,
+                                      int z_begin,
+                                      int z_end,
+                                      float *values,
+                                      size_t values_len);
+
 #endif /* __BKE_FLUID_H__ */
@@ -86,6 +86,10 @@ void BKE_sequence_iterator_end(SeqIterator *iter);
   } \
   ((void)0)
 
+/* Each prefetch worker evaluates its own copy of the scene, limit their amount to keep memory
+ * usage sane. */
+#define SEQ_PREFETCH_MAX_WORKERS 16
+
 typedef enum eSeqTaskId {
   SEQ_TASK_MAIN_RENDER,
   SEQ_TASK_PREFETCH_RENDER,
@@ -107,6 +111,8 @@ typedef struct SeqRenderData {
   int view_id;
   /* ID of task for asigning temp cache entries to particular task(thread, etc.) */
   eSeqTaskId task_id;
+  /* Index of prefetch worker, so temp cache entries of one worker are not freed by others. */
+  int worker_index;
 
   /* special case for OpenGL render */
   struct GPUOffScreen *gpu_offscreen;
@@ -331,10 +337,14 @@ bool BKE_sequencer_cache_put_if_possible(const SeqRenderData *context,
                                          struct ImBuf *nval,
                                          float cost);
 bool BKE_sequencer_cache_recycle_item(struct Scene *scene);
-void BKE_sequencer_cache_free_temp_cache(struct Scene *scene, short id, int cfra);
+void BKE_sequencer_cache_free_temp_cache(struct Scene *scene,
+                                         short id,
+                                         int worker_index,
+                                         int cfra);
 void BKE_sequencer_cache_destruct(struct Scene *scene);
 void BKE_sequencer_cache_cleanup_all(struct Main *bmain);
 void BKE_sequencer_cache_cleanup(struct Scene *scene);
+void BKE_sequencer_cache_cleanup_memory(struct Scene *scene);
 void BKE_sequencer_cache_cleanup_sequence(struct Scene *scene,
                                           struct Sequence *seq,
                                           struct Sequence *seq_changed,
@@ -48,6 +48,7 @@
 #include "BKE_context.h"
 #include "BKE_global.h"
 #include "BKE_main.h"
+#include "BKE_sequencer.h"
 
 #include "BLO_undofile.h"
 #include "BLO_readfile.h"
@@ -61,7 +62,16 @@
 
 #define UNDO_DISK 0
 
-bool BKE_memfile_undo_decode(MemFileUndoData *mfu, bContext *C)
+/**
+ * \param reuse_ids: Keep IDs of the current main which are unchanged in \a mfu.
+ * \param memfile_identical: The memfile that was written against the other one of the current
+ * main state and \a mfu, its chunks tell which IDs are identical in both.
+ * NULL when the current main was last written to \a mfu itself.
+ */
+bool BKE_memfile_undo_decode(MemFileUndoData *mfu,
+                             bool reuse_ids,
+                             const MemFile *memfile_identical,
+                             bContext *C)
 {
   Main *bmain = CTX_data_main(C);
   char mainstr[sizeof(bmain->name)];
@@ -76,8 +86,18 @@ bool BKE_memfile_undo_decode(MemFileUndoData *mfu, bContext *C)
     success = BKE_blendfile_read(C, mfu->filename, NULL, 0);
   }
   else {
-    success = BKE_blendfile_read_from_memfile(
-        C, &mfu->memfile, &(const struct BlendFileReadParams){0}, NULL);
+    /* Unchanged scenes are kept and changed ones are re-read at their old address,
+     * prefetch threads must not be reading them meanwhile. */
+    for (Scene *scene = bmain->scenes.first; scene; scene = scene->id.next) {
+      BKE_sequencer_prefetch_stop(scene);
+    }
+    success = BKE_blendfile_read_from_memfile(C,
+                                              &mfu->memfile,
+                                              &(const struct BlendFileReadParams){
+                                                  .undo_reuse_ids = reuse_ids,
+                                                  .undo_memfile_identical = memfile_identical,
+                                              },
+                                              NULL);
   }
 
   /* Restore, bmain has been re-allocated. */
@@ -116,6 +136,13 @@ MemFileUndoData *BKE_memfile_undo_encode(Main *bmain, MemFileUndoData *mfu_prev)
     BLI_strncpy(mfu->filename, filename, sizeof(mfu->filename));
   }
   else {
+    /* The IDs written now are the reference for edits until the next push. */
+    ID *id;
+    FOREACH_MAIN_ID_BEGIN (bmain, id) {
+      id->recalc_after_undo_push = 0;
+    }
+    FOREACH_MAIN_ID_END;
+
     MemFile *prevfile = (mfu_prev) ? &(mfu_prev->memfile) : NULL;
     /* success = */ /* UNUSED */ BLO_write_file_mem(bmain, prevfile, &mfu->memfile, G.fileflags);
     mfu->undo_size = mfu->memfile.size;
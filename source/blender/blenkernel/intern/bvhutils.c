@@ -30,7 +30,6 @@
 #include "DNA_meshdata_types.h"
 
 #include "BLI_utildefines.h"
-#include "BLI_linklist.h"
 #include "BLI_math.h"
 #include "BLI_threads.h"
 
@@ -41,7 +40,7 @@
 
 #include "MEM_guardedalloc.h"
 
-static ThreadRWMutex cache_rwlock = BLI_RWLOCK_INITIALIZER;
+#include "atomic_ops.h"
 
 /* -------------------------------------------------------------------- */
 /** \name Local Callbacks
@@ -523,24 +522,19 @@ BVHTree *bvhtree_from_editmesh_verts_ex(BVHTreeFromEditMesh *data,
   BVHTree *tree = NULL;
 
   if (bvh_cache) {
-    BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-    data->cached = bvhcache_find(*bvh_cache, bvh_cache_type, &data->tree);
-    BLI_rw_mutex_unlock(&cache_rwlock);
+    bool lock_started = false;
+    data->cached = bvhcache_find(bvh_cache, bvh_cache_type, &data->tree, &lock_started);
 
     if (data->cached == false) {
-      BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_WRITE);
-      data->cached = bvhcache_find(*bvh_cache, bvh_cache_type, &data->tree);
-      if (data->cached == false) {
-        tree = bvhtree_from_editmesh_verts_create_tree(
-            epsilon, tree_type, axis, em, verts_mask, verts_num_active);
-
-        /* Save on cache for later use */
-        /* printf("BVHTree built and saved on cache\n"); */
-        bvhcache_insert(bvh_cache, tree, bvh_cache_type);
-        data->cached = true;
-      }
-      BLI_rw_mutex_unlock(&cache_rwlock);
+      tree = bvhtree_from_editmesh_verts_create_tree(
+          epsilon, tree_type, axis, em, verts_mask, verts_num_active);
+
+      /* Save on cache for later use */
+      /* printf("BVHTree built and saved on cache\n"); */
+      bvhcache_insert(*bvh_cache, tree, bvh_cache_type);
+      data->cached = true;
     }
+    bvhcache_unlock(*bvh_cache, bvh_cache_type, lock_started);
   }
   else {
     tree = bvhtree_from_editmesh_verts_create_tree(
@@ -585,18 +579,10 @@ BVHTree *bvhtree_from_mesh_verts_ex(BVHTreeFromMesh *data,
                                     BVHCache **bvh_cache)
 {
   bool in_cache = false;
+  bool lock_started = false;
   BVHTree *tree = NULL;
   if (bvh_cache) {
-    BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-    in_cache = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-    BLI_rw_mutex_unlock(&cache_rwlock);
-    if (in_cache == false) {
-      BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_WRITE);
-      in_cache = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-      if (in_cache) {
-        BLI_rw_mutex_unlock(&cache_rwlock);
-      }
-    }
+    in_cache = bvhcache_find(bvh_cache, bvh_cache_type, &tree, &lock_started);
   }
 
   if (in_cache == false) {
@@ -606,8 +592,8 @@ BVHTree *bvhtree_from_mesh_verts_ex(BVHTreeFromMesh *data,
     if (bvh_cache) {
       /* Save on cache for later use */
       /* printf("BVHTree built and saved on cache\n"); */
-      bvhcache_insert(bvh_cache, tree, bvh_cache_type);
-      BLI_rw_mutex_unlock(&cache_rwlock);
+      bvhcache_insert(*bvh_cache, tree, bvh_cache_type);
+      bvhcache_unlock(*bvh_cache, bvh_cache_type, lock_started);
       in_cache = true;
     }
   }
@@ -740,24 +726,19 @@ BVHTree *bvhtree_from_editmesh_edges_ex(BVHTreeFromEditMesh *data,
   BVHTree *tree = NULL;
 
   if (bvh_cache) {
-    BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-    data->cached = bvhcache_find(*bvh_cache, bvh_cache_type, &data->tree);
-    BLI_rw_mutex_unlock(&cache_rwlock);
+    bool lock_started = false;
+    data->cached = bvhcache_find(bvh_cache, bvh_cache_type, &data->tree, &lock_started);
 
     if (data->cached == false) {
-      BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_WRITE);
-      data->cached = bvhcache_find(*bvh_cache, bvh_cache_type, &data->tree);
-      if (data->cached == false) {
-        tree = bvhtree_from_editmesh_edges_create_tree(
-            epsilon, tree_type, axis, em, edges_mask, edges_num_active);
-
-        /* Save on cache for later use */
-        /* printf("BVHTree built and saved on cache\n"); */
-        bvhcache_insert(bvh_cache, tree, bvh_cache_type);
-        data->cached = true;
-      }
-      BLI_rw_mutex_unlock(&cache_rwlock);
+      tree = bvhtree_from_editmesh_edges_create_tree(
+          epsilon, tree_type, axis, em, edges_mask, edges_num_active);
+
+      /* Save on cache for later use */
+      /* printf("BVHTree built and saved on cache\n"); */
+      bvhcache_insert(*bvh_cache, tree, bvh_cache_type);
+      data->cached = true;
     }
+    bvhcache_unlock(*bvh_cache, bvh_cache_type, lock_started);
   }
   else {
     tree = bvhtree_from_editmesh_edges_create_tree(
@@ -805,18 +786,10 @@ BVHTree *bvhtree_from_mesh_edges_ex(BVHTreeFromMesh *data,
                                     BVHCache **bvh_cache)
 {
   bool in_cache = false;
+  bool lock_started = false;
   BVHTree *tree = NULL;
   if (bvh_cache) {
-    BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-    in_cache = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-    BLI_rw_mutex_unlock(&cache_rwlock);
-    if (in_cache == false) {
-      BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_WRITE);
-      in_cache = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-      if (in_cache) {
-        BLI_rw_mutex_unlock(&cache_rwlock);
-      }
-    }
+    in_cache = bvhcache_find(bvh_cache, bvh_cache_type, &tree, &lock_started);
   }
 
   if (in_cache == false) {
@@ -826,8 +799,8 @@ BVHTree *bvhtree_from_mesh_edges_ex(BVHTreeFromMesh *data,
     if (bvh_cache) {
       /* Save on cache for later use */
       /* printf("BVHTree built and saved on cache\n"); */
-      bvhcache_insert(bvh_cache, tree, bvh_cache_type);
-      BLI_rw_mutex_unlock(&cache_rwlock);
+      bvhcache_insert(*bvh_cache, tree, bvh_cache_type);
+      bvhcache_unlock(*bvh_cache, bvh_cache_type, lock_started);
       in_cache = true;
     }
   }
@@ -940,18 +913,10 @@ BVHTree *bvhtree_from_mesh_faces_ex(BVHTreeFromMesh *data,
                                     BVHCache **bvh_cache)
 {
   bool in_cache = false;
+  bool lock_started = false;
   BVHTree *tree = NULL;
   if (bvh_cache) {
-    BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-    in_cache = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-    BLI_rw_mutex_unlock(&cache_rwlock);
-    if (in_cache == false) {
-      BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_WRITE);
-      in_cache = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-      if (in_cache) {
-        BLI_rw_mutex_unlock(&cache_rwlock);
-      }
-    }
+    in_cache = bvhcache_find(bvh_cache, bvh_cache_type, &tree, &lock_started);
   }
 
   if (in_cache == false) {
@@ -961,8 +926,8 @@ BVHTree *bvhtree_from_mesh_faces_ex(BVHTreeFromMesh *data,
     if (bvh_cache) {
       /* Save on cache for later use */
       /* printf("BVHTree built and saved on cache\n"); */
-      bvhcache_insert(bvh_cache, tree, bvh_cache_type);
-      BLI_rw_mutex_unlock(&cache_rwlock);
+      bvhcache_insert(*bvh_cache, tree, bvh_cache_type);
+      bvhcache_unlock(*bvh_cache, bvh_cache_type, lock_started);
       in_cache = true;
     }
   }
@@ -1120,22 +1085,17 @@ BVHTree *bvhtree_from_editmesh_looptri_ex(BVHTreeFromEditMesh *data,
 
   BVHTree *tree = NULL;
   if (bvh_cache) {
-    BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-    bool in_cache = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-    BLI_rw_mutex_unlock(&cache_rwlock);
+    bool lock_started = false;
+    bool in_cache = bvhcache_find(bvh_cache, bvh_cache_type, &tree, &lock_started);
     if (in_cache == false) {
-      BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_WRITE);
-      in_cache = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-      if (in_cache == false) {
-        tree = bvhtree_from_editmesh_looptri_create_tree(
-            epsilon, tree_type, axis, em, looptri_mask, looptri_num_active);
-
-        /* Save on cache for later use */
-        /* printf("BVHTree built and saved on cache\n"); */
-        bvhcache_insert(bvh_cache, tree, bvh_cache_type);
-      }
-      BLI_rw_mutex_unlock(&cache_rwlock);
+      tree = bvhtree_from_editmesh_looptri_create_tree(
+          epsilon, tree_type, axis, em, looptri_mask, looptri_num_active);
+
+      /* Save on cache for later use */
+      /* printf("BVHTree built and saved on cache\n"); */
+      bvhcache_insert(*bvh_cache, tree, bvh_cache_type);
     }
+    bvhcache_unlock(*bvh_cache, bvh_cache_type, lock_started);
   }
   else {
     tree = bvhtree_from_editmesh_looptri_create_tree(
@@ -1180,18 +1140,10 @@ BVHTree *bvhtree_from_mesh_looptri_ex(BVHTreeFromMesh *data,
                                       BVHCache **bvh_cache)
 {
   bool in_cache = false;
+  bool lock_started = false;
   BVHTree *tree = NULL;
   if (bvh_cache) {
-    BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-    in_cache = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-    BLI_rw_mutex_unlock(&cache_rwlock);
-    if (in_cache == false) {
-      BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_WRITE);
-      in_cache = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-      if (in_cache) {
-        BLI_rw_mutex_unlock(&cache_rwlock);
-      }
-    }
+    in_cache = bvhcache_find(bvh_cache, bvh_cache_type, &tree, &lock_started);
   }
 
   if (in_cache == false) {
@@ -1207,8 +1159,8 @@ BVHTree *bvhtree_from_mesh_looptri_ex(BVHTreeFromMesh *data,
                                                  looptri_num_active);
 
     if (bvh_cache) {
-      bvhcache_insert(bvh_cache, tree, bvh_cache_type);
-      BLI_rw_mutex_unlock(&cache_rwlock);
+      bvhcache_insert(*bvh_cache, tree, bvh_cache_type);
+      bvhcache_unlock(*bvh_cache, bvh_cache_type, lock_started);
       in_cache = true;
     }
   }
@@ -1317,9 +1269,7 @@ BVHTree *BKE_bvhtree_from_mesh_get(struct BVHTreeFromMesh *data,
   BVHTree *tree = NULL;
   BVHCache **bvh_cache = &mesh->runtime.bvh_cache;
 
-  BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-  bool is_cached = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-  BLI_rw_mutex_unlock(&cache_rwlock);
+  bool is_cached = bvhcache_find(bvh_cache, bvh_cache_type, &tree, NULL);
 
   if (is_cached && tree == NULL) {
     memset(data, 0, sizeof(*data));
@@ -1339,8 +1289,6 @@ BVHTree *BKE_bvhtree_from_mesh_get(struct BVHTreeFromMesh *data,
               mesh->medge, mesh->totedge, mesh->mvert, verts_len, &loose_vert_len);
         }
 
-        /* TODO: a global mutex lock held during the expensive operation of
-         * building the BVH tree is really bad for performance. */
         tree = bvhtree_from_mesh_verts_ex(data,
                                           mesh->mvert,
                                           verts_len,
@@ -1501,9 +1449,7 @@ BVHTree *BKE_bvhtree_from_editmesh_get(BVHTreeFromEditMesh *data,
   memset(data, 0, sizeof(*data));
 
   if (bvh_cache) {
-    BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-    is_cached = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
-    BLI_rw_mutex_unlock(&cache_rwlock);
+    is_cached = bvhcache_find(bvh_cache, bvh_cache_type, &tree, NULL);
 
     if (is_cached && tree == NULL) {
       return tree;
@@ -1621,35 +1567,120 @@ void free_bvhtree_from_mesh(struct BVHTreeFromMesh *data)
  * \{ */
 
 typedef struct BVHCacheItem {
-  int type;
+  /** Set once #tree is stored, read without locking. */
+  uint32_t is_filled;
   BVHTree *tree;
-
+  /** Held while the tree of this type is being built. */
+  ThreadMutex mutex;
 } BVHCacheItem;
 
 /**
- * Queries a bvhcache for the cache bvhtree of the request type
+ * One slot per tree type, so lookups of trees that were built already never lock,
+ * and threads building different types of trees for the same mesh don't wait on each other.
  */
-bool bvhcache_find(const BVHCache *cache, int type, BVHTree **r_tree)
+struct BVHCache {
+  BVHCacheItem items[BVHTREE_MAX_ITEM];
+};
+
+static BVHCache *bvhcache_init(void)
 {
-  while (cache) {
-    const BVHCacheItem *item = cache->link;
-    if (item->type == type) {
-      *r_tree = item->tree;
-      return true;
+  BVHCache *cache = MEM_callocN(sizeof(BVHCache), __func__);
+  for (int i = 0; i < BVHTREE_MAX_ITEM; i++) {
+    BLI_mutex_init(&cache->items[i].mutex);
+  }
+  return cache;
+}
+
+static void bvhcache_free_data(BVHCache *cache)
+{
+  for (int i = 0; i < BVHTREE_MAX_ITEM; i++) {
+    BVHCacheItem *item = &cache->items[i];
+    BLI_bvhtree_free(item->tree);
+    BLI_mutex_end(&item->mutex);
+  }
+  MEM_freeN(cache);
+}
+
+/**
+ * Returns the cache stored in \a cache_p, creating it when missing.
+ * Concurrent callers agree on a single cache, the ones losing the race free their copy.
+ */
+static BVHCache *bvhcache_ensure(BVHCache **cache_p)
+{
+  BVHCache *cache = *cache_p;
+  if (cache == NULL) {
+    BVHCache *cache_new = bvhcache_init();
+    cache = atomic_cas_ptr((void **)cache_p, NULL, cache_new);
+    if (cache == NULL) {
+      cache = cache_new;
     }
-    cache = cache->next;
+    else {
+      bvhcache_free_data(cache_new);
+    }
+  }
+  return cache;
+}
+
+static bool bvhcache_find_filled(const BVHCache *cache, int type, BVHTree **r_tree)
+{
+  const BVHCacheItem *item = &cache->items[type];
+  if (atomic_load_uint32(&item->is_filled)) {
+    *r_tree = item->tree;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Queries a bvhcache for the cache bvhtree of the request type.
+ *
+ * When \a r_locked is given and no tree is cached yet, the slot of \a type is locked
+ * before returning false: the caller must build the tree, #bvhcache_insert it
+ * and call #bvhcache_unlock. Other threads asking for the same type wait for that tree
+ * instead of building their own.
+ */
+bool bvhcache_find(BVHCache **cache_p, int type, BVHTree **r_tree, bool *r_locked)
+{
+  BLI_assert(type >= 0 && type < BVHTREE_MAX_ITEM);
+
+  if (r_locked) {
+    *r_locked = false;
   }
+
+  BVHCache *cache = *cache_p;
+  if (cache != NULL && bvhcache_find_filled(cache, type, r_tree)) {
+    return true;
+  }
+  if (r_locked == NULL) {
+    return false;
+  }
+
+  cache = bvhcache_ensure(cache_p);
+  BLI_mutex_lock(&cache->items[type].mutex);
+  if (bvhcache_find_filled(cache, type, r_tree)) {
+    BLI_mutex_unlock(&cache->items[type].mutex);
+    return true;
+  }
+  *r_locked = true;
   return false;
 }
 
+void bvhcache_unlock(BVHCache *cache, int type, bool lock_started)
+{
+  if (lock_started) {
+    BLI_mutex_unlock(&cache->items[type].mutex);
+  }
+}
+
 bool bvhcache_has_tree(const BVHCache *cache, const BVHTree *tree)
 {
-  while (cache) {
-    const BVHCacheItem *item = cache->link;
-    if (item->tree == tree) {
+  if (cache == NULL) {
+    return false;
+  }
+  for (int i = 0; i < BVHTREE_MAX_ITEM; i++) {
+    if (cache->items[i].tree == tree) {
       return true;
     }
-    cache = cache->next;
   }
   return false;
 }
@@ -1659,38 +1690,30 @@ bool bvhcache_has_tree(const BVHCache *cache, const BVHTree *tree)
  * After that the caller no longer needs to worry when to free the BVHTree
  * as that will be done when the cache is freed.
  *
- * A call to this assumes that there was no previous cached tree of the given type
+ * A call to this assumes that there was no previous cached tree of the given type,
+ * and that the slot of the type was locked by #bvhcache_find.
  * \warning The #BVHTree can be NULL.
  */
-void bvhcache_insert(BVHCache **cache_p, BVHTree *tree, int type)
+void bvhcache_insert(BVHCache *cache, BVHTree *tree, int type)
 {
-  BVHCacheItem *item = NULL;
-
-  BLI_assert(bvhcache_find(*cache_p, type, &(BVHTree *){0}) == false);
+  BVHCacheItem *item = &cache->items[type];
 
-  item = MEM_mallocN(sizeof(BVHCacheItem), "BVHCacheItem");
+  BLI_assert(item->is_filled == false);
 
-  item->type = type;
   item->tree = tree;
-
-  BLI_linklist_prepend(cache_p, item);
+  /* Publish the tree to lock-free readers. */
+  atomic_store_uint32(&item->is_filled, true);
 }
 
 /**
  * frees a bvhcache
  */
-static void bvhcacheitem_free(void *_item)
-{
-  BVHCacheItem *item = (BVHCacheItem *)_item;
-
-  BLI_bvhtree_free(item->tree);
-  MEM_freeN(item);
-}
-
 void bvhcache_free(BVHCache **cache_p)
 {
-  BLI_linklist_free(*cache_p, (LinkNodeFreeFP)bvhcacheitem_free);
-  *cache_p = NULL;
+  if (*cache_p) {
+    bvhcache_free_data(*cache_p);
+    *cache_p = NULL;
+  }
 }
 
 /** \} */
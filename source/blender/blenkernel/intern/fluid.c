@@ -4352,6 +4352,161 @@ void BKE_fluid_effector_type_set(Object *UNUSED(object), FluidEffectorSettings *
   settings->type = type;
 }
 
+/**
+ * Copy the slices \a z_begin to \a z_end of a domain grid, in the same layout as the grid
+ * arrays of the RNA API. This lets render engines convert large grids one part at a time
+ * instead of holding a full copy of them. Grids are named like the volume attributes:
+ * "density", "flame", "color", "velocity", "heat" and "temperature".
+ *
+ * \return false when the grid does not exist or has a different size than \a values_len.
+ */
+bool BKE_fluid_domain_grid_get_slices(FluidDomainSettings *mds,
+                                      const char *name,
+                                      int z_begin,
+                                      int z_end,
+                                      float *values,
+                                      size_t values_len)
+{
+#ifdef WITH_FLUID
+  if (mds->fluid == NULL) {
+    return false;
+  }
+
+  /* Velocity and heat data is always low-resolution. */
+  const bool is_velocity = STREQ(name, "velocity");
+  const bool is_heat = STREQ(name, "heat");
+  const bool use_noise = (mds->flags & FLUID_DOMAIN_USE_NOISE) && !is_velocity && !is_heat;
+  int res[3];
+  if (use_noise) {
+    manta_smoke_turbulence_get_res(mds->fluid, res);
+  }
+  else {
+    copy_v3_v3_int(res, mds->res);
+  }
+
+  const int channels = is_velocity ? 3 : STREQ(name, "color") ? 4 : 1;
+  if (z_begin < 0 || z_end > res[2] || z_begin > z_end ||
+      values_len != (size_t)res[0] * res[1] * (z_end - z_begin) * channels) {
+    return false;
+  }
+
+  const size_t offset = (size_t)res[0] * res[1] * z_begin;
+  const size_t num_cells = (size_t)res[0] * res[1] * (z_end - z_begin);
+  bool found = true;
+
+  BLI_rw_mutex_lock(mds->fluid_mutex, THREAD_LOCK_READ);
+
+  if (STREQ(name, "density")) {
+    float *density = use_noise ? manta_smoke_turbulence_get_density(mds->fluid) :
+                                 manta_smoke_get_density(mds->fluid);
+    if (density) {
+      memcpy(values, density + offset, num_cells * sizeof(float));
+    }
+    else {
+      found = false;
+    }
+  }
+  else if (STREQ(name, "flame") || STREQ(name, "temperature")) {
+    float *flame = use_noise ? manta_smoke_turbulence_get_flame(mds->fluid) :
+                               manta_smoke_get_flame(mds->fluid);
+    if (flame == NULL) {
+      memset(values, 0, num_cells * sizeof(float));
+    }
+    else if (STREQ(name, "flame")) {
+      memcpy(values, flame + offset, num_cells * sizeof(float));
+    }
+    else {
+      /* Output is such that 0..1 maps to 0..1000K */
+      const float offset_temp = mds->flame_ignition;
+      const float scale = mds->flame_max_temp - mds->flame_ignition;
+      for (size_t i = 0; i < num_cells; i++) {
+        const float f = flame[offset + i];
+        values[i] = (f > 0.01f) ? offset_temp + f * scale : 0.0f;
+      }
+    }
+  }
+  else if (is_heat) {
+    float *heat = manta_smoke_get_heat(mds->fluid);
+    if (heat) {
+      /* Scale heat values from -2.0-2.0 to -1.0-1.0. */
+      for (size_t i = 0; i < num_cells; i++) {
+        values[i] = heat[offset + i] * 0.5f;
+      }
+    }
+    else {
+      memset(values, 0, num_cells * sizeof(float));
+    }
+  }
+  else if (is_velocity) {
+    float *vx = manta_get_velocity_x(mds->fluid);
+    float *vy = manta_get_velocity_y(mds->fluid);
+    float *vz = manta_get_velocity_z(mds->fluid);
+    if (vx && vy && vz) {
+      for (size_t i = 0; i < num_cells; i++) {
+        values[i * 3 + 0] = vx[offset + i];
+        values[i * 3 + 1] = vy[offset + i];
+        values[i * 3 + 2] = vz[offset + i];
+      }
+    }
+    else {
+      found = false;
+    }
+  }
+  else if (STREQ(name, "color")) {
+    /* The RGB is "premultiplied" by density for better interpolation results. */
+    float *density, *r = NULL, *g = NULL, *b = NULL;
+    if (use_noise) {
+      density = manta_smoke_turbulence_get_density(mds->fluid);
+      if (manta_smoke_turbulence_has_colors(mds->fluid)) {
+        r = manta_smoke_turbulence_get_color_r(mds->fluid);
+        g = manta_smoke_turbulence_get_color_g(mds->fluid);
+        b = manta_smoke_turbulence_get_color_b(mds->fluid);
+      }
+    }
+    else {
+      density = manta_smoke_get_density(mds->fluid);
+      if (manta_smoke_has_colors(mds->fluid)) {
+        r = manta_smoke_get_color_r(mds->fluid);
+        g = manta_smoke_get_color_g(mds->fluid);
+        b = manta_smoke_get_color_b(mds->fluid);
+      }
+    }
+
+    if (density) {
+      for (size_t i = 0; i < num_cells; i++) {
+        const float alpha = density[offset + i];
+        float *value = values + i * 4;
+        if (alpha == 0.0f) {
+          zero_v3(value);
+        }
+        else if (r) {
+          value[0] = r[offset + i];
+          value[1] = g[offset + i];
+          value[2] = b[offset + i];
+        }
+        else {
+          mul_v3_v3fl(value, mds->active_color, alpha);
+        }
+        value[3] = alpha;
+      }
+    }
+    else {
+      found = false;
+    }
+  }
+  else {
+    found = false;
+  }
+
+  BLI_rw_mutex_unlock(mds->fluid_mutex);
+
+  return found;
+#else
+  UNUSED_VARS(mds, name, z_begin, z_end, values, values_len);
+  return false;
+#endif
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -159,6 +159,10 @@ static void imagecache_put(Image *image, int index, ImBuf *ibuf)
     image->cache = IMB_moviecache_create(
         "Image Datablock Cache", sizeof(ImageCacheKey), imagecache_hashhash, imagecache_hashcmp);
     IMB_moviecache_set_getdata_callback(image->cache, imagecache_keydata);
+    /* Movie frames can't be painted, so they never change while cached. */
+    if (image->source == IMA_SRC_MOVIE) {
+      IMB_moviecache_set_disk_spill(image->cache, true);
+    }
   }
 
   key.index = index;
@@ -4555,6 +4559,7 @@ static ImBuf *image_get_render_result(Image *ima, ImageUser *iuser, void **r_loc
   BLI_thread_lock(LOCK_COLORMANAGE);
   if (ibuf->x != rres.rectx || ibuf->y != rres.recty || ibuf->rect_float != rectf) {
     ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+    IMB_tag_changed(ibuf);
   }
 
   ibuf->x = rres.rectx;
@@ -5470,6 +5475,7 @@ bool BKE_image_is_dirty(Image *image)
 void BKE_image_mark_dirty(Image *UNUSED(image), ImBuf *ibuf)
 {
   ibuf->userflags |= IB_BITMAPDIRTY;
+  IMB_tag_changed(ibuf);
 }
 
 bool BKE_image_buffer_format_writable(ImBuf *ibuf)
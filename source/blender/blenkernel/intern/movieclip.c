@@ -595,6 +595,8 @@ static bool put_imbuf_cache(
                                          moviecache_getprioritydata,
                                          moviecache_getitempriority,
                                          moviecache_prioritydeleter);
+    /* Frames are never modified, reading them back from local disk is cheaper than decoding. */
+    IMB_moviecache_set_disk_spill(moviecache, true);
 
     clip->cache->moviecache = moviecache;
     clip->cache->sequence_offset = -1;
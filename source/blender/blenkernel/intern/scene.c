@@ -2076,6 +2076,24 @@ void BKE_scene_free_depsgraph_hash(Scene *scene)
   scene->depsgraph_hash = NULL;
 }
 
+/**
+ * Undo keeps unchanged scenes, including their dependency graphs,
+ * these are moved to the new \a bmain and their relations are rebuilt on next evaluation.
+ */
+void BKE_scene_undo_depsgraphs_main_set(Main *bmain, Scene *scene)
+{
+  if (scene->depsgraph_hash == NULL) {
+    return;
+  }
+  GHashIterator gh_iter;
+  GHASH_ITER (gh_iter, scene->depsgraph_hash) {
+    const DepsgraphKey *key = BLI_ghashIterator_getKey(&gh_iter);
+    Depsgraph *depsgraph = BLI_ghashIterator_getValue(&gh_iter);
+    DEG_graph_replace_owners(depsgraph, bmain, scene, key->view_layer);
+    DEG_graph_tag_relations_update(depsgraph);
+  }
+}
+
 /* Query depsgraph for a specific contexts. */
 
 Depsgraph *BKE_scene_get_depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, bool allocate)
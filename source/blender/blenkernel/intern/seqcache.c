@@ -22,12 +22,17 @@
 
 #include <stddef.h>
 #include <memory.h>
+#include <time.h>
+
+#include "zlib.h"
 
 #include "MEM_guardedalloc.h"
 
 #include "DNA_sequence_types.h"
 #include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
 
+#include "IMB_colormanagement.h"
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
@@ -35,7 +40,14 @@
 #include "BLI_threads.h"
 #include "BLI_listbase.h"
 #include "BLI_ghash.h"
-
+#include "BLI_math_base.h"
+#include "BLI_fileops.h"
+#include "BLI_fileops_types.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_task.h"
+
+#include "BKE_appdir.h"
 #include "BKE_sequencer.h"
 #include "BKE_scene.h"
 #include "BKE_main.h"
@@ -63,15 +75,104 @@
  * entries one by one in reverse order to their creation.
  *
  * User can exclude caching of some images. Such entries will have is_temp_cache set.
+ *
+ * Disk cache:
+ * When enabled in the preferences, permanent entries are also written to disk, so they can be
+ * loaded back after they were recycled from memory or after the blend-file is opened again.
+ * Files are stored in `<cache dir>/<blend-file name>_seq_cache/<scene name>-<time stamp>/`.
+ * Final frames are stored directly in this directory and keyed by timeline frame, other images
+ * are stored in a sub-directory per strip and keyed by frame relative to strip start.
+ * Files are invalidated together with memory entries by #BKE_sequencer_cache_cleanup_sequence
+ * and #BKE_sequencer_cache_cleanup, and the oldest files are removed once the size limit is
+ * reached.
+ *
+ * Files are compressed and written in a background task pool, neither the memory cache nor the
+ * disk cache are locked meanwhile. A file is written under a temporary name and only renamed
+ * and listed once it is complete, writes which finish after the directory of the scene changed
+ * are discarded.
+ *
+ * The time stamp is stored in #Editing, so it is saved with the blend-file and undo steps. Every
+ * invalidation moves the remaining files to a directory with a new stamp, so an older state of
+ * the scene (blend-file reopened without saving, undo) never finds images rendered after it.
  */
 
+#define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%-%d-%d.dcf"
+#define DCACHE_FILE_ID "BSDC"
+#define DCACHE_FILE_VERSION 1
+#define DCACHE_COLORSPACE_NAME_LEN 64
+/* Maximum amount of bytes passed to a single zlib call. */
+#define DCACHE_IO_CHUNK_SIZE (1 << 26)
+/* Files are written under this prefix first, it is skipped when scanning directories. */
+#define DCACHE_WRITING_PREFIX "writing-"
+/* Maximum amount of images waiting to be written, further images are not written. */
+#define DCACHE_WRITE_QUEUE_MAX 8
+
+typedef struct DiskCacheHeader {
+  char id[4];
+  int version;
+  int x, y;
+  int planes;
+  int channels;
+  /** #eDiskCacheHeaderFlag. */
+  int flag;
+  char rect_colorspace[DCACHE_COLORSPACE_NAME_LEN];
+  char float_colorspace[DCACHE_COLORSPACE_NAME_LEN];
+} DiskCacheHeader;
+
+typedef enum eDiskCacheHeaderFlag {
+  DCACHE_HAS_RECT = (1 << 0),
+  DCACHE_HAS_RECT_FLOAT = (1 << 1),
+} eDiskCacheHeaderFlag;
+
+typedef struct DiskCacheFile {
+  struct DiskCacheFile *next, *prev;
+  char path[FILE_MAX];
+  /** Name of strip directory, empty for final frames. */
+  char seq_dirname[64];
+  size_t size;
+  int64_t mtime;
+  int cache_type;
+  int rectx;
+  int recty;
+  int render_size;
+  int view_id;
+  /** Frame relative to strip start, timeline frame for final frames. */
+  int frame;
+} DiskCacheFile;
+
+typedef struct SeqDiskCache {
+  /** Directory of the scene that files are stored in. */
+  char dirpath[FILE_MAX];
+  /** Files sorted from oldest to newest. */
+  ListBase files;
+  /** Lookup of #DiskCacheFile by path. */
+  struct GHash *files_hash;
+  size_t size_total;
+  ThreadMutex read_write_mutex;
+  /** Pool of #seq_disk_cache_write_task. */
+  struct TaskPool *write_pool;
+  /** Paths of files which are being written. */
+  struct GSet *files_writing;
+} SeqDiskCache;
+
+typedef struct DiskCacheWriteTask {
+  struct ImBuf *ibuf;
+  /** Directory of the scene when the task was queued. */
+  char dirpath[FILE_MAX];
+  char path[FILE_MAX];
+  char seq_dirname[64];
+} DiskCacheWriteTask;
+
 typedef struct SeqCache {
   struct GHash *hash;
   ThreadMutex iterator_mutex;
   struct BLI_mempool *keys_pool;
   struct BLI_mempool *items_pool;
-  struct SeqCacheKey *last_key;
+  /* Last permanent key put by each task, the main render uses the first one and prefetch workers
+   * the following ones, so frames rendered at the same time are linked separately. */
+  struct SeqCacheKey *last_key[SEQ_PREFETCH_MAX_WORKERS + 1];
   size_t memory_used;
+  struct SeqDiskCache *disk_cache;
 } SeqCache;
 
 typedef struct SeqCacheItem {
@@ -91,6 +192,7 @@ typedef struct SeqCacheKey {
   bool is_temp_cache; /* this cache entry will be freed before rendering next frame */
   /* ID of task for asigning temp cache entries to particular task(thread, etc.) */
   eSeqTaskId task_id;
+  int worker_index;
   int type;
 } SeqCacheKey;
 
@@ -172,10 +274,32 @@ static size_t seq_cache_get_mem_total(void)
   return ((size_t)U.memcachelimit) * 1024 * 1024;
 }
 
+static SeqCacheKey **seq_cache_last_key_get(SeqCache *cache, const SeqRenderData *context)
+{
+  if (context->task_id == SEQ_TASK_PREFETCH_RENDER) {
+    return &cache->last_key[1 + context->worker_index];
+  }
+  return &cache->last_key[0];
+}
+
+static void seq_cache_last_keys_clear(SeqCache *cache)
+{
+  memset(cache->last_key, 0, sizeof(cache->last_key));
+}
+
 static void seq_cache_keyfree(void *val)
 {
   SeqCacheKey *key = val;
-  BLI_mempool_free(key->cache_owner->keys_pool, key);
+  SeqCache *cache = key->cache_owner;
+
+  /* Key may be recycled by another task while the frame it belongs to is still rendered. */
+  for (int i = 0; i < ARRAY_SIZE(cache->last_key); i++) {
+    if (cache->last_key[i] == key) {
+      cache->last_key[i] = NULL;
+    }
+  }
+
+  BLI_mempool_free(cache->keys_pool, key);
 }
 
 static void seq_cache_valfree(void *val)
@@ -200,7 +324,6 @@ static void seq_cache_put(SeqCache *cache, SeqCacheKey *key, ImBuf *ibuf)
 
   if (BLI_ghash_reinsert(cache->hash, key, item, seq_cache_keyfree, seq_cache_valfree)) {
     IMB_refImBuf(ibuf);
-    cache->last_key = key;
     cache->memory_used += IMB_get_size_in_memory(ibuf);
   }
 }
@@ -218,6 +341,642 @@ static ImBuf *seq_cache_get(SeqCache *cache, void *key)
   return NULL;
 }
 
+/* ***************************** Disk Cache ****************************** */
+
+static bool seq_disk_cache_is_enabled(const char *blendfile_path)
+{
+  /* Unsaved files have no stable location to store images for. */
+  return (U.sequencer_disk_cache_flag & USER_SEQ_DISK_CACHE_ENABLE) && blendfile_path[0] != '\0';
+}
+
+static bool seq_disk_cache_is_enabled_for_context(const SeqRenderData *context)
+{
+  if (context->skip_cache || context->is_proxy_render || context->bmain == NULL) {
+    return false;
+  }
+  return seq_disk_cache_is_enabled(BKE_main_blendfile_path(context->bmain));
+}
+
+/* Only whole frames are stored, so file names can be used as keys. */
+static bool seq_disk_cache_is_key_supported(const SeqCacheKey *key)
+{
+  return key->seq && (key->nfra == (float)(int)key->nfra);
+}
+
+static void seq_disk_cache_get_dir(const char *blendfile_path,
+                                   const Scene *scene,
+                                   int64_t timestamp,
+                                   char *path,
+                                   size_t path_len)
+{
+  char cache_dir[FILE_MAX];
+  char blendfile_name[FILE_MAXFILE];
+  char project_dirname[FILE_MAXFILE];
+  char scene_name[MAX_ID_NAME];
+  char scene_dirname[MAX_ID_NAME + 24];
+
+  if (U.sequencer_disk_cache_dir[0] != '\0') {
+    BLI_strncpy(cache_dir, U.sequencer_disk_cache_dir, sizeof(cache_dir));
+    BLI_path_abs(cache_dir, blendfile_path);
+  }
+  else {
+    BLI_strncpy(cache_dir, BKE_tempdir_base(), sizeof(cache_dir));
+  }
+
+  /* Use suffix, so the directory name doesn't conflict with the blend-file itself. */
+  BLI_split_file_part(blendfile_path, blendfile_name, sizeof(blendfile_name));
+  BLI_snprintf(project_dirname, sizeof(project_dirname), "%s_seq_cache", blendfile_name);
+
+  BLI_strncpy(scene_name, scene->id.name + 2, sizeof(scene_name));
+  BLI_filename_make_safe(scene_name);
+  BLI_snprintf(scene_dirname, sizeof(scene_dirname), "%s-%lld", scene_name, (long long)timestamp);
+
+  BLI_path_join(path, path_len, cache_dir, project_dirname, scene_dirname, NULL);
+}
+
+static void seq_disk_cache_get_seq_dirname(const Sequence *seq, char *r_name, size_t name_len)
+{
+  BLI_strncpy(r_name, seq->name + 2, name_len);
+  BLI_filename_make_safe(r_name);
+}
+
+static int seq_disk_cache_key_frame(const SeqCacheKey *key)
+{
+  if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
+    return key->seq->start + (int)key->nfra;
+  }
+  return (int)key->nfra;
+}
+
+static void seq_disk_cache_get_file_path(const SeqDiskCache *disk_cache,
+                                         const SeqCacheKey *key,
+                                         char *path,
+                                         size_t path_len)
+{
+  char filename[FILE_MAXFILE];
+
+  BLI_snprintf(filename,
+               sizeof(filename),
+               DCACHE_FNAME_FORMAT,
+               key->type,
+               key->context.rectx,
+               key->context.recty,
+               key->context.preview_render_size,
+               key->context.view_id,
+               seq_disk_cache_key_frame(key));
+
+  if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
+    BLI_path_join(path, path_len, disk_cache->dirpath, filename, NULL);
+  }
+  else {
+    char seq_dirname[sizeof(key->seq->name)];
+    seq_disk_cache_get_seq_dirname(key->seq, seq_dirname, sizeof(seq_dirname));
+    BLI_path_join(path, path_len, disk_cache->dirpath, seq_dirname, filename, NULL);
+  }
+}
+
+static DiskCacheFile *seq_disk_cache_add_file(SeqDiskCache *disk_cache,
+                                              const char *path,
+                                              const char *seq_dirname)
+{
+  DiskCacheFile tmp = {NULL};
+  const char *filename = BLI_path_basename(path);
+
+  /* Skip files which are not created by the cache. */
+  if (sscanf(filename,
+             DCACHE_FNAME_FORMAT,
+             &tmp.cache_type,
+             &tmp.rectx,
+             &tmp.recty,
+             &tmp.render_size,
+             &tmp.view_id,
+             &tmp.frame) != 6) {
+    return NULL;
+  }
+
+  BLI_stat_t st;
+  if (BLI_stat(path, &st) != 0) {
+    return NULL;
+  }
+
+  DiskCacheFile *cache_file = MEM_mallocN(sizeof(DiskCacheFile), "DiskCacheFile");
+  *cache_file = tmp;
+  BLI_strncpy(cache_file->path, path, sizeof(cache_file->path));
+  BLI_strncpy(cache_file->seq_dirname, seq_dirname, sizeof(cache_file->seq_dirname));
+  cache_file->size = (size_t)st.st_size;
+  cache_file->mtime = (int64_t)st.st_mtime;
+
+  BLI_addtail(&disk_cache->files, cache_file);
+  BLI_ghash_insert(disk_cache->files_hash, cache_file->path, cache_file);
+  disk_cache->size_total += cache_file->size;
+
+  return cache_file;
+}
+
+static void seq_disk_cache_delete_file(SeqDiskCache *disk_cache, DiskCacheFile *cache_file)
+{
+  BLI_delete(cache_file->path, false, false);
+  BLI_ghash_remove(disk_cache->files_hash, cache_file->path, NULL, NULL);
+  disk_cache->size_total -= cache_file->size;
+  BLI_freelinkN(&disk_cache->files, cache_file);
+}
+
+static void seq_disk_cache_scan_dir(SeqDiskCache *disk_cache,
+                                    const char *dirpath,
+                                    const char *seq_dirname)
+{
+  struct direntry *filelist;
+  const uint nbr = BLI_filelist_dir_contents(dirpath, &filelist);
+
+  for (uint i = 0; i < nbr; i++) {
+    const struct direntry *entry = &filelist[i];
+
+    if (FILENAME_IS_CURRPAR(entry->relname)) {
+      continue;
+    }
+
+    if (S_ISDIR(entry->type)) {
+      /* Only final frames and strip directories are expected in the scene directory. */
+      if (seq_dirname[0] == '\0') {
+        seq_disk_cache_scan_dir(disk_cache, entry->path, entry->relname);
+      }
+      continue;
+    }
+
+    seq_disk_cache_add_file(disk_cache, entry->path, seq_dirname);
+  }
+
+  BLI_filelist_free(filelist, nbr);
+}
+
+static int seq_disk_cache_file_cmp_mtime(const void *a_, const void *b_)
+{
+  const DiskCacheFile *a = a_;
+  const DiskCacheFile *b = b_;
+
+  return (a->mtime > b->mtime);
+}
+
+static void seq_disk_cache_clear_files(SeqDiskCache *disk_cache)
+{
+  BLI_ghash_clear(disk_cache->files_hash, NULL, NULL);
+  BLI_freelistN(&disk_cache->files);
+  disk_cache->size_total = 0;
+}
+
+/* Make sure files in the cache directory of the scene are known,
+ * must be called with `read_write_mutex` locked. */
+static void seq_disk_cache_sync_dir(SeqDiskCache *disk_cache,
+                                    const char *blendfile_path,
+                                    const Scene *scene)
+{
+  char dirpath[FILE_MAX];
+  seq_disk_cache_get_dir(
+      blendfile_path, scene, scene->ed->disk_cache_timestamp, dirpath, sizeof(dirpath));
+
+  if (STREQ(dirpath, disk_cache->dirpath)) {
+    return;
+  }
+
+  seq_disk_cache_clear_files(disk_cache);
+  BLI_strncpy(disk_cache->dirpath, dirpath, sizeof(disk_cache->dirpath));
+
+  if (BLI_is_dir(dirpath)) {
+    seq_disk_cache_scan_dir(disk_cache, dirpath, "");
+    BLI_listbase_sort(&disk_cache->files, seq_disk_cache_file_cmp_mtime);
+  }
+}
+
+/* Stamps of older states are lower, unless the blend-file was reopened without saving, so
+ * stamps of directories which already exist are skipped. */
+static int64_t seq_disk_cache_new_timestamp(const char *blendfile_path, const Scene *scene)
+{
+  char dirpath[FILE_MAX];
+  int64_t timestamp = (int64_t)time(NULL);
+
+  if (timestamp <= scene->ed->disk_cache_timestamp) {
+    timestamp = scene->ed->disk_cache_timestamp + 1;
+  }
+
+  seq_disk_cache_get_dir(blendfile_path, scene, timestamp, dirpath, sizeof(dirpath));
+  while (BLI_exists(dirpath)) {
+    timestamp++;
+    seq_disk_cache_get_dir(blendfile_path, scene, timestamp, dirpath, sizeof(dirpath));
+  }
+
+  return timestamp;
+}
+
+/* Switch the scene to a new time stamp, files which are still valid are moved to the directory
+ * of the new stamp when `keep_files` is set, otherwise they are deleted.
+ * Must be called with `read_write_mutex` locked and the directory synchronized. */
+static void seq_disk_cache_update_timestamp(SeqDiskCache *disk_cache,
+                                            const char *blendfile_path,
+                                            Scene *scene,
+                                            bool keep_files)
+{
+  char dirpath[FILE_MAX];
+
+  scene->ed->disk_cache_timestamp = seq_disk_cache_new_timestamp(blendfile_path, scene);
+  seq_disk_cache_get_dir(
+      blendfile_path, scene, scene->ed->disk_cache_timestamp, dirpath, sizeof(dirpath));
+
+  if (keep_files && disk_cache->files.first && BLI_rename(disk_cache->dirpath, dirpath) == 0) {
+    const size_t dirpath_len = strlen(disk_cache->dirpath);
+    BLI_ghash_clear(disk_cache->files_hash, NULL, NULL);
+
+    LISTBASE_FOREACH (DiskCacheFile *, cache_file, &disk_cache->files) {
+      char relpath[FILE_MAX];
+      BLI_strncpy(relpath, cache_file->path + dirpath_len, sizeof(relpath));
+      BLI_snprintf(cache_file->path, sizeof(cache_file->path), "%s%s", dirpath, relpath);
+      BLI_ghash_insert(disk_cache->files_hash, cache_file->path, cache_file);
+    }
+  }
+  else {
+    if (BLI_is_dir(disk_cache->dirpath)) {
+      BLI_delete(disk_cache->dirpath, true, true);
+    }
+    seq_disk_cache_clear_files(disk_cache);
+  }
+
+  BLI_strncpy(disk_cache->dirpath, dirpath, sizeof(disk_cache->dirpath));
+}
+
+static void seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
+{
+  if (U.sequencer_disk_cache_size_limit <= 0) {
+    return;
+  }
+
+  const size_t size_limit = ((size_t)U.sequencer_disk_cache_size_limit) * 1024 * 1024 * 1024;
+
+  while (disk_cache->size_total > size_limit && disk_cache->files.first) {
+    seq_disk_cache_delete_file(disk_cache, disk_cache->files.first);
+  }
+}
+
+static SeqDiskCache *seq_disk_cache_ensure(SeqCache *cache)
+{
+  BLI_mutex_lock(&cache_create_lock);
+  if (cache->disk_cache == NULL) {
+    SeqDiskCache *disk_cache = MEM_callocN(sizeof(SeqDiskCache), "SeqDiskCache");
+    disk_cache->files_hash = BLI_ghash_str_new("SeqDiskCache files");
+    BLI_mutex_init(&disk_cache->read_write_mutex);
+    disk_cache->write_pool = BLI_task_pool_create_background(BLI_task_scheduler_get(),
+                                                             disk_cache);
+    disk_cache->files_writing = BLI_gset_str_new("SeqDiskCache files writing");
+    cache->disk_cache = disk_cache;
+  }
+  BLI_mutex_unlock(&cache_create_lock);
+
+  return cache->disk_cache;
+}
+
+static void seq_disk_cache_free(SeqDiskCache *disk_cache)
+{
+  BLI_task_pool_work_and_wait(disk_cache->write_pool);
+  BLI_task_pool_free(disk_cache->write_pool);
+  BLI_gset_free(disk_cache->files_writing, NULL);
+  BLI_ghash_free(disk_cache->files_hash, NULL, NULL);
+  BLI_freelistN(&disk_cache->files);
+  BLI_mutex_end(&disk_cache->read_write_mutex);
+  MEM_freeN(disk_cache);
+}
+
+static bool seq_disk_cache_gzwrite(gzFile file, const void *data, size_t size)
+{
+  const char *data_ptr = data;
+
+  while (size > 0) {
+    const unsigned int chunk = (unsigned int)min_zz(size, DCACHE_IO_CHUNK_SIZE);
+    if (gzwrite(file, data_ptr, chunk) != (int)chunk) {
+      return false;
+    }
+    data_ptr += chunk;
+    size -= chunk;
+  }
+  return true;
+}
+
+static bool seq_disk_cache_gzread(gzFile file, void *data, size_t size)
+{
+  char *data_ptr = data;
+
+  while (size > 0) {
+    const unsigned int chunk = (unsigned int)min_zz(size, DCACHE_IO_CHUNK_SIZE);
+    if (gzread(file, data_ptr, chunk) != (int)chunk) {
+      return false;
+    }
+    data_ptr += chunk;
+    size -= chunk;
+  }
+  return true;
+}
+
+static const char *seq_disk_cache_write_mode(void)
+{
+  switch (U.sequencer_disk_cache_compression) {
+    case USER_SEQ_DISK_CACHE_COMPRESSION_NONE:
+      return "wb0";
+    case USER_SEQ_DISK_CACHE_COMPRESSION_HIGH:
+      return "wb9";
+    case USER_SEQ_DISK_CACHE_COMPRESSION_LOW:
+    default:
+      return "wb1";
+  }
+}
+
+static bool seq_disk_cache_write_file(const char *path, ImBuf *ibuf)
+{
+  DiskCacheHeader header = {{0}};
+  const size_t num_pixels = (size_t)ibuf->x * (size_t)ibuf->y;
+
+  memcpy(header.id, DCACHE_FILE_ID, sizeof(header.id));
+  header.version = DCACHE_FILE_VERSION;
+  header.x = ibuf->x;
+  header.y = ibuf->y;
+  header.planes = ibuf->planes;
+  header.channels = ibuf->channels ? ibuf->channels : 4;
+
+  if (ibuf->rect) {
+    header.flag |= DCACHE_HAS_RECT;
+    if (ibuf->rect_colorspace) {
+      BLI_strncpy(header.rect_colorspace,
+                  IMB_colormanagement_get_rect_colorspace(ibuf),
+                  sizeof(header.rect_colorspace));
+    }
+  }
+  if (ibuf->rect_float) {
+    header.flag |= DCACHE_HAS_RECT_FLOAT;
+    if (ibuf->float_colorspace) {
+      BLI_strncpy(header.float_colorspace,
+                  IMB_colormanagement_get_float_colorspace(ibuf),
+                  sizeof(header.float_colorspace));
+    }
+  }
+
+  gzFile file = BLI_gzopen(path, seq_disk_cache_write_mode());
+  if (file == NULL) {
+    return false;
+  }
+
+  bool ok = seq_disk_cache_gzwrite(file, &header, sizeof(header));
+  if (ok && ibuf->rect) {
+    ok = seq_disk_cache_gzwrite(file, ibuf->rect, num_pixels * sizeof(*ibuf->rect));
+  }
+  if (ok && ibuf->rect_float) {
+    ok = seq_disk_cache_gzwrite(
+        file, ibuf->rect_float, num_pixels * header.channels * sizeof(float));
+  }
+
+  if (gzclose(file) != Z_OK) {
+    ok = false;
+  }
+
+  if (!ok) {
+    BLI_delete(path, false, false);
+  }
+
+  return ok;
+}
+
+static ImBuf *seq_disk_cache_read_file(const char *path)
+{
+  gzFile file = BLI_gzopen(path, "rb");
+  if (file == NULL) {
+    return NULL;
+  }
+
+  DiskCacheHeader header;
+  if (!seq_disk_cache_gzread(file, &header, sizeof(header)) ||
+      memcmp(header.id, DCACHE_FILE_ID, sizeof(header.id)) != 0 ||
+      header.version != DCACHE_FILE_VERSION || header.x <= 0 || header.y <= 0 ||
+      header.channels < 1 || header.channels > 4 ||
+      (header.flag & (DCACHE_HAS_RECT | DCACHE_HAS_RECT_FLOAT)) == 0) {
+    gzclose(file);
+    return NULL;
+  }
+
+  /* Colorspace names are expected to be null terminated. */
+  header.rect_colorspace[DCACHE_COLORSPACE_NAME_LEN - 1] = '\0';
+  header.float_colorspace[DCACHE_COLORSPACE_NAME_LEN - 1] = '\0';
+
+  int flags = 0;
+  if (header.flag & DCACHE_HAS_RECT) {
+    flags |= IB_rect;
+  }
+  if (header.flag & DCACHE_HAS_RECT_FLOAT) {
+    flags |= IB_rectfloat;
+  }
+
+  ImBuf *ibuf = IMB_allocImBuf(header.x, header.y, header.planes, flags);
+  if (ibuf == NULL) {
+    gzclose(file);
+    return NULL;
+  }
+
+  const size_t num_pixels = (size_t)header.x * (size_t)header.y;
+  bool ok = true;
+
+  if (ibuf->rect) {
+    ok = seq_disk_cache_gzread(file, ibuf->rect, num_pixels * sizeof(*ibuf->rect));
+  }
+  if (ok && ibuf->rect_float) {
+    ibuf->channels = header.channels;
+    ok = seq_disk_cache_gzread(
+        file, ibuf->rect_float, num_pixels * header.channels * sizeof(float));
+  }
+
+  gzclose(file);
+
+  if (!ok) {
+    IMB_freeImBuf(ibuf);
+    return NULL;
+  }
+
+  if (header.rect_colorspace[0] != '\0') {
+    IMB_colormanagement_assign_rect_colorspace(ibuf, header.rect_colorspace);
+  }
+  if (header.float_colorspace[0] != '\0') {
+    IMB_colormanagement_assign_float_colorspace(ibuf, header.float_colorspace);
+  }
+
+  return ibuf;
+}
+
+static void seq_disk_cache_write_task(TaskPool *__restrict pool,
+                                      void *taskdata,
+                                      int UNUSED(threadid))
+{
+  SeqDiskCache *disk_cache = BLI_task_pool_userdata(pool);
+  DiskCacheWriteTask *task = taskdata;
+
+  char dirpath[FILE_MAX], filename[FILE_MAXFILE], path_writing[FILE_MAX];
+  BLI_split_dirfile(task->path, dirpath, filename, sizeof(dirpath), sizeof(filename));
+  /* The directory part ends with a separator. */
+  BLI_snprintf(
+      path_writing, sizeof(path_writing), "%s" DCACHE_WRITING_PREFIX "%s", dirpath, filename);
+
+  const bool ok = BLI_dir_create_recursive(dirpath) &&
+                  seq_disk_cache_write_file(path_writing, task->ibuf);
+  IMB_freeImBuf(task->ibuf);
+
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  BLI_gset_remove(disk_cache->files_writing, task->path, NULL);
+
+  if (ok) {
+    /* The scene changed meanwhile when its directory did, the image may be outdated. */
+    if (STREQ(task->dirpath, disk_cache->dirpath) &&
+        BLI_ghash_lookup(disk_cache->files_hash, task->path) == NULL &&
+        BLI_rename(path_writing, task->path) == 0) {
+      seq_disk_cache_add_file(disk_cache, task->path, task->seq_dirname);
+      seq_disk_cache_enforce_limits(disk_cache);
+    }
+    else {
+      BLI_delete(path_writing, false, false);
+    }
+  }
+
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+}
+
+/* Queue writing the image to disk, the image is referenced until it is written. */
+static void seq_disk_cache_write(SeqCache *cache, const SeqCacheKey *key, ImBuf *ibuf)
+{
+  if (!seq_disk_cache_is_enabled_for_context(&key->context) ||
+      !seq_disk_cache_is_key_supported(key)) {
+    return;
+  }
+
+  SeqDiskCache *disk_cache = seq_disk_cache_ensure(cache);
+
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  seq_disk_cache_sync_dir(
+      disk_cache, BKE_main_blendfile_path(key->context.bmain), key->context.scene);
+
+  char path[FILE_MAX];
+  seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
+
+  if (BLI_ghash_lookup(disk_cache->files_hash, path) == NULL &&
+      !BLI_gset_haskey(disk_cache->files_writing, path) &&
+      BLI_gset_len(disk_cache->files_writing) < DCACHE_WRITE_QUEUE_MAX) {
+    DiskCacheWriteTask *task = MEM_callocN(sizeof(DiskCacheWriteTask), "DiskCacheWriteTask");
+    task->ibuf = ibuf;
+    IMB_refImBuf(ibuf);
+    BLI_strncpy(task->dirpath, disk_cache->dirpath, sizeof(task->dirpath));
+    BLI_strncpy(task->path, path, sizeof(task->path));
+    if (key->type != SEQ_CACHE_STORE_FINAL_OUT) {
+      seq_disk_cache_get_seq_dirname(key->seq, task->seq_dirname, sizeof(task->seq_dirname));
+    }
+
+    BLI_gset_insert(disk_cache->files_writing, task->path);
+    BLI_task_pool_push(
+        disk_cache->write_pool, seq_disk_cache_write_task, task, true, TASK_PRIORITY_LOW);
+  }
+
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+}
+
+static ImBuf *seq_disk_cache_read(SeqCache *cache, const SeqCacheKey *key)
+{
+  if (!seq_disk_cache_is_enabled_for_context(&key->context) ||
+      !seq_disk_cache_is_key_supported(key)) {
+    return NULL;
+  }
+
+  SeqDiskCache *disk_cache = seq_disk_cache_ensure(cache);
+  ImBuf *ibuf = NULL;
+
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  seq_disk_cache_sync_dir(
+      disk_cache, BKE_main_blendfile_path(key->context.bmain), key->context.scene);
+
+  char path[FILE_MAX];
+  seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
+
+  DiskCacheFile *cache_file = BLI_ghash_lookup(disk_cache->files_hash, path);
+  if (cache_file) {
+    ibuf = seq_disk_cache_read_file(path);
+    /* Remove unreadable files, so they are written again. */
+    if (ibuf == NULL) {
+      seq_disk_cache_delete_file(disk_cache, cache_file);
+    }
+  }
+
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+
+  return ibuf;
+}
+
+/* Files may be left from previous sessions, so the directory is synchronized even when nothing
+ * was rendered yet. */
+static void seq_disk_cache_invalidate(SeqCache *cache,
+                                      Scene *scene,
+                                      Sequence *seq,
+                                      Sequence *seq_changed,
+                                      int range_start,
+                                      int range_end,
+                                      int invalidate_composite,
+                                      int invalidate_source)
+{
+  const char *blendfile_path = BKE_main_blendfile_path_from_global();
+  if (blendfile_path[0] == '\0') {
+    return;
+  }
+  /* Files of the current stamp stay valid for the saved state while the cache is disabled. */
+  if (!seq_disk_cache_is_enabled(blendfile_path)) {
+    scene->ed->disk_cache_timestamp = seq_disk_cache_new_timestamp(blendfile_path, scene);
+    return;
+  }
+
+  SeqDiskCache *disk_cache = seq_disk_cache_ensure(cache);
+  char seq_dirname[sizeof(seq->name)];
+  seq_disk_cache_get_seq_dirname(seq, seq_dirname, sizeof(seq_dirname));
+
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  seq_disk_cache_sync_dir(disk_cache, blendfile_path, scene);
+
+  DiskCacheFile *next_file;
+  for (DiskCacheFile *cache_file = disk_cache->files.first; cache_file; cache_file = next_file) {
+    next_file = cache_file->next;
+
+    if (cache_file->cache_type & invalidate_composite && cache_file->frame >= range_start &&
+        cache_file->frame <= range_end) {
+      seq_disk_cache_delete_file(disk_cache, cache_file);
+      continue;
+    }
+
+    const int timeline_frame = seq->start + cache_file->frame;
+    if (cache_file->cache_type & invalidate_source && STREQ(cache_file->seq_dirname, seq_dirname) &&
+        timeline_frame >= seq_changed->startdisp && timeline_frame <= seq_changed->enddisp) {
+      seq_disk_cache_delete_file(disk_cache, cache_file);
+    }
+  }
+
+  seq_disk_cache_update_timestamp(disk_cache, blendfile_path, scene, true);
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+}
+
+/* Same as #seq_disk_cache_invalidate for all files of the scene. */
+static void seq_disk_cache_invalidate_all(SeqCache *cache, Scene *scene)
+{
+  const char *blendfile_path = BKE_main_blendfile_path_from_global();
+  if (blendfile_path[0] == '\0') {
+    return;
+  }
+  if (!seq_disk_cache_is_enabled(blendfile_path)) {
+    scene->ed->disk_cache_timestamp = seq_disk_cache_new_timestamp(blendfile_path, scene);
+    return;
+  }
+
+  SeqDiskCache *disk_cache = seq_disk_cache_ensure(cache);
+
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  seq_disk_cache_sync_dir(disk_cache, blendfile_path, scene);
+  seq_disk_cache_update_timestamp(disk_cache, blendfile_path, scene, false);
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+}
+
 static void seq_cache_relink_keys(SeqCacheKey *link_next, SeqCacheKey *link_prev)
 {
   if (link_next) {
@@ -440,7 +1199,6 @@ static void BKE_sequencer_cache_create(Scene *scene)
     cache->keys_pool = BLI_mempool_create(sizeof(SeqCacheKey), 0, 64, BLI_MEMPOOL_NOP);
     cache->items_pool = BLI_mempool_create(sizeof(SeqCacheItem), 0, 64, BLI_MEMPOOL_NOP);
     cache->hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
-    cache->last_key = NULL;
     BLI_mutex_init(&cache->iterator_mutex);
     scene->ed->cache = cache;
   }
@@ -449,7 +1207,7 @@ static void BKE_sequencer_cache_create(Scene *scene)
 
 /* ***************************** API ****************************** */
 
-void BKE_sequencer_cache_free_temp_cache(Scene *scene, short id, int cfra)
+void BKE_sequencer_cache_free_temp_cache(Scene *scene, short id, int worker_index, int cfra)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
   if (!cache) {
@@ -464,7 +1222,8 @@ void BKE_sequencer_cache_free_temp_cache(Scene *scene, short id, int cfra)
     SeqCacheKey *key = BLI_ghashIterator_getKey(&gh_iter);
     BLI_ghashIterator_step(&gh_iter);
 
-    if (key->is_temp_cache && key->task_id == id && key->seq->start + key->nfra != cfra) {
+    if (key->is_temp_cache && key->task_id == id && key->worker_index == worker_index &&
+        key->seq->start + key->nfra != cfra) {
       BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
     }
   }
@@ -482,6 +1241,11 @@ void BKE_sequencer_cache_destruct(Scene *scene)
   BLI_mempool_destroy(cache->keys_pool);
   BLI_mempool_destroy(cache->items_pool);
   BLI_mutex_end(&cache->iterator_mutex);
+
+  if (cache->disk_cache) {
+    seq_disk_cache_free(cache->disk_cache);
+  }
+
   MEM_freeN(cache);
   scene->ed->cache = NULL;
 }
@@ -493,6 +1257,24 @@ void BKE_sequencer_cache_cleanup_all(Main *bmain)
   }
 }
 void BKE_sequencer_cache_cleanup(Scene *scene)
+{
+  BKE_sequencer_cache_cleanup_memory(scene);
+
+  if (scene->ed == NULL) {
+    return;
+  }
+
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  if (!cache) {
+    BKE_sequencer_cache_create(scene);
+    cache = seq_cache_get_from_scene(scene);
+  }
+
+  seq_disk_cache_invalidate_all(cache, scene);
+}
+
+/* Images on disk stay valid, used to release memory without changes of the scene. */
+void BKE_sequencer_cache_cleanup_memory(Scene *scene)
 {
   BKE_sequencer_prefetch_stop(scene);
 
@@ -511,7 +1293,7 @@ void BKE_sequencer_cache_cleanup(Scene *scene)
     BLI_ghashIterator_step(&gh_iter);
     BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
   }
-  cache->last_key = NULL;
+  seq_cache_last_keys_clear(cache);
   seq_cache_unlock(scene);
 }
 
@@ -522,7 +1304,8 @@ void BKE_sequencer_cache_cleanup_sequence(Scene *scene,
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
   if (!cache) {
-    return;
+    BKE_sequencer_cache_create(scene);
+    cache = seq_cache_get_from_scene(scene);
   }
 
   seq_cache_lock(scene);
@@ -568,98 +1351,52 @@ void BKE_sequencer_cache_cleanup_sequence(Scene *scene,
       BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
     }
   }
-  cache->last_key = NULL;
+  seq_cache_last_keys_clear(cache);
   seq_cache_unlock(scene);
+
+  seq_disk_cache_invalidate(cache,
+                            scene,
+                            seq,
+                            seq_changed,
+                            range_start,
+                            range_end,
+                            invalidate_composite,
+                            invalidate_source);
 }
 
-struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context,
-                                      Sequence *seq,
-                                      float cfra,
-                                      int type)
+static void seq_cache_put_ex(const SeqRenderData *context,
+                             Sequence *seq,
+                             float cfra,
+                             int type,
+                             ImBuf *i,
+                             float cost,
+                             bool skip_disk_cache)
 {
   Scene *scene = context->scene;
 
-  if (context->is_prefetch_render) {
-    context = BKE_sequencer_prefetch_get_original_context(context);
-    scene = context->scene;
-    seq = BKE_sequencer_prefetch_get_original_sequence(seq, scene);
+  if (i == NULL || context->skip_cache || context->is_proxy_render || !seq) {
+    return;
   }
 
   if (!scene->ed->cache) {
     BKE_sequencer_cache_create(scene);
-    return NULL;
   }
 
   seq_cache_lock(scene);
-  SeqCache *cache = seq_cache_get_from_scene(scene);
-  ImBuf *ibuf = NULL;
-
-  if (cache && seq) {
-    SeqCacheKey key;
-
-    key.seq = seq;
-    key.context = *context;
-    key.nfra = cfra - seq->start;
-    key.type = type;
-
-    ibuf = seq_cache_get(cache, &key);
-  }
-  seq_cache_unlock(scene);
-
-  return ibuf;
-}
-
-bool BKE_sequencer_cache_put_if_possible(
-    const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *ibuf, float cost)
-{
-  Scene *scene = context->scene;
-
-  if (context->is_prefetch_render) {
-    context = BKE_sequencer_prefetch_get_original_context(context);
-    scene = context->scene;
-    seq = BKE_sequencer_prefetch_get_original_sequence(seq, scene);
-  }
-
-  if (BKE_sequencer_cache_recycle_item(scene)) {
-    BKE_sequencer_cache_put(context, seq, cfra, type, ibuf, cost);
-    return true;
-  }
-  else {
-    seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key);
-    scene->ed->cache->last_key = NULL;
-    return false;
-  }
-}
 
-void BKE_sequencer_cache_put(
-    const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *i, float cost)
-{
-  Scene *scene = context->scene;
-
-  if (context->is_prefetch_render) {
-    context = BKE_sequencer_prefetch_get_original_context(context);
-    scene = context->scene;
-    seq = BKE_sequencer_prefetch_get_original_sequence(seq, scene);
-  }
-
-  if (i == NULL || context->skip_cache || context->is_proxy_render || !seq) {
-    return;
-  }
+  SeqCache *cache = seq_cache_get_from_scene(scene);
 
   /* Prevent reinserting, it breaks cache key linking */
-  ImBuf *test = BKE_sequencer_cache_get(context, seq, cfra, type);
-  if (test) {
-    IMB_freeImBuf(test);
+  SeqCacheKey test_key;
+  test_key.seq = seq;
+  test_key.context = *context;
+  test_key.nfra = cfra - seq->start;
+  test_key.type = type;
+  if (BLI_ghash_haskey(cache->hash, &test_key)) {
+    seq_cache_unlock(scene);
     return;
   }
 
-  if (!scene->ed->cache) {
-    BKE_sequencer_cache_create(scene);
-  }
-
-  seq_cache_lock(scene);
-
-  SeqCache *cache = seq_cache_get_from_scene(scene);
   int flag;
 
   if (seq->cache_flag & SEQ_CACHE_OVERRIDE) {
@@ -687,34 +1424,125 @@ void BKE_sequencer_cache_put(
   key->link_next = NULL;
   key->is_temp_cache = true;
   key->task_id = context->task_id;
+  key->worker_index = context->worker_index;
 
   /* Item stored for later use */
+  SeqCacheKey **last_key = seq_cache_last_key_get(cache, context);
   if (flag & type) {
     key->is_temp_cache = false;
-    key->link_prev = cache->last_key;
+    key->link_prev = *last_key;
   }
 
-  SeqCacheKey *temp_last_key = cache->last_key;
   seq_cache_put(cache, key, i);
 
-  /* Restore pointer to previous item as this one will be freed when stack is rendered */
-  if (key->is_temp_cache) {
-    cache->last_key = temp_last_key;
-  }
-
-  /* Set last_key's reference to this key so we can look up chain backwards
-   * Item is already put in cache, so cache->last_key points to current key;
-   */
-  if (flag & type && temp_last_key) {
-    temp_last_key->link_next = cache->last_key;
+  /* Set last_key's reference to this key so we can look up chain backwards.
+   * Temp cache items are freed when stack is rendered, so they are not linked. */
+  if (!key->is_temp_cache) {
+    if (*last_key) {
+      (*last_key)->link_next = key;
+    }
+    *last_key = key;
   }
 
   /* Reset linking */
   if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
-    cache->last_key = NULL;
+    *last_key = NULL;
   }
 
+  /* Key may be recycled by other threads once cache is unlocked. */
+  const bool use_disk_cache = !skip_disk_cache && !key->is_temp_cache;
+  SeqCacheKey disk_key = *key;
+
   seq_cache_unlock(scene);
+
+  if (use_disk_cache) {
+    seq_disk_cache_write(cache, &disk_key, i);
+  }
+}
+
+struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context,
+                                      Sequence *seq,
+                                      float cfra,
+                                      int type)
+{
+  Scene *scene = context->scene;
+
+  if (context->is_prefetch_render) {
+    context = BKE_sequencer_prefetch_get_original_context(context);
+    scene = context->scene;
+    seq = BKE_sequencer_prefetch_get_original_sequence(seq, scene);
+  }
+
+  if (!scene->ed->cache) {
+    BKE_sequencer_cache_create(scene);
+  }
+
+  if (!seq) {
+    return NULL;
+  }
+
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  SeqCacheKey key;
+
+  key.seq = seq;
+  key.context = *context;
+  key.nfra = cfra - seq->start;
+  key.type = type;
+
+  seq_cache_lock(scene);
+  ImBuf *ibuf = seq_cache_get(cache, &key);
+  seq_cache_unlock(scene);
+
+  if (ibuf) {
+    return ibuf;
+  }
+
+  /* Try disk cache, loaded image is added to memory cache, so it can be recycled again. */
+  ibuf = seq_disk_cache_read(cache, &key);
+  if (ibuf) {
+    seq_cache_put_ex(context, seq, cfra, type, ibuf, 0.0f, true);
+  }
+
+  return ibuf;
+}
+
+bool BKE_sequencer_cache_put_if_possible(
+    const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *ibuf, float cost)
+{
+  Scene *scene = context->scene;
+
+  if (context->is_prefetch_render) {
+    context = BKE_sequencer_prefetch_get_original_context(context);
+    scene = context->scene;
+    seq = BKE_sequencer_prefetch_get_original_sequence(seq, scene);
+  }
+
+  if (BKE_sequencer_cache_recycle_item(scene)) {
+    BKE_sequencer_cache_put(context, seq, cfra, type, ibuf, cost);
+    return true;
+  }
+  else {
+    SeqCache *cache = seq_cache_get_from_scene(scene);
+    if (cache) {
+      seq_cache_lock(scene);
+      SeqCacheKey **last_key = seq_cache_last_key_get(cache, context);
+      seq_cache_set_temp_cache_linked(scene, *last_key);
+      *last_key = NULL;
+      seq_cache_unlock(scene);
+    }
+    return false;
+  }
+}
+
+void BKE_sequencer_cache_put(
+    const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *i, float cost)
+{
+  if (context->is_prefetch_render) {
+    context = BKE_sequencer_prefetch_get_original_context(context);
+    seq = BKE_sequencer_prefetch_get_original_sequence(seq, context->scene);
+  }
+
+  seq_cache_put_ex(context, seq, cfra, type, i, cost, false);
 }
 
 void BKE_sequencer_cache_iterate(
@@ -739,7 +1567,7 @@ void BKE_sequencer_cache_iterate(
     interrupt = callback(userdata, key->seq, key->nfra, key->type, key->cost);
   }
 
-  cache->last_key = NULL;
+  seq_cache_last_keys_clear(cache);
   seq_cache_unlock(scene);
 }
 
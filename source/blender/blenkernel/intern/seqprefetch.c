@@ -34,6 +34,7 @@
 #include "DNA_anim_types.h"
 
 #include "BLI_listbase.h"
+#include "BLI_math_base.h"
 #include "BLI_threads.h"
 
 #include "IMB_imbuf.h"
@@ -52,25 +53,45 @@
 #include "DEG_depsgraph_debug.h"
 #include "DEG_depsgraph_query.h"
 
+/* Frames are rendered by a pool of workers, each of them owns an evaluated copy of the scene,
+ * so strips (and their decoders) are never shared between threads.
+ * Frames are handed out in order, starting with the one closest to the playhead.
+ * Workers are kept between runs, their depsgraphs are only built again after the scene changed.
+ * Depsgraphs are built from the original scene, so this is done on the main thread when prefetch
+ * starts, never by the workers. */
+typedef struct PrefetchWorker {
+  struct PrefetchJob *pfjob;
+
+  struct Main *bmain_eval;
+  struct Scene *scene_eval;
+  struct Depsgraph *depsgraph;
+
+  /* context */
+  struct SeqRenderData context;
+  struct SeqRenderData context_cpy;
+
+  /* Frame being rendered by this worker. */
+  int cfra;
+} PrefetchWorker;
+
 typedef struct PrefetchJob {
   struct PrefetchJob *next, *prev;
 
   struct Main *bmain;
-  struct Main *bmain_eval;
   struct Scene *scene;
-  struct Scene *scene_eval;
-  struct Depsgraph *depsgraph;
+  /* Context of the run, used to set up contexts of the workers. */
+  struct SeqRenderData context;
 
   ThreadMutex prefetch_suspend_mutex;
   ThreadCondition prefetch_suspend_cond;
+  /* Protects prefetch area while frames are handed out to workers. */
+  ThreadMutex prefetch_frames_mutex;
 
   ListBase threads;
-
-  /* context */
-  struct SeqRenderData context;
-  struct SeqRenderData context_cpy;
-  struct ListBase *seqbasep;
-  struct ListBase *seqbasep_cpy;
+  PrefetchWorker *workers;
+  int num_workers;
+  int num_workers_running;
+  int num_workers_waiting;
 
   /* prefetch area */
   float cfra;
@@ -80,6 +101,8 @@ typedef struct PrefetchJob {
   bool running;
   bool waiting;
   bool stop;
+  /* Scene was changed since workers were updated. */
+  bool scene_changed;
 } PrefetchJob;
 
 static bool seq_prefetch_is_playing(Main *bmain)
@@ -153,7 +176,7 @@ SeqRenderData *BKE_sequencer_prefetch_get_original_context(const SeqRenderData *
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
 
-  return &pfjob->context;
+  return &pfjob->workers[context->worker_index].context;
 }
 
 static bool seq_prefetch_is_cache_full(Scene *scene)
@@ -175,38 +198,82 @@ void BKE_sequencer_prefetch_get_time_range(Scene *scene, int *start, int *end)
   *end = pfjob->cfra + pfjob->num_frames_prefetched;
 }
 
-static void seq_prefetch_free_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_free_depsgraph(PrefetchWorker *worker)
 {
-  if (pfjob->depsgraph != NULL) {
-    DEG_graph_free(pfjob->depsgraph);
+  if (worker->depsgraph != NULL) {
+    DEG_graph_free(worker->depsgraph);
   }
-  pfjob->depsgraph = NULL;
-  pfjob->scene_eval = NULL;
+  worker->depsgraph = NULL;
+  worker->scene_eval = NULL;
 }
 
-static void seq_prefetch_update_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_update_depsgraph(PrefetchWorker *worker, int cfra)
 {
-  DEG_evaluate_on_framechange(
-      pfjob->bmain_eval, pfjob->depsgraph, pfjob->cfra + pfjob->num_frames_prefetched);
+  DEG_evaluate_on_framechange(worker->bmain_eval, worker->depsgraph, cfra);
 }
 
-static void seq_prefetch_init_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_init_depsgraph(PrefetchWorker *worker, int cfra)
 {
-  Main *bmain = pfjob->bmain_eval;
+  PrefetchJob *pfjob = worker->pfjob;
+  Main *bmain = worker->bmain_eval;
   Scene *scene = pfjob->scene;
   ViewLayer *view_layer = BKE_view_layer_default_render(scene);
 
-  pfjob->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
-  DEG_debug_name_set(pfjob->depsgraph, "SEQUENCER PREFETCH");
+  worker->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+  DEG_debug_name_set(worker->depsgraph, "SEQUENCER PREFETCH");
 
   /* Make sure there is a correct evaluated scene pointer. */
-  DEG_graph_build_for_render_pipeline(pfjob->depsgraph, bmain, scene, view_layer);
+  DEG_graph_build_for_render_pipeline(worker->depsgraph, bmain, scene, view_layer);
 
   /* Update immediately so we have proper evaluated scene. */
-  seq_prefetch_update_depsgraph(pfjob);
+  seq_prefetch_update_depsgraph(worker, cfra);
 
-  pfjob->scene_eval = DEG_get_evaluated_scene(pfjob->depsgraph);
-  pfjob->scene_eval->ed->cache_flag = 0;
+  worker->scene_eval = DEG_get_evaluated_scene(worker->depsgraph);
+  worker->scene_eval->ed->cache_flag = 0;
+}
+
+/* Scene strips are rendered by the render pipeline of their scene, which can't render multiple
+ * frames at once, so only a single worker is used for them. */
+static int seq_prefetch_num_workers_get(Scene *scene)
+{
+  Sequence *seq;
+  bool has_scene_strips = false;
+
+  SEQ_BEGIN (scene->ed, seq) {
+    if (seq->type == SEQ_TYPE_SCENE) {
+      has_scene_strips = true;
+    }
+  }
+  SEQ_END;
+
+  if (has_scene_strips) {
+    return 1;
+  }
+
+  return min_ii(BLI_system_thread_count(), SEQ_PREFETCH_MAX_WORKERS);
+}
+
+static void seq_prefetch_free_workers(PrefetchJob *pfjob)
+{
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+    seq_prefetch_free_depsgraph(worker);
+    BKE_main_free(worker->bmain_eval);
+  }
+  MEM_SAFE_FREE(pfjob->workers);
+  pfjob->num_workers = 0;
+}
+
+static void seq_prefetch_init_workers(PrefetchJob *pfjob, int num_workers)
+{
+  pfjob->num_workers = num_workers;
+  pfjob->workers = MEM_callocN(sizeof(PrefetchWorker) * pfjob->num_workers, "PrefetchWorker");
+
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+    worker->pfjob = pfjob;
+    worker->bmain_eval = BKE_main_new();
+  }
 }
 
 static void seq_prefetch_update_area(PrefetchJob *pfjob)
@@ -244,46 +311,52 @@ void BKE_sequencer_prefetch_stop(Scene *scene)
   }
 
   pfjob->stop = true;
+  pfjob->scene_changed = true;
 
   while (pfjob->running) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
-static void seq_prefetch_update_context(const SeqRenderData *context)
+static void seq_prefetch_update_context(PrefetchWorker *worker)
 {
-  PrefetchJob *pfjob;
-  pfjob = seq_prefetch_job_get(context->scene);
+  PrefetchJob *pfjob = worker->pfjob;
+  const SeqRenderData *context = &pfjob->context;
+  const int worker_index = (int)(worker - pfjob->workers);
 
-  BKE_sequencer_new_render_data(pfjob->bmain_eval,
-                                pfjob->depsgraph,
-                                pfjob->scene_eval,
+  BKE_sequencer_new_render_data(worker->bmain_eval,
+                                worker->depsgraph,
+                                worker->scene_eval,
                                 context->rectx,
                                 context->recty,
                                 context->preview_render_size,
                                 false,
-                                &pfjob->context_cpy);
-  pfjob->context_cpy.is_prefetch_render = true;
-  pfjob->context_cpy.task_id = SEQ_TASK_PREFETCH_RENDER;
+                                &worker->context_cpy);
+  worker->context_cpy.is_prefetch_render = true;
+  worker->context_cpy.task_id = SEQ_TASK_PREFETCH_RENDER;
+  worker->context_cpy.worker_index = worker_index;
 
   BKE_sequencer_new_render_data(pfjob->bmain,
-                                pfjob->depsgraph,
+                                worker->depsgraph,
                                 pfjob->scene,
                                 context->rectx,
                                 context->recty,
                                 context->preview_render_size,
                                 false,
-                                &pfjob->context);
-  pfjob->context.is_prefetch_render = false;
+                                &worker->context);
+  worker->context.is_prefetch_render = false;
 
   /* Same ID as prefetch context, because context will be swapped, but we still
    * want to assign this ID to cache entries created in this thread.
-   * This is to allow "temp cache" work correctly for both threads.
+   * This is to allow "temp cache" work correctly for all threads.
    */
-  pfjob->context.task_id = SEQ_TASK_PREFETCH_RENDER;
+  worker->context.task_id = SEQ_TASK_PREFETCH_RENDER;
+  worker->context.worker_index = worker_index;
 }
 
-static void seq_prefetch_update_scene(Scene *scene)
+/* Workers are only created again when their amount changes, depsgraphs of existing workers are
+ * built again when the scene changed. Runs on the main thread, while no worker is running. */
+static void seq_prefetch_update_scene(Scene *scene, int cfra)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
@@ -291,8 +364,27 @@ static void seq_prefetch_update_scene(Scene *scene)
     return;
   }
 
-  seq_prefetch_free_depsgraph(pfjob);
-  seq_prefetch_init_depsgraph(pfjob);
+  const int num_workers = seq_prefetch_num_workers_get(scene);
+
+  if (num_workers != pfjob->num_workers) {
+    seq_prefetch_free_workers(pfjob);
+    seq_prefetch_init_workers(pfjob, num_workers);
+  }
+  else if (pfjob->scene_changed) {
+    for (int i = 0; i < pfjob->num_workers; i++) {
+      seq_prefetch_free_depsgraph(&pfjob->workers[i]);
+    }
+  }
+
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+    if (worker->depsgraph == NULL) {
+      seq_prefetch_init_depsgraph(worker, cfra);
+    }
+    seq_prefetch_update_context(worker);
+  }
+
+  pfjob->scene_changed = false;
 }
 
 static void seq_prefetch_resume(Scene *scene)
@@ -300,7 +392,7 @@ static void seq_prefetch_resume(Scene *scene)
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
   if (pfjob && pfjob->waiting) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
@@ -313,75 +405,101 @@ void BKE_sequencer_prefetch_free(Scene *scene)
 
   BKE_sequencer_prefetch_stop(scene);
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
   BLI_threadpool_end(&pfjob->threads);
   BLI_mutex_end(&pfjob->prefetch_suspend_mutex);
   BLI_condition_end(&pfjob->prefetch_suspend_cond);
-  seq_prefetch_free_depsgraph(pfjob);
-  BKE_main_free(pfjob->bmain_eval);
+  BLI_mutex_end(&pfjob->prefetch_frames_mutex);
+  seq_prefetch_free_workers(pfjob);
   MEM_freeN(pfjob);
   scene->ed->prefetch_job = NULL;
 }
 
-static void *seq_prefetch_frames(void *job)
+/* Hand out next frame to render, returns false when prefetching should end. */
+static bool seq_prefetch_next_frame(PrefetchJob *pfjob, int *r_cfra)
 {
-  PrefetchJob *pfjob = (PrefetchJob *)job;
-
-  while (pfjob->cfra + pfjob->num_frames_prefetched <= pfjob->scene->r.efra) {
-    pfjob->scene_eval->ed->prefetch_job = NULL;
-
-    AnimData *adt = BKE_animdata_from_id(&pfjob->context_cpy.scene->id);
-    BKE_animsys_evaluate_animdata(pfjob->context_cpy.scene,
-                                  &pfjob->context_cpy.scene->id,
-                                  adt,
-                                  pfjob->cfra + pfjob->num_frames_prefetched,
-                                  ADT_RECALC_ALL,
-                                  false);
-    seq_prefetch_update_depsgraph(pfjob);
-
-    /* This is quite hacky solution:
-     * We need cross-reference original scene with copy for cache.
-     * However depsgraph must not have this data, because it will try to kill this job.
-     * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
-     * Set to NULL before return!
-     */
-    pfjob->scene_eval->ed->prefetch_job = pfjob;
+  bool has_frame = false;
 
-    ImBuf *ibuf = BKE_sequencer_give_ibuf(
-        &pfjob->context_cpy, pfjob->cfra + pfjob->num_frames_prefetched, 0);
-    BKE_sequencer_cache_free_temp_cache(
-        pfjob->scene, pfjob->context.task_id, pfjob->cfra + pfjob->num_frames_prefetched);
-    IMB_freeImBuf(ibuf);
+  BLI_mutex_lock(&pfjob->prefetch_frames_mutex);
+  seq_prefetch_update_area(pfjob);
+
+  const int cfra = pfjob->cfra + pfjob->num_frames_prefetched;
+
+  /* Avoid "collision" with main thread, but make sure to fetch at least few frames */
+  const bool collides = pfjob->num_frames_prefetched > 5 && (cfra - pfjob->scene->r.cfra) < 2;
+
+  if (cfra <= pfjob->scene->r.efra && !collides && !pfjob->stop &&
+      (pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE)) {
+    pfjob->num_frames_prefetched++;
+    *r_cfra = cfra;
+    has_frame = true;
+  }
+
+  BLI_mutex_unlock(&pfjob->prefetch_frames_mutex);
+
+  return has_frame;
+}
+
+static void seq_prefetch_render_frame(PrefetchWorker *worker)
+{
+  PrefetchJob *pfjob = worker->pfjob;
+
+  worker->scene_eval->ed->prefetch_job = NULL;
+
+  AnimData *adt = BKE_animdata_from_id(&worker->scene_eval->id);
+  BKE_animsys_evaluate_animdata(
+      worker->scene_eval, &worker->scene_eval->id, adt, worker->cfra, ADT_RECALC_ALL, false);
+  seq_prefetch_update_depsgraph(worker, worker->cfra);
+
+  /* This is quite hacky solution:
+   * We need cross-reference original scene with copy for cache.
+   * However depsgraph must not have this data, because it will try to kill this job.
+   * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
+   * Set to NULL before return!
+   */
+  worker->scene_eval->ed->prefetch_job = pfjob;
+
+  ImBuf *ibuf = BKE_sequencer_give_ibuf(&worker->context_cpy, worker->cfra, 0);
+  BKE_sequencer_cache_free_temp_cache(
+      pfjob->scene, worker->context.task_id, worker->context.worker_index, worker->cfra);
+  IMB_freeImBuf(ibuf);
+}
+
+static void *seq_prefetch_frames(void *worker_v)
+{
+  PrefetchWorker *worker = (PrefetchWorker *)worker_v;
+  PrefetchJob *pfjob = worker->pfjob;
+  bool has_rendered = false;
+
+  while (seq_prefetch_next_frame(pfjob, &worker->cfra)) {
+    seq_prefetch_render_frame(worker);
+    has_rendered = true;
 
     /* suspend thread */
     BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
     while ((seq_prefetch_is_cache_full(pfjob->scene) || seq_prefetch_is_scrubbing(pfjob->bmain)) &&
            pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE && !pfjob->stop) {
+      pfjob->num_workers_waiting++;
       pfjob->waiting = true;
       BLI_condition_wait(&pfjob->prefetch_suspend_cond, &pfjob->prefetch_suspend_mutex);
-      seq_prefetch_update_area(pfjob);
+      pfjob->num_workers_waiting--;
+      pfjob->waiting = pfjob->num_workers_waiting > 0;
     }
-    pfjob->waiting = false;
     BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+  }
 
-    /* Avoid "collision" with main thread, but make sure to fetch at least few frames */
-    if (pfjob->num_frames_prefetched > 5 &&
-        (pfjob->cfra + pfjob->num_frames_prefetched - pfjob->scene->r.cfra) < 2) {
-      break;
-    }
-
-    if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop) {
-      break;
-    }
-
-    seq_prefetch_update_area(pfjob);
-    pfjob->num_frames_prefetched++;
+  if (has_rendered) {
+    BKE_sequencer_cache_free_temp_cache(
+        pfjob->scene, worker->context.task_id, worker->context.worker_index, worker->cfra);
+    worker->scene_eval->ed->prefetch_job = NULL;
   }
 
-  BKE_sequencer_cache_free_temp_cache(
-      pfjob->scene, pfjob->context.task_id, pfjob->cfra + pfjob->num_frames_prefetched);
-  pfjob->running = false;
-  pfjob->scene_eval->ed->prefetch_job = NULL;
+  /* Job is running until last worker finishes. */
+  BLI_mutex_lock(&pfjob->prefetch_frames_mutex);
+  pfjob->num_workers_running--;
+  if (pfjob->num_workers_running == 0) {
+    pfjob->running = false;
+  }
+  BLI_mutex_unlock(&pfjob->prefetch_frames_mutex);
 
   return 0;
 }
@@ -395,31 +513,36 @@ static PrefetchJob *seq_prefetch_start(const SeqRenderData *context, float cfra)
       pfjob = (PrefetchJob *)MEM_callocN(sizeof(PrefetchJob), "PrefetchJob");
       context->scene->ed->prefetch_job = pfjob;
 
-      BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, 1);
+      BLI_threadpool_init(&pfjob->threads,
+                          seq_prefetch_frames,
+                          min_ii(BLI_system_thread_count(), SEQ_PREFETCH_MAX_WORKERS));
       BLI_mutex_init(&pfjob->prefetch_suspend_mutex);
       BLI_condition_init(&pfjob->prefetch_suspend_cond);
+      BLI_mutex_init(&pfjob->prefetch_frames_mutex);
 
       pfjob->bmain = context->bmain;
-      pfjob->bmain_eval = BKE_main_new();
-
       pfjob->scene = context->scene;
-      seq_prefetch_init_depsgraph(pfjob);
     }
   }
-  seq_prefetch_update_scene(context->scene);
-  seq_prefetch_update_context(context);
+
+  /* Workers of previous run must be finished before their scene copies are freed. */
+  BLI_threadpool_clear(&pfjob->threads);
 
   pfjob->cfra = cfra;
   pfjob->num_frames_prefetched = 1;
 
+  pfjob->context = *context;
+  seq_prefetch_update_scene(context->scene, (int)cfra);
+
   pfjob->waiting = false;
   pfjob->stop = false;
   pfjob->running = true;
+  pfjob->num_workers_running = pfjob->num_workers;
+  pfjob->num_workers_waiting = 0;
 
-  if (&pfjob->threads) {
-    BLI_threadpool_remove(&pfjob->threads, pfjob);
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    BLI_threadpool_insert(&pfjob->threads, &pfjob->workers[i]);
   }
-  BLI_threadpool_insert(&pfjob->threads, pfjob);
 
   return pfjob;
 }
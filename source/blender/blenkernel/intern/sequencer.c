@@ -638,6 +638,7 @@ void BKE_sequencer_new_render_data(Main *bmain,
   r_context->view_id = 0;
   r_context->gpu_offscreen = NULL;
   r_context->task_id = SEQ_TASK_MAIN_RENDER;
+  r_context->worker_index = 0;
   r_context->is_prefetch_render = false;
 }
 
@@ -4101,7 +4102,8 @@ ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int cha
     out = BKE_sequencer_cache_get(context, seq_arr[count - 1], cfra, SEQ_CACHE_STORE_FINAL_OUT);
   }
 
-  BKE_sequencer_cache_free_temp_cache(context->scene, context->task_id, cfra);
+  BKE_sequencer_cache_free_temp_cache(
+      context->scene, context->task_id, context->worker_index, cfra);
 
   clock_t begin = seq_estimate_render_cost_begin();
   float cost = 0;
@@ -4440,7 +4442,13 @@ void BKE_sequencer_free_imbuf(Scene *scene, ListBase *seqbase, bool for_render)
 {
   Sequence *seq;
 
-  BKE_sequencer_cache_cleanup(scene);
+  /* Final render only frees memory, the scene did not change. */
+  if (for_render) {
+    BKE_sequencer_cache_cleanup_memory(scene);
+  }
+  else {
+    BKE_sequencer_cache_cleanup(scene);
+  }
   BKE_sequencer_prefetch_stop(scene);
 
   for (seq = seqbase->first; seq; seq = seq->next) {
@@ -6095,5 +6103,5 @@ void BKE_sequencer_all_free_anim_ibufs(Scene *scene, int cfra)
     return;
   }
   sequencer_all_free_anim_ibufs(&ed->seqbase, cfra);
-  BKE_sequencer_cache_cleanup(scene);
+  BKE_sequencer_cache_cleanup_memory(scene);
 }
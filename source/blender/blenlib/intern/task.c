@@ -45,18 +45,12 @@
  */
 #define MEMPOOL_SIZE 256
 
-/* Number of tasks which are pushed directly to local thread queue.
+/* Capacity of the per-thread work-stealing task deques, must be a power of two.
  *
- * This allows thread to fetch next task without locking the whole queue.
+ * Tasks which do not fit into the deque of the pushing thread are pushed to the
+ * scheduler's global queue instead.
  */
-#define LOCAL_QUEUE_SIZE 1
-
-/* Number of tasks which are allowed to be scheduled in a delayed manner.
- *
- * This allows to use less locks per graph node children schedule. More details
- * could be found at TaskThreadLocalStorage::do_delayed_push.
- */
-#define DELAYED_QUEUE_SIZE 4096
+#define TASK_DEQUE_SIZE 4096
 
 #ifndef NDEBUG
 #  define ASSERT_THREAD_ID(scheduler, thread_id) \
@@ -138,29 +132,50 @@ typedef struct TaskThreadLocalStorage {
    */
   TaskMemPool task_mempool;
 
-  /* Local queue keeps thread alive by keeping small amount of tasks ready
-   * to be picked up without causing global thread locks for synchronization.
-   */
-  int num_local_queue;
-  Task *local_queue[LOCAL_QUEUE_SIZE];
-
   /* Thread can be marked for delayed tasks push. This is helpful when it's
    * know that lots of subsequent task pushed will happen from the same thread
    * without "interrupting" for task execution.
    *
-   * We try to accumulate as much tasks as possible in a local queue without
-   * any locks first, and then we push all of them into a scheduler's queue
-   * from within a single mutex lock.
+   * Tasks are still pushed to the thread's deque right away, but sleeping threads
+   * are only woken up once, when the delayed push ends.
    */
   bool do_delayed_push;
-  int num_delayed_queue;
-  Task *delayed_queue[DELAYED_QUEUE_SIZE];
 } TaskThreadLocalStorage;
 
+/* Item of a task deque.
+ *
+ * The pool is stored next to the task, so it can be checked before the task is
+ * taken, without accessing task memory which might be owned by another thread.
+ */
+typedef struct TaskDequeItem {
+  Task *task;
+  TaskPool *pool;
+} TaskDequeItem;
+
+/* Lock-free work-stealing deque (Chase-Lev), with a fixed capacity.
+ *
+ * Only the owning thread pushes and pops tasks at the bottom, in LIFO order, which
+ * keeps the data of nested tasks hot in its caches. Other threads steal tasks from
+ * the top, which are the oldest (and usually biggest) pieces of work.
+ *
+ * Indices are ever-increasing wrapping counters, their difference is the number
+ * of tasks in the deque.
+ */
+typedef struct TaskDeque {
+  uint32_t top;
+  /* Avoid false sharing between the owner's and the thieves' index. */
+  char _pad[60];
+  uint32_t bottom;
+  TaskDequeItem items[TASK_DEQUE_SIZE];
+} TaskDeque;
+
 struct TaskPool {
   TaskScheduler *scheduler;
 
+  /* Number of pushed tasks which are not finished yet. */
   volatile size_t num;
+  /* Number of threads waiting for tasks of this pool in num_cond. */
+  uint32_t num_waiters;
   ThreadMutex num_mutex;
   ThreadCondition num_cond;
 
@@ -201,6 +216,23 @@ struct TaskPool {
 #endif
 };
 
+/* Tasks are scheduled in the following way:
+ *
+ * - Tasks pushed from the main thread or from a worker thread go to the deque of
+ *   that thread. Those threads take their own tasks first, idle threads steal from
+ *   the deques of the others, starting at a random one.
+ *
+ * - Tasks pushed from any other thread, or which do not fit into a deque, go to the
+ *   global queue, which is protected by a mutex.
+ *
+ * - Idle worker threads sleep on the queue condition. Every push increments the work
+ *   generation counter, and only wakes up threads when some are sleeping, so pushing
+ *   does not need any lock in the common case.
+ *
+ * - A thread waiting for a pool only runs tasks of that pool. It takes them from
+ *   anywhere in its own deque, and moves tasks of other pools which cover them in
+ *   the deque of another thread to the global queue.
+ */
 struct TaskScheduler {
   pthread_t *threads;
   struct TaskThread *task_threads;
@@ -210,6 +242,13 @@ struct TaskScheduler {
   ListBase queue;
   ThreadMutex queue_mutex;
   ThreadCondition queue_cond;
+  /* Number of tasks in the global queue, for checks without locking. */
+  volatile uint32_t num_queued;
+
+  /* Incremented after every push, see task_scheduler_work_pushed(). */
+  uint32_t work_gen;
+  /* Number of worker threads waiting for work in queue_cond. */
+  uint32_t num_sleeping;
 
   ThreadMutex startup_mutex;
   ThreadCondition startup_cond;
@@ -224,7 +263,10 @@ struct TaskScheduler {
 typedef struct TaskThread {
   TaskScheduler *scheduler;
   int id;
+  /* State for picking a random thread to steal tasks from. */
+  uint32_t rng_state;
   TaskThreadLocalStorage tls;
+  TaskDeque deque;
 } TaskThread;
 
 /* Helper */
@@ -326,107 +368,340 @@ static void task_free(TaskPool *pool, Task *task, const int thread_id)
   }
 }
 
-/* Task Scheduler */
+/* Task Deque */
 
-static void task_pool_num_decrease(TaskPool *pool, size_t done)
+/* Push a task at the bottom of the deque, only to be called from the owning thread.
+ * Returns false when the deque is full. */
+static bool task_deque_push(TaskDeque *deque, Task *task)
 {
-  BLI_mutex_lock(&pool->num_mutex);
+  const uint32_t bottom = deque->bottom;
+  const uint32_t top = atomic_load_uint32(&deque->top);
 
-  BLI_assert(pool->num >= done);
+  if ((int32_t)(bottom - top) >= TASK_DEQUE_SIZE) {
+    return false;
+  }
 
-  pool->num -= done;
+  TaskDequeItem *item = &deque->items[bottom & (TASK_DEQUE_SIZE - 1)];
+  item->task = task;
+  item->pool = task->pool;
 
-  if (pool->num == 0) {
-    BLI_condition_notify_all(&pool->num_cond);
+  /* Make the item visible to thieves before the new bottom. */
+  atomic_store_uint32(&deque->bottom, bottom + 1);
+  return true;
+}
+
+/* Pop the most recently pushed task, only to be called from the owning thread.
+ * When pool is given, only a task of that pool is returned. */
+static Task *task_deque_pop(TaskDeque *deque, const TaskPool *pool)
+{
+  while (true) {
+    const uint32_t old_bottom = deque->bottom;
+    uint32_t top = atomic_load_uint32(&deque->top);
+
+    /* Top only ever increases, so a deque which looks empty here is empty. */
+    if ((int32_t)(old_bottom - top) <= 0) {
+      return NULL;
+    }
+
+    /* Tasks of other pools can be pushed on top of the tasks of the pool, when the thread runs
+     * one of them while it is waiting for the pool. Find the most recent task of the pool. */
+    uint32_t bottom = old_bottom - 1;
+    if (pool != NULL) {
+      while (deque->items[bottom & (TASK_DEQUE_SIZE - 1)].pool != pool) {
+        if ((int32_t)(bottom - top) <= 0) {
+          return NULL;
+        }
+        bottom -= 1;
+      }
+    }
+
+    /* Reserve the item before looking at top, so thieves see the reservation. Items above it
+     * are hidden from thieves until bottom is restored. */
+    atomic_store_uint32(&deque->bottom, bottom);
+    top = atomic_load_uint32(&deque->top);
+    const int32_t num_tasks_left = (int32_t)(bottom - top);
+
+    if (num_tasks_left < 0) {
+      /* Thieves took the item meanwhile, look again. */
+      atomic_store_uint32(&deque->bottom, old_bottom);
+      continue;
+    }
+
+    Task *task = deque->items[bottom & (TASK_DEQUE_SIZE - 1)].task;
+    if (num_tasks_left > 0) {
+      /* Close the gap, thieves can't access items which are not below bottom. */
+      for (uint32_t i = bottom; i + 1 != old_bottom; i++) {
+        deque->items[i & (TASK_DEQUE_SIZE - 1)] = deque->items[(i + 1) & (TASK_DEQUE_SIZE - 1)];
+      }
+      atomic_store_uint32(&deque->bottom, old_bottom - 1);
+      return task;
+    }
+
+    /* Oldest task in the deque, race against thieves for it. Either way top moves past it,
+     * so the items above it stay in place. */
+    const bool is_taken = (atomic_cas_uint32(&deque->top, top, top + 1) == top);
+    atomic_store_uint32(&deque->bottom, old_bottom);
+    if (is_taken) {
+      return task;
+    }
   }
+}
 
-  BLI_mutex_unlock(&pool->num_mutex);
+/* Check whether any task of the pool is in the deque, can be called from any thread.
+ * The result is only a hint, tasks are taken by other threads meanwhile. */
+static bool task_deque_has_pool(const TaskDeque *deque, const TaskPool *pool)
+{
+  const uint32_t top = atomic_load_uint32(&deque->top);
+  const uint32_t bottom = atomic_load_uint32(&deque->bottom);
+
+  for (uint32_t i = top; (int32_t)(bottom - i) > 0; i++) {
+    if (deque->items[i & (TASK_DEQUE_SIZE - 1)].pool == pool) {
+      return true;
+    }
+  }
+  return false;
 }
 
-static void task_pool_num_increase(TaskPool *pool, size_t new)
+/* Steal the oldest task of the deque, can be called from any thread.
+ * When pool is given, only a task of that pool is returned. */
+static Task *task_deque_steal(TaskDeque *deque, const TaskPool *pool)
+{
+  const uint32_t top = atomic_load_uint32(&deque->top);
+  const uint32_t bottom = atomic_load_uint32(&deque->bottom);
+
+  if ((int32_t)(bottom - top) <= 0) {
+    return NULL;
+  }
+
+  /* The item might be overwritten after it was taken by someone else,
+   * the CAS below fails in that case. */
+  const TaskDequeItem item = deque->items[top & (TASK_DEQUE_SIZE - 1)];
+  if (pool != NULL && item.pool != pool) {
+    return NULL;
+  }
+
+  if (atomic_cas_uint32(&deque->top, top, top + 1) != top) {
+    return NULL;
+  }
+  return item.task;
+}
+
+/* Task Scheduler */
+
+static void task_pool_num_decrease(TaskPool *pool, size_t done)
 {
+  /* Decrease without locking, unless this finishes the pool. */
+  size_t num = pool->num;
+  while (num > done) {
+    const size_t num_prev = atomic_cas_z((size_t *)&pool->num, num, num - done);
+    if (num_prev == num) {
+      return;
+    }
+    num = num_prev;
+  }
+
+  /* The last decrease happens with the mutex locked, waiters check for it with the mutex
+   * locked too. This way the pool is not accessed here anymore once they see it finished,
+   * and might free it. */
   BLI_mutex_lock(&pool->num_mutex);
 
-  pool->num += new;
+  BLI_assert(pool->num >= done);
+  atomic_sub_and_fetch_z((size_t *)&pool->num, done);
   BLI_condition_notify_all(&pool->num_cond);
 
   BLI_mutex_unlock(&pool->num_mutex);
 }
 
-static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, Task **task)
+static void task_pool_num_increase(TaskPool *pool, size_t new)
+{
+  atomic_add_and_fetch_z((size_t *)&pool->num, new);
+}
+
+/* Wake up threads after new tasks of the pool were made available.
+ *
+ * Sleeping threads re-check the work generation after announcing themselves as
+ * sleepers, so either they see the new generation or we see them sleeping.
+ */
+static void task_scheduler_work_pushed(TaskScheduler *scheduler,
+                                       TaskPool *pool,
+                                       const bool notify_all)
 {
-  bool found_task = false;
+  atomic_add_and_fetch_uint32(&scheduler->work_gen, 1);
+
+  if (atomic_load_uint32(&scheduler->num_sleeping) != 0) {
+    BLI_mutex_lock(&scheduler->queue_mutex);
+    if (notify_all) {
+      BLI_condition_notify_all(&scheduler->queue_cond);
+    }
+    else {
+      BLI_condition_notify_one(&scheduler->queue_cond);
+    }
+    BLI_mutex_unlock(&scheduler->queue_mutex);
+  }
+
+  if (atomic_load_uint32(&pool->num_waiters) != 0) {
+    BLI_mutex_lock(&pool->num_mutex);
+    BLI_condition_notify_all(&pool->num_cond);
+    BLI_mutex_unlock(&pool->num_mutex);
+  }
+}
+
+/* Move a task taken from a deque to the global queue.
+ *
+ * Threads are woken up before the queue is unlocked, the pool of the task might be freed
+ * as soon as another thread takes the task.
+ */
+static void task_scheduler_requeue(TaskScheduler *scheduler, Task *task)
+{
+  TaskPool *pool = task->pool;
+
   BLI_mutex_lock(&scheduler->queue_mutex);
+  BLI_addtail(&scheduler->queue, task);
+  scheduler->num_queued++;
+
+  atomic_add_and_fetch_uint32(&scheduler->work_gen, 1);
+  BLI_condition_notify_one(&scheduler->queue_cond);
 
-  while (!scheduler->queue.first && !scheduler->do_exit) {
-    BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+  if (atomic_load_uint32(&pool->num_waiters) != 0) {
+    BLI_mutex_lock(&pool->num_mutex);
+    BLI_condition_notify_all(&pool->num_cond);
+    BLI_mutex_unlock(&pool->num_mutex);
   }
 
-  do {
-    Task *current_task;
+  BLI_mutex_unlock(&scheduler->queue_mutex);
+}
 
-    /* Assuming we can only have a void queue in 'exit' case here seems logical
-     * (we should only be here after our worker thread has been woken up from a
-     * condition_wait(), which only happens after a new task was added to the queue),
-     * but it is wrong.
-     * Waiting on condition may wake up the thread even if condition is not signaled
-     * (spurious wake-ups), and some race condition may also empty the queue **after**
-     * condition has been signaled, but **before** awoken thread reaches this point...
-     * See http://stackoverflow.com/questions/8594591
-     *
-     * So we only abort here if do_exit is set.
-     */
-    if (scheduler->do_exit) {
-      BLI_mutex_unlock(&scheduler->queue_mutex);
-      return false;
-    }
+BLI_INLINE uint32_t task_thread_rng_next(TaskThread *thread)
+{
+  /* Xorshift, good enough to spread stealing over threads. */
+  uint32_t x = thread->rng_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  thread->rng_state = x;
+  return x;
+}
+
+/* Find a task to run.
+ *
+ * - thread: Thread which owns a deque, its own tasks are taken first. Can be NULL.
+ * - pool: When not NULL, only tasks of this pool are taken.
+ * - background_only: Only take tasks of pools which run in background.
+ */
+static Task *task_scheduler_find_task(TaskScheduler *scheduler,
+                                      TaskThread *thread,
+                                      const TaskPool *pool,
+                                      const bool background_only)
+{
+  Task *task = NULL;
 
-    for (current_task = scheduler->queue.first; current_task != NULL;
-         current_task = current_task->next) {
-      TaskPool *pool = current_task->pool;
+  if (thread != NULL) {
+    task = task_deque_pop(&thread->deque, pool);
+    if (task != NULL) {
+      return task;
+    }
+  }
 
-      if (scheduler->background_thread_only && !pool->run_in_background) {
+  if (scheduler->num_queued != 0) {
+    BLI_mutex_lock(&scheduler->queue_mutex);
+    for (task = scheduler->queue.first; task != NULL; task = task->next) {
+      if (pool != NULL && task->pool != pool) {
         continue;
       }
-
-      *task = current_task;
-      found_task = true;
-      BLI_remlink(&scheduler->queue, *task);
+      if (background_only && !task->pool->run_in_background) {
+        continue;
+      }
+      BLI_remlink(&scheduler->queue, task);
+      scheduler->num_queued--;
       break;
     }
-    if (!found_task) {
-      BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+    BLI_mutex_unlock(&scheduler->queue_mutex);
+    if (task != NULL) {
+      return task;
     }
-  } while (!found_task);
+  }
 
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+  /* Deques are not used when only the background thread exists. */
+  if (scheduler->background_thread_only) {
+    return NULL;
+  }
 
-  return true;
+  const int num_deques = scheduler->num_threads + 1;
+  const int start = (thread != NULL) ? (int)(task_thread_rng_next(thread) % num_deques) : 0;
+  for (int i = 0; i < num_deques; i++) {
+    TaskThread *victim = &scheduler->task_threads[(start + i) % num_deques];
+    if (victim == thread) {
+      continue;
+    }
+    task = task_deque_steal(&victim->deque, pool);
+    while (task == NULL && pool != NULL && task_deque_has_pool(&victim->deque, pool)) {
+      /* Tasks of other pools are older than a task of the pool. This thread waits for the pool
+       * and must not run them, move them to the global queue where other threads still can. */
+      task = task_deque_steal(&victim->deque, NULL);
+      if (task != NULL && task->pool != pool) {
+        task_scheduler_requeue(scheduler, task);
+        task = NULL;
+      }
+    }
+    if (task != NULL) {
+      return task;
+    }
+  }
+
+  return NULL;
 }
 
-BLI_INLINE void handle_local_queue(TaskThreadLocalStorage *tls, const int thread_id)
+static bool task_scheduler_thread_wait_pop(TaskThread *thread, Task **task)
 {
-  BLI_assert(!tls->do_delayed_push);
-  while (tls->num_local_queue > 0) {
-    /* We pop task from queue before handling it so handler of the task can
-     * push next job to the local queue.
-     */
-    tls->num_local_queue--;
-    Task *local_task = tls->local_queue[tls->num_local_queue];
-    /* TODO(sergey): Double-check work_and_wait() doesn't handle other's
-     * pool tasks.
-     */
-    TaskPool *local_pool = local_task->pool;
-    local_task->run(local_pool, local_task->taskdata, thread_id);
-    task_free(local_pool, local_task, thread_id);
+  TaskScheduler *scheduler = thread->scheduler;
+
+  while (true) {
+    const uint32_t work_gen = atomic_load_uint32(&scheduler->work_gen);
+
+    if (scheduler->do_exit) {
+      return false;
+    }
+
+    *task = task_scheduler_find_task(
+        scheduler, thread, NULL, scheduler->background_thread_only);
+    if (*task != NULL) {
+      return true;
+    }
+
+    /* Nothing to do, sleep until something gets pushed.
+     * Waiting on condition may wake up the thread even if condition is not signaled
+     * (spurious wake-ups), hence the loop. */
+    BLI_mutex_lock(&scheduler->queue_mutex);
+    atomic_add_and_fetch_uint32(&scheduler->num_sleeping, 1);
+    while (!scheduler->do_exit && atomic_load_uint32(&scheduler->work_gen) == work_gen) {
+      BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+    }
+    atomic_sub_and_fetch_uint32(&scheduler->num_sleeping, 1);
+    BLI_mutex_unlock(&scheduler->queue_mutex);
+  }
+}
+
+/* Run the task, unless its pool was canceled meanwhile, and mark it done. */
+BLI_INLINE void task_run_and_free(TaskPool *pool, Task *task, const int thread_id)
+{
+  TaskThreadLocalStorage *tls = get_task_tls(pool, thread_id);
+  UNUSED_VARS_NDEBUG(tls);
+
+  if (!pool->do_cancel) {
+    BLI_assert(!tls->do_delayed_push);
+    task->run(pool, task->taskdata, thread_id);
+    BLI_assert(!tls->do_delayed_push);
   }
-  BLI_assert(!tls->do_delayed_push);
+
+  task_free(pool, task, thread_id);
+
+  /* Notify pool task was done, the pool might be freed after this. */
+  task_pool_num_decrease(pool, 1);
 }
 
 static void *task_scheduler_thread_run(void *thread_p)
 {
   TaskThread *thread = (TaskThread *)thread_p;
-  TaskThreadLocalStorage *tls = &thread->tls;
   TaskScheduler *scheduler = thread->scheduler;
   int thread_id = thread->id;
   Task *task;
@@ -442,22 +717,8 @@ static void *task_scheduler_thread_run(void *thread_p)
   BLI_mutex_unlock(&scheduler->startup_mutex);
 
   /* keep popping off tasks */
-  while (task_scheduler_thread_wait_pop(scheduler, &task)) {
-    TaskPool *pool = task->pool;
-
-    /* run task */
-    BLI_assert(!tls->do_delayed_push);
-    task->run(pool, task->taskdata, thread_id);
-    BLI_assert(!tls->do_delayed_push);
-
-    /* delete task */
-    task_free(pool, task, thread_id);
-
-    /* Handle all tasks from local queue. */
-    handle_local_queue(tls, thread_id);
-
-    /* notify pool task was done */
-    task_pool_num_decrease(pool, 1);
+  while (task_scheduler_thread_wait_pop(thread, &task)) {
+    task_run_and_free(task->pool, task, thread_id);
   }
 
   return NULL;
@@ -493,10 +754,14 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
     num_threads = 1;
   }
 
-  scheduler->task_threads = MEM_mallocN(sizeof(TaskThread) * (num_threads + 1),
+  /* Deques must start out empty. */
+  scheduler->task_threads = MEM_callocN(sizeof(TaskThread) * (num_threads + 1),
                                         "TaskScheduler task threads");
 
   /* Initialize TLS for main thread. */
+  scheduler->task_threads[0].scheduler = scheduler;
+  scheduler->task_threads[0].id = 0;
+  scheduler->task_threads[0].rng_state = 1;
   initialize_task_tls(&scheduler->task_threads[0].tls);
 
   pthread_key_create(&scheduler->tls_id_key, NULL);
@@ -512,6 +777,7 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
       TaskThread *thread = &scheduler->task_threads[i + 1];
       thread->scheduler = scheduler;
       thread->id = i + 1;
+      thread->rng_state = (uint32_t)(i + 2) * 2654435761u;
       initialize_task_tls(&thread->tls);
 
       if (pthread_create(&scheduler->threads[i], NULL, task_scheduler_thread_run, thread) != 0) {
@@ -564,6 +830,8 @@ void BLI_task_scheduler_free(TaskScheduler *scheduler)
     for (int i = 0; i < scheduler->num_threads + 1; i++) {
       TaskThreadLocalStorage *tls = &scheduler->task_threads[i].tls;
       free_task_tls(tls);
+      /* Pools wait for their tasks, so nothing can be left in the deques. */
+      BLI_assert(scheduler->task_threads[i].deque.top == scheduler->task_threads[i].deque.bottom);
     }
 
     MEM_freeN(scheduler->task_threads);
@@ -591,7 +859,8 @@ int BLI_task_scheduler_num_threads(TaskScheduler *scheduler)
 
 static void task_scheduler_push(TaskScheduler *scheduler, Task *task, TaskPriority priority)
 {
-  task_pool_num_increase(task->pool, 1);
+  /* The task might be done and freed as soon as it is in the queue. */
+  TaskPool *pool = task->pool;
 
   /* add task to queue */
   BLI_mutex_lock(&scheduler->queue_mutex);
@@ -602,30 +871,38 @@ static void task_scheduler_push(TaskScheduler *scheduler, Task *task, TaskPriori
   else {
     BLI_addtail(&scheduler->queue, task);
   }
+  scheduler->num_queued++;
 
-  BLI_condition_notify_one(&scheduler->queue_cond);
   BLI_mutex_unlock(&scheduler->queue_mutex);
+
+  task_scheduler_work_pushed(scheduler, pool, false);
 }
 
+/* Push all tasks of the list, to the deque of the calling thread when possible. */
 static void task_scheduler_push_all(TaskScheduler *scheduler,
                                     TaskPool *pool,
-                                    Task **tasks,
-                                    int num_tasks)
+                                    TaskThread *thread,
+                                    ListBase *tasks)
 {
-  if (num_tasks == 0) {
+  if (BLI_listbase_is_empty(tasks)) {
     return;
   }
 
-  task_pool_num_increase(pool, num_tasks);
-
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  if (thread != NULL) {
+    Task *task;
+    while ((task = tasks->first) && task_deque_push(&thread->deque, task)) {
+      BLI_remlink(tasks, task);
+    }
+  }
 
-  for (int i = 0; i < num_tasks; i++) {
-    BLI_addhead(&scheduler->queue, tasks[i]);
+  if (!BLI_listbase_is_empty(tasks)) {
+    BLI_mutex_lock(&scheduler->queue_mutex);
+    scheduler->num_queued += (uint32_t)BLI_listbase_count(tasks);
+    BLI_movelisttolist(&scheduler->queue, tasks);
+    BLI_mutex_unlock(&scheduler->queue_mutex);
   }
 
-  BLI_condition_notify_all(&scheduler->queue_cond);
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+  task_scheduler_work_pushed(scheduler, pool, true);
 }
 
 static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
@@ -642,6 +919,7 @@ static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
     if (task->pool == pool) {
       task_data_free(task, pool->thread_id);
       BLI_freelinkN(&scheduler->queue, task);
+      scheduler->num_queued--;
 
       done++;
     }
@@ -650,7 +928,9 @@ static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
   BLI_mutex_unlock(&scheduler->queue_mutex);
 
   /* notify done */
-  task_pool_num_decrease(pool, done);
+  if (done != 0) {
+    task_pool_num_decrease(pool, done);
+  }
 }
 
 /* Task Pool */
@@ -677,6 +957,7 @@ static TaskPool *task_pool_create_ex(TaskScheduler *scheduler,
 
   pool->scheduler = scheduler;
   pool->num = 0;
+  pool->num_waiters = 0;
   pool->do_cancel = false;
   pool->do_work = false;
   pool->is_suspended = is_suspended;
@@ -796,9 +1077,36 @@ void BLI_task_pool_free(TaskPool *pool)
   BLI_threaded_malloc_end();
 }
 
-BLI_INLINE bool task_can_use_local_queues(TaskPool *pool, int thread_id)
+/* Thread owning the deque which tasks pushed from given thread ID go to,
+ * NULL when they have to go to the global queue. */
+BLI_INLINE TaskThread *task_pool_push_thread_get(TaskPool *pool, int thread_id)
+{
+  TaskScheduler *scheduler = pool->scheduler;
+
+  if (thread_id == -1 || scheduler->background_thread_only) {
+    return NULL;
+  }
+  /* Threads which are not managed by the scheduler identify as 0 too. */
+  if (thread_id == 0 && (pool->use_local_tls || !BLI_thread_is_main())) {
+    return NULL;
+  }
+  ASSERT_THREAD_ID(scheduler, thread_id);
+  return &scheduler->task_threads[thread_id];
+}
+
+/* Thread owning the deque of the calling thread, when it is the one the pool was created from. */
+BLI_INLINE TaskThread *task_pool_creator_thread_get(TaskPool *pool)
 {
-  return (thread_id != -1 && (thread_id != pool->thread_id || pool->do_work));
+  TaskScheduler *scheduler = pool->scheduler;
+
+  if (scheduler->background_thread_only || pool->use_local_tls) {
+    return NULL;
+  }
+  if (pool->thread_id == 0) {
+    return BLI_thread_is_main() ? &scheduler->task_threads[0] : NULL;
+  }
+  TaskThread *thread = pthread_getspecific(scheduler->tls_id_key);
+  return (thread != NULL && thread->id == pool->thread_id) ? thread : NULL;
 }
 
 static void task_pool_push(TaskPool *pool,
@@ -827,28 +1135,21 @@ static void task_pool_push(TaskPool *pool,
     atomic_fetch_and_add_z(&pool->num_suspended, 1);
     return;
   }
-  /* Populate to any local queue first, this is cheapest push ever. */
-  if (task_can_use_local_queues(pool, thread_id)) {
-    ASSERT_THREAD_ID(pool->scheduler, thread_id);
-    TaskThreadLocalStorage *tls = get_task_tls(pool, thread_id);
-    /* Try to push to a local execution queue.
-     * These tasks will be picked up next.
-     */
-    if (tls->num_local_queue < LOCAL_QUEUE_SIZE) {
-      tls->local_queue[tls->num_local_queue] = task;
-      tls->num_local_queue++;
-      return;
-    }
-    /* If we are in the delayed tasks push mode, we push tasks to a
-     * temporary local queue first without any locks, and then move them
-     * to global execution queue with a single lock.
-     */
-    if (tls->do_delayed_push && tls->num_delayed_queue < DELAYED_QUEUE_SIZE) {
-      tls->delayed_queue[tls->num_delayed_queue] = task;
-      tls->num_delayed_queue++;
-      return;
+
+  /* Account for the task before anyone can run it. */
+  task_pool_num_increase(pool, 1);
+
+  /* Push to the deque of the current thread first, this is cheapest push ever,
+   * other threads steal from it when they run out of work. */
+  TaskThread *thread = task_pool_push_thread_get(pool, thread_id);
+  if (thread != NULL && task_deque_push(&thread->deque, task)) {
+    /* In the delayed tasks push mode threads are woken up once, at the end. */
+    if (!get_task_tls(pool, thread_id)->do_delayed_push) {
+      task_scheduler_work_pushed(pool->scheduler, pool, false);
     }
+    return;
   }
+
   /* Do push to a global execution pool, slowest possible method,
    * causes quite reasonable amount of threading overhead.
    */
@@ -881,85 +1182,60 @@ void BLI_task_pool_push_from_thread(TaskPool *pool,
   task_pool_push(pool, run, taskdata, free_taskdata, NULL, priority, thread_id);
 }
 
-void BLI_task_pool_work_and_wait(TaskPool *pool)
+/* Run tasks of the pool from the calling thread until all of them are done.
+ *
+ * Only tasks of this pool are taken, if we get a task from another pool,
+ * we can get into deadlock. */
+static void task_pool_work_until_done(TaskPool *pool, TaskThread *thread)
 {
-  TaskThreadLocalStorage *tls = get_task_tls(pool, pool->thread_id);
   TaskScheduler *scheduler = pool->scheduler;
 
-  if (atomic_fetch_and_and_uint8((uint8_t *)&pool->is_suspended, 0)) {
-    if (pool->num_suspended) {
-      task_pool_num_increase(pool, pool->num_suspended);
-      BLI_mutex_lock(&scheduler->queue_mutex);
+  while (true) {
+    const uint32_t work_gen = atomic_load_uint32(&scheduler->work_gen);
 
-      BLI_movelisttolist(&scheduler->queue, &pool->suspended_queue);
-
-      BLI_condition_notify_all(&scheduler->queue_cond);
-      BLI_mutex_unlock(&scheduler->queue_mutex);
-
-      pool->num_suspended = 0;
-    }
-  }
-
-  pool->do_work = true;
-
-  ASSERT_THREAD_ID(pool->scheduler, pool->thread_id);
-
-  handle_local_queue(tls, pool->thread_id);
-
-  BLI_mutex_lock(&pool->num_mutex);
-
-  while (pool->num != 0) {
-    Task *task, *work_task = NULL;
-    bool found_task = false;
-
-    BLI_mutex_unlock(&pool->num_mutex);
-
-    BLI_mutex_lock(&scheduler->queue_mutex);
-
-    /* find task from this pool. if we get a task from another pool,
-     * we can get into deadlock */
-
-    for (task = scheduler->queue.first; task; task = task->next) {
-      if (task->pool == pool) {
-        work_task = task;
-        found_task = true;
-        BLI_remlink(&scheduler->queue, task);
-        break;
+    if (pool->num != 0) {
+      Task *task = task_scheduler_find_task(scheduler, thread, pool, false);
+      if (task != NULL) {
+        task_run_and_free(pool, task, pool->thread_id);
+        continue;
       }
     }
 
-    BLI_mutex_unlock(&scheduler->queue_mutex);
-
-    /* if found task, do it, otherwise wait until other tasks are done */
-    if (found_task) {
-      /* run task */
-      BLI_assert(!tls->do_delayed_push);
-      work_task->run(pool, work_task->taskdata, pool->thread_id);
-      BLI_assert(!tls->do_delayed_push);
-
-      /* delete task */
-      task_free(pool, task, pool->thread_id);
-
-      /* Handle all tasks from local queue. */
-      handle_local_queue(tls, pool->thread_id);
-
-      /* notify pool task was done */
-      task_pool_num_decrease(pool, 1);
-    }
-
+    /* Remaining tasks are running in other threads, wait until they are done
+     * or push more tasks. */
     BLI_mutex_lock(&pool->num_mutex);
     if (pool->num == 0) {
+      BLI_mutex_unlock(&pool->num_mutex);
       break;
     }
-
-    if (!found_task) {
+    atomic_add_and_fetch_uint32(&pool->num_waiters, 1);
+    while (pool->num != 0 && atomic_load_uint32(&scheduler->work_gen) == work_gen) {
       BLI_condition_wait(&pool->num_cond, &pool->num_mutex);
     }
+    atomic_sub_and_fetch_uint32(&pool->num_waiters, 1);
+    BLI_mutex_unlock(&pool->num_mutex);
   }
+}
 
-  BLI_mutex_unlock(&pool->num_mutex);
+void BLI_task_pool_work_and_wait(TaskPool *pool)
+{
+  TaskScheduler *scheduler = pool->scheduler;
+
+  ASSERT_THREAD_ID(pool->scheduler, pool->thread_id);
+
+  TaskThread *thread = task_pool_creator_thread_get(pool);
+
+  if (atomic_fetch_and_and_uint8((uint8_t *)&pool->is_suspended, 0)) {
+    if (pool->num_suspended) {
+      task_pool_num_increase(pool, pool->num_suspended);
+      task_scheduler_push_all(scheduler, pool, thread, &pool->suspended_queue);
+      pool->num_suspended = 0;
+    }
+  }
+
+  pool->do_work = true;
 
-  BLI_assert(tls->num_local_queue == 0);
+  task_pool_work_until_done(pool, thread);
 }
 
 void BLI_task_pool_work_wait_and_reset(TaskPool *pool)
@@ -976,12 +1252,19 @@ void BLI_task_pool_cancel(TaskPool *pool)
 
   task_scheduler_clear(pool->scheduler, pool);
 
-  /* wait until all entries are cleared */
-  BLI_mutex_lock(&pool->num_mutex);
-  while (pool->num) {
-    BLI_condition_wait(&pool->num_cond, &pool->num_mutex);
+  /* Tasks left in thread deques are discarded when popped. Help with that when we own
+   * the deque they were pushed to, otherwise just wait until all entries are cleared. */
+  TaskThread *thread = task_pool_creator_thread_get(pool);
+  if (thread != NULL) {
+    task_pool_work_until_done(pool, thread);
+  }
+  else {
+    BLI_mutex_lock(&pool->num_mutex);
+    while (pool->num) {
+      BLI_condition_wait(&pool->num_cond, &pool->num_mutex);
+    }
+    BLI_mutex_unlock(&pool->num_mutex);
   }
-  BLI_mutex_unlock(&pool->num_mutex);
 
   pool->do_cancel = false;
 }
@@ -1003,8 +1286,7 @@ ThreadMutex *BLI_task_pool_user_mutex(TaskPool *pool)
 
 void BLI_task_pool_delayed_push_begin(TaskPool *pool, int thread_id)
 {
-  if (task_can_use_local_queues(pool, thread_id)) {
-    ASSERT_THREAD_ID(pool->scheduler, thread_id);
+  if (task_pool_push_thread_get(pool, thread_id) != NULL) {
     TaskThreadLocalStorage *tls = get_task_tls(pool, thread_id);
     tls->do_delayed_push = true;
   }
@@ -1012,13 +1294,11 @@ void BLI_task_pool_delayed_push_begin(TaskPool *pool, int thread_id)
 
 void BLI_task_pool_delayed_push_end(TaskPool *pool, int thread_id)
 {
-  if (task_can_use_local_queues(pool, thread_id)) {
-    ASSERT_THREAD_ID(pool->scheduler, thread_id);
+  if (task_pool_push_thread_get(pool, thread_id) != NULL) {
     TaskThreadLocalStorage *tls = get_task_tls(pool, thread_id);
     BLI_assert(tls->do_delayed_push);
-    task_scheduler_push_all(pool->scheduler, pool, tls->delayed_queue, tls->num_delayed_queue);
     tls->do_delayed_push = false;
-    tls->num_delayed_queue = 0;
+    task_scheduler_work_pushed(pool->scheduler, pool, true);
   }
 }
 
@@ -76,6 +76,14 @@ typedef struct WorkspaceConfigFileData {
 struct BlendFileReadParams {
   uint skip_flags : 2; /* eBLOReadSkip */
   uint is_startup : 1;
+  /** Undo: keep IDs of the current main which are unchanged in the #MemFile being read. */
+  uint undo_reuse_ids : 1;
+  /**
+   * Undo: #MemFile written against the other one of the current main state and the #MemFile
+   * being read, its ID chunks tell which IDs are identical in both. NULL when the current main
+   * was last written to the #MemFile being read itself.
+   */
+  const struct MemFile *undo_memfile_identical;
 };
 
 /* skip reading some data-block types (may want to skip screen data too). */
@@ -96,7 +104,7 @@ BlendFileData *BLO_read_from_memory(const void *mem,
 BlendFileData *BLO_read_from_memfile(struct Main *oldmain,
                                      const char *filename,
                                      struct MemFile *memfile,
-                                     eBLOReadSkip skip_flags,
+                                     const struct BlendFileReadParams *params,
                                      struct ReportList *reports);
 
 void BLO_blendfiledata_free(BlendFileData *bfd);
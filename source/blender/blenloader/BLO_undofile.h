@@ -25,6 +25,7 @@
  * \ingroup blenloader
  */
 
+struct GHash;
 struct Scene;
 
 typedef struct {
@@ -36,9 +37,22 @@ typedef struct {
   bool is_identical;
 } MemFileChunk;
 
+/** The chunks an ID was written into, each ID starts a new chunk (undo only). */
+typedef struct MemFileIDChunks {
+  MemFileChunk *first;
+  unsigned int chunks_len;
+  /**
+   * When true, all chunks are identical to the ones of the same ID in the #MemFile
+   * this one was compared with while writing, so the ID didn't change.
+   */
+  bool is_identical;
+} MemFileIDChunks;
+
 typedef struct MemFile {
   ListBase chunks;
   size_t size;
+  /** Maps ID addresses to their #MemFileIDChunks. */
+  struct GHash *id_chunks;
 } MemFile;
 
 typedef struct MemFileUndoData {
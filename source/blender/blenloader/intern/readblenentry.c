@@ -363,7 +363,7 @@ BlendFileData *BLO_read_from_memory(const void *mem,
 BlendFileData *BLO_read_from_memfile(Main *oldmain,
                                      const char *filename,
                                      MemFile *memfile,
-                                     eBLOReadSkip skip_flags,
+                                     const struct BlendFileReadParams *params,
                                      ReportList *reports)
 {
   BlendFileData *bfd = NULL;
@@ -373,7 +373,7 @@ BlendFileData *BLO_read_from_memfile(Main *oldmain,
   fd = blo_filedata_from_memfile(memfile, reports);
   if (fd) {
     fd->reports = reports;
-    fd->skip_flags = skip_flags;
+    fd->skip_flags = params->skip_flags;
     BLI_strncpy(fd->relabase, filename, sizeof(fd->relabase));
 
     /* clear ob->proxy_from pointers in old main */
@@ -384,6 +384,11 @@ BlendFileData *BLO_read_from_memfile(Main *oldmain,
     /* add the library pointers in oldmap lookup */
     blo_add_library_pointer_map(&old_mainlist, fd);
 
+    /* makes lookup of existing IDs in old main, to keep unchanged ones */
+    if (params->undo_reuse_ids) {
+      blo_make_undo_old_id_map(fd, oldmain, params->undo_memfile_identical);
+    }
+
     /* makes lookup of existing images in old main */
     blo_make_image_pointer_map(fd, oldmain);
 
@@ -451,6 +456,10 @@ BlendFileData *BLO_read_from_memfile(Main *oldmain,
     printf("Remaining mains/libs in oldmain: %d\n", BLI_listbase_count(&fd->old_mainlist) - 1);
 #endif
 
+    if (params->undo_reuse_ids) {
+      blo_end_undo_old_id_map(fd, bfd ? bfd->main : NULL);
+    }
+
     /* That way, libs (aka mains) we did not reuse in new undone/redone state
      * will be cleared together with oldmain... */
     blo_join_main(&old_mainlist);
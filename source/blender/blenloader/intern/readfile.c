@@ -34,6 +34,15 @@
 #include "BLI_utildefines.h"
 #ifndef WIN32
 #  include <unistd.h>  // for read close
+#  include <signal.h>  // for sigaction
+#  include <sys/mman.h>  // for mmap
+#  include <sys/stat.h>  // for fstat
+#  ifdef __linux__
+#    include <sys/vfs.h>  // for fstatfs
+#  else
+#    include <sys/param.h>
+#    include <sys/mount.h>  // for fstatfs
+#  endif
 #else
 #  include <io.h>  // for open close read
 #  include "winsock2.h"
@@ -100,6 +109,7 @@
 #include "BLI_math.h"
 #include "BLI_threads.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 #include "BLI_ghash.h"
 
 #include "BLT_translation.h"
@@ -217,11 +227,26 @@
  * Delay reading blocks we might not use (especially applies to library linking).
  * which keeps large arrays in memory from data-blocks we may not even use.
  *
- * \note This is disabled when using compression,
+ * \note This is disabled when reading compressed files written before frames were used,
  * while zlib supports seek it's unusably slow, see: T61880.
+ * Files with a frame index (see #BLEND_GZIP_FRAME_SIZE) only decompress frames that are read.
  */
 #define USE_BHEAD_READ_ON_DEMAND
 
+/**
+ * Map uncompressed files into memory instead of reading them,
+ * so data can be copied directly from the page cache (which is shared between processes)
+ * and read on demand without any system calls.
+ *
+ * Only regular files on local file-systems are mapped. Reading a mapping fails with SIGBUS
+ * when the file is truncated or the volume goes away, this is caught and the read fails instead.
+ *
+ * \note Not used on WIN32, where the mmap emulation is not thread-safe.
+ */
+#ifndef WIN32
+#  define USE_MMAP_READ
+#endif
+
 /* use GHash for BHead name-based lookups (speeds up linking) */
 #define USE_GHASH_BHEAD
 
@@ -955,12 +980,51 @@ BHead *blo_bhead_next(FileData *fd, BHead *thisblock)
   return bhead;
 }
 
+/**
+ * Reading from a memory mapped file failed (the file was truncated or the volume went away),
+ * data which was read after the failure is zeroed.
+ */
+static bool blo_filedata_has_io_error(const FileData *fd)
+{
+#ifdef USE_MMAP_READ
+  /* Don't check before the data was copied, the flag is set while copying. */
+  __sync_synchronize();
+  return fd->mmap_io_error;
+#else
+  UNUSED_VARS(fd);
+  return false;
+#endif
+}
+
 #ifdef USE_BHEAD_READ_ON_DEMAND
+/**
+ * Access data which hasn't been read yet in place, when the file is memory mapped.
+ *
+ * \return NULL when the data needs to be read.
+ */
+static const void *blo_bhead_data_mapped(const FileData *fd, const BHead *thisblock)
+{
+  const BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
+  if (fd->mmap_data == NULL || new_bhead->has_data) {
+    return NULL;
+  }
+  BLI_assert(new_bhead->file_offset + new_bhead->bhead.len <= (off64_t)fd->mmap_size);
+  return fd->mmap_data + new_bhead->file_offset;
+}
+
+/**
+ * \note Thread-safe for memory mapped files, which don't need to seek.
+ */
 static bool blo_bhead_read_data(FileData *fd, BHead *thisblock, void *buf)
 {
   bool success = true;
   BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
   BLI_assert(new_bhead->has_data == false && new_bhead->file_offset != 0);
+  const void *data_mapped = blo_bhead_data_mapped(fd, thisblock);
+  if (data_mapped != NULL) {
+    memcpy(buf, data_mapped, new_bhead->bhead.len);
+    return !blo_filedata_has_io_error(fd);
+  }
   off64_t offset_backup = fd->file_offset;
   if (UNLIKELY(fd->seek(fd, new_bhead->file_offset, SEEK_SET) == -1)) {
     success = false;
@@ -1155,6 +1219,213 @@ static off64_t fd_seek_data_from_file(FileData *filedata, off64_t offset, int wh
   return filedata->file_offset;
 }
 
+/* Memory mapped file reading. */
+
+#ifdef USE_MMAP_READ
+
+/* Maximum number of files mapped at once, other files are read as usual. */
+#  define MMAP_FILES_MAX 64
+
+/* Files currently mapped, looked up by the signal handler so it can't use any lock. */
+static FileData *volatile mmap_files[MMAP_FILES_MAX];
+static struct sigaction mmap_sigbus_action_prev;
+static ThreadMutex mmap_sigbus_mutex = BLI_MUTEX_INITIALIZER;
+static bool mmap_sigbus_handler_installed = false;
+
+static void mmap_sigbus_handler(int sig, siginfo_t *siginfo, void *ucontext)
+{
+  const char *error_addr = (const char *)siginfo->si_addr;
+
+  for (int i = 0; i < ARRAY_SIZE(mmap_files); i++) {
+    FileData *fd = mmap_files[i];
+    if (fd != NULL && error_addr >= fd->mmap_data && error_addr < fd->mmap_data + fd->mmap_size) {
+      /* Replace the mapping with zeros so the failed access can continue,
+       * the error is checked once reading is done. */
+      fd->mmap_io_error = true;
+      if (mmap((void *)fd->mmap_data,
+               fd->mmap_size,
+               PROT_READ,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+               -1,
+               0) == MAP_FAILED) {
+        abort();
+      }
+      return;
+    }
+  }
+
+  /* Not in a mapped blend file, pass on to the previous handler. */
+  if (mmap_sigbus_action_prev.sa_flags & SA_SIGINFO) {
+    mmap_sigbus_action_prev.sa_sigaction(sig, siginfo, ucontext);
+  }
+  else if (mmap_sigbus_action_prev.sa_handler != SIG_DFL &&
+           mmap_sigbus_action_prev.sa_handler != SIG_IGN) {
+    mmap_sigbus_action_prev.sa_handler(sig);
+  }
+  else {
+    signal(sig, SIG_DFL);
+    raise(sig);
+  }
+}
+
+static bool mmap_file_register(FileData *fd)
+{
+  BLI_mutex_lock(&mmap_sigbus_mutex);
+
+  if (!mmap_sigbus_handler_installed) {
+    struct sigaction action = {{0}};
+    action.sa_sigaction = mmap_sigbus_handler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    mmap_sigbus_handler_installed = (sigaction(SIGBUS, &action, &mmap_sigbus_action_prev) == 0);
+  }
+
+  bool registered = false;
+  if (mmap_sigbus_handler_installed) {
+    for (int i = 0; i < ARRAY_SIZE(mmap_files); i++) {
+      if (mmap_files[i] == NULL) {
+        mmap_files[i] = fd;
+        registered = true;
+        break;
+      }
+    }
+  }
+
+  BLI_mutex_unlock(&mmap_sigbus_mutex);
+  return registered;
+}
+
+static void mmap_file_unregister(FileData *fd)
+{
+  BLI_mutex_lock(&mmap_sigbus_mutex);
+  for (int i = 0; i < ARRAY_SIZE(mmap_files); i++) {
+    if (mmap_files[i] == fd) {
+      mmap_files[i] = NULL;
+      break;
+    }
+  }
+  BLI_mutex_unlock(&mmap_sigbus_mutex);
+}
+
+/**
+ * Only map regular files on local file-systems, network and removable volumes
+ * are more likely to go away while the file is read.
+ */
+static bool mmap_file_descriptor_is_supported(int file)
+{
+  struct stat st;
+  if (fstat(file, &st) != 0 || !S_ISREG(st.st_mode)) {
+    return false;
+  }
+
+  struct statfs st_fs;
+  if (fstatfs(file, &st_fs) != 0) {
+    return false;
+  }
+#  ifdef __linux__
+  switch ((uint)st_fs.f_type) {
+    case 0x6969:     /* NFS */
+    case 0x517B:     /* SMB */
+    case 0xFE534D42: /* SMB2 */
+    case 0xFF534D42: /* CIFS */
+    case 0x5346414F: /* AFS */
+    case 0x73757245: /* CODA */
+    case 0x01021997: /* 9P */
+    case 0x65735546: /* FUSE */
+    case 0x00C36400: /* CEPH */
+    case 0x0BD00BD0: /* LUSTRE */
+    case 0x47504653: /* GPFS */
+    case 0x4D44:     /* MSDOS (FAT) */
+    case 0x2011BAB0: /* EXFAT */
+      return false;
+  }
+  return true;
+#  else
+  return (st_fs.f_flags & MNT_LOCAL) != 0;
+#  endif
+}
+
+static int fd_read_from_mmap(FileData *filedata, void *buffer, uint size)
+{
+  /* don't read more bytes then there are available in the mapping */
+  const size_t readsize = MIN2((size_t)size, filedata->mmap_size - (size_t)filedata->file_offset);
+
+  memcpy(buffer, filedata->mmap_data + filedata->file_offset, readsize);
+  if (UNLIKELY(blo_filedata_has_io_error(filedata))) {
+    return -1;
+  }
+  filedata->file_offset += readsize;
+
+  return (int)readsize;
+}
+
+static off64_t fd_seek_from_mmap(FileData *filedata, off64_t offset, int whence)
+{
+  off64_t offset_new;
+  switch (whence) {
+    case SEEK_SET:
+      offset_new = offset;
+      break;
+    case SEEK_CUR:
+      offset_new = filedata->file_offset + offset;
+      break;
+    case SEEK_END:
+      offset_new = (off64_t)filedata->mmap_size + offset;
+      break;
+    default:
+      return -1;
+  }
+
+  if (offset_new < 0 || offset_new > (off64_t)filedata->mmap_size) {
+    return -1;
+  }
+
+  filedata->file_offset = offset_new;
+  return offset_new;
+}
+
+/* Read an uncompressed file from a memory mapping, when it can be mapped. */
+static void mmap_filedata_init(FileData *fd)
+{
+  if (!mmap_file_descriptor_is_supported(fd->filedes)) {
+    return;
+  }
+
+  const size_t size = BLI_file_descriptor_size(fd->filedes);
+  if (size == (size_t)-1) {
+    return;
+  }
+
+  void *mem = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd->filedes, 0);
+  if (mem == MAP_FAILED) {
+    return;
+  }
+
+  fd->mmap_data = mem;
+  fd->mmap_size = size;
+
+  if (!mmap_file_register(fd)) {
+    munmap(mem, size);
+    fd->mmap_data = NULL;
+    fd->mmap_size = 0;
+    return;
+  }
+
+  fd->read = fd_read_from_mmap;
+  fd->seek = fd_seek_from_mmap;
+}
+
+static void mmap_filedata_free(FileData *fd)
+{
+  if (fd->mmap_data != NULL) {
+    mmap_file_unregister(fd);
+    munmap((void *)fd->mmap_data, fd->mmap_size);
+    fd->mmap_data = NULL;
+  }
+}
+#endif /* USE_MMAP_READ */
+
+
 /* GZip file reading. */
 
 static int fd_read_gzip_from_file(FileData *filedata, void *buffer, uint size)
@@ -1171,6 +1442,222 @@ static int fd_read_gzip_from_file(FileData *filedata, void *buffer, uint size)
   return (readsize);
 }
 
+/* GZip file reading, using the frame index. */
+
+typedef struct GzipFrame {
+  /** Offset of the gzip member in the file. */
+  off64_t file_offset;
+  /** Offset of the frame in the uncompressed data. */
+  off64_t data_offset;
+  uint file_len;
+  uint data_len;
+} GzipFrame;
+
+typedef struct FileDataGzipFrames {
+  GzipFrame *frames;
+  int frames_len;
+  off64_t data_len;
+
+  /** Decompressed frame, -1 when there is none. */
+  int frame_cached;
+  char *frame_buf;
+  char *compressed_buf;
+} FileDataGzipFrames;
+
+static uint gzip_frame_read_u32(const uchar *src)
+{
+  return (uint)src[0] | ((uint)src[1] << 8) | ((uint)src[2] << 16) | ((uint)src[3] << 24);
+}
+
+static void gzip_frames_free(FileDataGzipFrames *gzframes)
+{
+  MEM_SAFE_FREE(gzframes->frames);
+  MEM_SAFE_FREE(gzframes->frame_buf);
+  MEM_SAFE_FREE(gzframes->compressed_buf);
+  MEM_freeN(gzframes);
+}
+
+/**
+ * Build the frame index of a compressed file by reading the headers of all gzip members.
+ *
+ * \return NULL when the file wasn't written in frames (or is corrupt),
+ * the caller can fall back to reading the file as a single stream.
+ */
+static FileDataGzipFrames *gzip_frames_from_file(int file)
+{
+  FileDataGzipFrames *gzframes = MEM_callocN(sizeof(*gzframes), __func__);
+  int frames_alloc = 0;
+  off64_t file_offset = 0;
+  off64_t data_offset = 0;
+  bool ok = true;
+
+  while (true) {
+    uchar header[BLEND_GZIP_FRAME_HEADER_SIZE];
+    const ssize_t readsize = read(file, header, sizeof(header));
+    if (readsize == 0) {
+      break;
+    }
+    if ((readsize != sizeof(header)) ||
+        /* Magic, deflate method and extra field flag. */
+        (header[0] != 0x1f || header[1] != 0x8b || header[2] != 8 || header[3] != 4) ||
+        /* Extra field holding only the frame sizes. */
+        (header[10] != 12 || header[11] != 0 || header[12] != 'B' || header[13] != 'L' ||
+         header[14] != 8 || header[15] != 0)) {
+      ok = false;
+      break;
+    }
+
+    GzipFrame frame;
+    frame.file_offset = file_offset;
+    frame.data_offset = data_offset;
+    frame.file_len = gzip_frame_read_u32(&header[16]);
+    frame.data_len = gzip_frame_read_u32(&header[20]);
+
+    if ((frame.file_len <= BLEND_GZIP_FRAME_HEADER_SIZE + BLEND_GZIP_FRAME_TRAILER_SIZE) ||
+        (frame.data_len > BLEND_GZIP_FRAME_SIZE)) {
+      ok = false;
+      break;
+    }
+
+    if (gzframes->frames_len == frames_alloc) {
+      frames_alloc = frames_alloc ? frames_alloc * 2 : 64;
+      gzframes->frames = MEM_reallocN(gzframes->frames, sizeof(GzipFrame) * frames_alloc);
+    }
+    gzframes->frames[gzframes->frames_len++] = frame;
+
+    file_offset += frame.file_len;
+    data_offset += frame.data_len;
+    if (lseek(file, file_offset, SEEK_SET) != file_offset) {
+      ok = false;
+      break;
+    }
+  }
+
+  lseek(file, 0, SEEK_SET);
+
+  if (!ok || gzframes->frames_len == 0) {
+    gzip_frames_free(gzframes);
+    return NULL;
+  }
+
+  gzframes->data_len = data_offset;
+  gzframes->frame_cached = -1;
+  gzframes->frame_buf = MEM_mallocN(BLEND_GZIP_FRAME_SIZE, __func__);
+  return gzframes;
+}
+
+static int gzip_frames_find(const FileDataGzipFrames *gzframes, off64_t data_offset)
+{
+  int low = 0, high = gzframes->frames_len - 1;
+  while (low < high) {
+    const int mid = (low + high + 1) / 2;
+    if (gzframes->frames[mid].data_offset <= data_offset) {
+      low = mid;
+    }
+    else {
+      high = mid - 1;
+    }
+  }
+  return low;
+}
+
+static bool gzip_frames_decompress(FileData *filedata, int frame_index)
+{
+  FileDataGzipFrames *gzframes = filedata->gzframes;
+  const GzipFrame *frame = &gzframes->frames[frame_index];
+
+  if (gzframes->frame_cached == frame_index) {
+    return true;
+  }
+  gzframes->frame_cached = -1;
+
+  const uint compressed_len = frame->file_len - BLEND_GZIP_FRAME_HEADER_SIZE;
+  gzframes->compressed_buf = MEM_reallocN(gzframes->compressed_buf, compressed_len);
+  const uchar *compressed_buf = (const uchar *)gzframes->compressed_buf;
+
+  if ((lseek(filedata->filedes, frame->file_offset + BLEND_GZIP_FRAME_HEADER_SIZE, SEEK_SET) ==
+       -1) ||
+      (read(filedata->filedes, gzframes->compressed_buf, compressed_len) !=
+       (ssize_t)compressed_len)) {
+    return false;
+  }
+
+  z_stream strm = {NULL};
+  if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+    return false;
+  }
+  strm.next_in = (Bytef *)compressed_buf;
+  strm.avail_in = compressed_len - BLEND_GZIP_FRAME_TRAILER_SIZE;
+  strm.next_out = (Bytef *)gzframes->frame_buf;
+  strm.avail_out = frame->data_len;
+  const int err = inflate(&strm, Z_FINISH);
+  const uLong data_len = strm.total_out;
+  inflateEnd(&strm);
+
+  const uchar *trailer = &compressed_buf[compressed_len - BLEND_GZIP_FRAME_TRAILER_SIZE];
+  if ((err != Z_STREAM_END) || (data_len != frame->data_len) ||
+      (gzip_frame_read_u32(&trailer[4]) != frame->data_len) ||
+      (gzip_frame_read_u32(&trailer[0]) !=
+       (uint)crc32(crc32(0L, Z_NULL, 0), (const Bytef *)gzframes->frame_buf, frame->data_len))) {
+    printf("%s: zlib error\n", __func__);
+    return false;
+  }
+
+  gzframes->frame_cached = frame_index;
+  return true;
+}
+
+static int fd_read_gzip_frames_from_file(FileData *filedata, void *buffer, uint size)
+{
+  FileDataGzipFrames *gzframes = filedata->gzframes;
+  char *buffer_iter = buffer;
+  int readsize = 0;
+
+  while (size > 0 && filedata->file_offset < gzframes->data_len) {
+    const int frame_index = gzip_frames_find(gzframes, filedata->file_offset);
+    const GzipFrame *frame = &gzframes->frames[frame_index];
+    if (!gzip_frames_decompress(filedata, frame_index)) {
+      return EOF;
+    }
+
+    const uint frame_offset = (uint)(filedata->file_offset - frame->data_offset);
+    const uint len = MIN2(size, frame->data_len - frame_offset);
+    memcpy(buffer_iter, gzframes->frame_buf + frame_offset, len);
+
+    buffer_iter += len;
+    size -= len;
+    readsize += (int)len;
+    filedata->file_offset += len;
+  }
+
+  return readsize;
+}
+
+static off64_t fd_seek_gzip_frames_from_file(FileData *filedata, off64_t offset, int whence)
+{
+  off64_t offset_new;
+  switch (whence) {
+    case SEEK_SET:
+      offset_new = offset;
+      break;
+    case SEEK_CUR:
+      offset_new = filedata->file_offset + offset;
+      break;
+    case SEEK_END:
+      offset_new = filedata->gzframes->data_len + offset;
+      break;
+    default:
+      return -1;
+  }
+
+  if (offset_new < 0 || offset_new > filedata->gzframes->data_len) {
+    return -1;
+  }
+
+  filedata->file_offset = offset_new;
+  return offset_new;
+}
+
 /* Memory reading. */
 
 static int fd_read_from_memory(FileData *filedata, void *buffer, uint size)
@@ -1297,6 +1784,7 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
   FileDataSeekFn *seek_fn = NULL; /* Optional. */
 
   gzFile gzfile = (gzFile)Z_NULL;
+  FileDataGzipFrames *gzframes = NULL;
 
   char header[7];
 
@@ -1322,6 +1810,17 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   /* Gzip file. */
   errno = 0;
+  if ((read_fn == NULL) &&
+      /* Check header magic. */
+      (header[0] == 0x1f && header[1] == 0x8b)) {
+    /* Files written in frames can be read on demand. */
+    gzframes = gzip_frames_from_file(file);
+    if (gzframes != NULL) {
+      read_fn = fd_read_gzip_frames_from_file;
+      seek_fn = fd_seek_gzip_frames_from_file;
+    }
+  }
+
   if ((read_fn == NULL) &&
       /* Check header magic. */
       (header[0] == 0x1f && header[1] == 0x8b)) {
@@ -1351,10 +1850,17 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   fd->filedes = file;
   fd->gzfiledes = gzfile;
+  fd->gzframes = gzframes;
 
   fd->read = read_fn;
   fd->seek = seek_fn;
 
+#ifdef USE_MMAP_READ
+  if (read_fn == fd_read_data_from_file) {
+    mmap_filedata_init(fd);
+  }
+#endif
+
   return fd;
 }
 
@@ -1415,20 +1921,26 @@ static int fd_read_gzip_from_memory(FileData *filedata, void *buffer, uint size)
   filedata->strm.next_out = (Bytef *)buffer;
   filedata->strm.avail_out = size;
 
-  // Inflate another chunk.
-  err = inflate(&filedata->strm, Z_SYNC_FLUSH);
+  while (filedata->strm.avail_out > 0) {
+    // Inflate another chunk.
+    err = inflate(&filedata->strm, Z_SYNC_FLUSH);
 
-  if (err == Z_STREAM_END) {
-    return 0;
-  }
-  else if (err != Z_OK) {
-    printf("fd_read_gzip_from_memory: zlib error\n");
-    return 0;
+    if (err == Z_STREAM_END) {
+      /* Compressed files consist of multiple gzip members, continue with the next one. */
+      if (filedata->strm.avail_in == 0 || inflateReset(&filedata->strm) != Z_OK) {
+        break;
+      }
+    }
+    else if (err != Z_OK) {
+      printf("fd_read_gzip_from_memory: zlib error\n");
+      return 0;
+    }
   }
 
-  filedata->file_offset += size;
+  const uint readsize = size - filedata->strm.avail_out;
+  filedata->file_offset += readsize;
 
-  return (size);
+  return (int)readsize;
 }
 
 static int fd_read_gzip_from_memory_init(FileData *fd)
@@ -1507,6 +2019,18 @@ void blo_filedata_free(FileData *fd)
       gzclose(fd->gzfiledes);
     }
 
+    if (fd->gzframes != NULL) {
+      gzip_frames_free(fd->gzframes);
+    }
+
+    if (fd->undo_old_id_map != NULL) {
+      BLI_ghash_free(fd->undo_old_id_map, NULL, NULL);
+    }
+
+#ifdef USE_MMAP_READ
+    mmap_filedata_free(fd);
+#endif
+
     if (fd->strm.next_in) {
       if (inflateEnd(&fd->strm) != Z_OK) {
         printf("close gzip stream error\n");
@@ -2062,6 +2586,129 @@ void blo_end_movieclip_pointer_map(FileData *fd, Main *oldmain)
   }
 }
 
+/**
+ * Undo: make a lookup of the local IDs in old main by address,
+ * tagging the ones which are identical in the memfile being read, so they can be kept as is.
+ *
+ * Other IDs which exist in the memfile are read again at their old address,
+ * so pointers to them (from kept IDs, the UI or dependency graphs) remain valid.
+ *
+ * \param memfile_identical: Memfile whose ID chunks tell which IDs are identical in the state
+ * old main was last written with and the memfile being read, NULL when both are the same.
+ * IDs edited since that write are never identical.
+ */
+void blo_make_undo_old_id_map(FileData *fd, Main *oldmain, const MemFile *memfile_identical)
+{
+  ListBase *lbarray[MAX_LIBARRAY];
+  int a = set_listbasepointers(oldmain, lbarray);
+
+  fd->undo_old_id_map = BLI_ghash_ptr_new(__func__);
+  fd->undo_old_ids_len = 0;
+  fd->undo_old_ids_used = 0;
+  fd->undo_ids_added = false;
+
+  while (a--) {
+    LISTBASE_FOREACH (ID *, id, lbarray[a]) {
+      /* The window-manager, workspaces and screens are handled separately by undo. */
+      if (ELEM(GS(id->name), ID_LI, ID_WM, ID_WS, ID_SCR)) {
+        break;
+      }
+
+      id->tag &= ~LIB_TAG_UNDO_OLD_ID_REUSED;
+      if (id->recalc_after_undo_push == 0) {
+        if (memfile_identical == NULL) {
+          id->tag |= LIB_TAG_UNDO_OLD_ID_REUSED;
+        }
+        else if (memfile_identical->id_chunks != NULL) {
+          const MemFileIDChunks *id_chunks = BLI_ghash_lookup(memfile_identical->id_chunks, id);
+          if (id_chunks != NULL && id_chunks->is_identical) {
+            id->tag |= LIB_TAG_UNDO_OLD_ID_REUSED;
+          }
+        }
+      }
+
+      BLI_ghash_insert(fd->undo_old_id_map, id, id);
+      fd->undo_old_ids_len++;
+    }
+  }
+}
+
+/**
+ * Undo: fix-up data that kept IDs share with IDs which were read again.
+ */
+void blo_end_undo_old_id_map(FileData *fd, Main *newmain)
+{
+  if (fd->undo_old_id_map == NULL) {
+    return;
+  }
+
+  BLI_ghash_free(fd->undo_old_id_map, NULL, NULL);
+  fd->undo_old_id_map = NULL;
+
+  if (newmain == NULL) {
+    return;
+  }
+
+  /* When IDs were added or removed, dependency graphs of kept scenes
+   * reference IDs which don't exist anymore, they have to be built from scratch. */
+  const bool ids_changed = fd->undo_ids_added || (fd->undo_old_ids_used != fd->undo_old_ids_len);
+
+  LISTBASE_FOREACH (Scene *, scene, &newmain->scenes) {
+    if (scene->id.tag & LIB_TAG_UNDO_OLD_ID_REUSED) {
+      if (ids_changed) {
+        BKE_scene_free_depsgraph_hash(scene);
+      }
+      else {
+        BKE_scene_undo_depsgraphs_main_set(newmain, scene);
+      }
+    }
+  }
+
+  /* Pose channels point to bones of the armature, which may have been read again. */
+  LISTBASE_FOREACH (Object *, ob, &newmain->objects) {
+    if ((ob->id.tag & LIB_TAG_UNDO_OLD_ID_REUSED) && ob->pose && ob->type == OB_ARMATURE) {
+      bArmature *arm = ob->data;
+      if (arm == NULL || (arm->id.tag & LIB_TAG_UNDO_OLD_ID_REUSED)) {
+        continue;
+      }
+      bool rebuild = false;
+      LISTBASE_FOREACH (bPoseChannel *, pchan, &ob->pose->chanbase) {
+        pchan->bone = BKE_armature_find_bone_name(arm, pchan->name);
+        if (UNLIKELY(pchan->bone == NULL)) {
+          rebuild = true;
+        }
+      }
+      if (rebuild) {
+        BKE_pose_tag_recalc(newmain, ob->pose);
+      }
+    }
+  }
+
+  /* Kept IDs didn't add their users when linking, count all users again. */
+  if (fd->undo_old_ids_used != 0) {
+    BKE_main_id_refcount_recompute(newmain, false);
+  }
+
+  /* Evaluated copies of IDs which were read again are outdated. */
+  ID *id;
+  FOREACH_MAIN_ID_BEGIN (newmain, id) {
+    if (id->tag & LIB_TAG_UNDO_OLD_ID_REUSED) {
+      id->tag &= ~LIB_TAG_UNDO_OLD_ID_REUSED;
+    }
+    else if (!ID_IS_LINKED(id)) {
+      int recalc = ID_RECALC_COPY_ON_WRITE;
+      if (GS(id->name) == ID_OB) {
+        recalc |= ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY;
+      }
+      /* Reading the step is not an edit of it. */
+      const int recalc_after_undo_push = id->recalc_after_undo_push;
+      DEG_id_tag_update_ex(newmain, id, recalc);
+      id->recalc_after_undo_push = recalc_after_undo_push;
+    }
+  }
+  FOREACH_MAIN_ID_END;
+}
+
 void blo_make_sound_pointer_map(FileData *fd, Main *oldmain)
 {
   bSound *sound = oldmain->sounds.first;
@@ -2254,6 +2901,13 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
     if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
       if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
 #ifdef USE_BHEAD_READ_ON_DEMAND
+        /* Reconstruct directly from the mapped file,
+         * as long as it's aligned for reading the members in place. */
+        const void *data_mapped = blo_bhead_data_mapped(fd, bh);
+        if (data_mapped != NULL && (POINTER_AS_UINT(data_mapped) & 7) == 0) {
+          return DNA_struct_reconstruct(
+              fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, data_mapped);
+        }
         if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
           bh = blo_bhead_read_full(fd, bh);
           if (UNLIKELY(bh == NULL)) {
@@ -2269,9 +2923,14 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
         /* SDNA_CMP_EQUAL */
         temp = MEM_mallocN(bh->len, blockname);
 #ifdef USE_BHEAD_READ_ON_DEMAND
+        const void *data_mapped = blo_bhead_data_mapped(fd, bh);
         if (BHEADN_FROM_BHEAD(bh)->has_data) {
           memcpy(temp, (bh + 1), bh->len);
         }
+        else if (data_mapped != NULL) {
+          /* Single copy from the mapped file, no need to seek. */
+          memcpy(temp, data_mapped, bh->len);
+        }
         else {
           /* Instead of allocating the bhead, then copying it,
            * read the data from the file directly into the memory. */
@@ -9286,8 +9945,184 @@ static const char *dataname(short id_code)
   return "Data from Lib Block";
 }
 
+#ifdef USE_MMAP_READ
+/* Minimum amount of data (in bytes) following an ID, to read its blocks in parallel. */
+#  define READ_DATA_PARALLEL_MIN_SIZE (1 << 16)
+
+typedef struct ReadDataParallelData {
+  FileData *fd;
+  BHead **bheads;
+  void **data;
+  /** Name for all blocks, or NULL to use the name of each block from #allocnames. */
+  const char *allocname;
+  const char **allocnames;
+} ReadDataParallelData;
+
+static void read_data_parallel_cb(void *__restrict userdata,
+                                  const int iter,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ReadDataParallelData *data = userdata;
+  const char *allocname = data->allocname ? data->allocname : data->allocnames[iter];
+  data->data[iter] = read_struct(data->fd, data->bheads[iter], allocname);
+}
+
+/**
+ * Read the data-blocks of all IDs in the file in parallel, before reading the IDs themselves,
+ * so files with many small IDs benefit as well. #read_data_into_oldnewmap takes the blocks
+ * from #FileData.datamap_prefetched, blocks which are not used are freed by
+ * #read_data_prefetch_end.
+ *
+ * Only the conversion and copying of the blocks is done in parallel, linking the IDs
+ * (direct_link_*, lib_link_* and versioning) stays sequential: it updates shared #OldNewMap
+ * usage counts and global state.
+ */
+static void read_data_prefetch_begin(FileData *fd)
+{
+  if (fd->mmap_data == NULL || (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) {
+    return;
+  }
+
+  BHead **bheads = NULL;
+  const char **allocnames = NULL;
+  int bheads_len = 0, bheads_alloc = 0;
+  size_t data_len = 0;
+  /* Name of the ID the current data-blocks belong to, NULL when not following an ID. */
+  const char *allocname = NULL;
+
+  for (BHead *bhead = blo_bhead_first(fd); bhead && bhead->code != ENDB;
+       bhead = blo_bhead_next(fd, bhead)) {
+    if (bhead->code != DATA) {
+      /* Same distinction between blocks as #blo_read_file_internal. */
+      const bool is_id = !ELEM(bhead->code, DNA1, TEST, REND, GLOB, USER, ID_LINK_PLACEHOLDER);
+      allocname = is_id ? dataname(bhead->code) : NULL;
+      continue;
+    }
+    if (allocname == NULL) {
+      continue;
+    }
+    if (bheads_len == bheads_alloc) {
+      bheads_alloc = bheads_alloc ? bheads_alloc * 2 : 1024;
+      bheads = MEM_reallocN_id(bheads, sizeof(*bheads) * bheads_alloc, __func__);
+      allocnames = MEM_reallocN_id(allocnames, sizeof(*allocnames) * bheads_alloc, __func__);
+    }
+    bheads[bheads_len] = bhead;
+    allocnames[bheads_len] = allocname;
+    bheads_len++;
+    data_len += (size_t)bhead->len;
+  }
+
+  if (bheads_len < 2 || data_len < READ_DATA_PARALLEL_MIN_SIZE) {
+    MEM_SAFE_FREE(bheads);
+    MEM_SAFE_FREE(allocnames);
+    return;
+  }
+
+  void **data = MEM_mallocN(sizeof(*data) * bheads_len, __func__);
+  ReadDataParallelData read_data = {
+      .fd = fd,
+      .bheads = bheads,
+      .data = data,
+      .allocname = NULL,
+      .allocnames = allocnames,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, bheads_len, &read_data, read_data_parallel_cb, &settings);
+
+  fd->datamap_prefetched = BLI_ghash_ptr_new_ex(__func__, (uint)bheads_len);
+  for (int i = 0; i < bheads_len; i++) {
+    if (data[i]) {
+      BLI_ghash_insert(fd->datamap_prefetched, bheads[i], data[i]);
+    }
+  }
+
+  MEM_freeN(data);
+  MEM_freeN(allocnames);
+  MEM_freeN(bheads);
+}
+
+static void read_data_prefetch_end(FileData *fd)
+{
+  if (fd->datamap_prefetched != NULL) {
+    BLI_ghash_free(fd->datamap_prefetched, NULL, MEM_freeN);
+    fd->datamap_prefetched = NULL;
+  }
+}
+
+/**
+ * Reading data-blocks from a memory mapped file doesn't need to seek,
+ * so the blocks of an ID can be converted and copied in parallel,
+ * only adding them to the map is done in order.
+ */
+static BHead *read_data_into_oldnewmap_parallel(FileData *fd, BHead *bhead, const char *allocname)
+{
+  BHead **bheads = NULL;
+  int bheads_len = 0, bheads_alloc = 0;
+  size_t data_len = 0;
+
+  for (bhead = blo_bhead_next(fd, bhead); bhead && bhead->code == DATA;
+       bhead = blo_bhead_next(fd, bhead)) {
+    if (bheads_len == bheads_alloc) {
+      bheads_alloc = bheads_alloc ? bheads_alloc * 2 : 64;
+      bheads = MEM_reallocN_id(bheads, sizeof(*bheads) * bheads_alloc, __func__);
+    }
+    bheads[bheads_len++] = bhead;
+    data_len += (size_t)bhead->len;
+  }
+
+  if (bheads_len == 0) {
+    return bhead;
+  }
+
+  void **data = MEM_mallocN(sizeof(*data) * bheads_len, __func__);
+  ReadDataParallelData read_data = {
+      .fd = fd,
+      .bheads = bheads,
+      .data = data,
+      .allocname = allocname,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (bheads_len > 1 && data_len >= READ_DATA_PARALLEL_MIN_SIZE);
+  BLI_task_parallel_range(0, bheads_len, &read_data, read_data_parallel_cb, &settings);
+
+  for (int i = 0; i < bheads_len; i++) {
+    if (data[i]) {
+      oldnewmap_insert(fd->datamap, bheads[i]->old, data[i], 0);
+    }
+  }
+
+  MEM_freeN(data);
+  MEM_freeN(bheads);
+
+  return bhead;
+}
+#endif /* USE_MMAP_READ */
+
 static BHead *read_data_into_oldnewmap(FileData *fd, BHead *bhead, const char *allocname)
 {
+#ifdef USE_MMAP_READ
+  if (fd->datamap_prefetched != NULL) {
+    for (bhead = blo_bhead_next(fd, bhead); bhead && bhead->code == DATA;
+         bhead = blo_bhead_next(fd, bhead)) {
+      void *data = BLI_ghash_popkey(fd->datamap_prefetched, bhead, NULL);
+      if (data == NULL) {
+        data = read_struct(fd, bhead, allocname);
+      }
+      if (data) {
+        oldnewmap_insert(fd->datamap, bhead->old, data, 0);
+      }
+    }
+    return bhead;
+  }
+  if (fd->mmap_data != NULL) {
+    return read_data_into_oldnewmap_parallel(fd, bhead, allocname);
+  }
+#endif
+
   bhead = blo_bhead_next(fd, bhead);
 
   while (bhead && bhead->code == DATA) {
@@ -9313,6 +10148,67 @@ static BHead *read_data_into_oldnewmap(FileData *fd, BHead *bhead, const char *a
   return bhead;
 }
 
+static ID *read_libblock_undo_old_id_find(FileData *fd, BHead *bhead)
+{
+  ID *id_old = BLI_ghash_lookup(fd->undo_old_id_map, bhead->old);
+  /* The address may have been reused by another ID. */
+  if (id_old == NULL || !STREQ(id_old->name, blo_bhead_id_name(fd, bhead))) {
+    return NULL;
+  }
+  /* Only use each old ID once. */
+  BLI_ghash_remove(fd->undo_old_id_map, bhead->old, NULL, NULL);
+  fd->undo_old_ids_used++;
+  return id_old;
+}
+
+/**
+ * Move an unchanged ID from old main to \a main, skipping all of its data.
+ */
+static BHead *read_libblock_undo_reuse(
+    FileData *fd, Main *main, BHead *bhead, ID *id_old, const int tag, ID **r_id)
+{
+  Main *old_main = fd->old_mainlist->first;
+  const short idcode = GS(id_old->name);
+
+  BLI_remlink(which_libbase(old_main, idcode), id_old);
+  BLI_addtail(which_libbase(main, idcode), id_old);
+  oldnewmap_insert(fd->libmap, bhead->old, id_old, bhead->code);
+
+  id_old->tag = tag | LIB_TAG_UNDO_OLD_ID_REUSED;
+  id_old->newid = NULL;
+
+  if (r_id) {
+    *r_id = id_old;
+  }
+
+  for (bhead = blo_bhead_next(fd, bhead); bhead && bhead->code == DATA;
+       bhead = blo_bhead_next(fd, bhead)) {
+    /* pass */
+  }
+  return bhead;
+}
+
+/**
+ * Swap the newly read \a id into the memory of \a id_old, the previous content of \a id_old
+ * remains in old main, so it's freed (or partially restored, e.g. image caches) with it.
+ */
+static void read_libblock_undo_restore_at_old_address(FileData *fd, ID *id, ID *id_old)
+{
+  Main *old_main = fd->old_mainlist->first;
+  ListBase *old_lb = which_libbase(old_main, GS(id_old->name));
+  const size_t id_size = MEM_allocN_len(id);
+
+  BLI_remlink(old_lb, id_old);
+
+  void *id_temp = MEM_mallocN(id_size, __func__);
+  memcpy(id_temp, id_old, id_size);
+  memcpy(id_old, id, id_size);
+  memcpy(id, id_temp, id_size);
+  MEM_freeN(id_temp);
+
+  BLI_addtail(old_lb, id);
+}
+
 static BHead *read_libblock(FileData *fd,
                             Main *main,
                             BHead *bhead,
@@ -9389,9 +10285,30 @@ static BHead *read_libblock(FileData *fd,
     }
   }
 
+  /* Undo: keep unchanged IDs, or read changed ones at their old address. */
+  ID *id_old = NULL;
+  if (fd->undo_old_id_map != NULL && bhead->code != ID_LINK_PLACEHOLDER && main->curlib == NULL) {
+    id_old = read_libblock_undo_old_id_find(fd, bhead);
+    if (id_old != NULL && (id_old->tag & LIB_TAG_UNDO_OLD_ID_REUSED)) {
+      return read_libblock_undo_reuse(fd, main, bhead, id_old, tag, r_id);
+    }
+  }
+
   /* read libblock */
   id = read_struct(fd, bhead, "lib block");
 
+  if (id && fd->undo_old_id_map != NULL) {
+    if (id_old != NULL && MEM_allocN_len(id) == MEM_allocN_len(id_old)) {
+      read_libblock_undo_restore_at_old_address(fd, id, id_old);
+      id = id_old;
+    }
+    else {
+      fd->undo_ids_added = true;
+      /* No memfile stores this ID at its new address yet. */
+      id->recalc_after_undo_push = ID_RECALC_ALL;
+    }
+  }
+
   if (id) {
     const short idcode = GS(id->name);
     /* do after read_struct, for dna reconstruct */
@@ -9433,6 +10350,7 @@ static BHead *read_libblock(FileData *fd,
    * the version the file has been saved with. */
   if (!fd->memfile) {
     id->recalc = 0;
+    id->recalc_after_undo_push = 0;
   }
 
   /* this case cannot be direct_linked: it's just the ID part */
@@ -9977,6 +10895,12 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     }
   }
 
+#ifdef USE_MMAP_READ
+  if ((fd->skip_flags & BLO_READ_SKIP_DATA) == 0) {
+    read_data_prefetch_begin(fd);
+  }
+#endif
+
   while (bhead) {
     switch (bhead->code) {
       case DATA:
@@ -10028,6 +10952,20 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     }
   }
 
+#ifdef USE_MMAP_READ
+  read_data_prefetch_end(fd);
+#endif
+
+  if (UNLIKELY(blo_filedata_has_io_error(fd))) {
+    BKE_reportf(fd->reports, RPT_ERROR, "Unable to read '%s': %s", filepath, strerror(EIO));
+    if (mainlist.first != NULL) {
+      blo_join_main(&mainlist);
+    }
+    fd->mainlist = NULL;
+    BLO_blendfiledata_free(bfd);
+    return NULL;
+  }
+
   /* do before read_libraries, but skip undo case */
   if (fd->memfile == NULL) {
     if ((fd->skip_flags & BLO_READ_SKIP_DATA) == 0) {
@@ -12175,6 +13113,14 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
         /* Test if linked data-locks need to read further linked data-locks
          * and create link placeholders for them. */
         BLO_expand_main(fd, mainptr);
+
+        if (fd && UNLIKELY(blo_filedata_has_io_error(fd))) {
+          blo_reportf_wrap(basefd->reports,
+                           RPT_ERROR,
+                           TIP_("Unable to read library '%s': %s"),
+                           mainptr->curlib->filepath,
+                           strerror(EIO));
+        }
       }
     }
   }
@@ -73,6 +73,13 @@ typedef struct FileData {
 
   /** Regular file reading. */
   int filedes;
+  /** Memory mapped file reading (uncompressed files only), otherwise NULL. */
+  const char *mmap_data;
+  size_t mmap_size;
+  /** Reading the mapping failed, set from the SIGBUS handler. */
+  volatile bool mmap_io_error;
+  /** Data-blocks of all IDs read ahead in parallel, by #BHead (memory mapped files only). */
+  struct GHash *datamap_prefetched;
 
   /** Variables needed for reading from memory / stream. */
   const char *buffer;
@@ -83,6 +90,15 @@ typedef struct FileData {
   gzFile gzfiledes;
   /** Gzip stream for memory decompression. */
   z_stream strm;
+  /** Undo: IDs of the old main by address, which can be reused or re-read in place. */
+  struct GHash *undo_old_id_map;
+  /** Undo: number of IDs in #undo_old_id_map and how many of them were found in the file. */
+  int undo_old_ids_len, undo_old_ids_used;
+  /** Undo: IDs were read which don't exist in the old main. */
+  bool undo_ids_added;
+
+  /** Frame index for seeking in compressed files, see #BLEND_GZIP_FRAME_SIZE. */
+  struct FileDataGzipFrames *gzframes;
 
   /** Now only in use for library appending. */
   char relabase[FILE_MAX];
@@ -126,6 +142,19 @@ typedef struct FileData {
 
 #define SIZEOFBLENDERHEADER 12
 
+/**
+ * Compressed files are written as a series of gzip members, each holding an independently
+ * compressed frame of at most #BLEND_GZIP_FRAME_SIZE bytes, so frames can be compressed in
+ * parallel and decompressed on demand when seeking.
+ * Any gzip reader can still read such a file as a single stream.
+ *
+ * Besides regular gzip header fields, every member stores an extra field with sub-field ID "BL",
+ * which holds (little endian) the size of the whole member and the size of its uncompressed data.
+ */
+#define BLEND_GZIP_FRAME_SIZE (1 << 20)
+#define BLEND_GZIP_FRAME_HEADER_SIZE 24
+#define BLEND_GZIP_FRAME_TRAILER_SIZE 8
+
 /***/
 struct Main;
 void blo_join_main(ListBase *mainlist);
@@ -144,6 +173,10 @@ void blo_make_scene_pointer_map(FileData *fd, struct Main *oldmain);
 void blo_end_scene_pointer_map(FileData *fd, struct Main *oldmain);
 void blo_make_movieclip_pointer_map(FileData *fd, struct Main *oldmain);
 void blo_end_movieclip_pointer_map(FileData *fd, struct Main *oldmain);
+void blo_make_undo_old_id_map(FileData *fd,
+                              struct Main *oldmain,
+                              const struct MemFile *memfile_identical);
+void blo_end_undo_old_id_map(FileData *fd, struct Main *newmain);
 void blo_make_sound_pointer_map(FileData *fd, struct Main *oldmain);
 void blo_end_sound_pointer_map(FileData *fd, struct Main *oldmain);
 void blo_make_packed_pointer_map(FileData *fd, struct Main *oldmain);
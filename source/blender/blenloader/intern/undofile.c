@@ -41,6 +41,7 @@
 #include "DNA_listBase.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
 
 #include "BLO_undofile.h"
 #include "BLO_readfile.h"
@@ -64,29 +65,47 @@ void BLO_memfile_free(MemFile *memfile)
     MEM_freeN(chunk);
   }
   memfile->size = 0;
+
+  if (memfile->id_chunks != NULL) {
+    BLI_ghash_free(memfile->id_chunks, NULL, MEM_freeN);
+    memfile->id_chunks = NULL;
+  }
 }
 
 /* to keep list of memfiles consistent, 'first' is always first in list */
 /* result is that 'first' is being freed */
 void BLO_memfile_merge(MemFile *first, MemFile *second)
 {
-  MemFileChunk *fc, *sc;
-
-  fc = first->chunks.first;
-  sc = second->chunks.first;
-  while (fc || sc) {
-    if (fc && sc) {
-      if (sc->is_identical) {
-        sc->is_identical = false;
-        fc->is_identical = true;
-      }
+  /* Chunks are compared per ID, so shared buffers are not necessarily at the same position,
+   * hand over ownership of all buffers owned by 'first' that 'second' shares. */
+  GSet *buffers_owned = BLI_gset_ptr_new(__func__);
+
+  LISTBASE_FOREACH (MemFileChunk *, fc, &first->chunks) {
+    if (fc->is_identical == false) {
+      BLI_gset_add(buffers_owned, (void *)fc->buf);
+    }
+  }
+
+  LISTBASE_FOREACH (MemFileChunk *, sc, &second->chunks) {
+    if (sc->is_identical && BLI_gset_remove(buffers_owned, sc->buf, NULL)) {
+      sc->is_identical = false;
     }
-    if (fc) {
-      fc = fc->next;
+  }
+
+  LISTBASE_FOREACH (MemFileChunk *, fc, &first->chunks) {
+    if (fc->is_identical == false && !BLI_gset_haskey(buffers_owned, fc->buf)) {
+      fc->is_identical = true;
     }
-    if (sc) {
-      sc = sc->next;
+  }
+
+  BLI_gset_free(buffers_owned, NULL);
+
+  /* IDs of 'second' were compared to 'first', which doesn't precede it anymore. */
+  if (second->id_chunks != NULL) {
+    GHASH_FOREACH_BEGIN (MemFileIDChunks *, id_chunks, second->id_chunks) {
+      id_chunks->is_identical = false;
     }
+    GHASH_FOREACH_END();
   }
 
   BLO_memfile_free(first);
@@ -126,8 +145,11 @@ struct Main *BLO_memfile_main_get(struct MemFile *memfile,
                                   struct Scene **r_scene)
 {
   struct Main *bmain_undo = NULL;
-  BlendFileData *bfd = BLO_read_from_memfile(
-      oldmain, BKE_main_blendfile_path(oldmain), memfile, BLO_READ_SKIP_NONE, NULL);
+  BlendFileData *bfd = BLO_read_from_memfile(oldmain,
+                                             BKE_main_blendfile_path(oldmain),
+                                             memfile,
+                                             &(const struct BlendFileReadParams){0},
+                                             NULL);
 
   if (bfd) {
     bmain_undo = bfd->main;
@@ -144,7 +144,10 @@
 #include "MEM_guardedalloc.h"  // MEM_freeN
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "BKE_action.h"
 #include "BKE_blender_version.h"
@@ -215,7 +218,7 @@ struct WriteWrap {
   /* internal */
   union {
     int file_handle;
-    gzFile gz_handle;
+    struct WriteWrapGzip *gz_handle;
   } _user_data;
 };
 
@@ -246,17 +249,156 @@ static size_t ww_write_none(WriteWrap *ww, const char *buf, size_t buf_len)
 }
 #undef FILE_HANDLE
 
-/* zlib */
+/* zlib
+ *
+ * Data is split into frames of #BLEND_GZIP_FRAME_SIZE, which are compressed in parallel into
+ * independent gzip members, see #BLEND_GZIP_FRAME_HEADER_SIZE for details. */
 #define FILE_HANDLE(ww) (ww)->_user_data.gz_handle
 
+/* Amount of frames compressed at once per thread. */
+#define WW_GZIP_FRAMES_PER_THREAD 2
+
+typedef struct WriteWrapGzipFrame {
+  const char *data;
+  size_t data_len;
+  /* Compressed gzip member. */
+  char *result;
+  size_t result_len;
+} WriteWrapGzipFrame;
+
+typedef struct WriteWrapGzip {
+  int file_handle;
+  /* Uncompressed data of all frames in the batch. */
+  char *buf;
+  size_t buf_len;
+  size_t buf_used_len;
+  WriteWrapGzipFrame *frames;
+  int frames_len;
+} WriteWrapGzip;
+
+static void ww_gzip_write_u32(char *dst, uint value)
+{
+  dst[0] = (char)(value & 0xff);
+  dst[1] = (char)((value >> 8) & 0xff);
+  dst[2] = (char)((value >> 16) & 0xff);
+  dst[3] = (char)((value >> 24) & 0xff);
+}
+
+static void ww_gzip_compress_frame(void *__restrict userdata,
+                                   const int iter,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  WriteWrapGzipFrame *frame = &((WriteWrapGzipFrame *)userdata)[iter];
+  z_stream strm = {NULL};
+
+  frame->result = NULL;
+  frame->result_len = 0;
+
+  /* Raw deflate stream, gzip header and trailer are written manually. */
+  if (deflateInit2(&strm, 1, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return;
+  }
+
+  const size_t deflate_bound = deflateBound(&strm, (uLong)frame->data_len);
+  const size_t result_max_len = BLEND_GZIP_FRAME_HEADER_SIZE + deflate_bound +
+                                BLEND_GZIP_FRAME_TRAILER_SIZE;
+  char *result = MEM_mallocN(result_max_len, __func__);
+
+  strm.next_in = (Bytef *)frame->data;
+  strm.avail_in = (uInt)frame->data_len;
+  strm.next_out = (Bytef *)result + BLEND_GZIP_FRAME_HEADER_SIZE;
+  strm.avail_out = (uInt)deflate_bound;
+
+  const int err = deflate(&strm, Z_FINISH);
+  const size_t deflate_len = (size_t)strm.total_out;
+  deflateEnd(&strm);
+
+  if (err != Z_STREAM_END) {
+    MEM_freeN(result);
+    return;
+  }
+
+  const size_t result_len = BLEND_GZIP_FRAME_HEADER_SIZE + deflate_len +
+                            BLEND_GZIP_FRAME_TRAILER_SIZE;
+
+  /* Header: magic, deflate method, FEXTRA flag, no time-stamp, no extra flags, unknown OS. */
+  const char header[12] = {0x1f, (char)0x8b, 8, 4, 0, 0, 0, 0, 0, (char)255, 12, 0};
+  memcpy(result, header, sizeof(header));
+  /* Extra field: sub-field ID, length and the sizes of this member. */
+  result[12] = 'B';
+  result[13] = 'L';
+  result[14] = 8;
+  result[15] = 0;
+  ww_gzip_write_u32(&result[16], (uint)result_len);
+  ww_gzip_write_u32(&result[20], (uint)frame->data_len);
+
+  /* Trailer: CRC32 and size of uncompressed data. */
+  char *trailer = result + BLEND_GZIP_FRAME_HEADER_SIZE + deflate_len;
+  ww_gzip_write_u32(
+      &trailer[0], (uint)crc32(crc32(0L, Z_NULL, 0), (const Bytef *)frame->data, frame->data_len));
+  ww_gzip_write_u32(&trailer[4], (uint)frame->data_len);
+
+  frame->result = result;
+  frame->result_len = result_len;
+}
+
+static bool ww_gzip_flush(WriteWrapGzip *gz)
+{
+  if (gz->buf_used_len == 0) {
+    return true;
+  }
+
+  const int frames_len = (int)((gz->buf_used_len + BLEND_GZIP_FRAME_SIZE - 1) /
+                               BLEND_GZIP_FRAME_SIZE);
+  for (int i = 0; i < frames_len; i++) {
+    WriteWrapGzipFrame *frame = &gz->frames[i];
+    const size_t offset = (size_t)i * BLEND_GZIP_FRAME_SIZE;
+    frame->data = gz->buf + offset;
+    frame->data_len = MIN2(BLEND_GZIP_FRAME_SIZE, gz->buf_used_len - offset);
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (frames_len > 1);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, frames_len, gz->frames, ww_gzip_compress_frame, &settings);
+
+  /* Members are written in order, so the file can be read as a regular gzip stream. */
+  bool ok = true;
+  for (int i = 0; i < frames_len; i++) {
+    WriteWrapGzipFrame *frame = &gz->frames[i];
+    if (frame->result == NULL) {
+      ok = false;
+    }
+    else {
+      if (ok && write(gz->file_handle, frame->result, frame->result_len) !=
+                    (ssize_t)frame->result_len) {
+        ok = false;
+      }
+      MEM_freeN(frame->result);
+      frame->result = NULL;
+    }
+  }
+
+  gz->buf_used_len = 0;
+
+  return ok;
+}
+
 static bool ww_open_zlib(WriteWrap *ww, const char *filepath)
 {
-  gzFile file;
+  int file;
 
-  file = BLI_gzopen(filepath, "wb1");
+  file = BLI_open(filepath, O_BINARY + O_WRONLY + O_CREAT + O_TRUNC, 0666);
 
-  if (file != Z_NULL) {
-    FILE_HANDLE(ww) = file;
+  if (file != -1) {
+    WriteWrapGzip *gz = MEM_callocN(sizeof(*gz), __func__);
+    gz->file_handle = file;
+    gz->frames_len = BLI_system_thread_count() * WW_GZIP_FRAMES_PER_THREAD;
+    gz->frames = MEM_callocN(sizeof(*gz->frames) * gz->frames_len, __func__);
+    gz->buf_len = (size_t)gz->frames_len * BLEND_GZIP_FRAME_SIZE;
+    gz->buf = MEM_mallocN(gz->buf_len, __func__);
+    FILE_HANDLE(ww) = gz;
     return true;
   }
   else {
@@ -265,11 +407,38 @@ static bool ww_open_zlib(WriteWrap *ww, const char *filepath)
 }
 static bool ww_close_zlib(WriteWrap *ww)
 {
-  return (gzclose(FILE_HANDLE(ww)) == Z_OK);
+  WriteWrapGzip *gz = FILE_HANDLE(ww);
+  bool ok = ww_gzip_flush(gz);
+
+  if (close(gz->file_handle) == -1) {
+    ok = false;
+  }
+
+  MEM_freeN(gz->buf);
+  MEM_freeN(gz->frames);
+  MEM_freeN(gz);
+  FILE_HANDLE(ww) = NULL;
+
+  return ok;
 }
 static size_t ww_write_zlib(WriteWrap *ww, const char *buf, size_t buf_len)
 {
-  return gzwrite(FILE_HANDLE(ww), buf, buf_len);
+  WriteWrapGzip *gz = FILE_HANDLE(ww);
+  size_t written_len = 0;
+
+  while (written_len < buf_len) {
+    if (gz->buf_used_len == gz->buf_len) {
+      if (!ww_gzip_flush(gz)) {
+        break;
+      }
+    }
+    const size_t len = MIN2(buf_len - written_len, gz->buf_len - gz->buf_used_len);
+    memcpy(gz->buf + gz->buf_used_len, buf + written_len, len);
+    gz->buf_used_len += len;
+    written_len += len;
+  }
+
+  return written_len;
 }
 #undef FILE_HANDLE
 
@@ -325,6 +494,12 @@ typedef struct {
     MemFile *compare;
     /** Use to de-duplicate chunks when writing. */
     MemFileChunk *compare_chunk;
+    /** Last chunk before the ID being written, see #mywrite_id_begin. */
+    MemFileChunk *id_chunk_prev;
+    /** Chunks of the ID being written in #MemFile.compare (NULL when it didn't exist). */
+    MemFileIDChunks *id_compare_chunks;
+    /** Compare chunk to continue with after the ID, when it didn't exist in compare. */
+    MemFileChunk *id_compare_chunk_next;
   } mem;
   /** When true, write to #WriteData.current, could also call 'is_undo'. */
   bool use_memfile;
@@ -399,6 +574,68 @@ static void mywrite_flush(WriteData *wd)
   }
 }
 
+/**
+ * Start writing an ID, for undo each ID gets its own chunks which are compared with the chunks
+ * of the same ID in the previous step, so unchanged IDs can be detected even when other IDs
+ * changed size or order.
+ */
+static void mywrite_id_begin(WriteData *wd, ID *id)
+{
+  if (wd->use_memfile == false) {
+    return;
+  }
+
+  mywrite_flush(wd);
+
+  wd->mem.id_chunk_prev = wd->mem.current->chunks.last;
+  wd->mem.id_compare_chunks = NULL;
+  wd->mem.id_compare_chunk_next = wd->mem.compare_chunk;
+
+  if (wd->mem.compare != NULL && wd->mem.compare->id_chunks != NULL) {
+    wd->mem.id_compare_chunks = BLI_ghash_lookup(wd->mem.compare->id_chunks, id);
+    wd->mem.compare_chunk = wd->mem.id_compare_chunks ? wd->mem.id_compare_chunks->first : NULL;
+  }
+}
+
+static void mywrite_id_end(WriteData *wd, ID *id)
+{
+  if (wd->use_memfile == false) {
+    return;
+  }
+
+  mywrite_flush(wd);
+
+  MemFile *memfile = wd->mem.current;
+  MemFileChunk *chunk_first = wd->mem.id_chunk_prev ? wd->mem.id_chunk_prev->next :
+                                                      memfile->chunks.first;
+  if (chunk_first != NULL) {
+    MemFileIDChunks *id_chunks = MEM_mallocN(sizeof(*id_chunks), __func__);
+    id_chunks->first = chunk_first;
+    id_chunks->chunks_len = 0;
+    id_chunks->is_identical = true;
+    for (MemFileChunk *chunk = chunk_first; chunk; chunk = chunk->next) {
+      id_chunks->chunks_len++;
+      if (chunk->is_identical == false) {
+        id_chunks->is_identical = false;
+      }
+    }
+    if ((wd->mem.id_compare_chunks == NULL) ||
+        (wd->mem.id_compare_chunks->chunks_len != id_chunks->chunks_len)) {
+      id_chunks->is_identical = false;
+    }
+
+    if (memfile->id_chunks == NULL) {
+      memfile->id_chunks = BLI_ghash_ptr_new(__func__);
+    }
+    BLI_ghash_insert(memfile->id_chunks, id, id_chunks);
+  }
+
+  /* Continue comparing the data following this ID. */
+  if (wd->mem.id_compare_chunks == NULL) {
+    wd->mem.compare_chunk = wd->mem.id_compare_chunk_next;
+  }
+}
+
 /**
  * Low level WRITE(2) wrapper that buffers data
  * \param adr: Pointer to new chunk of data
@@ -3836,6 +4073,8 @@ static bool write_file_handle(Main *mainvar,
           BKE_override_library_operations_store_start(bmain, override_storage, id);
         }
 
+        mywrite_id_begin(wd, id);
+
         switch ((ID_Type)GS(id->name)) {
           case ID_WM:
             write_windowmanager(wd, (wmWindowManager *)id);
@@ -3952,6 +4191,8 @@ static bool write_file_handle(Main *mainvar,
             break;
         }
 
+        mywrite_id_end(wd, id);
+
         if (do_override) {
           BKE_override_library_operations_store_end(override_storage, id);
         }
@@ -0,0 +1,147 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2019, Blender Foundation.
+ */
+
+#include "COM_AreaExecutor.h"
+#include "COM_ReadBufferOperation.h"
+
+AreaExecutor::AreaExecutor(rcti *area)
+{
+  this->m_area = *area;
+}
+
+AreaExecutor::~AreaExecutor()
+{
+  for (AreaResults::iterator it = this->m_results.begin(); it != this->m_results.end(); ++it) {
+    if (it->second.owned) {
+      delete it->second.buffer;
+    }
+  }
+}
+
+bool AreaExecutor::canExecuteArea(NodeOperation *operation)
+{
+  if (!operation->hasAreaExecution()) {
+    return false;
+  }
+
+  /* Inputs are read from buffers with the datatype of the input socket. */
+  for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationInput *input = operation->getInputSocket(index);
+    if (!input->isConnected() || input->getLink()->getDataType() != input->getDataType()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void AreaExecutor::addOutput(NodeOperation *operation)
+{
+  addUser(operation);
+}
+
+void AreaExecutor::addUser(NodeOperation *operation)
+{
+  AreaResults::iterator it = this->m_results.find(operation);
+  if (it != this->m_results.end()) {
+    it->second.users++;
+    return;
+  }
+
+  AreaResult result = {NULL, 1, false};
+  this->m_results[operation] = result;
+
+  /* Operations calculated pixel by pixel read their inputs themselves. */
+  if (canExecuteArea(operation)) {
+    for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+      addUser(&operation->getInputSocket(index)->getLink()->getOperation());
+    }
+  }
+}
+
+void AreaExecutor::removeUser(NodeOperation *operation)
+{
+  AreaResult &result = this->m_results[operation];
+  BLI_assert(result.users > 0);
+  result.users--;
+  if (result.users == 0 && result.owned) {
+    delete result.buffer;
+    result.buffer = NULL;
+    result.owned = false;
+  }
+}
+
+MemoryBuffer *AreaExecutor::calculate(NodeOperation *operation, MemoryBuffer *output)
+{
+  AreaResults::iterator it = this->m_results.find(operation);
+  BLI_assert(it != this->m_results.end());
+  AreaResult &result = it->second;
+
+  if (result.buffer) {
+    BLI_assert(output == NULL || output == result.buffer);
+    return result.buffer;
+  }
+
+  if (output == NULL && operation->isReadBufferOperation()) {
+    /* Read from the buffer of the write operation directly when it contains the area. */
+    output = static_cast<ReadBufferOperation *>(operation)->getAreaBuffer(&this->m_area);
+    if (output) {
+      result.buffer = output;
+      return output;
+    }
+  }
+
+  if (output == NULL) {
+    output = new MemoryBuffer(operation->getOutputSocket()->getDataType(), &this->m_area);
+    result.owned = true;
+  }
+  result.buffer = output;
+
+  if (canExecuteArea(operation)) {
+    const unsigned int num_inputs = operation->getNumberOfInputSockets();
+    std::vector<MemoryBuffer *> inputs(num_inputs);
+    for (unsigned int index = 0; index < num_inputs; index++) {
+      inputs[index] = calculate(&operation->getInputSocket(index)->getLink()->getOperation());
+    }
+
+    operation->executeArea(output, &this->m_area, inputs.empty() ? NULL : &inputs[0]);
+
+    for (unsigned int index = 0; index < num_inputs; index++) {
+      removeUser(&operation->getInputSocket(index)->getLink()->getOperation());
+    }
+  }
+  else {
+    executePixels(operation, output);
+  }
+
+  return output;
+}
+
+void AreaExecutor::executePixels(NodeOperation *operation, MemoryBuffer *output)
+{
+  const int num_channels = output->get_num_channels();
+  float color[4];
+
+  for (int y = this->m_area.ymin; y < this->m_area.ymax; y++) {
+    float *buffer = output->getElem(this->m_area.xmin, y);
+    for (int x = this->m_area.xmin; x < this->m_area.xmax; x++) {
+      operation->readSampled(color, x, y, COM_PS_NEAREST);
+      memcpy(buffer, color, num_channels * sizeof(float));
+      buffer += num_channels;
+    }
+  }
+}
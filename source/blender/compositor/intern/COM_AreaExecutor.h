@@ -0,0 +1,97 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2019, Blender Foundation.
+ */
+
+#ifndef __COM_AREAEXECUTOR_H__
+#define __COM_AREAEXECUTOR_H__
+
+#include <map>
+#include <vector>
+
+#include "COM_NodeOperation.h"
+
+/**
+ * \brief Calculates an area of a chain of operations one operation at a time
+ *
+ * Instead of pulling every pixel through the whole chain of operations, every operation
+ * calculates the area in a single NodeOperation.executeArea call, reading the results of its
+ * inputs from buffers. Results read by several operations are only calculated once, and are
+ * freed as soon as the last operation reading them has been calculated.
+ *
+ * Operations without area execution are calculated pixel by pixel into a buffer, reading their
+ * own inputs like before.
+ *
+ * \note an AreaExecutor is only used by a single thread, for a single chunk
+ * \see NodeOperation.executeArea
+ * \ingroup Execution
+ */
+class AreaExecutor {
+ private:
+  struct AreaResult {
+    /** \brief the result of the operation, NULL when not calculated yet or freed */
+    MemoryBuffer *buffer;
+    /** \brief number of reads of the result that still have to happen */
+    int users;
+    /** \brief was the buffer allocated by this executor */
+    bool owned;
+  };
+  typedef std::map<NodeOperation *, AreaResult> AreaResults;
+
+  /**
+   * \brief the area to calculate
+   */
+  rcti m_area;
+
+  AreaResults m_results;
+
+ public:
+  AreaExecutor(rcti *area);
+  ~AreaExecutor();
+
+  /**
+   * \brief add an operation of which the result will be read by the caller
+   * \note all outputs must be added before calculating any of them
+   */
+  void addOutput(NodeOperation *operation);
+
+  /**
+   * \brief calculate the result of an operation that was added with addOutput
+   * \param output: buffer to write the result to, when NULL a buffer is allocated
+   * \return the buffer containing the result, valid until the executor is destroyed
+   */
+  MemoryBuffer *calculate(NodeOperation *operation, MemoryBuffer *output = NULL);
+
+ private:
+  /**
+   * \brief can the operation be calculated with executeArea, reading its inputs from buffers
+   */
+  static bool canExecuteArea(NodeOperation *operation);
+
+  void addUser(NodeOperation *operation);
+  void removeUser(NodeOperation *operation);
+
+  /**
+   * \brief calculate an operation pixel by pixel
+   */
+  void executePixels(NodeOperation *operation, MemoryBuffer *output);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:AreaExecutor")
+#endif
+};
+
+#endif
@@ -150,6 +150,23 @@ void ExecutionGroup::initExecution()
   this->m_cachedMaxReadBufferOffset = maxNumber;
 }
 
+bool ExecutionGroup::isExecuted() const
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ExecutionGroup::setExecuted()
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+  }
+}
+
 void ExecutionGroup::deinitExecution()
 {
   if (this->m_chunkExecutionStates != NULL) {
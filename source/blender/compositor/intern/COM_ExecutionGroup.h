@@ -372,6 +372,17 @@ class ExecutionGroup {
    */
   void finalizeChunkExecution(int chunkNumber, MemoryBuffer **memoryBuffers);
 
+  /**
+   * \brief have all chunks of this ExecutionGroup been calculated
+   */
+  bool isExecuted() const;
+
+  /**
+   * \brief mark all chunks as calculated, used when the output is restored from the ResultCache
+   * \note must be called after initExecution
+   */
+  void setExecuted();
+
   /**
    * \brief deinitExecution is called just after execution the whole graph.
    * \note It will release all needed resources
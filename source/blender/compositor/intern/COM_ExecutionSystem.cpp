@@ -32,6 +32,8 @@ extern "C" {
 #include "COM_ExecutionGroup.h"
 #include "COM_WorkScheduler.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_Debug.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
@@ -148,6 +150,24 @@ void ExecutionSystem::execute()
   }
   unsigned int index;
 
+  // Buffers read directly by complex operations are stored as floats
+  for (index = 0; index < this->m_operations.size(); index++) {
+    NodeOperation *operation = this->m_operations[index];
+    if (!operation->isComplex()) {
+      continue;
+    }
+    for (unsigned int i = 0; i < operation->getNumberOfInputSockets(); i++) {
+      NodeOperationInput *input = operation->getInputSocket(i);
+      if (!input->isConnected()) {
+        continue;
+      }
+      NodeOperation &inputOperation = input->getLink()->getOperation();
+      if (inputOperation.isReadBufferOperation()) {
+        ((ReadBufferOperation &)inputOperation).getMemoryProxy()->setNeedsFloatBuffer();
+      }
+    }
+  }
+
   // First allocale all write buffer
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
@@ -178,6 +198,12 @@ void ExecutionSystem::execute()
     executionGroup->initExecution();
   }
 
+  const bool useResultCache = (editingtree->flag & NTREE_COM_RESULT_CACHE) != 0;
+  ResultCacheKeys cacheKeys(this->m_context);
+  if (useResultCache) {
+    restoreCachedResults(cacheKeys);
+  }
+
   WorkScheduler::start(this->m_context);
 
   executeGroups(COM_PRIORITY_HIGH);
@@ -189,6 +215,10 @@ void ExecutionSystem::execute()
   WorkScheduler::finish();
   WorkScheduler::stop();
 
+  if (useResultCache && !editingtree->test_break(editingtree->tbh)) {
+    storeCachedResults(cacheKeys);
+  }
+
   editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | De-initializing execution"));
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
@@ -200,6 +230,44 @@ void ExecutionSystem::execute()
   }
 }
 
+void ExecutionSystem::restoreCachedResults(ResultCacheKeys &keys)
+{
+  unsigned int index;
+  for (index = 0; index < this->m_groups.size(); index++) {
+    ExecutionGroup *group = this->m_groups[index];
+    NodeOperation *operation = group->getOutputOperation();
+    if (!operation->isWriteBufferOperation()) {
+      continue;
+    }
+
+    WriteBufferOperation *writeOperation = (WriteBufferOperation *)operation;
+    uint64_t key;
+    if (keys.determineKey(writeOperation, &key) &&
+        ResultCache::restore(key, writeOperation->getMemoryProxy())) {
+      group->setExecuted();
+    }
+  }
+}
+
+void ExecutionSystem::storeCachedResults(ResultCacheKeys &keys)
+{
+  unsigned int index;
+  for (index = 0; index < this->m_groups.size(); index++) {
+    ExecutionGroup *group = this->m_groups[index];
+    NodeOperation *operation = group->getOutputOperation();
+    if (!operation->isWriteBufferOperation() || group->getWidth() == 0 ||
+        group->getHeight() == 0 || !group->isExecuted()) {
+      continue;
+    }
+
+    WriteBufferOperation *writeOperation = (WriteBufferOperation *)operation;
+    uint64_t key;
+    if (keys.determineKey(writeOperation, &key)) {
+      ResultCache::store(key, writeOperation->getMemoryProxy());
+    }
+  }
+}
+
 void ExecutionSystem::executeGroups(CompositorPriority priority)
 {
   unsigned int index;
@@ -17,6 +17,7 @@
  */
 
 class ExecutionGroup;
+class ResultCacheKeys;
 
 #ifndef __COM_EXECUTIONSYSTEM_H__
 #define __COM_EXECUTIONSYSTEM_H__
@@ -189,6 +190,17 @@ class ExecutionSystem {
  private:
   void executeGroups(CompositorPriority priority);
 
+  /**
+   * \brief restore the results of ExecutionGroups from the ResultCache
+   * and mark them as executed
+   */
+  void restoreCachedResults(ResultCacheKeys &keys);
+
+  /**
+   * \brief store the results of all fully executed ExecutionGroups in the ResultCache
+   */
+  void storeCachedResults(ResultCacheKeys &keys);
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
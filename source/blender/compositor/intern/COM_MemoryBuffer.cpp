@@ -50,7 +50,25 @@ int MemoryBuffer::getHeight() const
   return this->m_height;
 }
 
-MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, rcti *rect)
+void MemoryBuffer::allocateBuffer(bool half)
+{
+  BLI_mutex_init(&this->m_floatBufferMutex);
+  const size_t len = (size_t)determineBufferSize() * this->m_num_channels;
+  if (half) {
+    this->m_halfBuffer = (unsigned short *)MEM_mallocN_aligned(
+        sizeof(unsigned short) * len, 16, "COM_MemoryBuffer half");
+    this->m_buffer = NULL;
+  }
+  else {
+    this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * len, 16, "COM_MemoryBuffer");
+    this->m_halfBuffer = NULL;
+  }
+}
+
+MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy,
+                           unsigned int chunkNumber,
+                           rcti *rect,
+                           bool half)
 {
   BLI_rcti_init(&this->m_rect, rect->xmin, rect->xmax, rect->ymin, rect->ymax);
   this->m_width = BLI_rcti_size_x(&this->m_rect);
@@ -58,8 +76,7 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, r
   this->m_memoryProxy = memoryProxy;
   this->m_chunkNumber = chunkNumber;
   this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
-  this->m_buffer = (float *)MEM_mallocN_aligned(
-      sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+  this->allocateBuffer(half);
   this->m_state = COM_MB_ALLOCATED;
   this->m_datatype = memoryProxy->getDataType();
 }
@@ -72,12 +89,11 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect)
   this->m_memoryProxy = memoryProxy;
   this->m_chunkNumber = -1;
   this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
-  this->m_buffer = (float *)MEM_mallocN_aligned(
-      sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+  this->allocateBuffer(false);
   this->m_state = COM_MB_TEMPORARILY;
   this->m_datatype = memoryProxy->getDataType();
 }
-MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect)
+MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect, bool half)
 {
   BLI_rcti_init(&this->m_rect, rect->xmin, rect->xmax, rect->ymin, rect->ymax);
   this->m_width = BLI_rcti_size_x(&this->m_rect);
@@ -86,30 +102,58 @@ MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect)
   this->m_memoryProxy = NULL;
   this->m_chunkNumber = -1;
   this->m_num_channels = determine_num_channels(dataType);
-  this->m_buffer = (float *)MEM_mallocN_aligned(
-      sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+  this->allocateBuffer(half);
   this->m_state = COM_MB_TEMPORARILY;
   this->m_datatype = dataType;
 }
+float *MemoryBuffer::createFloatBuffer()
+{
+  BLI_assert(this->m_halfBuffer);
+  BLI_mutex_lock(&this->m_floatBufferMutex);
+  float *buffer = this->m_buffer;
+  if (buffer == NULL) {
+    const size_t len = (size_t)determineBufferSize() * this->m_num_channels;
+    buffer = (float *)MEM_mallocN_aligned(sizeof(float) * len, 16, "COM_MemoryBuffer");
+    half_to_float_vn(buffer, this->m_halfBuffer, len);
+    /* Readers don't lock, publish the copy once it is complete. */
+    atomic_store_ptr((void **)&this->m_buffer, buffer);
+  }
+  BLI_mutex_unlock(&this->m_floatBufferMutex);
+  return buffer;
+}
+
 MemoryBuffer *MemoryBuffer::duplicate()
 {
   MemoryBuffer *result = new MemoryBuffer(this->m_memoryProxy, &this->m_rect);
-  memcpy(result->m_buffer,
-         this->m_buffer,
-         this->determineBufferSize() * this->m_num_channels * sizeof(float));
+  result->copyElements(0, this, 0, this->determineBufferSize() * this->m_num_channels);
   return result;
 }
 void MemoryBuffer::clear()
 {
-  memset(this->m_buffer, 0, this->determineBufferSize() * this->m_num_channels * sizeof(float));
+  const size_t len = (size_t)this->determineBufferSize() * this->m_num_channels;
+  if (this->m_halfBuffer) {
+    memset(this->m_halfBuffer, 0, len * sizeof(unsigned short));
+  }
+  if (this->m_buffer) {
+    memset(this->m_buffer, 0, len * sizeof(float));
+  }
 }
 
 float MemoryBuffer::getMaximumValue()
 {
-  float result = this->m_buffer[0];
   const unsigned int size = this->determineBufferSize();
   unsigned int i;
 
+  if (this->m_halfBuffer) {
+    const unsigned short *hp_src = this->m_halfBuffer;
+    float result = half_to_float(hp_src[0]);
+    for (i = 0; i < size; i++, hp_src += this->m_num_channels) {
+      result = max(result, half_to_float(*hp_src));
+    }
+    return result;
+  }
+
+  float result = this->m_buffer[0];
   const float *fp_src = this->m_buffer;
 
   for (i = 0; i < size; i++, fp_src += this->m_num_channels) {
@@ -144,10 +188,40 @@ float MemoryBuffer::getMaximumValue(rcti *rect)
 
 MemoryBuffer::~MemoryBuffer()
 {
+  BLI_mutex_end(&this->m_floatBufferMutex);
   if (this->m_buffer) {
     MEM_freeN(this->m_buffer);
     this->m_buffer = NULL;
   }
+  if (this->m_halfBuffer) {
+    MEM_freeN(this->m_halfBuffer);
+    this->m_halfBuffer = NULL;
+  }
+}
+
+void MemoryBuffer::copyElements(size_t offset,
+                                const MemoryBuffer *otherBuffer,
+                                size_t otherOffset,
+                                size_t len)
+{
+  if (this->m_halfBuffer) {
+    /* the float copy would not see the new data */
+    BLI_assert(this->m_buffer == NULL);
+    if (otherBuffer->m_halfBuffer) {
+      memcpy(&this->m_halfBuffer[offset],
+             &otherBuffer->m_halfBuffer[otherOffset],
+             len * sizeof(unsigned short));
+    }
+    else {
+      float_to_half_vn(&this->m_halfBuffer[offset], &otherBuffer->m_buffer[otherOffset], len);
+    }
+  }
+  else if (otherBuffer->m_halfBuffer) {
+    half_to_float_vn(&this->m_buffer[offset], &otherBuffer->m_halfBuffer[otherOffset], len);
+  }
+  else {
+    memcpy(&this->m_buffer[offset], &otherBuffer->m_buffer[otherOffset], len * sizeof(float));
+  }
 }
 
 void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
@@ -170,9 +244,58 @@ void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
                   this->m_num_channels;
     offset = ((otherY - this->m_rect.ymin) * this->m_width + minX - this->m_rect.xmin) *
              this->m_num_channels;
-    memcpy(&this->m_buffer[offset],
-           &otherBuffer->m_buffer[otherOffset],
-           (maxX - minX) * this->m_num_channels * sizeof(float));
+    this->copyElements(offset, otherBuffer, otherOffset, (maxX - minX) * this->m_num_channels);
+  }
+}
+
+void MemoryBuffer::copyArea(MemoryBuffer *otherBuffer, const rcti *area)
+{
+  BLI_assert(otherBuffer->m_num_channels == this->m_num_channels);
+  BLI_assert(this->m_halfBuffer == NULL);
+  const size_t pixel_size = this->m_num_channels * sizeof(float);
+  const int minX = max(area->xmin, otherBuffer->m_rect.xmin);
+  const int maxX = min(area->xmax, otherBuffer->m_rect.xmax);
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *buffer = this->getElem(area->xmin, y);
+    if (y < otherBuffer->m_rect.ymin || y >= otherBuffer->m_rect.ymax || minX >= maxX) {
+      memset(buffer, 0, (area->xmax - area->xmin) * pixel_size);
+      continue;
+    }
+    /* clip result outside rect is zero */
+    memset(buffer, 0, (minX - area->xmin) * pixel_size);
+    this->copyElements(this->getOffset(minX, y),
+                       otherBuffer,
+                       otherBuffer->getOffset(minX, y),
+                       (maxX - minX) * this->m_num_channels);
+    memset(buffer + (maxX - area->xmin) * this->m_num_channels,
+           0,
+           (area->xmax - maxX) * pixel_size);
+  }
+}
+
+void MemoryBuffer::fill(const rcti *area, const float *value)
+{
+  if (this->m_halfBuffer) {
+    BLI_assert(this->m_buffer == NULL);
+    unsigned short half_value[4];
+    float_to_half_vn(half_value, value, this->m_num_channels);
+    for (int y = area->ymin; y < area->ymax; y++) {
+      unsigned short *buffer = &this->m_halfBuffer[this->getOffset(area->xmin, y)];
+      for (int x = area->xmin; x < area->xmax; x++) {
+        memcpy(buffer, half_value, this->m_num_channels * sizeof(unsigned short));
+        buffer += this->m_num_channels;
+      }
+    }
+    return;
+  }
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *buffer = this->getElem(area->xmin, y);
+    for (int x = area->xmin; x < area->xmax; x++) {
+      memcpy(buffer, value, this->m_num_channels * sizeof(float));
+      buffer += this->m_num_channels;
+    }
   }
 }
 
@@ -180,9 +303,14 @@ void MemoryBuffer::writePixel(int x, int y, const float color[4])
 {
   if (x >= this->m_rect.xmin && x < this->m_rect.xmax && y >= this->m_rect.ymin &&
       y < this->m_rect.ymax) {
-    const int offset = (this->m_width * (y - this->m_rect.ymin) + x - this->m_rect.xmin) *
-                       this->m_num_channels;
-    memcpy(&this->m_buffer[offset], color, sizeof(float) * this->m_num_channels);
+    const size_t offset = this->getOffset(x, y);
+    if (this->m_halfBuffer) {
+      BLI_assert(this->m_buffer == NULL);
+      float_to_half_vn(&this->m_halfBuffer[offset], color, this->m_num_channels);
+    }
+    else {
+      memcpy(&this->m_buffer[offset], color, sizeof(float) * this->m_num_channels);
+    }
   }
 }
 
@@ -190,8 +318,15 @@ void MemoryBuffer::addPixel(int x, int y, const float color[4])
 {
   if (x >= this->m_rect.xmin && x < this->m_rect.xmax && y >= this->m_rect.ymin &&
       y < this->m_rect.ymax) {
-    const int offset = (this->m_width * (y - this->m_rect.ymin) + x - this->m_rect.xmin) *
-                       this->m_num_channels;
+    const size_t offset = this->getOffset(x, y);
+    if (this->m_halfBuffer) {
+      BLI_assert(this->m_buffer == NULL);
+      unsigned short *dst = &this->m_halfBuffer[offset];
+      for (unsigned int i = 0; i < this->m_num_channels; i++) {
+        dst[i] = float_to_half(half_to_float(dst[i]) + color[i]);
+      }
+      return;
+    }
     float *dst = &this->m_buffer[offset];
     const float *src = color;
     for (int i = 0; i < this->m_num_channels; i++, dst++, src++) {
@@ -200,6 +335,72 @@ void MemoryBuffer::addPixel(int x, int y, const float color[4])
   }
 }
 
+void MemoryBuffer::readHalfPixel(float *result, int x, int y)
+{
+  if (x < 0 || y < 0 || x >= this->m_width || y >= this->m_height) {
+    zero_v4(result);
+  }
+  else {
+    half_to_float_vn(result,
+                     &this->m_halfBuffer[((size_t)this->m_width * y + x) * this->m_num_channels],
+                     this->m_num_channels);
+  }
+}
+
+/* Same as BLI_bilinear_interpolation_wrap_fl, reading the pixels from the half float data. */
+void MemoryBuffer::readBilinearHalf(float *result, float u, float v, bool wrap_x, bool wrap_y)
+{
+  int x1 = (int)floor(u);
+  int x2 = (int)ceil(u);
+  int y1 = (int)floor(v);
+  int y2 = (int)ceil(v);
+
+  /* pixel value must be already wrapped, however values at boundaries may flip */
+  if (wrap_x) {
+    if (x1 < 0) {
+      x1 = this->m_width - 1;
+    }
+    if (x2 >= this->m_width) {
+      x2 = 0;
+    }
+  }
+  else if (x2 < 0 || x1 >= this->m_width) {
+    copy_vn_fl(result, this->m_num_channels, 0.0f);
+    return;
+  }
+
+  if (wrap_y) {
+    if (y1 < 0) {
+      y1 = this->m_height - 1;
+    }
+    if (y2 >= this->m_height) {
+      y2 = 0;
+    }
+  }
+  else if (y2 < 0 || y1 >= this->m_height) {
+    copy_vn_fl(result, this->m_num_channels, 0.0f);
+    return;
+  }
+
+  /* sample including outside of edges of image */
+  float row1[4], row2[4], row3[4], row4[4];
+  readHalfPixel(row1, x1, y1);
+  readHalfPixel(row2, x1, y2);
+  readHalfPixel(row3, x2, y1);
+  readHalfPixel(row4, x2, y2);
+
+  const float a = u - floorf(u);
+  const float b = v - floorf(v);
+  const float a_b = a * b;
+  const float ma_b = (1.0f - a) * b;
+  const float a_mb = a * (1.0f - b);
+  const float ma_mb = (1.0f - a) * (1.0f - b);
+
+  for (unsigned int i = 0; i < this->m_num_channels; i++) {
+    result[i] = ma_mb * row1[i] + a_mb * row3[i] + ma_b * row2[i] + a_b * row4[i];
+  }
+}
+
 static void read_ewa_pixel_sampled(void *userdata, int x, int y, float result[4])
 {
   MemoryBuffer *buffer = (MemoryBuffer *)userdata;
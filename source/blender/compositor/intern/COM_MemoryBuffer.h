@@ -25,9 +25,12 @@ class MemoryBuffer;
 #include "COM_MemoryProxy.h"
 #include "COM_SocketReader.h"
 
+#include "atomic_ops.h"
+
 extern "C" {
 #include "BLI_math.h"
 #include "BLI_rect.h"
+#include "BLI_threads.h"
 }
 
 /**
@@ -50,10 +53,104 @@ typedef enum MemoryBufferExtend {
   COM_MB_REPEAT,
 } MemoryBufferExtend;
 
+/**
+ * \brief convert a half float to a float
+ */
+inline float half_to_float(unsigned short h)
+{
+  union {
+    unsigned int u;
+    float f;
+  } result;
+  const unsigned int sign = (unsigned int)(h & 0x8000) << 16;
+  const unsigned int exponent = (h >> 10) & 0x1f;
+  const unsigned int mantissa = h & 0x3ff;
+
+  if (exponent == 0x1f) {
+    /* infinity or NaN */
+    result.u = sign | 0x7f800000 | (mantissa << 13);
+  }
+  else if (exponent == 0) {
+    /* zero or denormal, the mantissa counts steps of 2^-24 */
+    result.f = (float)mantissa * (1.0f / 16777216.0f);
+    result.u |= sign;
+  }
+  else {
+    result.u = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  return result.f;
+}
+
+/**
+ * \brief convert a float to a half float, rounding to the nearest value
+ * \note finite values outside the range of half floats are clamped to +/-65504
+ */
+inline unsigned short float_to_half(float f)
+{
+  union {
+    unsigned int u;
+    float f;
+  } value;
+  value.f = f;
+  const unsigned short sign = (value.u >> 16) & 0x8000;
+  const unsigned int u = value.u & 0x7fffffff;
+
+  if (u >= 0x7f800000) {
+    /* infinity or NaN, keep NaN a NaN */
+    return sign | 0x7c00 | (u > 0x7f800000 ? 0x200 : 0);
+  }
+  if (u >= 0x477fe000) {
+    /* 65520 and above would round to infinity */
+    return sign | 0x7bff;
+  }
+  if (u < 0x38800000) {
+    /* denormal or zero, values below 2^-25 round to zero */
+    if (u < 0x33000000) {
+      return sign;
+    }
+    const unsigned int shift = 126 - (u >> 23);
+    const unsigned int mantissa = (u & 0x7fffff) | 0x800000;
+    const unsigned int halfway = 1u << (shift - 1);
+    const unsigned int remainder = mantissa & ((1u << shift) - 1);
+    unsigned int h = mantissa >> shift;
+    if (remainder > halfway || (remainder == halfway && (h & 1))) {
+      h++;
+    }
+    return sign | h;
+  }
+
+  /* normal, a carry of the rounding moves into the exponent */
+  unsigned int h = (u - (112 << 23)) >> 13;
+  const unsigned int remainder = u & 0x1fff;
+  if (remainder > 0x1000 || (remainder == 0x1000 && (h & 1))) {
+    h++;
+  }
+  return sign | h;
+}
+
+inline void half_to_float_vn(float *r, const unsigned short *h, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    r[i] = half_to_float(h[i]);
+  }
+}
+
+inline void float_to_half_vn(unsigned short *r, const float *f, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    r[i] = float_to_half(f[i]);
+  }
+}
+
 class MemoryProxy;
 
 /**
  * \brief a MemoryBuffer contains access to the data of a chunk
+ *
+ * The pixels are stored as floats, or as half floats when the MemoryProxy of a node tree using
+ * half float buffers allocates the buffer. Reading a half float buffer converts the pixels.
+ * Buffers read by complex operations, which access the data directly, are stored as floats,
+ * \see MemoryProxy::needsFloatBuffer
  */
 class MemoryBuffer {
  private:
@@ -85,9 +182,21 @@ class MemoryBuffer {
 
   /**
    * \brief the actual float buffer/data
+   * For half float buffers this is a copy of the data, created on first access
+   * \see getBuffer
    */
   float *m_buffer;
 
+  /**
+   * \brief the half float data, NULL when the pixels are stored as floats
+   */
+  unsigned short *m_halfBuffer;
+
+  /**
+   * \brief lock for creating the float copy of half float data
+   */
+  ThreadMutex m_floatBufferMutex;
+
   /**
    * \brief the number of channels of a single value in the buffer.
    * For value buffers this is 1, vector 3 and color 4
@@ -101,7 +210,7 @@ class MemoryBuffer {
   /**
    * \brief construct new MemoryBuffer for a chunk
    */
-  MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, rcti *rect);
+  MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, rcti *rect, bool half);
 
   /**
    * \brief construct new temporarily MemoryBuffer for an area
@@ -111,7 +220,7 @@ class MemoryBuffer {
   /**
    * \brief construct new temporarily MemoryBuffer for an area
    */
-  MemoryBuffer(DataType datatype, rcti *rect);
+  MemoryBuffer(DataType datatype, rcti *rect, bool half = false);
 
   /**
    * \brief destructor
@@ -131,13 +240,28 @@ class MemoryBuffer {
     return this->m_num_channels;
   }
 
+  /**
+   * \brief are the pixels stored as half floats
+   */
+  bool isHalf() const
+  {
+    return this->m_halfBuffer != NULL;
+  }
+
   /**
    * \brief get the data of this MemoryBuffer
    * \note buffer should already be available in memory
+   * \note a half float buffer is converted to a float copy on the first call, it must not be
+   *       written to after that. The copy is kept next to the half float data, so buffers
+   *       which are accessed this way should be stored as floats instead.
    */
   float *getBuffer()
   {
-    return this->m_buffer;
+    float *buffer = (float *)atomic_load_ptr((void *const *)&this->m_buffer);
+    if (buffer == NULL) {
+      buffer = this->createFloatBuffer();
+    }
+    return buffer;
   }
 
   /**
@@ -248,8 +372,13 @@ class MemoryBuffer {
       int v = y;
       this->wrap_pixel(u, v, extend_x, extend_y);
       const int offset = (this->m_width * y + x) * this->m_num_channels;
-      float *buffer = &this->m_buffer[offset];
-      memcpy(result, buffer, sizeof(float) * this->m_num_channels);
+      if (this->m_halfBuffer) {
+        half_to_float_vn(result, &this->m_halfBuffer[offset], this->m_num_channels);
+      }
+      else {
+        float *buffer = &this->m_buffer[offset];
+        memcpy(result, buffer, sizeof(float) * this->m_num_channels);
+      }
     }
   }
 
@@ -274,8 +403,23 @@ class MemoryBuffer {
     BLI_assert((int)(MEM_allocN_len(this->m_buffer) / sizeof(*this->m_buffer)) ==
                (int)(this->determineBufferSize() * COM_NUMBER_OF_CHANNELS));
 #endif
-    float *buffer = &this->m_buffer[offset];
-    memcpy(result, buffer, sizeof(float) * this->m_num_channels);
+    if (this->m_halfBuffer) {
+      half_to_float_vn(result, &this->m_halfBuffer[offset], this->m_num_channels);
+    }
+    else {
+      float *buffer = &this->m_buffer[offset];
+      memcpy(result, buffer, sizeof(float) * this->m_num_channels);
+    }
+  }
+
+  /**
+   * \brief get the address of the pixel at x, y
+   * \note the pixel must be inside the rect of this MemoryBuffer
+   */
+  inline float *getElem(int x, int y)
+  {
+    BLI_assert(x >= m_rect.xmin && x < m_rect.xmax && y >= m_rect.ymin && y < m_rect.ymax);
+    return &this->getBuffer()[getOffset(x, y)];
   }
 
   void writePixel(int x, int y, const float color[4]);
@@ -294,6 +438,10 @@ class MemoryBuffer {
       copy_vn_fl(result, this->m_num_channels, 0.0f);
       return;
     }
+    if (this->m_halfBuffer) {
+      this->readBilinearHalf(result, u, v, extend_x == COM_MB_REPEAT, extend_y == COM_MB_REPEAT);
+      return;
+    }
     BLI_bilinear_interpolation_wrap_fl(this->m_buffer,
                                        result,
                                        this->m_width,
@@ -324,6 +472,19 @@ class MemoryBuffer {
    */
   void copyContentFrom(MemoryBuffer *otherBuffer);
 
+  /**
+   * \brief copy an area from otherBuffer to this MemoryBuffer
+   * \param otherBuffer: source buffer, pixels outside of its rect are cleared
+   * \param area: the area to copy, must be inside the rect of this MemoryBuffer
+   */
+  void copyArea(MemoryBuffer *otherBuffer, const rcti *area);
+
+  /**
+   * \brief set all pixels of an area to the same value
+   * \param area: the area to fill, must be inside the rect of this MemoryBuffer
+   */
+  void fill(const rcti *area, const float *value);
+
   /**
    * \brief get the rect of this MemoryBuffer
    */
@@ -355,6 +516,28 @@ class MemoryBuffer {
  private:
   unsigned int determineBufferSize();
 
+  /**
+   * \brief offset of the first channel of the pixel at x, y in the data
+   */
+  inline size_t getOffset(int x, int y) const
+  {
+    return ((size_t)this->m_width * (y - m_rect.ymin) + x - m_rect.xmin) * this->m_num_channels;
+  }
+
+  void allocateBuffer(bool half);
+  float *createFloatBuffer();
+
+  /**
+   * \brief copy len channels from otherBuffer, converting between floats and half floats
+   */
+  void copyElements(size_t offset,
+                    const MemoryBuffer *otherBuffer,
+                    size_t otherOffset,
+                    size_t len);
+
+  void readHalfPixel(float *result, int x, int y);
+  void readBilinearHalf(float *result, float u, float v, bool wrap_x, bool wrap_y);
+
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryBuffer")
 #endif
@@ -23,9 +23,10 @@ MemoryProxy::MemoryProxy(DataType datatype)
   this->m_writeBufferOperation = NULL;
   this->m_executor = NULL;
   this->m_datatype = datatype;
+  this->m_needsFloatBuffer = false;
 }
 
-void MemoryProxy::allocate(unsigned int width, unsigned int height)
+void MemoryProxy::allocate(unsigned int width, unsigned int height, bool half)
 {
   rcti result;
   result.xmin = 0;
@@ -33,7 +34,7 @@ void MemoryProxy::allocate(unsigned int width, unsigned int height)
   result.ymin = 0;
   result.ymax = height;
 
-  this->m_buffer = new MemoryBuffer(this, 1, &result);
+  this->m_buffer = new MemoryBuffer(this, 1, &result, half);
 }
 
 void MemoryProxy::free()
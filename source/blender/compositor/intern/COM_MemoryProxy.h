@@ -63,6 +63,11 @@ class MemoryProxy {
    */
   DataType m_datatype;
 
+  /**
+   * \brief the buffer is read by complex operations, which access its data directly
+   */
+  bool m_needsFloatBuffer;
+
  public:
   MemoryProxy(DataType type);
 
@@ -101,10 +106,25 @@ class MemoryProxy {
     return this->m_writeBufferOperation;
   }
 
+  /**
+   * \brief store the pixels as floats, even when the node tree uses half float buffers.
+   * A float copy of half float data would be kept next to it for direct access.
+   */
+  void setNeedsFloatBuffer()
+  {
+    this->m_needsFloatBuffer = true;
+  }
+
+  bool needsFloatBuffer() const
+  {
+    return this->m_needsFloatBuffer;
+  }
+
   /**
    * \brief allocate memory of size width x height
+   * \param half: store the pixels as half floats
    */
-  void allocate(unsigned int width, unsigned int height);
+  void allocate(unsigned int width, unsigned int height, bool half);
 
   /**
    * \brief free the allocated memory
@@ -36,7 +36,10 @@ NodeOperation::NodeOperation()
   this->m_height = 0;
   this->m_isResolutionSet = false;
   this->m_openCL = false;
+  this->m_areaExecution = false;
   this->m_btree = NULL;
+  this->m_bnode = NULL;
+  this->m_bnodeOperationIndex = 0;
 }
 
 NodeOperation::~NodeOperation()
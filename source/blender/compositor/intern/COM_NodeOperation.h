@@ -42,6 +42,7 @@ using std::min;
 
 class OpenCLDevice;
 class ReadBufferOperation;
+class ResultCacheKey;
 class WriteBufferOperation;
 
 class NodeOperationInput;
@@ -105,6 +106,12 @@ class NodeOperation : public SocketReader {
    */
   bool m_openCL;
 
+  /**
+   * \brief can this operation calculate a whole area at once.
+   * \see NodeOperation.executeArea
+   */
+  bool m_areaExecution;
+
   /**
    * \brief mutex reference for very special node initializations
    * \note only use when you really know what you are doing.
@@ -126,6 +133,17 @@ class NodeOperation : public SocketReader {
    */
   bool m_isResolutionSet;
 
+  /**
+   * \brief the node this operation was created for,
+   * NULL for operations added while building the graph (buffers, conversions, constants)
+   */
+  const bNode *m_bnode;
+
+  /**
+   * \brief index of this operation among the operations created for m_bnode
+   */
+  unsigned int m_bnodeOperationIndex;
+
  public:
   virtual ~NodeOperation();
 
@@ -190,6 +208,38 @@ class NodeOperation : public SocketReader {
   {
     this->m_btree = tree;
   }
+  /**
+   * \brief set the node this operation was created for
+   * \see ResultCache
+   */
+  void setbNode(const bNode *node, unsigned int operationIndex)
+  {
+    this->m_bnode = node;
+    this->m_bnodeOperationIndex = operationIndex;
+  }
+  const bNode *getbNode() const
+  {
+    return this->m_bnode;
+  }
+  unsigned int getbNodeOperationIndex() const
+  {
+    return this->m_bnodeOperationIndex;
+  }
+
+  /**
+   * \brief add the settings the result of this operation depends on to its key in the ResultCache
+   *
+   * The settings of the node the operation was created for and the results of its inputs are
+   * already part of the key. Operations with settings that do not come from their node, or that
+   * read data from outside of the node tree (images, render results, movie clips...)
+   * must override this. Called after initExecution.
+   * \return false when the result of this operation can not be cached
+   */
+  virtual bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return true;
+  }
+
   virtual void initExecution();
 
   /**
@@ -203,6 +253,21 @@ class NodeOperation : public SocketReader {
   {
   }
 
+  /**
+   * \brief calculate the result of this operation for an area at once
+   * \ingroup execution
+   * \note only called when hasAreaExecution is set, by the AreaExecutor
+   * \param output: buffer to write the result to, containing the area
+   * \param area: the area to calculate, in the coordinates of the buffers
+   * \param inputs: the results of the input sockets, containing the area
+   * \see AreaExecutor
+   */
+  virtual void executeArea(MemoryBuffer * /*output*/,
+                           rcti * /*area*/,
+                           MemoryBuffer ** /*inputs*/)
+  {
+  }
+
   /**
    * \brief when a chunk is executed by an OpenCLDevice, this method is called
    * \ingroup execution
@@ -346,6 +411,33 @@ class NodeOperation : public SocketReader {
     return this->m_openCL;
   }
 
+  /**
+   * \brief can this NodeOperation calculate whole areas at once
+   * \see executeArea
+   */
+  bool hasAreaExecution() const
+  {
+    return this->m_areaExecution;
+  }
+
+  /**
+   * \brief should areas be calculated one operation at a time, set by the user on the node tree
+   * \see AreaExecutor
+   */
+  bool useAreaExecution() const
+  {
+    return (this->m_btree->flag & NTREE_COM_AREA_EXECUTION) != 0;
+  }
+
+  /**
+   * \brief should buffers between execution groups be stored as half floats, set by the user
+   * \see MemoryBuffer
+   */
+  bool useHalfBuffers() const
+  {
+    return (this->m_btree->flag & NTREE_COM_HALF_BUFFERS) != 0;
+  }
+
   virtual bool isViewerOperation() const
   {
     return false;
@@ -423,6 +515,14 @@ class NodeOperation : public SocketReader {
     this->m_openCL = openCL;
   }
 
+  /**
+   * \brief set if this NodeOperation implements executeArea
+   */
+  void setAreaExecution(bool areaExecution)
+  {
+    this->m_areaExecution = areaExecution;
+  }
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
@@ -0,0 +1,307 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2019, Blender Foundation.
+ */
+
+#include <list>
+#include <string.h>
+#include <typeinfo>
+
+#include "COM_ResultCache.h"
+#include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
+
+extern "C" {
+#include "DNA_color_types.h"
+#include "DNA_node_types.h"
+#include "DNA_userdef_types.h"
+}
+
+#include "MEM_guardedalloc.h"
+
+/* ******** Result Cache Key ******** */
+
+/* Mixing steps of MurmurHash64A. */
+static const uint64_t HASH_M = 0xc6a4a7935bd1e995ULL;
+static const int HASH_R = 47;
+
+static inline uint64_t hash_mix(uint64_t hash, uint64_t k)
+{
+  k *= HASH_M;
+  k ^= k >> HASH_R;
+  k *= HASH_M;
+  hash ^= k;
+  hash *= HASH_M;
+  return hash;
+}
+
+ResultCacheKey::ResultCacheKey()
+{
+  this->m_hash = 0x9ae16a3b2f90404fULL;
+}
+
+void ResultCacheKey::add(const void *data, size_t size)
+{
+  const unsigned char *bytes = (const unsigned char *)data;
+  /* Adding the size first keeps consecutive values apart. */
+  uint64_t hash = hash_mix(this->m_hash, size);
+  for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), bytes += sizeof(uint64_t)) {
+    uint64_t k;
+    memcpy(&k, bytes, sizeof(k));
+    hash = hash_mix(hash, k);
+  }
+  if (size > 0) {
+    uint64_t k = 0;
+    memcpy(&k, bytes, size);
+    hash = hash_mix(hash, k);
+  }
+  this->m_hash = hash;
+}
+
+void ResultCacheKey::addInt(int value)
+{
+  add(&value, sizeof(value));
+}
+
+void ResultCacheKey::addFloat(float value)
+{
+  add(&value, sizeof(value));
+}
+
+void ResultCacheKey::addUInt64(uint64_t value)
+{
+  add(&value, sizeof(value));
+}
+
+void ResultCacheKey::addPointer(const void *pointer)
+{
+  add(&pointer, sizeof(pointer));
+}
+
+void ResultCacheKey::addString(const char *str)
+{
+  add(str, str ? strlen(str) : 0);
+}
+
+static void result_cache_key_add_sockets(ResultCacheKey *key, const ListBase *sockets)
+{
+  for (bNodeSocket *sock = (bNodeSocket *)sockets->first; sock; sock = sock->next) {
+    if (sock->default_value) {
+      key->add(sock->default_value, MEM_allocN_len(sock->default_value));
+    }
+    else {
+      key->add(NULL, 0);
+    }
+  }
+}
+
+void ResultCacheKey::addNode(const bNode *node)
+{
+  addString(node->idname);
+  addInt(node->type);
+  addInt(node->custom1);
+  addInt(node->custom2);
+  addFloat(node->custom3);
+  addFloat(node->custom4);
+  addPointer(node->id);
+  /* Storage is plain data, curve mappings have a timestamp that changes with their points. */
+  if (node->storage) {
+    add(node->storage, MEM_allocN_len(node->storage));
+  }
+  result_cache_key_add_sockets(this, &node->inputs);
+  result_cache_key_add_sockets(this, &node->outputs);
+}
+
+/* ******** Result Cache Keys ******** */
+
+ResultCacheKeys::ResultCacheKeys(const CompositorContext &context)
+{
+  ResultCacheKey key;
+  key.addPointer(context.getScene());
+  key.addInt(context.getQuality());
+  key.addInt(context.isRendering());
+  key.addString(context.getViewName());
+  key.addInt(context.getbNodeTree()->flag & NTREE_COM_HALF_BUFFERS);
+
+  const RenderData *rd = context.getRenderData();
+  if (rd) {
+    key.add(rd, sizeof(*rd));
+  }
+
+  const ColorManagedViewSettings *viewSettings = context.getViewSettings();
+  if (viewSettings) {
+    key.addInt(viewSettings->flag);
+    key.addString(viewSettings->look);
+    key.addString(viewSettings->view_transform);
+    key.addFloat(viewSettings->exposure);
+    key.addFloat(viewSettings->gamma);
+    key.addPointer(viewSettings->curve_mapping);
+    if (viewSettings->curve_mapping) {
+      key.addInt(viewSettings->curve_mapping->changed_timestamp);
+    }
+  }
+
+  const ColorManagedDisplaySettings *displaySettings = context.getDisplaySettings();
+  if (displaySettings) {
+    key.addString(displaySettings->display_device);
+  }
+
+  this->m_contextHash = key.getHash();
+}
+
+bool ResultCacheKeys::determineKey(NodeOperation *operation, uint64_t *r_key)
+{
+  std::map<NodeOperation *, OperationKey>::const_iterator it = this->m_keys.find(operation);
+  if (it != this->m_keys.end()) {
+    *r_key = it->second.key;
+    return it->second.cacheable;
+  }
+
+  ResultCacheKey key;
+  key.addUInt64(this->m_contextHash);
+  key.addString(typeid(*operation).name());
+  key.addInt(operation->getWidth());
+  key.addInt(operation->getHeight());
+  if (operation->getNumberOfOutputSockets() > 0) {
+    key.addInt(operation->getOutputSocket()->getDataType());
+  }
+
+  const bNode *node = operation->getbNode();
+  if (node) {
+    key.addNode(node);
+    key.addInt(operation->getbNodeOperationIndex());
+  }
+
+  bool cacheable = operation->hashSettings(&key);
+
+  for (unsigned int index = 0; cacheable && index < operation->getNumberOfInputSockets();
+       index++) {
+    NodeOperationInput *input = operation->getInputSocket(index);
+    key.addInt(input->getDataType());
+    key.addInt(input->getResizeMode());
+    if (input->isConnected()) {
+      uint64_t inputKey;
+      cacheable = determineKey(&input->getLink()->getOperation(), &inputKey);
+      key.addUInt64(inputKey);
+    }
+  }
+
+  if (cacheable && operation->isReadBufferOperation()) {
+    ReadBufferOperation *readOperation = (ReadBufferOperation *)operation;
+    WriteBufferOperation *writeOperation =
+        readOperation->getMemoryProxy()->getWriteBufferOperation();
+    uint64_t writeKey;
+    cacheable = determineKey(writeOperation, &writeKey);
+    key.addUInt64(writeKey);
+    /* Precision of the buffer depends on the operations reading it. */
+    key.addInt(readOperation->getMemoryProxy()->needsFloatBuffer());
+  }
+
+  OperationKey &result = this->m_keys[operation];
+  result.key = key.getHash();
+  result.cacheable = cacheable;
+
+  *r_key = result.key;
+  return cacheable;
+}
+
+/* ******** Result Cache ******** */
+
+typedef std::map<uint64_t, MemoryBuffer *> CachedResults;
+
+static CachedResults g_results;
+/** Keys in the order they were stored or last restored, the oldest first. */
+static std::list<uint64_t> g_resultsOrder;
+static size_t g_resultsMemory = 0;
+
+static size_t result_cache_buffer_size(MemoryBuffer *buffer)
+{
+  const size_t channel_size = buffer->isHalf() ? sizeof(unsigned short) : sizeof(float);
+  return channel_size * buffer->getWidth() * buffer->getHeight() * buffer->get_num_channels();
+}
+
+static size_t result_cache_memory_limit()
+{
+  return ((size_t)U.memcachelimit) * 1024 * 1024;
+}
+
+static void result_cache_remove(uint64_t key)
+{
+  CachedResults::iterator it = g_results.find(key);
+  if (it != g_results.end()) {
+    g_resultsMemory -= result_cache_buffer_size(it->second);
+    delete it->second;
+    g_results.erase(it);
+  }
+  g_resultsOrder.remove(key);
+}
+
+bool ResultCache::restore(uint64_t key, MemoryProxy *memoryProxy)
+{
+  CachedResults::iterator it = g_results.find(key);
+  if (it == g_results.end()) {
+    return false;
+  }
+
+  MemoryBuffer *result = it->second;
+  MemoryBuffer *buffer = memoryProxy->getBuffer();
+  if (result->getWidth() != buffer->getWidth() || result->getHeight() != buffer->getHeight() ||
+      result->get_num_channels() != buffer->get_num_channels()) {
+    return false;
+  }
+
+  buffer->copyContentFrom(result);
+
+  g_resultsOrder.remove(key);
+  g_resultsOrder.push_back(key);
+  return true;
+}
+
+void ResultCache::store(uint64_t key, MemoryProxy *memoryProxy)
+{
+  if (g_results.find(key) != g_results.end()) {
+    return;
+  }
+
+  MemoryBuffer *buffer = memoryProxy->getBuffer();
+  const size_t size = result_cache_buffer_size(buffer);
+  const size_t limit = result_cache_memory_limit();
+  if (size > limit) {
+    return;
+  }
+
+  while (!g_resultsOrder.empty() && g_resultsMemory + size > limit) {
+    result_cache_remove(g_resultsOrder.front());
+  }
+
+  MemoryBuffer *result = new MemoryBuffer(
+      memoryProxy->getDataType(), buffer->getRect(), buffer->isHalf());
+  result->copyContentFrom(buffer);
+
+  g_results[key] = result;
+  g_resultsOrder.push_back(key);
+  g_resultsMemory += size;
+}
+
+void ResultCache::free()
+{
+  for (CachedResults::iterator it = g_results.begin(); it != g_results.end(); ++it) {
+    delete it->second;
+  }
+  g_results.clear();
+  g_resultsOrder.clear();
+  g_resultsMemory = 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2019, Blender Foundation.
+ */
+
+#ifndef __COM_RESULTCACHE_H__
+#define __COM_RESULTCACHE_H__
+
+#include <map>
+
+#include "BLI_sys_types.h"
+
+#include "COM_CompositorContext.h"
+#include "COM_NodeOperation.h"
+
+/**
+ * \brief 64 bit hash of everything the result of an operation depends on
+ * \see NodeOperation.hashSettings
+ * \ingroup Execution
+ */
+class ResultCacheKey {
+ private:
+  uint64_t m_hash;
+
+ public:
+  ResultCacheKey();
+
+  void add(const void *data, size_t size);
+  void addInt(int value);
+  void addFloat(float value);
+  void addUInt64(uint64_t value);
+  void addPointer(const void *pointer);
+  void addString(const char *str);
+
+  /**
+   * \brief add the type, settings and socket values of a node
+   */
+  void addNode(const bNode *node);
+
+  uint64_t getHash() const
+  {
+    return this->m_hash;
+  }
+};
+
+/**
+ * \brief determines the keys of the operations of a single execution
+ *
+ * The key of an operation combines the state of the CompositorContext, the settings of the
+ * operation and the keys of the operations connected to its inputs. A ReadBufferOperation uses
+ * the key of the WriteBufferOperation it reads from, so keys cover the whole graph upstream.
+ * \ingroup Execution
+ */
+class ResultCacheKeys {
+ private:
+  struct OperationKey {
+    uint64_t key;
+    bool cacheable;
+  };
+
+  /**
+   * \brief hash of the state of the CompositorContext
+   */
+  uint64_t m_contextHash;
+
+  std::map<NodeOperation *, OperationKey> m_keys;
+
+ public:
+  ResultCacheKeys(const CompositorContext &context);
+
+  /**
+   * \brief determine the key of the result of an operation
+   * \note must be called after the operations are initialized
+   * \return false when the operation or one of its inputs can not be cached
+   */
+  bool determineKey(NodeOperation *operation, uint64_t *r_key);
+};
+
+/**
+ * \brief keeps the results of WriteBufferOperations between executions
+ *
+ * When the settings and inputs of the operations of an ExecutionGroup did not change, the
+ * buffer it calculated in an earlier execution is restored, and the group and all groups it
+ * depends on are not executed. The memory used by the results is limited by the memory cache
+ * limit in the preferences, the oldest results are removed first.
+ *
+ * \note only accessed while holding the compositor mutex
+ * \see ExecutionSystem.execute
+ * \ingroup Execution
+ */
+class ResultCache {
+ public:
+  /**
+   * \brief copy a result into the buffer of a MemoryProxy
+   * \return false when no result with this key and resolution is stored
+   */
+  static bool restore(uint64_t key, MemoryProxy *memoryProxy);
+
+  /**
+   * \brief store a copy of the buffer of a MemoryProxy
+   */
+  static void store(uint64_t key, MemoryProxy *memoryProxy);
+
+  /**
+   * \brief free all results
+   */
+  static void free();
+};
+
+#endif
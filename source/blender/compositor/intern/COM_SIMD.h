@@ -0,0 +1,283 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2019, Blender Foundation.
+ */
+
+#ifndef __COM_SIMD_H__
+#define __COM_SIMD_H__
+
+#include <math.h>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+/**
+ * \brief the four channels of a color pixel in a single SSE register
+ *
+ * Row kernels of area execution handle a whole pixel per operation, compilers without SSE2
+ * get the same functions on plain floats. The functions do the same float operations in the
+ * same order as per channel code, so both give the same results.
+ * \ingroup Execution
+ */
+struct Float4 {
+#ifdef __SSE2__
+  __m128 m;
+#else
+  float f[4];
+#endif
+};
+
+#ifdef __SSE2__
+
+inline Float4 float4_make(__m128 m)
+{
+  Float4 result;
+  result.m = m;
+  return result;
+}
+
+inline Float4 float4_load(const float *p)
+{
+  return float4_make(_mm_loadu_ps(p));
+}
+
+inline void float4_store(float *p, Float4 a)
+{
+  _mm_storeu_ps(p, a.m);
+}
+
+inline Float4 float4_set(float r, float g, float b, float a)
+{
+  return float4_make(_mm_setr_ps(r, g, b, a));
+}
+
+inline Float4 float4_set1(float f)
+{
+  return float4_make(_mm_set1_ps(f));
+}
+
+inline Float4 operator+(Float4 a, Float4 b)
+{
+  return float4_make(_mm_add_ps(a.m, b.m));
+}
+
+inline Float4 operator-(Float4 a, Float4 b)
+{
+  return float4_make(_mm_sub_ps(a.m, b.m));
+}
+
+inline Float4 operator*(Float4 a, Float4 b)
+{
+  return float4_make(_mm_mul_ps(a.m, b.m));
+}
+
+inline Float4 operator/(Float4 a, Float4 b)
+{
+  return float4_make(_mm_div_ps(a.m, b.m));
+}
+
+/** Per channel (a < b) ? a : b, like min_ff. */
+inline Float4 float4_min(Float4 a, Float4 b)
+{
+  return float4_make(_mm_min_ps(a.m, b.m));
+}
+
+/** Per channel (a > b) ? a : b, like max_ff. */
+inline Float4 float4_max(Float4 a, Float4 b)
+{
+  return float4_make(_mm_max_ps(a.m, b.m));
+}
+
+inline Float4 float4_abs(Float4 a)
+{
+  return float4_make(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.m));
+}
+
+/* Comparisons return a mask for float4_select. */
+
+inline Float4 float4_lt(Float4 a, Float4 b)
+{
+  return float4_make(_mm_cmplt_ps(a.m, b.m));
+}
+
+inline Float4 float4_le(Float4 a, Float4 b)
+{
+  return float4_make(_mm_cmple_ps(a.m, b.m));
+}
+
+inline Float4 float4_gt(Float4 a, Float4 b)
+{
+  return float4_make(_mm_cmpgt_ps(a.m, b.m));
+}
+
+inline Float4 float4_neq(Float4 a, Float4 b)
+{
+  return float4_make(_mm_cmpneq_ps(a.m, b.m));
+}
+
+/** Per channel mask ? a : b. */
+inline Float4 float4_select(Float4 mask, Float4 a, Float4 b)
+{
+  return float4_make(_mm_or_ps(_mm_and_ps(mask.m, a.m), _mm_andnot_ps(mask.m, b.m)));
+}
+
+/** Mask of the channels that are true, the flags are indexed by channel. */
+inline Float4 float4_mask(bool r, bool g, bool b, bool a)
+{
+  return float4_make(_mm_castsi128_ps(_mm_set_epi32(-(int)a, -(int)b, -(int)g, -(int)r)));
+}
+
+/** All channels set to channel i of a. */
+template<int i> inline Float4 float4_broadcast(Float4 a)
+{
+  return float4_make(_mm_shuffle_ps(a.m, a.m, _MM_SHUFFLE(i, i, i, i)));
+}
+
+#else /* __SSE2__ */
+
+inline Float4 float4_load(const float *p)
+{
+  Float4 result = {{p[0], p[1], p[2], p[3]}};
+  return result;
+}
+
+inline void float4_store(float *p, Float4 a)
+{
+  p[0] = a.f[0];
+  p[1] = a.f[1];
+  p[2] = a.f[2];
+  p[3] = a.f[3];
+}
+
+inline Float4 float4_set(float r, float g, float b, float a)
+{
+  Float4 result = {{r, g, b, a}};
+  return result;
+}
+
+inline Float4 float4_set1(float f)
+{
+  Float4 result = {{f, f, f, f}};
+  return result;
+}
+
+#  define FLOAT4_CHANNELS(expr) \
+    Float4 result; \
+    for (int i = 0; i < 4; i++) { \
+      result.f[i] = (expr); \
+    } \
+    return result
+
+inline Float4 operator+(Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(a.f[i] + b.f[i]);
+}
+
+inline Float4 operator-(Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(a.f[i] - b.f[i]);
+}
+
+inline Float4 operator*(Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(a.f[i] * b.f[i]);
+}
+
+inline Float4 operator/(Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(a.f[i] / b.f[i]);
+}
+
+inline Float4 float4_min(Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(a.f[i] < b.f[i] ? a.f[i] : b.f[i]);
+}
+
+inline Float4 float4_max(Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(a.f[i] > b.f[i] ? a.f[i] : b.f[i]);
+}
+
+inline Float4 float4_abs(Float4 a)
+{
+  FLOAT4_CHANNELS(fabsf(a.f[i]));
+}
+
+/* Masks use 1.0f for true channels, float4_select is the only function reading them. */
+
+inline Float4 float4_lt(Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(a.f[i] < b.f[i] ? 1.0f : 0.0f);
+}
+
+inline Float4 float4_le(Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(a.f[i] <= b.f[i] ? 1.0f : 0.0f);
+}
+
+inline Float4 float4_gt(Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(a.f[i] > b.f[i] ? 1.0f : 0.0f);
+}
+
+inline Float4 float4_neq(Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(a.f[i] != b.f[i] ? 1.0f : 0.0f);
+}
+
+inline Float4 float4_select(Float4 mask, Float4 a, Float4 b)
+{
+  FLOAT4_CHANNELS(mask.f[i] != 0.0f ? a.f[i] : b.f[i]);
+}
+
+inline Float4 float4_mask(bool r, bool g, bool b, bool a)
+{
+  Float4 result = {{r ? 1.0f : 0.0f, g ? 1.0f : 0.0f, b ? 1.0f : 0.0f, a ? 1.0f : 0.0f}};
+  return result;
+}
+
+template<int i> inline Float4 float4_broadcast(Float4 a)
+{
+  return float4_set1(a.f[i]);
+}
+
+#  undef FLOAT4_CHANNELS
+
+#endif /* __SSE2__ */
+
+/** All channels set to the alpha of a. */
+inline Float4 float4_alpha(Float4 a)
+{
+  return float4_broadcast<3>(a);
+}
+
+/** The color channels of rgb with the alpha of a. */
+inline Float4 float4_with_alpha(Float4 rgb, Float4 a)
+{
+  return float4_select(float4_mask(false, false, false, true), a, rgb);
+}
+
+/** Clamp the channels to 0..1 like CLAMP, keeping NaN. */
+inline Float4 float4_clamp01(Float4 a)
+{
+  const Float4 zero = float4_set1(0.0f);
+  const Float4 one = float4_set1(1.0f);
+  a = float4_select(float4_lt(a, zero), zero, a);
+  return float4_select(float4_gt(a, one), one, a);
+}
+
+#endif
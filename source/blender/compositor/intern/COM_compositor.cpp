@@ -27,6 +27,7 @@ extern "C" {
 
 #include "COM_compositor.h"
 #include "COM_ExecutionSystem.h"
+#include "COM_ResultCache.h"
 #include "COM_WorkScheduler.h"
 #include "clew.h"
 #include "COM_MovieDistortionOperation.h"
@@ -86,6 +87,11 @@ void COM_execute(RenderData *rd,
   editingtree->progress(editingtree->prh, 0.0);
   editingtree->stats_draw(editingtree->sdh, IFACE_("Compositing"));
 
+  /* results of earlier executions are only kept while the node tree uses them */
+  if (!(editingtree->flag & NTREE_COM_RESULT_CACHE)) {
+    ResultCache::free();
+  }
+
   bool twopass = (editingtree->flag & NTREE_TWO_PASS) && !rendering;
   /* initialize execution system */
   if (twopass) {
@@ -115,6 +121,7 @@ void COM_deinitialize()
   if (is_compositorMutex_init) {
     BLI_mutex_lock(&s_compositorMutex);
     WorkScheduler::deinitialize();
+    ResultCache::free();
     is_compositorMutex_init = false;
     BLI_mutex_unlock(&s_compositorMutex);
     BLI_mutex_end(&s_compositorMutex);
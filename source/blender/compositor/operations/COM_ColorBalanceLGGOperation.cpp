@@ -44,6 +44,7 @@ ColorBalanceLGGOperation::ColorBalanceLGGOperation() : NodeOperation()
   this->m_inputValueOperation = NULL;
   this->m_inputColorOperation = NULL;
   this->setResolutionInputSocketIndex(1);
+  this->setAreaExecution(true);
 }
 
 void ColorBalanceLGGOperation::initExecution()
@@ -62,7 +63,28 @@ void ColorBalanceLGGOperation::executePixelSampled(float output[4],
 
   this->m_inputValueOperation->readSampled(value, x, y, sampler);
   this->m_inputColorOperation->readSampled(inputColor, x, y, sampler);
+  balancePixel(output, value, inputColor);
+}
+
+void ColorBalanceLGGOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = output->getElem(area->xmin, y);
+    const float *value = inputs[0]->getElem(area->xmin, y);
+    const float *color = inputs[1]->getElem(area->xmin, y);
+    for (int x = area->xmin; x < area->xmax; x++) {
+      balancePixel(out, value, color);
+      out += COM_NUM_CHANNELS_COLOR;
+      value += COM_NUM_CHANNELS_VALUE;
+      color += COM_NUM_CHANNELS_COLOR;
+    }
+  }
+}
 
+void ColorBalanceLGGOperation::balancePixel(float output[4],
+                                            const float *value,
+                                            const float inputColor[4])
+{
   float fac = value[0];
   fac = min(1.0f, fac);
   const float mfac = 1.0f - fac;
@@ -36,6 +36,8 @@ class ColorBalanceLGGOperation : public NodeOperation {
   float m_lift[3];
   float m_gamma_inv[3];
 
+  void balancePixel(float output[4], const float *value, const float inputColor[4]);
+
  public:
   /**
    * Default constructor
@@ -46,6 +48,7 @@ class ColorBalanceLGGOperation : public NodeOperation {
    * the inner loop of this program
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
 
   /**
    * Initialize the execution
@@ -33,6 +33,7 @@ ColorCorrectionOperation::ColorCorrectionOperation() : NodeOperation()
   this->m_redChannelEnabled = true;
   this->m_greenChannelEnabled = true;
   this->m_blueChannelEnabled = true;
+  this->setAreaExecution(true);
 }
 void ColorCorrectionOperation::initExecution()
 {
@@ -49,7 +50,28 @@ void ColorCorrectionOperation::executePixelSampled(float output[4],
   float inputMask[4];
   this->m_inputImage->readSampled(inputImageColor, x, y, sampler);
   this->m_inputMask->readSampled(inputMask, x, y, sampler);
+  correctPixel(output, inputImageColor, inputMask);
+}
+
+void ColorCorrectionOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = output->getElem(area->xmin, y);
+    const float *color = inputs[0]->getElem(area->xmin, y);
+    const float *mask = inputs[1]->getElem(area->xmin, y);
+    for (int x = area->xmin; x < area->xmax; x++) {
+      correctPixel(out, color, mask);
+      out += COM_NUM_CHANNELS_COLOR;
+      color += COM_NUM_CHANNELS_COLOR;
+      mask += COM_NUM_CHANNELS_VALUE;
+    }
+  }
+}
 
+void ColorCorrectionOperation::correctPixel(float output[4],
+                                            const float inputImageColor[4],
+                                            const float *inputMask)
+{
   float level = (inputImageColor[0] + inputImageColor[1] + inputImageColor[2]) / 3.0f;
   float contrast = this->m_data->master.contrast;
   float saturation = this->m_data->master.saturation;
@@ -33,6 +33,8 @@ class ColorCorrectionOperation : public NodeOperation {
   bool m_greenChannelEnabled;
   bool m_blueChannelEnabled;
 
+  void correctPixel(float output[4], const float inputImageColor[4], const float *inputMask);
+
  public:
   ColorCorrectionOperation();
 
@@ -40,6 +42,7 @@ class ColorCorrectionOperation : public NodeOperation {
    * the inner loop of this program
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
 
   /**
    * Initialize the execution
@@ -17,6 +17,7 @@
  */
 
 #include "COM_CompositorOperation.h"
+#include "COM_AreaExecutor.h"
 #include "BLI_listbase.h"
 #include "BKE_global.h"
 #include "BKE_image.h"
@@ -192,6 +193,42 @@ void CompositorOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
   }
 #endif
 
+  NodeOperation *imageOperation = this->getInputOperation(0);
+  NodeOperation *alphaOperation = this->getInputOperation(1);
+  NodeOperation *depthOperation = this->getInputOperation(2);
+
+  if (this->useAreaExecution() && imageOperation && alphaOperation && depthOperation) {
+    /* Calculate the inputs one operation at a time, results they share are calculated once. */
+    AreaExecutor executor(rect);
+    executor.addOutput(imageOperation);
+    if (this->m_useAlphaInput) {
+      executor.addOutput(alphaOperation);
+    }
+    executor.addOutput(depthOperation);
+
+    MemoryBuffer *image = executor.calculate(imageOperation);
+    MemoryBuffer *alpha = (this->m_useAlphaInput) ? executor.calculate(alphaOperation) : NULL;
+    MemoryBuffer *depth = executor.calculate(depthOperation);
+
+    for (y = y1; y < y2 && (!breaked); y++) {
+      for (x = x1; x < x2; x++) {
+        copy_v4_v4(buffer + offset4, image->getElem(x, y));
+        if (alpha) {
+          buffer[offset4 + 3] = *alpha->getElem(x, y);
+        }
+        zbuffer[offset] = *depth->getElem(x, y);
+        offset4 += COM_NUM_CHANNELS_COLOR;
+        offset++;
+      }
+      if (isBraked()) {
+        breaked = true;
+      }
+      offset += add;
+      offset4 += add * COM_NUM_CHANNELS_COLOR;
+    }
+    return;
+  }
+
   for (y = y1; y < y2 && (!breaked); y++) {
     for (x = x1; x < x2 && (!breaked); x++) {
       int input_x = x + dx, input_y = y + dy;
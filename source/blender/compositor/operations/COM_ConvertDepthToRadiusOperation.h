@@ -80,5 +80,11 @@ class ConvertDepthToRadiusOperation : public NodeOperation {
   {
     this->m_blurPostOperation = operation;
   }
+
+  /* not cached, the lens settings are read from the camera object */
+  bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return false;
+  }
 };
 #endif
@@ -43,6 +43,7 @@ ConvertValueToColorOperation::ConvertValueToColorOperation() : ConvertBaseOperat
 {
   this->addInputSocket(COM_DT_VALUE);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertValueToColorOperation::executePixelSampled(float output[4],
@@ -50,9 +51,19 @@ void ConvertValueToColorOperation::executePixelSampled(float output[4],
                                                        float y,
                                                        PixelSampler sampler)
 {
-  float value;
-  this->m_inputOperation->readSampled(&value, x, y, sampler);
-  output[0] = output[1] = output[2] = value;
+  convertPixelSampled<ConvertValueToColorOperation>(output, x, y, sampler);
+}
+
+void ConvertValueToColorOperation::executeArea(MemoryBuffer *output,
+                                               rcti *area,
+                                               MemoryBuffer **inputs)
+{
+  convertArea<ConvertValueToColorOperation>(output, area, inputs);
+}
+
+void ConvertValueToColorOperation::convertPixel(float output[4], const float input[4])
+{
+  output[0] = output[1] = output[2] = input[0];
   output[3] = 1.0f;
 }
 
@@ -62,6 +73,7 @@ ConvertColorToValueOperation::ConvertColorToValueOperation() : ConvertBaseOperat
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_VALUE);
+  this->setAreaExecution(true);
 }
 
 void ConvertColorToValueOperation::executePixelSampled(float output[4],
@@ -69,9 +81,19 @@ void ConvertColorToValueOperation::executePixelSampled(float output[4],
                                                        float y,
                                                        PixelSampler sampler)
 {
-  float inputColor[4];
-  this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-  output[0] = (inputColor[0] + inputColor[1] + inputColor[2]) / 3.0f;
+  convertPixelSampled<ConvertColorToValueOperation>(output, x, y, sampler);
+}
+
+void ConvertColorToValueOperation::executeArea(MemoryBuffer *output,
+                                               rcti *area,
+                                               MemoryBuffer **inputs)
+{
+  convertArea<ConvertColorToValueOperation>(output, area, inputs);
+}
+
+void ConvertColorToValueOperation::convertPixel(float output[4], const float input[4])
+{
+  output[0] = (input[0] + input[1] + input[2]) / 3.0f;
 }
 
 /* ******** Color to BW ******** */
@@ -80,6 +102,7 @@ ConvertColorToBWOperation::ConvertColorToBWOperation() : ConvertBaseOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_VALUE);
+  this->setAreaExecution(true);
 }
 
 void ConvertColorToBWOperation::executePixelSampled(float output[4],
@@ -87,9 +110,19 @@ void ConvertColorToBWOperation::executePixelSampled(float output[4],
                                                     float y,
                                                     PixelSampler sampler)
 {
-  float inputColor[4];
-  this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-  output[0] = IMB_colormanagement_get_luminance(inputColor);
+  convertPixelSampled<ConvertColorToBWOperation>(output, x, y, sampler);
+}
+
+void ConvertColorToBWOperation::executeArea(MemoryBuffer *output,
+                                            rcti *area,
+                                            MemoryBuffer **inputs)
+{
+  convertArea<ConvertColorToBWOperation>(output, area, inputs);
+}
+
+void ConvertColorToBWOperation::convertPixel(float output[4], const float input[4])
+{
+  output[0] = IMB_colormanagement_get_luminance(input);
 }
 
 /* ******** Color to Vector ******** */
@@ -98,6 +131,7 @@ ConvertColorToVectorOperation::ConvertColorToVectorOperation() : ConvertBaseOper
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_VECTOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertColorToVectorOperation::executePixelSampled(float output[4],
@@ -105,9 +139,19 @@ void ConvertColorToVectorOperation::executePixelSampled(float output[4],
                                                         float y,
                                                         PixelSampler sampler)
 {
-  float color[4];
-  this->m_inputOperation->readSampled(color, x, y, sampler);
-  copy_v3_v3(output, color);
+  convertPixelSampled<ConvertColorToVectorOperation>(output, x, y, sampler);
+}
+
+void ConvertColorToVectorOperation::executeArea(MemoryBuffer *output,
+                                                rcti *area,
+                                                MemoryBuffer **inputs)
+{
+  convertArea<ConvertColorToVectorOperation>(output, area, inputs);
+}
+
+void ConvertColorToVectorOperation::convertPixel(float output[4], const float input[4])
+{
+  copy_v3_v3(output, input);
 }
 
 /* ******** Value to Vector ******** */
@@ -116,6 +160,7 @@ ConvertValueToVectorOperation::ConvertValueToVectorOperation() : ConvertBaseOper
 {
   this->addInputSocket(COM_DT_VALUE);
   this->addOutputSocket(COM_DT_VECTOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertValueToVectorOperation::executePixelSampled(float output[4],
@@ -123,9 +168,19 @@ void ConvertValueToVectorOperation::executePixelSampled(float output[4],
                                                         float y,
                                                         PixelSampler sampler)
 {
-  float value;
-  this->m_inputOperation->readSampled(&value, x, y, sampler);
-  output[0] = output[1] = output[2] = value;
+  convertPixelSampled<ConvertValueToVectorOperation>(output, x, y, sampler);
+}
+
+void ConvertValueToVectorOperation::executeArea(MemoryBuffer *output,
+                                                rcti *area,
+                                                MemoryBuffer **inputs)
+{
+  convertArea<ConvertValueToVectorOperation>(output, area, inputs);
+}
+
+void ConvertValueToVectorOperation::convertPixel(float output[4], const float input[4])
+{
+  output[0] = output[1] = output[2] = input[0];
 }
 
 /* ******** Vector to Color ******** */
@@ -134,6 +189,7 @@ ConvertVectorToColorOperation::ConvertVectorToColorOperation() : ConvertBaseOper
 {
   this->addInputSocket(COM_DT_VECTOR);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertVectorToColorOperation::executePixelSampled(float output[4],
@@ -141,7 +197,19 @@ void ConvertVectorToColorOperation::executePixelSampled(float output[4],
                                                         float y,
                                                         PixelSampler sampler)
 {
-  this->m_inputOperation->readSampled(output, x, y, sampler);
+  convertPixelSampled<ConvertVectorToColorOperation>(output, x, y, sampler);
+}
+
+void ConvertVectorToColorOperation::executeArea(MemoryBuffer *output,
+                                                rcti *area,
+                                                MemoryBuffer **inputs)
+{
+  convertArea<ConvertVectorToColorOperation>(output, area, inputs);
+}
+
+void ConvertVectorToColorOperation::convertPixel(float output[4], const float input[4])
+{
+  copy_v3_v3(output, input);
   output[3] = 1.0f;
 }
 
@@ -151,6 +219,7 @@ ConvertVectorToValueOperation::ConvertVectorToValueOperation() : ConvertBaseOper
 {
   this->addInputSocket(COM_DT_VECTOR);
   this->addOutputSocket(COM_DT_VALUE);
+  this->setAreaExecution(true);
 }
 
 void ConvertVectorToValueOperation::executePixelSampled(float output[4],
@@ -158,8 +227,18 @@ void ConvertVectorToValueOperation::executePixelSampled(float output[4],
                                                         float y,
                                                         PixelSampler sampler)
 {
-  float input[4];
-  this->m_inputOperation->readSampled(input, x, y, sampler);
+  convertPixelSampled<ConvertVectorToValueOperation>(output, x, y, sampler);
+}
+
+void ConvertVectorToValueOperation::executeArea(MemoryBuffer *output,
+                                                rcti *area,
+                                                MemoryBuffer **inputs)
+{
+  convertArea<ConvertVectorToValueOperation>(output, area, inputs);
+}
+
+void ConvertVectorToValueOperation::convertPixel(float output[4], const float input[4])
+{
   output[0] = (input[0] + input[1] + input[2]) / 3.0f;
 }
 
@@ -169,6 +248,7 @@ ConvertRGBToYCCOperation::ConvertRGBToYCCOperation() : ConvertBaseOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertRGBToYCCOperation::setMode(int mode)
@@ -192,17 +272,24 @@ void ConvertRGBToYCCOperation::executePixelSampled(float output[4],
                                                    float y,
                                                    PixelSampler sampler)
 {
-  float inputColor[4];
+  convertPixelSampled<ConvertRGBToYCCOperation>(output, x, y, sampler);
+}
+
+void ConvertRGBToYCCOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  convertArea<ConvertRGBToYCCOperation>(output, area, inputs);
+}
+
+void ConvertRGBToYCCOperation::convertPixel(float output[4], const float input[4])
+{
   float color[3];
 
-  this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-  rgb_to_ycc(
-      inputColor[0], inputColor[1], inputColor[2], &color[0], &color[1], &color[2], this->m_mode);
+  rgb_to_ycc(input[0], input[1], input[2], &color[0], &color[1], &color[2], this->m_mode);
 
   /* divided by 255 to normalize for viewing in */
   /* R,G,B --> Y,Cb,Cr */
   mul_v3_v3fl(output, color, 1.0f / 255.0f);
-  output[3] = inputColor[3];
+  output[3] = input[3];
 }
 
 /* ******** YCC to RGB ******** */
@@ -211,6 +298,7 @@ ConvertYCCToRGBOperation::ConvertYCCToRGBOperation() : ConvertBaseOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertYCCToRGBOperation::setMode(int mode)
@@ -234,21 +322,24 @@ void ConvertYCCToRGBOperation::executePixelSampled(float output[4],
                                                    float y,
                                                    PixelSampler sampler)
 {
-  float inputColor[4];
-  this->m_inputOperation->readSampled(inputColor, x, y, sampler);
+  convertPixelSampled<ConvertYCCToRGBOperation>(output, x, y, sampler);
+}
+
+void ConvertYCCToRGBOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  convertArea<ConvertYCCToRGBOperation>(output, area, inputs);
+}
+
+void ConvertYCCToRGBOperation::convertPixel(float output[4], const float input[4])
+{
+  float color[3];
 
   /* need to un-normalize the data */
   /* R,G,B --> Y,Cb,Cr */
-  mul_v3_fl(inputColor, 255.0f);
+  mul_v3_v3fl(color, input, 255.0f);
 
-  ycc_to_rgb(inputColor[0],
-             inputColor[1],
-             inputColor[2],
-             &output[0],
-             &output[1],
-             &output[2],
-             this->m_mode);
-  output[3] = inputColor[3];
+  ycc_to_rgb(color[0], color[1], color[2], &output[0], &output[1], &output[2], this->m_mode);
+  output[3] = input[3];
 }
 
 /* ******** RGB to YUV ******** */
@@ -257,6 +348,7 @@ ConvertRGBToYUVOperation::ConvertRGBToYUVOperation() : ConvertBaseOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertRGBToYUVOperation::executePixelSampled(float output[4],
@@ -264,16 +356,26 @@ void ConvertRGBToYUVOperation::executePixelSampled(float output[4],
                                                    float y,
                                                    PixelSampler sampler)
 {
-  float inputColor[4];
-  this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-  rgb_to_yuv(inputColor[0],
-             inputColor[1],
-             inputColor[2],
-             &output[0],
-             &output[1],
-             &output[2],
-             BLI_YUV_ITU_BT709);
-  output[3] = inputColor[3];
+  convertPixelSampled<ConvertRGBToYUVOperation>(output, x, y, sampler);
+}
+
+void ConvertRGBToYUVOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  convertAreaFloat4<ConvertRGBToYUVOperation>(output, area, inputs);
+}
+
+void ConvertRGBToYUVOperation::convertPixel(float output[4], const float input[4])
+{
+  rgb_to_yuv(input[0], input[1], input[2], &output[0], &output[1], &output[2], BLI_YUV_ITU_BT709);
+  output[3] = input[3];
+}
+
+Float4 ConvertRGBToYUVOperation::convertFloat4(Float4 input)
+{
+  /* rgb_to_yuv with BLI_YUV_ITU_BT709, by columns of the matrix */
+  return float4_set(0.2126f, -0.09991f, 0.615f, 0.0f) * float4_broadcast<0>(input) +
+         float4_set(0.7152f, -0.33609f, -0.55861f, 0.0f) * float4_broadcast<1>(input) +
+         float4_set(0.0722f, 0.436f, -0.05639f, 0.0f) * float4_broadcast<2>(input);
 }
 
 /* ******** YUV to RGB ******** */
@@ -282,6 +384,7 @@ ConvertYUVToRGBOperation::ConvertYUVToRGBOperation() : ConvertBaseOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertYUVToRGBOperation::executePixelSampled(float output[4],
@@ -289,16 +392,30 @@ void ConvertYUVToRGBOperation::executePixelSampled(float output[4],
                                                    float y,
                                                    PixelSampler sampler)
 {
-  float inputColor[4];
-  this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-  yuv_to_rgb(inputColor[0],
-             inputColor[1],
-             inputColor[2],
-             &output[0],
-             &output[1],
-             &output[2],
-             BLI_YUV_ITU_BT709);
-  output[3] = inputColor[3];
+  convertPixelSampled<ConvertYUVToRGBOperation>(output, x, y, sampler);
+}
+
+void ConvertYUVToRGBOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  convertAreaFloat4<ConvertYUVToRGBOperation>(output, area, inputs);
+}
+
+void ConvertYUVToRGBOperation::convertPixel(float output[4], const float input[4])
+{
+  yuv_to_rgb(input[0], input[1], input[2], &output[0], &output[1], &output[2], BLI_YUV_ITU_BT709);
+  output[3] = input[3];
+}
+
+Float4 ConvertYUVToRGBOperation::convertFloat4(Float4 input)
+{
+  /* yuv_to_rgb with BLI_YUV_ITU_BT709, by columns of the matrix. Channels with a zero in the
+   * matrix skip the term, multiplying an infinite U or V by zero would give NaN. */
+  const Float4 zero = float4_set1(0.0f);
+  const Float4 u = float4_set(0.0f, -0.21482f, 2.12798f, 0.0f) * float4_broadcast<1>(input);
+  const Float4 v = float4_set(1.28033f, -0.38059f, 0.0f, 0.0f) * float4_broadcast<2>(input);
+  return float4_broadcast<0>(input) +
+         float4_select(float4_mask(false, true, true, false), u, zero) +
+         float4_select(float4_mask(true, true, false, false), v, zero);
 }
 
 /* ******** RGB to HSV ******** */
@@ -307,6 +424,7 @@ ConvertRGBToHSVOperation::ConvertRGBToHSVOperation() : ConvertBaseOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertRGBToHSVOperation::executePixelSampled(float output[4],
@@ -314,10 +432,18 @@ void ConvertRGBToHSVOperation::executePixelSampled(float output[4],
                                                    float y,
                                                    PixelSampler sampler)
 {
-  float inputColor[4];
-  this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-  rgb_to_hsv_v(inputColor, output);
-  output[3] = inputColor[3];
+  convertPixelSampled<ConvertRGBToHSVOperation>(output, x, y, sampler);
+}
+
+void ConvertRGBToHSVOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  convertArea<ConvertRGBToHSVOperation>(output, area, inputs);
+}
+
+void ConvertRGBToHSVOperation::convertPixel(float output[4], const float input[4])
+{
+  rgb_to_hsv_v(input, output);
+  output[3] = input[3];
 }
 
 /* ******** HSV to RGB ******** */
@@ -326,6 +452,7 @@ ConvertHSVToRGBOperation::ConvertHSVToRGBOperation() : ConvertBaseOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertHSVToRGBOperation::executePixelSampled(float output[4],
@@ -333,13 +460,21 @@ void ConvertHSVToRGBOperation::executePixelSampled(float output[4],
                                                    float y,
                                                    PixelSampler sampler)
 {
-  float inputColor[4];
-  this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-  hsv_to_rgb_v(inputColor, output);
+  convertPixelSampled<ConvertHSVToRGBOperation>(output, x, y, sampler);
+}
+
+void ConvertHSVToRGBOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  convertArea<ConvertHSVToRGBOperation>(output, area, inputs);
+}
+
+void ConvertHSVToRGBOperation::convertPixel(float output[4], const float input[4])
+{
+  hsv_to_rgb_v(input, output);
   output[0] = max_ff(output[0], 0.0f);
   output[1] = max_ff(output[1], 0.0f);
   output[2] = max_ff(output[2], 0.0f);
-  output[3] = inputColor[3];
+  output[3] = input[3];
 }
 
 /* ******** Premul to Straight ******** */
@@ -348,6 +483,7 @@ ConvertPremulToStraightOperation::ConvertPremulToStraightOperation() : ConvertBa
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertPremulToStraightOperation::executePixelSampled(float output[4],
@@ -355,29 +491,46 @@ void ConvertPremulToStraightOperation::executePixelSampled(float output[4],
                                                            float y,
                                                            PixelSampler sampler)
 {
-  float inputValue[4];
-  float alpha;
+  convertPixelSampled<ConvertPremulToStraightOperation>(output, x, y, sampler);
+}
+
+void ConvertPremulToStraightOperation::executeArea(MemoryBuffer *output,
+                                                   rcti *area,
+                                                   MemoryBuffer **inputs)
+{
+  convertAreaFloat4<ConvertPremulToStraightOperation>(output, area, inputs);
+}
 
-  this->m_inputOperation->readSampled(inputValue, x, y, sampler);
-  alpha = inputValue[3];
+void ConvertPremulToStraightOperation::convertPixel(float output[4], const float input[4])
+{
+  const float alpha = input[3];
 
   if (fabsf(alpha) < 1e-5f) {
     zero_v3(output);
   }
   else {
-    mul_v3_v3fl(output, inputValue, 1.0f / alpha);
+    mul_v3_v3fl(output, input, 1.0f / alpha);
   }
 
   /* never touches the alpha */
   output[3] = alpha;
 }
 
+Float4 ConvertPremulToStraightOperation::convertFloat4(Float4 input)
+{
+  const Float4 alpha = float4_alpha(input);
+  return float4_select(float4_lt(float4_abs(alpha), float4_set1(1e-5f)),
+                       float4_set1(0.0f),
+                       input * (float4_set1(1.0f) / alpha));
+}
+
 /* ******** Straight to Premul ******** */
 
 ConvertStraightToPremulOperation::ConvertStraightToPremulOperation() : ConvertBaseOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void ConvertStraightToPremulOperation::executePixelSampled(float output[4],
@@ -385,24 +538,38 @@ void ConvertStraightToPremulOperation::executePixelSampled(float output[4],
                                                            float y,
                                                            PixelSampler sampler)
 {
-  float inputValue[4];
-  float alpha;
+  convertPixelSampled<ConvertStraightToPremulOperation>(output, x, y, sampler);
+}
 
-  this->m_inputOperation->readSampled(inputValue, x, y, sampler);
-  alpha = inputValue[3];
+void ConvertStraightToPremulOperation::executeArea(MemoryBuffer *output,
+                                                   rcti *area,
+                                                   MemoryBuffer **inputs)
+{
+  convertAreaFloat4<ConvertStraightToPremulOperation>(output, area, inputs);
+}
+
+void ConvertStraightToPremulOperation::convertPixel(float output[4], const float input[4])
+{
+  const float alpha = input[3];
 
-  mul_v3_v3fl(output, inputValue, alpha);
+  mul_v3_v3fl(output, input, alpha);
 
   /* never touches the alpha */
   output[3] = alpha;
 }
 
+Float4 ConvertStraightToPremulOperation::convertFloat4(Float4 input)
+{
+  return input * float4_alpha(input);
+}
+
 /* ******** Separate Channels ******** */
 
 SeparateChannelOperation::SeparateChannelOperation() : NodeOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_VALUE);
+  this->setAreaExecution(true);
   this->m_inputOperation = NULL;
 }
 void SeparateChannelOperation::initExecution()
@@ -425,6 +592,19 @@ void SeparateChannelOperation::executePixelSampled(float output[4],
   output[0] = input[this->m_channel];
 }
 
+void SeparateChannelOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = output->getElem(area->xmin, y);
+    const float *in = inputs[0]->getElem(area->xmin, y) + this->m_channel;
+    for (int x = area->xmin; x < area->xmax; x++) {
+      *out = *in;
+      out += COM_NUM_CHANNELS_VALUE;
+      in += COM_NUM_CHANNELS_COLOR;
+    }
+  }
+}
+
 /* ******** Combine Channels ******** */
 
 CombineChannelsOperation::CombineChannelsOperation() : NodeOperation()
@@ -435,6 +615,7 @@ CombineChannelsOperation::CombineChannelsOperation() : NodeOperation()
   this->addInputSocket(COM_DT_VALUE);
   this->addOutputSocket(COM_DT_COLOR);
   this->setResolutionInputSocketIndex(0);
+  this->setAreaExecution(true);
   this->m_inputChannel1Operation = NULL;
   this->m_inputChannel2Operation = NULL;
   this->m_inputChannel3Operation = NULL;
@@ -480,3 +661,21 @@ void CombineChannelsOperation::executePixelSampled(float output[4],
     output[3] = input[0];
   }
 }
+
+void CombineChannelsOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = output->getElem(area->xmin, y);
+    const float *in[4] = {inputs[0]->getElem(area->xmin, y),
+                          inputs[1]->getElem(area->xmin, y),
+                          inputs[2]->getElem(area->xmin, y),
+                          inputs[3]->getElem(area->xmin, y)};
+    for (int x = area->xmin; x < area->xmax; x++) {
+      out[0] = *in[0]++;
+      out[1] = *in[1]++;
+      out[2] = *in[2]++;
+      out[3] = *in[3]++;
+      out += COM_NUM_CHANNELS_COLOR;
+    }
+  }
+}
@@ -20,11 +20,63 @@
 #define __COM_CONVERTOPERATION_H__
 
 #include "COM_NodeOperation.h"
+#include "COM_SIMD.h"
 
 class ConvertBaseOperation : public NodeOperation {
  protected:
   SocketReader *m_inputOperation;
 
+  /**
+   * Read the input of a pixel and convert it with the convertPixel function of operation type T.
+   */
+  template<typename T>
+  inline void convertPixelSampled(float output[4], float x, float y, PixelSampler sampler)
+  {
+    float input[4];
+    this->m_inputOperation->readSampled(input, x, y, sampler);
+    static_cast<T *>(this)->convertPixel(output, input);
+  }
+
+  /**
+   * Convert the input buffer of an area row by row with the convertPixel function of operation
+   * type T, the call is not virtual so the function can be inlined into the loop.
+   */
+  template<typename T>
+  inline void convertArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+  {
+    const int input_channels = inputs[0]->get_num_channels();
+    const int output_channels = output->get_num_channels();
+    for (int y = area->ymin; y < area->ymax; y++) {
+      float *out = output->getElem(area->xmin, y);
+      const float *in = inputs[0]->getElem(area->xmin, y);
+      for (int x = area->xmin; x < area->xmax; x++) {
+        static_cast<T *>(this)->convertPixel(out, in);
+        out += output_channels;
+        in += input_channels;
+      }
+    }
+  }
+
+  /**
+   * Convert the color input buffer of an area row by row with the convertFloat4 function of
+   * operation type T, which converts all channels of a pixel at once. The alpha is kept.
+   */
+  template<typename T>
+  inline void convertAreaFloat4(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+  {
+    for (int y = area->ymin; y < area->ymax; y++) {
+      float *out = output->getElem(area->xmin, y);
+      const float *in = inputs[0]->getElem(area->xmin, y);
+      for (int x = area->xmin; x < area->xmax; x++) {
+        const Float4 color = float4_load(in);
+        const Float4 result = static_cast<T *>(this)->convertFloat4(color);
+        float4_store(out, float4_with_alpha(result, color));
+        out += COM_NUM_CHANNELS_COLOR;
+        in += COM_NUM_CHANNELS_COLOR;
+      }
+    }
+  }
+
  public:
   ConvertBaseOperation();
 
@@ -37,6 +89,8 @@ class ConvertValueToColorOperation : public ConvertBaseOperation {
   ConvertValueToColorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 };
 
 class ConvertColorToValueOperation : public ConvertBaseOperation {
@@ -44,6 +98,8 @@ class ConvertColorToValueOperation : public ConvertBaseOperation {
   ConvertColorToValueOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 };
 
 class ConvertColorToBWOperation : public ConvertBaseOperation {
@@ -51,6 +107,8 @@ class ConvertColorToBWOperation : public ConvertBaseOperation {
   ConvertColorToBWOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 };
 
 class ConvertColorToVectorOperation : public ConvertBaseOperation {
@@ -58,6 +116,8 @@ class ConvertColorToVectorOperation : public ConvertBaseOperation {
   ConvertColorToVectorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 };
 
 class ConvertValueToVectorOperation : public ConvertBaseOperation {
@@ -65,6 +125,8 @@ class ConvertValueToVectorOperation : public ConvertBaseOperation {
   ConvertValueToVectorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 };
 
 class ConvertVectorToColorOperation : public ConvertBaseOperation {
@@ -72,6 +134,8 @@ class ConvertVectorToColorOperation : public ConvertBaseOperation {
   ConvertVectorToColorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 };
 
 class ConvertVectorToValueOperation : public ConvertBaseOperation {
@@ -79,6 +143,8 @@ class ConvertVectorToValueOperation : public ConvertBaseOperation {
   ConvertVectorToValueOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 };
 
 class ConvertRGBToYCCOperation : public ConvertBaseOperation {
@@ -90,6 +156,8 @@ class ConvertRGBToYCCOperation : public ConvertBaseOperation {
   ConvertRGBToYCCOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 
   /** Set the YCC mode */
   void setMode(int mode);
@@ -104,6 +172,8 @@ class ConvertYCCToRGBOperation : public ConvertBaseOperation {
   ConvertYCCToRGBOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 
   /** Set the YCC mode */
   void setMode(int mode);
@@ -114,6 +184,9 @@ class ConvertRGBToYUVOperation : public ConvertBaseOperation {
   ConvertRGBToYUVOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
+  Float4 convertFloat4(Float4 input);
 };
 
 class ConvertYUVToRGBOperation : public ConvertBaseOperation {
@@ -121,6 +194,9 @@ class ConvertYUVToRGBOperation : public ConvertBaseOperation {
   ConvertYUVToRGBOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
+  Float4 convertFloat4(Float4 input);
 };
 
 class ConvertRGBToHSVOperation : public ConvertBaseOperation {
@@ -128,6 +204,8 @@ class ConvertRGBToHSVOperation : public ConvertBaseOperation {
   ConvertRGBToHSVOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 };
 
 class ConvertHSVToRGBOperation : public ConvertBaseOperation {
@@ -135,6 +213,8 @@ class ConvertHSVToRGBOperation : public ConvertBaseOperation {
   ConvertHSVToRGBOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
 };
 
 class ConvertPremulToStraightOperation : public ConvertBaseOperation {
@@ -142,6 +222,9 @@ class ConvertPremulToStraightOperation : public ConvertBaseOperation {
   ConvertPremulToStraightOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
+  Float4 convertFloat4(Float4 input);
 };
 
 class ConvertStraightToPremulOperation : public ConvertBaseOperation {
@@ -149,6 +232,9 @@ class ConvertStraightToPremulOperation : public ConvertBaseOperation {
   ConvertStraightToPremulOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void convertPixel(float output[4], const float input[4]);
+  Float4 convertFloat4(Float4 input);
 };
 
 class SeparateChannelOperation : public NodeOperation {
@@ -159,6 +245,7 @@ class SeparateChannelOperation : public NodeOperation {
  public:
   SeparateChannelOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
 
   void initExecution();
   void deinitExecution();
@@ -179,6 +266,7 @@ class CombineChannelsOperation : public NodeOperation {
  public:
   CombineChannelsOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
 
   void initExecution();
   void deinitExecution();
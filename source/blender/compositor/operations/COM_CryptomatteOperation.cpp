@@ -17,6 +17,7 @@
  */
 
 #include "COM_CryptomatteOperation.h"
+#include "COM_ResultCache.h"
 
 CryptomatteOperation::CryptomatteOperation(size_t num_inputs) : NodeOperation()
 {
@@ -42,6 +43,15 @@ void CryptomatteOperation::addObjectIndex(float objectIndex)
   }
 }
 
+bool CryptomatteOperation::hashSettings(ResultCacheKey *key)
+{
+  /* the matte id is parsed by the node, the storage only points to it */
+  for (size_t i = 0; i < m_objectIndex.size(); i++) {
+    key->addFloat(m_objectIndex[i]);
+  }
+  return true;
+}
+
 void CryptomatteOperation::executePixel(float output[4], int x, int y, void *data)
 {
   float input[4];
@@ -17,11 +17,16 @@
  */
 
 #include <limits.h>
+#include <string.h>
 
 #include "COM_FastGaussianBlurOperation.h"
 #include "MEM_guardedalloc.h"
 #include "BLI_utildefines.h"
 
+extern "C" {
+#include "BLI_task.h"
+}
+
 FastGaussianBlurOperation::FastGaussianBlurOperation() : BlurBaseOperation(COM_DT_COLOR)
 {
   this->m_iirgaus = NULL;
@@ -111,19 +116,128 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
   return this->m_iirgaus;
 }
 
+typedef struct IIRGaussData {
+  double cf[4], tsM[9];
+  float *buffer;
+  unsigned int width, height, num_channels, chan;
+} IIRGaussData;
+
+/* Intermediate buffers of one thread, allocated on first use. */
+typedef struct IIRGaussChunk {
+  double *X, *Y, *W;
+} IIRGaussChunk;
+
+static void IIR_gauss_chunk_ensure(IIRGaussChunk *chunk, const IIRGaussData *data)
+{
+  if (chunk->X == NULL) {
+    const unsigned int sz = max(data->width, data->height);
+    chunk->X = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss X buf");
+    chunk->Y = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss Y buf");
+    chunk->W = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss W buf");
+  }
+}
+
+/* Filter the L values of X forward into W and backward into Y. */
+static void IIR_gauss_yvv(const IIRGaussData *data, IIRGaussChunk *chunk, const int L)
+{
+  const double *cf = data->cf;
+  const double *tsM = data->tsM;
+  const double *X = chunk->X;
+  double *Y = chunk->Y;
+  double *W = chunk->W;
+  double tsu[3], tsv[3];
+  int i;
+
+  W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0];
+  W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0];
+  W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0];
+  for (i = 3; i < L; i++) {
+    W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3];
+  }
+  tsu[0] = W[L - 1] - X[L - 1];
+  tsu[1] = W[L - 2] - X[L - 1];
+  tsu[2] = W[L - 3] - X[L - 1];
+  tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1];
+  tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1];
+  tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1];
+  Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2];
+  Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1];
+  Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0];
+  for (i = L - 4; i >= 0; i--) {
+    Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3];
+  }
+}
+
+static void IIR_gauss_row(void *__restrict userdata,
+                          const int y,
+                          const TaskParallelTLS *__restrict tls)
+{
+  const IIRGaussData *data = (const IIRGaussData *)userdata;
+  IIRGaussChunk *chunk = (IIRGaussChunk *)tls->userdata_chunk;
+  const unsigned int num_channels = data->num_channels;
+  float *buffer = data->buffer;
+  unsigned int x;
+  int offset;
+
+  IIR_gauss_chunk_ensure(chunk, data);
+
+  offset = y * data->width * num_channels + data->chan;
+  for (x = 0; x < data->width; x++) {
+    chunk->X[x] = buffer[offset];
+    offset += num_channels;
+  }
+  IIR_gauss_yvv(data, chunk, data->width);
+  offset = y * data->width * num_channels + data->chan;
+  for (x = 0; x < data->width; x++) {
+    buffer[offset] = chunk->Y[x];
+    offset += num_channels;
+  }
+}
+
+static void IIR_gauss_column(void *__restrict userdata,
+                             const int x,
+                             const TaskParallelTLS *__restrict tls)
+{
+  const IIRGaussData *data = (const IIRGaussData *)userdata;
+  IIRGaussChunk *chunk = (IIRGaussChunk *)tls->userdata_chunk;
+  const int add = data->width * data->num_channels;
+  float *buffer = data->buffer;
+  unsigned int y;
+  int offset;
+
+  IIR_gauss_chunk_ensure(chunk, data);
+
+  offset = x * data->num_channels + data->chan;
+  for (y = 0; y < data->height; y++) {
+    chunk->X[y] = buffer[offset];
+    offset += add;
+  }
+  IIR_gauss_yvv(data, chunk, data->height);
+  offset = x * data->num_channels + data->chan;
+  for (y = 0; y < data->height; y++) {
+    buffer[offset] = chunk->Y[y];
+    offset += add;
+  }
+}
+
+static void IIR_gauss_finalize(void *__restrict /*userdata*/, void *__restrict userdata_chunk)
+{
+  IIRGaussChunk *chunk = (IIRGaussChunk *)userdata_chunk;
+  if (chunk->X) {
+    MEM_freeN(chunk->X);
+    MEM_freeN(chunk->Y);
+    MEM_freeN(chunk->W);
+  }
+}
+
 void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
                                           float sigma,
                                           unsigned int chan,
                                           unsigned int xy)
 {
-  double q, q2, sc, cf[4], tsM[9], tsu[3], tsv[3];
-  double *X, *Y, *W;
+  double q, q2, sc, cf[4], tsM[9];
   const unsigned int src_width = src->getWidth();
   const unsigned int src_height = src->getHeight();
-  unsigned int x, y, sz;
-  unsigned int i;
-  float *buffer = src->getBuffer();
-  const unsigned int num_channels = src->get_num_channels();
 
   // <0.5 not valid, though can have a possibly useful sort of sharpening effect
   if (sigma < 0.5f) {
@@ -134,7 +248,7 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
     xy = 3;
   }
 
-  // XXX The YVV macro defined below explicitly expects sources of at least 3x3 pixels,
+  // XXX IIR_gauss_yvv explicitly expects sources of at least 3x3 pixels,
   //     so just skipping blur along faulty direction if src's def is below that limit!
   if (src_width < 3) {
     xy &= ~1;
@@ -185,75 +299,30 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
                  cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
   tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
 
-#define YVV(L) \
-  { \
-    W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0]; \
-    for (i = 3; i < L; i++) { \
-      W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3]; \
-    } \
-    tsu[0] = W[L - 1] - X[L - 1]; \
-    tsu[1] = W[L - 2] - X[L - 1]; \
-    tsu[2] = W[L - 3] - X[L - 1]; \
-    tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1]; \
-    tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1]; \
-    tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1]; \
-    Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2]; \
-    Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1]; \
-    Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0]; \
-    /* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */ \
-    for (i = L - 4; i != UINT_MAX; i--) { \
-      Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3]; \
-    } \
-  } \
-  (void)0
-
-  // intermediate buffers
-  sz = max(src_width, src_height);
-  X = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss X buf");
-  Y = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss Y buf");
-  W = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss W buf");
+  IIRGaussData data;
+  memcpy(data.cf, cf, sizeof(cf));
+  memcpy(data.tsM, tsM, sizeof(tsM));
+  data.buffer = src->getBuffer();
+  data.width = src_width;
+  data.height = src_height;
+  data.num_channels = src->get_num_channels();
+  data.chan = chan;
+
+  /* Every row and column is filtered independently, with its own intermediate buffers. */
+  IIRGaussChunk chunk = {NULL, NULL, NULL};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 8;
+  settings.userdata_chunk = &chunk;
+  settings.userdata_chunk_size = sizeof(chunk);
+  settings.func_finalize = IIR_gauss_finalize;
+
   if (xy & 1) {  // H
-    int offset;
-    for (y = 0; y < src_height; y++) {
-      const int yx = y * src_width;
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        X[x] = buffer[offset];
-        offset += num_channels;
-      }
-      YVV(src_width);
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        buffer[offset] = Y[x];
-        offset += num_channels;
-      }
-    }
+    BLI_task_parallel_range(0, src_height, &data, IIR_gauss_row, &settings);
   }
   if (xy & 2) {  // V
-    int offset;
-    const int add = src_width * num_channels;
-
-    for (x = 0; x < src_width; x++) {
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        X[y] = buffer[offset];
-        offset += add;
-      }
-      YVV(src_height);
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        buffer[offset] = Y[y];
-        offset += add;
-      }
-    }
+    BLI_task_parallel_range(0, src_width, &data, IIR_gauss_column, &settings);
   }
-
-  MEM_freeN(X);
-  MEM_freeN(W);
-  MEM_freeN(Y);
-#undef YVV
 }
 
 ///
@@ -19,6 +19,16 @@
 #include "COM_GammaOperation.h"
 #include "BLI_math.h"
 
+static inline void gamma_pixel(float output[4], const float input[4], const float gamma)
+{
+  /* check for negative to avoid nan's */
+  output[0] = input[0] > 0.0f ? powf(input[0], gamma) : input[0];
+  output[1] = input[1] > 0.0f ? powf(input[1], gamma) : input[1];
+  output[2] = input[2] > 0.0f ? powf(input[2], gamma) : input[2];
+
+  output[3] = input[3];
+}
+
 GammaOperation::GammaOperation() : NodeOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
@@ -26,6 +36,7 @@ GammaOperation::GammaOperation() : NodeOperation()
   this->addOutputSocket(COM_DT_COLOR);
   this->m_inputProgram = NULL;
   this->m_inputGammaProgram = NULL;
+  this->setAreaExecution(true);
 }
 void GammaOperation::initExecution()
 {
@@ -40,13 +51,22 @@ void GammaOperation::executePixelSampled(float output[4], float x, float y, Pixe
 
   this->m_inputProgram->readSampled(inputValue, x, y, sampler);
   this->m_inputGammaProgram->readSampled(inputGamma, x, y, sampler);
-  const float gamma = inputGamma[0];
-  /* check for negative to avoid nan's */
-  output[0] = inputValue[0] > 0.0f ? powf(inputValue[0], gamma) : inputValue[0];
-  output[1] = inputValue[1] > 0.0f ? powf(inputValue[1], gamma) : inputValue[1];
-  output[2] = inputValue[2] > 0.0f ? powf(inputValue[2], gamma) : inputValue[2];
+  gamma_pixel(output, inputValue, inputGamma[0]);
+}
 
-  output[3] = inputValue[3];
+void GammaOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = output->getElem(area->xmin, y);
+    const float *color = inputs[0]->getElem(area->xmin, y);
+    const float *gamma = inputs[1]->getElem(area->xmin, y);
+    for (int x = area->xmin; x < area->xmax; x++) {
+      gamma_pixel(out, color, gamma[0]);
+      out += COM_NUM_CHANNELS_COLOR;
+      color += COM_NUM_CHANNELS_COLOR;
+      gamma += COM_NUM_CHANNELS_VALUE;
+    }
+  }
 }
 
 void GammaOperation::deinitExecution()
@@ -35,6 +35,7 @@ class GammaOperation : public NodeOperation {
    * the inner loop of this program
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
 
   /**
    * Initialize the execution
@@ -19,6 +19,10 @@
 #include "COM_GlareFogGlowOperation.h"
 #include "MEM_guardedalloc.h"
 
+extern "C" {
+#include "BLI_task.h"
+}
+
 /*
  *  2D Fast Hartley Transform, used for convolution
  */
@@ -123,6 +127,55 @@ static void FHT(fREAL *data, unsigned int M, unsigned int inverse)
   }
 }
 //------------------------------------------------------------------------------
+
+/* The rows of the 2D transform and of the convolution are independent of each other and are
+ * calculated in parallel, the transpose in between stays on a single thread. */
+typedef struct FHT2DData {
+  fREAL *data;
+  unsigned int Mx, Nx, Ny, inverse;
+} FHT2DData;
+
+static void FHT2D_row(void *__restrict userdata,
+                      const int j,
+                      const TaskParallelTLS *__restrict /*tls*/)
+{
+  const FHT2DData *fht = (const FHT2DData *)userdata;
+  FHT(&fht->data[fht->Nx * j], fht->Mx, fht->inverse);
+}
+
+/* Row j and its mirrored row are only touched by iteration j. */
+static void FHT2D_finalize_row(void *__restrict userdata,
+                               const int j,
+                               const TaskParallelTLS *__restrict /*tls*/)
+{
+  const FHT2DData *fht = (const FHT2DData *)userdata;
+  fREAL *data = fht->data;
+  const unsigned int Nx = fht->Nx, Ny = fht->Ny, Mx = fht->Mx;
+  unsigned int jm = (Ny - j) & (Ny - 1);
+  unsigned int ji = j << Mx;
+  unsigned int jmi = jm << Mx;
+  for (unsigned int i = 0; i <= (Nx >> 1); i++) {
+    unsigned int im = (Nx - i) & (Nx - 1);
+    fREAL A = data[ji + i];
+    fREAL B = data[jmi + i];
+    fREAL C = data[ji + im];
+    fREAL D = data[jmi + im];
+    fREAL E = (fREAL)0.5 * ((A + D) - (B + C));
+    data[ji + i] = A - E;
+    data[jmi + i] = B + E;
+    data[ji + im] = C + E;
+    data[jmi + im] = D - E;
+  }
+}
+
+static void FHT2D_parallel_rows(FHT2DData *fht, int num_rows, TaskParallelRangeFunc func)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(0, num_rows, fht, func, &settings);
+}
+
 /* 2D Fast Hartley Transform, Mx/My -> log2 of width/height,
  * nzp -> the row where zero pad data starts,
  * inverse -> see above */
@@ -130,15 +183,19 @@ static void FHT2D(
     fREAL *data, unsigned int Mx, unsigned int My, unsigned int nzp, unsigned int inverse)
 {
   unsigned int i, j, Nx, Ny, maxy;
+  FHT2DData fht;
 
   Nx = 1 << Mx;
   Ny = 1 << My;
 
   // rows (forward transform skips 0 pad data)
   maxy = inverse ? Ny : nzp;
-  for (j = 0; j < maxy; j++) {
-    FHT(&data[Nx * j], Mx, inverse);
-  }
+  fht.data = data;
+  fht.Mx = Mx;
+  fht.Nx = Nx;
+  fht.Ny = Ny;
+  fht.inverse = inverse;
+  FHT2D_parallel_rows(&fht, maxy, FHT2D_row);
 
   // transpose data
   if (Nx == Ny) {  // square
@@ -171,32 +228,48 @@ static void FHT2D(
   SWAP(unsigned int, Mx, My);
 
   // now columns == transposed rows
-  for (j = 0; j < Ny; j++) {
-    FHT(&data[Nx * j], Mx, inverse);
-  }
+  fht.Mx = Mx;
+  fht.Nx = Nx;
+  fht.Ny = Ny;
+  FHT2D_parallel_rows(&fht, Ny, FHT2D_row);
 
   // finalize
-  for (j = 0; j <= (Ny >> 1); j++) {
-    unsigned int jm = (Ny - j) & (Ny - 1);
-    unsigned int ji = j << Mx;
-    unsigned int jmi = jm << Mx;
-    for (i = 0; i <= (Nx >> 1); i++) {
-      unsigned int im = (Nx - i) & (Nx - 1);
-      fREAL A = data[ji + i];
-      fREAL B = data[jmi + i];
-      fREAL C = data[ji + im];
-      fREAL D = data[jmi + im];
-      fREAL E = (fREAL)0.5 * ((A + D) - (B + C));
-      data[ji + i] = A - E;
-      data[jmi + i] = B + E;
-      data[ji + im] = C + E;
-      data[jmi + im] = D - E;
-    }
-  }
+  FHT2D_parallel_rows(&fht, (Ny >> 1) + 1, FHT2D_finalize_row);
 }
 
 //------------------------------------------------------------------------------
 
+typedef struct FHTConvolveData {
+  fREAL *d1, *d2;
+  unsigned int M, m, n, n2;
+} FHTConvolveData;
+
+/* Column i and its mirrored column are only touched by iteration i. */
+static void fht_convolve_column(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict /*tls*/)
+{
+  const FHTConvolveData *conv = (const FHTConvolveData *)userdata;
+  fREAL *d1 = conv->d1, *d2 = conv->d2;
+  const unsigned int M = conv->M, n = conv->n;
+  fREAL a, b;
+  unsigned int j, L, mj, mL;
+  unsigned int k = conv->m - i;
+  for (j = 1; j < conv->n2; j++) {
+    L = n - j;
+    mj = j << M;
+    mL = L << M;
+    a = d1[i + mj] * d2[i + mj] - d1[k + mL] * d2[k + mL];
+    b = d1[k + mL] * d2[i + mj] + d1[i + mj] * d2[k + mL];
+    d1[i + mj] = (b + a) * (fREAL)0.5;
+    d1[k + mL] = (b - a) * (fREAL)0.5;
+    a = d1[i + mL] * d2[i + mL] - d1[k + mj] * d2[k + mj];
+    b = d1[k + mj] * d2[i + mL] + d1[i + mL] * d2[k + mj];
+    d1[i + mL] = (b + a) * (fREAL)0.5;
+    d1[k + mj] = (b - a) * (fREAL)0.5;
+  }
+}
+
 /* 2D convolution calc, d1 *= d2, M/N - > log2 of width/height */
 static void fht_convolve(fREAL *d1, fREAL *d2, unsigned int M, unsigned int N)
 {
@@ -234,24 +307,41 @@ static void fht_convolve(fREAL *d1, fREAL *d2, unsigned int M, unsigned int N)
     d1[m2 + mj] = (b + a) * (fREAL)0.5;
     d1[m2 + mL] = (b - a) * (fREAL)0.5;
   }
-  for (i = 1; i < m2; i++) {
-    k = m - i;
-    for (j = 1; j < n2; j++) {
-      L = n - j;
-      mj = j << M;
-      mL = L << M;
-      a = d1[i + mj] * d2[i + mj] - d1[k + mL] * d2[k + mL];
-      b = d1[k + mL] * d2[i + mj] + d1[i + mj] * d2[k + mL];
-      d1[i + mj] = (b + a) * (fREAL)0.5;
-      d1[k + mL] = (b - a) * (fREAL)0.5;
-      a = d1[i + mL] * d2[i + mL] - d1[k + mj] * d2[k + mj];
-      b = d1[k + mj] * d2[i + mL] + d1[i + mL] * d2[k + mj];
-      d1[i + mL] = (b + a) * (fREAL)0.5;
-      d1[k + mj] = (b - a) * (fREAL)0.5;
+
+  FHTConvolveData conv = {d1, d2, M, m, n, n2};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(1, m2, &conv, fht_convolve_column, &settings);
+}
+//------------------------------------------------------------------------------
+
+typedef struct OverlapAddData {
+  const fREAL *data;
+  float *dst;
+  int w2, imageWidth, imageHeight;
+  int x_offset, y_offset, ch;
+} OverlapAddData;
+
+static void overlap_add_row(void *__restrict userdata,
+                            const int y,
+                            const TaskParallelTLS *__restrict /*tls*/)
+{
+  const OverlapAddData *overlap = (const OverlapAddData *)userdata;
+  const int yy = overlap->y_offset + y;
+  if ((yy < 0) || (yy >= overlap->imageHeight)) {
+    return;
+  }
+  const fREAL *fp = &overlap->data[y * overlap->w2];
+  fRGB *colp = (fRGB *)&overlap->dst[yy * overlap->imageWidth * COM_NUM_CHANNELS_COLOR];
+  for (int x = 0; x < overlap->w2; x++) {
+    const int xx = overlap->x_offset + x;
+    if ((xx < 0) || (xx >= overlap->imageWidth)) {
+      continue;
     }
+    colp[xx][overlap->ch] += fp[x];
   }
 }
-//------------------------------------------------------------------------------
 
 static void convolve(float *dst, MemoryBuffer *in1, MemoryBuffer *in2)
 {
@@ -324,6 +414,16 @@ static void convolve(float *dst, MemoryBuffer *in1, MemoryBuffer *in2)
   if (imageHeight % ybsz) {
     nyb++;
   }
+  OverlapAddData overlap;
+  overlap.data = data2;
+  overlap.dst = rdst->getBuffer();
+  overlap.w2 = w2;
+  overlap.imageWidth = imageWidth;
+  overlap.imageHeight = imageHeight;
+  TaskParallelSettings overlap_settings;
+  BLI_parallel_range_settings_defaults(&overlap_settings);
+  overlap_settings.min_iter_per_thread = 8;
+
   for (ybl = 0; ybl < nyb; ybl++) {
     for (xbl = 0; xbl < nxb; xbl++) {
 
@@ -375,21 +475,10 @@ static void convolve(float *dst, MemoryBuffer *in1, MemoryBuffer *in2)
         // data again transposed, so in order again
 
         // overlap-add result
-        for (y = 0; y < (int)h2; y++) {
-          const int yy = ybl * ybsz + y - hh;
-          if ((yy < 0) || (yy >= imageHeight)) {
-            continue;
-          }
-          fp = &data2[y * w2];
-          colp = (fRGB *)&rdst->getBuffer()[yy * imageWidth * COM_NUM_CHANNELS_COLOR];
-          for (x = 0; x < (int)w2; x++) {
-            const int xx = xbl * xbsz + x - hw;
-            if ((xx < 0) || (xx >= imageWidth)) {
-              continue;
-            }
-            colp[xx][ch] += fp[x];
-          }
-        }
+        overlap.x_offset = xbl * xbsz - (int)hw;
+        overlap.y_offset = ybl * ybsz - (int)hh;
+        overlap.ch = ch;
+        BLI_task_parallel_range(0, h2, &overlap, overlap_add_row, &overlap_settings);
       }
       in2done = true;
     }
@@ -20,6 +20,10 @@
 #include "BLI_math.h"
 #include "COM_FastGaussianBlurOperation.h"
 
+extern "C" {
+#include "BLI_task.h"
+}
+
 static float smoothMask(float x, float y)
 {
   float t;
@@ -33,13 +37,76 @@ static float smoothMask(float x, float y)
   }
 }
 
+typedef struct GlareGhostData {
+  MemoryBuffer *gbuf, *tbuf1, *tbuf2;
+  const fRGB *cm;
+  const float *scalef;
+  int n;
+} GlareGhostData;
+
+/* Combine the two blurred buffers into gbuf, every row reads only tbuf1 and tbuf2. */
+static void glare_ghost_initial_row(void *__restrict userdata,
+                                    const int y,
+                                    const TaskParallelTLS *__restrict /*tls*/)
+{
+  const GlareGhostData *ghost = (const GlareGhostData *)userdata;
+  MemoryBuffer *gbuf = ghost->gbuf;
+  const float sc = 2.13, isc = -0.97;
+  const float v = ((float)y + 0.5f) / (float)gbuf->getHeight();
+  fRGB c, tc;
+  float u, sm, s, t;
+
+  for (int x = 0; x < gbuf->getWidth(); x++) {
+    u = ((float)x + 0.5f) / (float)gbuf->getWidth();
+    s = (u - 0.5f) * sc + 0.5f;
+    t = (v - 0.5f) * sc + 0.5f;
+    ghost->tbuf1->readBilinear(c, s * gbuf->getWidth(), t * gbuf->getHeight());
+    sm = smoothMask(s, t);
+    mul_v3_fl(c, sm);
+    s = (u - 0.5f) * isc + 0.5f;
+    t = (v - 0.5f) * isc + 0.5f;
+    ghost->tbuf2->readBilinear(tc, s * gbuf->getWidth() - 0.5f, t * gbuf->getHeight() - 0.5f);
+    sm = smoothMask(s, t);
+    madd_v3_v3fl(c, tc, sm);
+
+    gbuf->writePixel(x, y, c);
+  }
+}
+
+/* Add the ghosts of iteration n to tbuf1, every row reads only gbuf. */
+static void glare_ghost_iteration_row(void *__restrict userdata,
+                                      const int y,
+                                      const TaskParallelTLS *__restrict /*tls*/)
+{
+  const GlareGhostData *ghost = (const GlareGhostData *)userdata;
+  MemoryBuffer *gbuf = ghost->gbuf;
+  const float v = ((float)y + 0.5f) / (float)gbuf->getHeight();
+  fRGB c, tc;
+  float u, sm, s, t;
+
+  for (int x = 0; x < gbuf->getWidth(); x++) {
+    u = ((float)x + 0.5f) / (float)gbuf->getWidth();
+    zero_v4(tc);
+    for (int p = 0; p < 4; p++) {
+      const int np = (ghost->n << 2) + p;
+      s = (u - 0.5f) * ghost->scalef[np] + 0.5f;
+      t = (v - 0.5f) * ghost->scalef[np] + 0.5f;
+      gbuf->readBilinear(c, s * gbuf->getWidth() - 0.5f, t * gbuf->getHeight() - 0.5f);
+      mul_v3_v3(c, ghost->cm[np]);
+      sm = smoothMask(s, t) * 0.25f;
+      madd_v3_v3fl(tc, c, sm);
+    }
+    ghost->tbuf1->addPixel(x, y, tc);
+  }
+}
+
 void GlareGhostOperation::generateGlare(float *data, MemoryBuffer *inputTile, NodeGlare *settings)
 {
   const int qt = 1 << settings->quality;
   const float s1 = 4.0f / (float)qt, s2 = 2.0f * s1;
-  int x, y, n, p, np;
-  fRGB c, tc, cm[64];
-  float sc, isc, u, v, sm, s, t, ofs, scalef[64];
+  int x, y, n;
+  fRGB cm[64];
+  float ofs, scalef[64];
   const float cmo = 1.0f - settings->colmod;
 
   MemoryBuffer *gbuf = inputTile->duplicate();
@@ -98,25 +165,14 @@ void GlareGhostOperation::generateGlare(float *data, MemoryBuffer *inputTile, No
     }
   }
 
-  sc = 2.13;
-  isc = -0.97;
-  for (y = 0; y < gbuf->getHeight() && (!breaked); y++) {
-    v = ((float)y + 0.5f) / (float)gbuf->getHeight();
-    for (x = 0; x < gbuf->getWidth(); x++) {
-      u = ((float)x + 0.5f) / (float)gbuf->getWidth();
-      s = (u - 0.5f) * sc + 0.5f;
-      t = (v - 0.5f) * sc + 0.5f;
-      tbuf1->readBilinear(c, s * gbuf->getWidth(), t * gbuf->getHeight());
-      sm = smoothMask(s, t);
-      mul_v3_fl(c, sm);
-      s = (u - 0.5f) * isc + 0.5f;
-      t = (v - 0.5f) * isc + 0.5f;
-      tbuf2->readBilinear(tc, s * gbuf->getWidth() - 0.5f, t * gbuf->getHeight() - 0.5f);
-      sm = smoothMask(s, t);
-      madd_v3_v3fl(c, tc, sm);
-
-      gbuf->writePixel(x, y, c);
-    }
+  GlareGhostData ghost = {gbuf, tbuf1, tbuf2, cm, scalef, 0};
+  TaskParallelSettings parallel_settings;
+  BLI_parallel_range_settings_defaults(&parallel_settings);
+  parallel_settings.min_iter_per_thread = 8;
+
+  if (!breaked) {
+    BLI_task_parallel_range(
+        0, gbuf->getHeight(), &ghost, glare_ghost_initial_row, &parallel_settings);
     if (isBraked()) {
       breaked = true;
     }
@@ -126,25 +182,11 @@ void GlareGhostOperation::generateGlare(float *data, MemoryBuffer *inputTile, No
          0,
          tbuf1->getWidth() * tbuf1->getHeight() * COM_NUM_CHANNELS_COLOR * sizeof(float));
   for (n = 1; n < settings->iter && (!breaked); n++) {
-    for (y = 0; y < gbuf->getHeight() && (!breaked); y++) {
-      v = ((float)y + 0.5f) / (float)gbuf->getHeight();
-      for (x = 0; x < gbuf->getWidth(); x++) {
-        u = ((float)x + 0.5f) / (float)gbuf->getWidth();
-        tc[0] = tc[1] = tc[2] = 0.0f;
-        for (p = 0; p < 4; p++) {
-          np = (n << 2) + p;
-          s = (u - 0.5f) * scalef[np] + 0.5f;
-          t = (v - 0.5f) * scalef[np] + 0.5f;
-          gbuf->readBilinear(c, s * gbuf->getWidth() - 0.5f, t * gbuf->getHeight() - 0.5f);
-          mul_v3_v3(c, cm[np]);
-          sm = smoothMask(s, t) * 0.25f;
-          madd_v3_v3fl(tc, c, sm);
-        }
-        tbuf1->addPixel(x, y, tc);
-      }
-      if (isBraked()) {
-        breaked = true;
-      }
+    ghost.n = n;
+    BLI_task_parallel_range(
+        0, gbuf->getHeight(), &ghost, glare_ghost_iteration_row, &parallel_settings);
+    if (isBraked()) {
+      breaked = true;
     }
     memcpy(gbuf->getBuffer(),
            tbuf1->getBuffer(),
@@ -18,78 +18,130 @@
 
 #include "COM_GlareSimpleStarOperation.h"
 
+extern "C" {
+#include "BLI_task.h"
+}
+
+/* Every pixel is blended in place with its two neighbors at distance i along a line, so the
+ * lines can be filtered in parallel as long as each one is walked in the order of the original
+ * scan: forward in raster order, then backward. */
+typedef struct GlareSimpleStarPass {
+  MemoryBuffer *buffer;
+  int width, height;
+  /* Step from one pixel of a line to the next one in raster order. */
+  int step_x, step_y;
+  /* Direction of the neighbor that is blended in first. */
+  int neighbor_x, neighbor_y;
+  int i;
+  float f1, f2;
+} GlareSimpleStarPass;
+
+static int glare_simple_star_num_lines(const GlareSimpleStarPass *pass)
+{
+  if (pass->step_y == 0) {
+    return pass->height;
+  }
+  if (pass->step_x == 0) {
+    return pass->width;
+  }
+  return pass->width + pass->height - 1;
+}
+
+static void glare_simple_star_pixel(const GlareSimpleStarPass *pass, int x, int y)
+{
+  const int i = pass->i;
+  float c[4], tc[4];
+  pass->buffer->read(c, x, y);
+  mul_v3_fl(c, pass->f1);
+  pass->buffer->read(tc, x + pass->neighbor_x * i, y + pass->neighbor_y * i);
+  madd_v3_v3fl(c, tc, pass->f2);
+  pass->buffer->read(tc, x - pass->neighbor_x * i, y - pass->neighbor_y * i);
+  madd_v3_v3fl(c, tc, pass->f2);
+  c[3] = 1.0f;
+  pass->buffer->writePixel(x, y, c);
+}
+
+static void glare_simple_star_line(void *__restrict userdata,
+                                   const int line,
+                                   const TaskParallelTLS *__restrict /*tls*/)
+{
+  const GlareSimpleStarPass *pass = (const GlareSimpleStarPass *)userdata;
+  int x, y, length;
+
+  if (pass->step_y == 0) {
+    x = 0;
+    y = line;
+  }
+  else if (line < pass->width) {
+    x = line;
+    y = 0;
+  }
+  else {
+    x = (pass->step_x > 0) ? 0 : pass->width - 1;
+    y = line - pass->width + 1;
+  }
+
+  for (length = 0; x >= 0 && x < pass->width && y < pass->height; length++) {
+    glare_simple_star_pixel(pass, x, y);
+    x += pass->step_x;
+    y += pass->step_y;
+  }
+  while (length--) {
+    x -= pass->step_x;
+    y -= pass->step_y;
+    glare_simple_star_pixel(pass, x, y);
+  }
+}
+
 void GlareSimpleStarOperation::generateGlare(float *data,
                                              MemoryBuffer *inputTile,
                                              NodeGlare *settings)
 {
-  int i, x, y, ym, yp, xm, xp;
-  float c[4] = {0, 0, 0, 0}, tc[4] = {0, 0, 0, 0};
+  int i;
   const float f1 = 1.0f - settings->fade;
   const float f2 = (1.0f - f1) * 0.5f;
 
   MemoryBuffer *tbuf1 = inputTile->duplicate();
   MemoryBuffer *tbuf2 = inputTile->duplicate();
 
-  bool breaked = false;
-  for (i = 0; i < settings->iter && (!breaked); i++) {
-    //      // (x || x-1, y-1) to (x || x+1, y+1)
-    //      // F
-    for (y = 0; y < this->getHeight() && (!breaked); y++) {
-      ym = y - i;
-      yp = y + i;
-      for (x = 0; x < this->getWidth(); x++) {
-        xm = x - i;
-        xp = x + i;
-        tbuf1->read(c, x, y);
-        mul_v3_fl(c, f1);
-        tbuf1->read(tc, (settings->star_45 ? xm : x), ym);
-        madd_v3_v3fl(c, tc, f2);
-        tbuf1->read(tc, (settings->star_45 ? xp : x), yp);
-        madd_v3_v3fl(c, tc, f2);
-        c[3] = 1.0f;
-        tbuf1->writePixel(x, y, c);
+  const int star_45 = settings->star_45 ? 1 : 0;
+  GlareSimpleStarPass pass1, pass2;
+  pass1.buffer = tbuf1;
+  pass2.buffer = tbuf2;
+  pass1.width = pass2.width = getWidth();
+  pass1.height = pass2.height = getHeight();
+  pass1.f1 = pass2.f1 = f1;
+  pass1.f2 = pass2.f2 = f2;
+  // (x || x-1, y-1) to (x || x+1, y+1)
+  pass1.step_x = star_45;
+  pass1.step_y = 1;
+  pass1.neighbor_x = -star_45;
+  pass1.neighbor_y = -1;
+  // (x-1, y || y+1) to (x+1, y || y-1)
+  pass2.step_x = star_45 ? -1 : 1;
+  pass2.step_y = star_45;
+  pass2.neighbor_x = -1;
+  pass2.neighbor_y = star_45;
 
-        tbuf2->read(c, x, y);
-        mul_v3_fl(c, f1);
-        tbuf2->read(tc, xm, (settings->star_45 ? yp : y));
-        madd_v3_v3fl(c, tc, f2);
-        tbuf2->read(tc, xp, (settings->star_45 ? ym : y));
-        madd_v3_v3fl(c, tc, f2);
-        c[3] = 1.0f;
-        tbuf2->writePixel(x, y, c);
-      }
-      if (isBraked()) {
-        breaked = true;
-      }
-    }
-    //      // B
-    for (y = this->getHeight() - 1; y >= 0 && (!breaked); y--) {
-      ym = y - i;
-      yp = y + i;
-      for (x = this->getWidth() - 1; x >= 0; x--) {
-        xm = x - i;
-        xp = x + i;
-        tbuf1->read(c, x, y);
-        mul_v3_fl(c, f1);
-        tbuf1->read(tc, (settings->star_45 ? xm : x), ym);
-        madd_v3_v3fl(c, tc, f2);
-        tbuf1->read(tc, (settings->star_45 ? xp : x), yp);
-        madd_v3_v3fl(c, tc, f2);
-        c[3] = 1.0f;
-        tbuf1->writePixel(x, y, c);
+  TaskParallelSettings parallel_settings;
+  BLI_parallel_range_settings_defaults(&parallel_settings);
+  parallel_settings.min_iter_per_thread = 8;
 
-        tbuf2->read(c, x, y);
-        mul_v3_fl(c, f1);
-        tbuf2->read(tc, xm, (settings->star_45 ? yp : y));
-        madd_v3_v3fl(c, tc, f2);
-        tbuf2->read(tc, xp, (settings->star_45 ? ym : y));
-        madd_v3_v3fl(c, tc, f2);
-        c[3] = 1.0f;
-        tbuf2->writePixel(x, y, c);
-      }
-      if (isBraked()) {
-        breaked = true;
-      }
+  bool breaked = false;
+  for (i = 0; i < settings->iter && (!breaked); i++) {
+    pass1.i = pass2.i = i;
+    BLI_task_parallel_range(0,
+                            glare_simple_star_num_lines(&pass1),
+                            &pass1,
+                            glare_simple_star_line,
+                            &parallel_settings);
+    BLI_task_parallel_range(0,
+                            glare_simple_star_num_lines(&pass2),
+                            &pass2,
+                            glare_simple_star_line,
+                            &parallel_settings);
+    if (isBraked()) {
+      breaked = true;
     }
   }
 
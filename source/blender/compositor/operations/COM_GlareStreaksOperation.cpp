@@ -19,13 +19,63 @@
 #include "COM_GlareStreaksOperation.h"
 #include "BLI_math.h"
 
+extern "C" {
+#include "BLI_task.h"
+}
+
+typedef struct GlareStreaksPass {
+  MemoryBuffer *tsrc, *tdst;
+  int n;
+  float vxp, vyp, wt, cmo;
+} GlareStreaksPass;
+
+/* A pass only reads from tsrc, so every row of tdst can be written by its own task. */
+static void glare_streaks_pass_row(void *__restrict userdata,
+                                   const int y,
+                                   const TaskParallelTLS *__restrict /*tls*/)
+{
+  const GlareStreaksPass *pass = (const GlareStreaksPass *)userdata;
+  MemoryBuffer *tsrc = pass->tsrc;
+  const int width = tsrc->getWidth();
+  const float vxp = pass->vxp, vyp = pass->vyp, wt = pass->wt, cmo = pass->cmo;
+  float *tdstcol = pass->tdst->getBuffer() + y * width * 4;
+  float c1[4], c2[4], c3[4], c4[4];
+
+  for (int x = 0; x < width; x++, tdstcol += 4) {
+    // first pass no offset, always same for every pass, exact copy,
+    // otherwise results in uneven brightness, only need once
+    if (pass->n == 0) {
+      tsrc->read(c1, x, y);
+    }
+    else {
+      c1[0] = c1[1] = c1[2] = 0;
+    }
+    tsrc->readBilinear(c2, x + vxp, y + vyp);
+    tsrc->readBilinear(c3, x + vxp * 2.0f, y + vyp * 2.0f);
+    tsrc->readBilinear(c4, x + vxp * 3.0f, y + vyp * 3.0f);
+    // modulate color to look vaguely similar to a color spectrum
+    c2[1] *= cmo;
+    c2[2] *= cmo;
+
+    c3[0] *= cmo;
+    c3[1] *= cmo;
+
+    c4[0] *= cmo;
+    c4[2] *= cmo;
+
+    tdstcol[0] = 0.5f * (tdstcol[0] + c1[0] + wt * (c2[0] + wt * (c3[0] + wt * c4[0])));
+    tdstcol[1] = 0.5f * (tdstcol[1] + c1[1] + wt * (c2[1] + wt * (c3[1] + wt * c4[1])));
+    tdstcol[2] = 0.5f * (tdstcol[2] + c1[2] + wt * (c2[2] + wt * (c3[2] + wt * c4[2])));
+    tdstcol[3] = 1.0f;
+  }
+}
+
 void GlareStreaksOperation::generateGlare(float *data,
                                           MemoryBuffer *inputTile,
                                           NodeGlare *settings)
 {
-  int x, y, n;
+  int n;
   unsigned int nump = 0;
-  float c1[4], c2[4], c3[4], c4[4];
   float a, ang = DEG2RADF(360.0f) / (float)settings->streaks;
 
   int size = inputTile->getWidth() * inputTile->getHeight();
@@ -49,38 +99,14 @@ void GlareStreaksOperation::generateGlare(float *data,
                         (float)pow((double)settings->colmod,
                                    (double)n +
                                        1);  // colormodulation amount relative to current pass
-      float *tdstcol = tdst->getBuffer();
-      for (y = 0; y < tsrc->getHeight() && (!breaked); y++) {
-        for (x = 0; x < tsrc->getWidth(); x++, tdstcol += 4) {
-          // first pass no offset, always same for every pass, exact copy,
-          // otherwise results in uneven brightness, only need once
-          if (n == 0) {
-            tsrc->read(c1, x, y);
-          }
-          else {
-            c1[0] = c1[1] = c1[2] = 0;
-          }
-          tsrc->readBilinear(c2, x + vxp, y + vyp);
-          tsrc->readBilinear(c3, x + vxp * 2.0f, y + vyp * 2.0f);
-          tsrc->readBilinear(c4, x + vxp * 3.0f, y + vyp * 3.0f);
-          // modulate color to look vaguely similar to a color spectrum
-          c2[1] *= cmo;
-          c2[2] *= cmo;
-
-          c3[0] *= cmo;
-          c3[1] *= cmo;
-
-          c4[0] *= cmo;
-          c4[2] *= cmo;
-
-          tdstcol[0] = 0.5f * (tdstcol[0] + c1[0] + wt * (c2[0] + wt * (c3[0] + wt * c4[0])));
-          tdstcol[1] = 0.5f * (tdstcol[1] + c1[1] + wt * (c2[1] + wt * (c3[1] + wt * c4[1])));
-          tdstcol[2] = 0.5f * (tdstcol[2] + c1[2] + wt * (c2[2] + wt * (c3[2] + wt * c4[2])));
-          tdstcol[3] = 1.0f;
-        }
-        if (isBraked()) {
-          breaked = true;
-        }
+      GlareStreaksPass pass = {tsrc, tdst, n, vxp, vyp, wt, cmo};
+      TaskParallelSettings parallel_settings;
+      BLI_parallel_range_settings_defaults(&parallel_settings);
+      parallel_settings.min_iter_per_thread = 8;
+      BLI_task_parallel_range(
+          0, tsrc->getHeight(), &pass, glare_streaks_pass_row, &parallel_settings);
+      if (isBraked()) {
+        breaked = true;
       }
       memcpy(tsrc->getBuffer(), tdst->getBuffer(), sizeof(float) * size4);
     }
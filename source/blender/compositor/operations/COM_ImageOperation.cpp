@@ -17,6 +17,7 @@
  */
 
 #include "COM_ImageOperation.h"
+#include "COM_ResultCache.h"
 
 #include "BLI_listbase.h"
 #include "DNA_image_types.h"
@@ -97,6 +98,28 @@ void BaseImageOperation::initExecution()
   }
 }
 
+bool BaseImageOperation::hashSettings(ResultCacheKey *key)
+{
+  key->addPointer(this->m_image);
+  key->addInt(this->m_framenumber);
+  key->addString(this->m_viewName);
+  if (this->m_buffer == NULL) {
+    return true;
+  }
+
+  /* The pixels of the image can change without the node changing (reloading, painting),
+   * the buffer gets a new timestamp whenever they do. */
+  key->addPointer(this->m_buffer);
+  key->addInt(this->m_buffer->changed_timestamp);
+  key->addInt(this->m_imagewidth);
+  key->addInt(this->m_imageheight);
+  key->addInt(this->m_numberOfChannels);
+  key->addInt(this->m_imageFloatBuffer != NULL);
+  key->addInt(this->m_depthBuffer != NULL);
+  key->addPointer(this->m_buffer->rect_colorspace);
+  return true;
+}
+
 void BaseImageOperation::deinitExecution()
 {
   this->m_imageFloatBuffer = NULL;
@@ -84,6 +84,12 @@ class KeyingScreenOperation : public NodeOperation {
   }
 
   void executePixel(float output[4], int x, int y, void *data);
+
+  /* not cached, the screen is built from the tracks of the movie clip */
+  bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return false;
+  }
 };
 
 #endif
@@ -93,6 +93,12 @@ class MaskOperation : public NodeOperation {
   }
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+  /* not cached, the mask data-block can change without the node changing */
+  bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return false;
+  }
 };
 
 #endif
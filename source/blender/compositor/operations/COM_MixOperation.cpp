@@ -101,19 +101,24 @@ void MixBaseOperation::deinitExecution()
 
 MixAddOperation::MixAddOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixAddOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixAddOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixAddOperation>(output, area, inputs);
+}
 
+void MixAddOperation::mixPixel(float output[4],
+                               const float *inputValue,
+                               const float inputColor1[4],
+                               const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -126,11 +131,16 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
   clampIfNeeded(output);
 }
 
+Float4 MixAddOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  return inputColor1 + inputValue * inputColor2;
+}
+
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixBlendOperation::executePixelSampled(float output[4],
@@ -138,15 +148,20 @@ void MixBlendOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-  float value;
+  mixPixelSampled<MixBlendOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-  value = inputValue[0];
+void MixBlendOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixBlendOperation>(output, area, inputs);
+}
+
+void MixBlendOperation::mixPixel(float output[4],
+                                 const float *inputValue,
+                                 const float inputColor1[4],
+                                 const float inputColor2[4])
+{
+  float value = inputValue[0];
 
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -160,11 +175,17 @@ void MixBlendOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixBlendOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 valuem = float4_set1(1.0f) - inputValue;
+  return valuem * inputColor1 + inputValue * inputColor2;
+}
+
 /* ******** Mix Burn Operation ******** */
 
 MixColorBurnOperation::MixColorBurnOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixColorBurnOperation::executePixelSampled(float output[4],
@@ -172,14 +193,20 @@ void MixColorBurnOperation::executePixelSampled(float output[4],
                                                 float y,
                                                 PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-  float tmp;
+  mixPixelSampled<MixColorBurnOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixColorBurnOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixColorBurnOperation>(output, area, inputs);
+}
+
+void MixColorBurnOperation::mixPixel(float output[4],
+                                     const float *inputValue,
+                                     const float inputColor1[4],
+                                     const float inputColor2[4])
+{
+  float tmp;
 
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
@@ -243,11 +270,23 @@ void MixColorBurnOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixColorBurnOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 zero = float4_set1(0.0f);
+  const Float4 one = float4_set1(1.0f);
+  const Float4 valuem = one - inputValue;
+  const Float4 tmp = valuem + inputValue * inputColor2;
+  Float4 result = one - (one - inputColor1) / tmp;
+  result = float4_select(float4_lt(result, zero), zero, result);
+  result = float4_select(float4_gt(result, one), one, result);
+  return float4_select(float4_le(tmp, zero), zero, result);
+}
+
 /* ******** Mix Color Operation ******** */
 
 MixColorOperation::MixColorOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixColorOperation::executePixelSampled(float output[4],
@@ -255,14 +294,19 @@ void MixColorOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixColorOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixColorOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixArea<MixColorOperation>(output, area, inputs);
+}
 
+void MixColorOperation::mixPixel(float output[4],
+                                 const float *inputValue,
+                                 const float inputColor1[4],
+                                 const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -292,7 +336,7 @@ void MixColorOperation::executePixelSampled(float output[4],
 
 MixDarkenOperation::MixDarkenOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixDarkenOperation::executePixelSampled(float output[4],
@@ -300,14 +344,19 @@ void MixDarkenOperation::executePixelSampled(float output[4],
                                              float y,
                                              PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixDarkenOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixDarkenOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixDarkenOperation>(output, area, inputs);
+}
 
+void MixDarkenOperation::mixPixel(float output[4],
+                                  const float *inputValue,
+                                  const float inputColor1[4],
+                                  const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -321,11 +370,17 @@ void MixDarkenOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixDarkenOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 valuem = float4_set1(1.0f) - inputValue;
+  return float4_min(inputColor1, inputColor2) * inputValue + inputColor1 * valuem;
+}
+
 /* ******** Mix Difference Operation ******** */
 
 MixDifferenceOperation::MixDifferenceOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixDifferenceOperation::executePixelSampled(float output[4],
@@ -333,14 +388,19 @@ void MixDifferenceOperation::executePixelSampled(float output[4],
                                                  float y,
                                                  PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixDifferenceOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixDifferenceOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixDifferenceOperation>(output, area, inputs);
+}
 
+void MixDifferenceOperation::mixPixel(float output[4],
+                                      const float *inputValue,
+                                      const float inputColor1[4],
+                                      const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -354,11 +414,17 @@ void MixDifferenceOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixDifferenceOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 valuem = float4_set1(1.0f) - inputValue;
+  return valuem * inputColor1 + inputValue * float4_abs(inputColor1 - inputColor2);
+}
+
 /* ******** Mix Difference Operation ******** */
 
 MixDivideOperation::MixDivideOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixDivideOperation::executePixelSampled(float output[4],
@@ -366,14 +432,19 @@ void MixDivideOperation::executePixelSampled(float output[4],
                                              float y,
                                              PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixDivideOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixDivideOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixDivideOperation>(output, area, inputs);
+}
 
+void MixDivideOperation::mixPixel(float output[4],
+                                  const float *inputValue,
+                                  const float inputColor1[4],
+                                  const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -404,11 +475,19 @@ void MixDivideOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixDivideOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 zero = float4_set1(0.0f);
+  const Float4 valuem = float4_set1(1.0f) - inputValue;
+  const Float4 result = valuem * inputColor1 + inputValue * inputColor1 / inputColor2;
+  return float4_select(float4_neq(inputColor2, zero), result, zero);
+}
+
 /* ******** Mix Dodge Operation ******** */
 
 MixDodgeOperation::MixDodgeOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixDodgeOperation::executePixelSampled(float output[4],
@@ -416,14 +495,20 @@ void MixDodgeOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-  float tmp;
+  mixPixelSampled<MixDodgeOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixDodgeOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixDodgeOperation>(output, area, inputs);
+}
+
+void MixDodgeOperation::mixPixel(float output[4],
+                                 const float *inputValue,
+                                 const float inputColor1[4],
+                                 const float inputColor2[4])
+{
+  float tmp;
 
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
@@ -492,27 +577,46 @@ void MixDodgeOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixDodgeOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 zero = float4_set1(0.0f);
+  const Float4 one = float4_set1(1.0f);
+  const Float4 tmp = one - inputValue * inputColor2;
+  Float4 result = inputColor1 / tmp;
+  result = float4_select(float4_gt(result, one), one, result);
+  result = float4_select(float4_le(tmp, zero), one, result);
+  return float4_select(float4_neq(inputColor1, zero), result, zero);
+}
+
 /* ******** Mix Glare Operation ******** */
 
 MixGlareOperation::MixGlareOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixGlareOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
                                             PixelSampler sampler)
+{
+  mixPixelSampled<MixGlareOperation>(output, x, y, sampler);
+}
+
+void MixGlareOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixArea<MixGlareOperation>(output, area, inputs);
+}
+
+void MixGlareOperation::mixPixel(float output[4],
+                                 const float *inputValue,
+                                 const float color1[4],
+                                 const float inputColor2[4])
 {
   float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-  float value;
+  copy_v4_v4(inputColor1, color1);
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-  value = inputValue[0];
+  float value = inputValue[0];
   float mf = 2.0f - 2.0f * fabsf(value - 0.5f);
 
   if (inputColor1[0] < 0.0f) {
@@ -537,19 +641,24 @@ void MixGlareOperation::executePixelSampled(float output[4],
 
 MixHueOperation::MixHueOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixHueOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixHueOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixHueOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixArea<MixHueOperation>(output, area, inputs);
+}
 
+void MixHueOperation::mixPixel(float output[4],
+                               const float *inputValue,
+                               const float inputColor1[4],
+                               const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -579,7 +688,7 @@ void MixHueOperation::executePixelSampled(float output[4], float x, float y, Pix
 
 MixLightenOperation::MixLightenOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixLightenOperation::executePixelSampled(float output[4],
@@ -587,14 +696,19 @@ void MixLightenOperation::executePixelSampled(float output[4],
                                               float y,
                                               PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixLightenOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixLightenOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixLightenOperation>(output, area, inputs);
+}
 
+void MixLightenOperation::mixPixel(float output[4],
+                                   const float *inputValue,
+                                   const float inputColor1[4],
+                                   const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -626,11 +740,17 @@ void MixLightenOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixLightenOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 tmp = inputValue * inputColor2;
+  return float4_max(tmp, inputColor1);
+}
+
 /* ******** Mix Linear Light Operation ******** */
 
 MixLinearLightOperation::MixLinearLightOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixLinearLightOperation::executePixelSampled(float output[4],
@@ -638,14 +758,19 @@ void MixLinearLightOperation::executePixelSampled(float output[4],
                                                   float y,
                                                   PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixLinearLightOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixLinearLightOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixLinearLightOperation>(output, area, inputs);
+}
 
+void MixLinearLightOperation::mixPixel(float output[4],
+                                       const float *inputValue,
+                                       const float inputColor1[4],
+                                       const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -674,11 +799,23 @@ void MixLinearLightOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixLinearLightOperation::mixFloat4(Float4 inputValue,
+                                          Float4 inputColor1,
+                                          Float4 inputColor2)
+{
+  const Float4 one = float4_set1(1.0f);
+  const Float4 two = float4_set1(2.0f);
+  const Float4 half = float4_set1(0.5f);
+  return float4_select(float4_gt(inputColor2, half),
+                       inputColor1 + inputValue * (two * (inputColor2 - half)),
+                       inputColor1 + inputValue * (two * inputColor2 - one));
+}
+
 /* ******** Mix Multiply Operation ******** */
 
 MixMultiplyOperation::MixMultiplyOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixMultiplyOperation::executePixelSampled(float output[4],
@@ -686,14 +823,19 @@ void MixMultiplyOperation::executePixelSampled(float output[4],
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixMultiplyOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixMultiplyOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixMultiplyOperation>(output, area, inputs);
+}
 
+void MixMultiplyOperation::mixPixel(float output[4],
+                                    const float *inputValue,
+                                    const float inputColor1[4],
+                                    const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -707,11 +849,17 @@ void MixMultiplyOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixMultiplyOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 valuem = float4_set1(1.0f) - inputValue;
+  return inputColor1 * (valuem + inputValue * inputColor2);
+}
+
 /* ******** Mix Ovelray Operation ******** */
 
 MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixOverlayOperation::executePixelSampled(float output[4],
@@ -719,14 +867,19 @@ void MixOverlayOperation::executePixelSampled(float output[4],
                                               float y,
                                               PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixOverlayOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixOverlayOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixOverlayOperation>(output, area, inputs);
+}
 
+void MixOverlayOperation::mixPixel(float output[4],
+                                   const float *inputValue,
+                                   const float inputColor1[4],
+                                   const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -757,11 +910,22 @@ void MixOverlayOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixOverlayOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 one = float4_set1(1.0f);
+  const Float4 two = float4_set1(2.0f);
+  const Float4 valuem = one - inputValue;
+  return float4_select(
+      float4_lt(inputColor1, float4_set1(0.5f)),
+      inputColor1 * (valuem + two * inputValue * inputColor2),
+      one - (valuem + two * inputValue * (one - inputColor2)) * (one - inputColor1));
+}
+
 /* ******** Mix Saturation Operation ******** */
 
 MixSaturationOperation::MixSaturationOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixSaturationOperation::executePixelSampled(float output[4],
@@ -769,14 +933,19 @@ void MixSaturationOperation::executePixelSampled(float output[4],
                                                  float y,
                                                  PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixSaturationOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixSaturationOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixArea<MixSaturationOperation>(output, area, inputs);
+}
 
+void MixSaturationOperation::mixPixel(float output[4],
+                                      const float *inputValue,
+                                      const float inputColor1[4],
+                                      const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -803,7 +972,7 @@ void MixSaturationOperation::executePixelSampled(float output[4],
 
 MixScreenOperation::MixScreenOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixScreenOperation::executePixelSampled(float output[4],
@@ -811,14 +980,19 @@ void MixScreenOperation::executePixelSampled(float output[4],
                                              float y,
                                              PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixScreenOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixScreenOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixScreenOperation>(output, area, inputs);
+}
 
+void MixScreenOperation::mixPixel(float output[4],
+                                  const float *inputValue,
+                                  const float inputColor1[4],
+                                  const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -833,11 +1007,18 @@ void MixScreenOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixScreenOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 one = float4_set1(1.0f);
+  const Float4 valuem = one - inputValue;
+  return one - (valuem + inputValue * (one - inputColor2)) * (one - inputColor1);
+}
+
 /* ******** Mix Soft Light Operation ******** */
 
 MixSoftLightOperation::MixSoftLightOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixSoftLightOperation::executePixelSampled(float output[4],
@@ -845,14 +1026,19 @@ void MixSoftLightOperation::executePixelSampled(float output[4],
                                                 float y,
                                                 PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixSoftLightOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixSoftLightOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixSoftLightOperation>(output, area, inputs);
+}
 
+void MixSoftLightOperation::mixPixel(float output[4],
+                                     const float *inputValue,
+                                     const float inputColor1[4],
+                                     const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -879,11 +1065,21 @@ void MixSoftLightOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixSoftLightOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  const Float4 one = float4_set1(1.0f);
+  const Float4 valuem = one - inputValue;
+  /* first calculate non-fac based Screen mix */
+  const Float4 screen = one - (one - inputColor2) * (one - inputColor1);
+  return valuem * inputColor1 +
+         inputValue * (((one - inputColor1) * inputColor2 * inputColor1) + (inputColor1 * screen));
+}
+
 /* ******** Mix Subtract Operation ******** */
 
 MixSubtractOperation::MixSubtractOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixSubtractOperation::executePixelSampled(float output[4],
@@ -891,14 +1087,19 @@ void MixSubtractOperation::executePixelSampled(float output[4],
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixSubtractOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixSubtractOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixAreaFloat4<MixSubtractOperation>(output, area, inputs);
+}
 
+void MixSubtractOperation::mixPixel(float output[4],
+                                    const float *inputValue,
+                                    const float inputColor1[4],
+                                    const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
@@ -911,11 +1112,16 @@ void MixSubtractOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+Float4 MixSubtractOperation::mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2)
+{
+  return inputColor1 - inputValue * inputColor2;
+}
+
 /* ******** Mix Value Operation ******** */
 
 MixValueOperation::MixValueOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setAreaExecution(true);
 }
 
 void MixValueOperation::executePixelSampled(float output[4],
@@ -923,14 +1129,19 @@ void MixValueOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
+  mixPixelSampled<MixValueOperation>(output, x, y, sampler);
+}
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+void MixValueOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+{
+  mixArea<MixValueOperation>(output, area, inputs);
+}
 
+void MixValueOperation::mixPixel(float output[4],
+                                 const float *inputValue,
+                                 const float inputColor1[4],
+                                 const float inputColor2[4])
+{
   float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
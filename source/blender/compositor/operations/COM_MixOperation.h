@@ -19,6 +19,7 @@
 #ifndef __COM_MIXOPERATION_H__
 #define __COM_MIXOPERATION_H__
 #include "COM_NodeOperation.h"
+#include "COM_SIMD.h"
 
 /**
  * All this programs converts an input color to an output value.
@@ -46,6 +47,78 @@ class MixBaseOperation : public NodeOperation {
     }
   }
 
+  /**
+   * Read the inputs of a pixel and mix them with the mixPixel function of operation type T.
+   */
+  template<typename T>
+  inline void mixPixelSampled(float output[4], float x, float y, PixelSampler sampler)
+  {
+    float inputValue[4];
+    float inputColor1[4];
+    float inputColor2[4];
+
+    this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
+    this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
+    this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+
+    static_cast<T *>(this)->mixPixel(output, inputValue, inputColor1, inputColor2);
+  }
+
+  /**
+   * Mix the input buffers of an area row by row with the mixPixel function of operation type T,
+   * the call is not virtual so the function can be inlined into the loop.
+   */
+  template<typename T> inline void mixArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+  {
+    for (int y = area->ymin; y < area->ymax; y++) {
+      float *out = output->getElem(area->xmin, y);
+      const float *value = inputs[0]->getElem(area->xmin, y);
+      const float *color1 = inputs[1]->getElem(area->xmin, y);
+      const float *color2 = inputs[2]->getElem(area->xmin, y);
+      for (int x = area->xmin; x < area->xmax; x++) {
+        static_cast<T *>(this)->mixPixel(out, value, color1, color2);
+        out += COM_NUM_CHANNELS_COLOR;
+        value += COM_NUM_CHANNELS_VALUE;
+        color1 += COM_NUM_CHANNELS_COLOR;
+        color2 += COM_NUM_CHANNELS_COLOR;
+      }
+    }
+  }
+
+  /**
+   * Mix the input buffers of an area row by row with the mixFloat4 function of operation type T,
+   * which mixes all channels of a pixel at once. Multiplying the value by the alpha of the second
+   * color, keeping the alpha of the first color and clamping are done here, like in mixPixel.
+   */
+  template<typename T>
+  inline void mixAreaFloat4(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs)
+  {
+    for (int y = area->ymin; y < area->ymax; y++) {
+      float *out = output->getElem(area->xmin, y);
+      const float *value = inputs[0]->getElem(area->xmin, y);
+      const float *color1 = inputs[1]->getElem(area->xmin, y);
+      const float *color2 = inputs[2]->getElem(area->xmin, y);
+      for (int x = area->xmin; x < area->xmax; x++) {
+        const Float4 inputColor1 = float4_load(color1);
+        const Float4 inputColor2 = float4_load(color2);
+        Float4 inputValue = float4_set1(value[0]);
+        if (this->m_valueAlphaMultiply) {
+          inputValue = inputValue * float4_alpha(inputColor2);
+        }
+        Float4 result = static_cast<T *>(this)->mixFloat4(inputValue, inputColor1, inputColor2);
+        result = float4_with_alpha(result, inputColor1);
+        if (this->m_useClamp) {
+          result = float4_clamp01(result);
+        }
+        float4_store(out, result);
+        out += COM_NUM_CHANNELS_COLOR;
+        value += COM_NUM_CHANNELS_VALUE;
+        color1 += COM_NUM_CHANNELS_COLOR;
+        color2 += COM_NUM_CHANNELS_COLOR;
+      }
+    }
+  }
+
  public:
   /**
    * Default constructor
@@ -87,114 +160,223 @@ class MixAddOperation : public MixBaseOperation {
  public:
   MixAddOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixBlendOperation : public MixBaseOperation {
  public:
   MixBlendOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixColorBurnOperation : public MixBaseOperation {
  public:
   MixColorBurnOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixColorOperation : public MixBaseOperation {
  public:
   MixColorOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
 };
 
 class MixDarkenOperation : public MixBaseOperation {
  public:
   MixDarkenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixDifferenceOperation : public MixBaseOperation {
  public:
   MixDifferenceOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixDivideOperation : public MixBaseOperation {
  public:
   MixDivideOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixDodgeOperation : public MixBaseOperation {
  public:
   MixDodgeOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixGlareOperation : public MixBaseOperation {
  public:
   MixGlareOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
 };
 
 class MixHueOperation : public MixBaseOperation {
  public:
   MixHueOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
 };
 
 class MixLightenOperation : public MixBaseOperation {
  public:
   MixLightenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixLinearLightOperation : public MixBaseOperation {
  public:
   MixLinearLightOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixMultiplyOperation : public MixBaseOperation {
  public:
   MixMultiplyOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
  public:
   MixOverlayOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixSaturationOperation : public MixBaseOperation {
  public:
   MixSaturationOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
 };
 
 class MixScreenOperation : public MixBaseOperation {
  public:
   MixScreenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixSoftLightOperation : public MixBaseOperation {
  public:
   MixSoftLightOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixSubtractOperation : public MixBaseOperation {
  public:
   MixSubtractOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
+  Float4 mixFloat4(Float4 inputValue, Float4 inputColor1, Float4 inputColor2);
 };
 
 class MixValueOperation : public MixBaseOperation {
  public:
   MixValueOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+  void mixPixel(float output[4],
+                const float *inputValue,
+                const float inputColor1[4],
+                const float inputColor2[4]);
 };
 
 #endif
@@ -69,5 +69,11 @@ class MovieClipAttributeOperation : public NodeOperation {
   {
     this->m_invert = invert;
   }
+
+  /* not cached, stabilization data is read from the movie clip */
+  bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return false;
+  }
 };
 #endif
@@ -65,6 +65,12 @@ class MovieClipBaseOperation : public NodeOperation {
     this->m_framenumber = framenumber;
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+  /* not cached, movie frames are not hashed */
+  bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return false;
+  }
 };
 
 class MovieClipOperation : public MovieClipBaseOperation {
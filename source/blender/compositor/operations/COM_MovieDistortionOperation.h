@@ -59,6 +59,12 @@ class MovieDistortionOperation : public NodeOperation {
   bool determineDependingAreaOfInterest(rcti *input,
                                         ReadBufferOperation *readOperation,
                                         rcti *output);
+
+  /* not cached, the camera intrinsics are read from the movie clip */
+  bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return false;
+  }
 };
 
 #endif
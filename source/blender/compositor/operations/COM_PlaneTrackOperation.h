@@ -78,6 +78,12 @@ class PlaneTrackMaskOperation : public PlaneDistortMaskOperation, public PlaneTr
     unsigned int temp[2];
     NodeOperation::determineResolution(temp, resolution);
   }
+
+  /* not cached, plane tracks are read from the movie clip */
+  bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return false;
+  }
 };
 
 class PlaneTrackWarpImageOperation : public PlaneDistortWarpImageOperation,
@@ -95,6 +101,12 @@ class PlaneTrackWarpImageOperation : public PlaneDistortWarpImageOperation,
     unsigned int temp[2];
     NodeOperation::determineResolution(temp, resolution);
   }
+
+  /* not cached, plane tracks are read from the movie clip */
+  bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return false;
+  }
 };
 
 #endif
@@ -26,6 +26,7 @@ ReadBufferOperation::ReadBufferOperation(DataType datatype) : NodeOperation()
   this->m_single_value = false;
   this->m_offset = 0;
   this->m_buffer = NULL;
+  this->setAreaExecution(true);
 }
 
 void *ReadBufferOperation::initializeTileData(rcti * /*rect*/)
@@ -107,6 +108,28 @@ void ReadBufferOperation::executePixelFiltered(
   }
 }
 
+void ReadBufferOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer ** /*inputs*/)
+{
+  if (m_single_value) {
+    /* write buffer has a single value stored at (0,0) */
+    float value[4];
+    m_buffer->read(value, 0, 0);
+    output->fill(area, value);
+  }
+  else {
+    output->copyArea(m_buffer, area);
+  }
+}
+
+MemoryBuffer *ReadBufferOperation::getAreaBuffer(rcti *area)
+{
+  /* Half float buffers are converted by copying the area. */
+  if (m_single_value || m_buffer->isHalf() || !BLI_rcti_inside_rcti(m_buffer->getRect(), area)) {
+    return NULL;
+  }
+  return m_buffer;
+}
+
 bool ReadBufferOperation::determineDependingAreaOfInterest(rcti *input,
                                                            ReadBufferOperation *readOperation,
                                                            rcti *output)
@@ -51,6 +51,13 @@ class ReadBufferOperation : public NodeOperation {
                           MemoryBufferExtend extend_x,
                           MemoryBufferExtend extend_y);
   void executePixelFiltered(float output[4], float x, float y, float dx[2], float dy[2]);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+
+  /**
+   * \brief the buffer of the write operation, when it can be read directly for an area
+   * \return NULL when the area needs to be copied
+   */
+  MemoryBuffer *getAreaBuffer(rcti *area);
   bool isReadBufferOperation() const
   {
     return true;
@@ -17,6 +17,7 @@
  */
 
 #include "COM_RenderLayersProg.h"
+#include "COM_ResultCache.h"
 
 #include "BLI_listbase.h"
 #include "BKE_scene.h"
@@ -35,6 +36,7 @@ RenderLayersProg::RenderLayersProg(const char *passName, DataType type, int elem
 {
   this->setScene(NULL);
   this->m_inputBuffer = NULL;
+  this->m_resultTimestamp = 0;
   this->m_elementsize = elementsize;
   this->m_rd = NULL;
 
@@ -61,6 +63,7 @@ void RenderLayersProg::initExecution()
             rl, this->m_passName.c_str(), this->m_viewName);
       }
     }
+    this->m_resultTimestamp = rr->changed_timestamp;
   }
   if (re) {
     RE_ReleaseResult(re);
@@ -68,6 +71,23 @@ void RenderLayersProg::initExecution()
   }
 }
 
+bool RenderLayersProg::hashSettings(ResultCacheKey *key)
+{
+  key->addPointer(this->m_scene);
+  key->addInt(this->m_layerId);
+  key->addString(this->m_passName.c_str());
+  key->addString(this->m_viewName);
+  if (this->m_inputBuffer == NULL) {
+    return true;
+  }
+
+  /* Every render replaces the pixels of the pass and gives the result a new timestamp. */
+  key->addPointer(this->m_inputBuffer);
+  key->addInt(this->m_resultTimestamp);
+  key->addInt(this->m_elementsize);
+  return true;
+}
+
 void RenderLayersProg::doInterpolation(float output[4], float x, float y, PixelSampler sampler)
 {
   unsigned int offset;
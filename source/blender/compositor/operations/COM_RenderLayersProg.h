@@ -55,6 +55,11 @@ class RenderLayersProg : public NodeOperation {
    */
   float *m_inputBuffer;
 
+  /**
+   * timestamp of the render result the buffer was taken from, changes with its passes
+   */
+  unsigned int m_resultTimestamp;
+
   /**
    * renderpass where this operation needs to get its data from
    */
@@ -122,6 +127,7 @@ class RenderLayersProg : public NodeOperation {
   }
   void initExecution();
   void deinitExecution();
+  bool hashSettings(ResultCacheKey *key);
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
 };
 
@@ -17,10 +17,12 @@
  */
 
 #include "COM_SetColorOperation.h"
+#include "COM_ResultCache.h"
 
 SetColorOperation::SetColorOperation() : NodeOperation()
 {
   this->addOutputSocket(COM_DT_COLOR);
+  this->setAreaExecution(true);
 }
 
 void SetColorOperation::executePixelSampled(float output[4],
@@ -31,9 +33,20 @@ void SetColorOperation::executePixelSampled(float output[4],
   copy_v4_v4(output, this->m_color);
 }
 
+void SetColorOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer ** /*inputs*/)
+{
+  output->fill(area, this->m_color);
+}
+
 void SetColorOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
   resolution[0] = preferredResolution[0];
   resolution[1] = preferredResolution[1];
 }
+
+bool SetColorOperation::hashSettings(ResultCacheKey *key)
+{
+  key->add(this->m_color, sizeof(this->m_color));
+  return true;
+}
@@ -17,10 +17,12 @@
  */
 
 #include "COM_SetValueOperation.h"
+#include "COM_ResultCache.h"
 
 SetValueOperation::SetValueOperation() : NodeOperation()
 {
   this->addOutputSocket(COM_DT_VALUE);
+  this->setAreaExecution(true);
 }
 
 void SetValueOperation::executePixelSampled(float output[4],
@@ -31,9 +33,20 @@ void SetValueOperation::executePixelSampled(float output[4],
   output[0] = this->m_value;
 }
 
+void SetValueOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer ** /*inputs*/)
+{
+  output->fill(area, &this->m_value);
+}
+
 void SetValueOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
   resolution[0] = preferredResolution[0];
   resolution[1] = preferredResolution[1];
 }
+
+bool SetValueOperation::hashSettings(ResultCacheKey *key)
+{
+  key->addFloat(this->m_value);
+  return true;
+}
@@ -47,7 +47,9 @@ class SetValueOperation : public NodeOperation {
    * the inner loop of this program
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
   void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
+  bool hashSettings(ResultCacheKey *key);
 
   bool isSetOperation() const
   {
@@ -17,11 +17,13 @@
  */
 
 #include "COM_SetVectorOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_defines.h"
 
 SetVectorOperation::SetVectorOperation() : NodeOperation()
 {
   this->addOutputSocket(COM_DT_VECTOR);
+  this->setAreaExecution(true);
 }
 
 void SetVectorOperation::executePixelSampled(float output[4],
@@ -34,9 +36,24 @@ void SetVectorOperation::executePixelSampled(float output[4],
   output[2] = this->m_z;
 }
 
+void SetVectorOperation::executeArea(MemoryBuffer *output, rcti *area, MemoryBuffer ** /*inputs*/)
+{
+  const float vector[3] = {this->m_x, this->m_y, this->m_z};
+  output->fill(area, vector);
+}
+
 void SetVectorOperation::determineResolution(unsigned int resolution[2],
                                              unsigned int preferredResolution[2])
 {
   resolution[0] = preferredResolution[0];
   resolution[1] = preferredResolution[1];
 }
+
+bool SetVectorOperation::hashSettings(ResultCacheKey *key)
+{
+  key->addFloat(this->m_x);
+  key->addFloat(this->m_y);
+  key->addFloat(this->m_z);
+  key->addFloat(this->m_w);
+  return true;
+}
@@ -71,6 +71,12 @@ class TextureBaseOperation : public NodeOperation {
   {
     this->m_sceneColorManage = sceneColorManage;
   }
+
+  /* not cached, texture data-blocks are evaluated outside of the node tree */
+  bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return false;
+  }
 };
 
 class TextureOperation : public TextureBaseOperation {
@@ -96,6 +96,12 @@ class TrackPositionOperation : public NodeOperation {
   {
     return true;
   }
+
+  /* not cached, track positions are read from the movie clip */
+  bool hashSettings(ResultCacheKey * /*key*/)
+  {
+    return false;
+  }
 };
 
 #endif
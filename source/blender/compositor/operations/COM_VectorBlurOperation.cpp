@@ -21,6 +21,7 @@
 #include "BLI_math.h"
 extern "C" {
 #include "BLI_jitter_2d.h"
+#include "BLI_task.h"
 }
 #include "COM_VectorBlurOperation.h"
 
@@ -146,6 +147,9 @@ typedef struct ZSpan {
   /* range for clipping */
   int rectx, recty;
 
+  /* rows that are filled in, spans are still calculated for the full range */
+  int miny, maxy;
+
   /* actual filled in range */
   int miny1, maxy1, miny2, maxy2;
   /* vertex pointers detect min/max range in */
@@ -169,6 +173,9 @@ void zbuf_alloc_span(ZSpan *zspan, int rectx, int recty, float clipcrop)
   zspan->rectx = rectx;
   zspan->recty = recty;
 
+  zspan->miny = 0;
+  zspan->maxy = recty;
+
   zspan->span1 = (float *)MEM_mallocN(recty * sizeof(float), "zspan");
   zspan->span2 = (float *)MEM_mallocN(recty * sizeof(float), "zspan");
 
@@ -373,6 +380,13 @@ static void zbuf_fill_in_rgba(
 
   for (y = my2; y >= my0; y--, span1--, span2--) {
 
+    if (y < zspan->miny || y >= zspan->maxy) {
+      zy0 -= zyd;
+      rectzofs -= rectx;
+      rectpofs -= rectx;
+      continue;
+    }
+
     sn1 = floor(*span1);
     sn2 = floor(*span2);
     sn1++;
@@ -541,6 +555,212 @@ static void set_quad_bezier_ipo(float fac, float *data)
   data[2] = fac * fac;
 }
 
+typedef struct VecBlurData {
+  NodeBlurData *nbd;
+  int xsize, ysize, samples;
+  float *newrect;
+  const float *imgrect, *zbufrect;
+  float *rectvz;
+  const float *rowspeed;
+  float *rectz;
+  DrawBufPixel *rectdraw;
+  float *rectweight, *rectmax;
+  const char *rectmove;
+  const float (*jit)[2];
+} VecBlurData;
+
+#define VECBLUR_BAND_SIZE 64
+
+static void zbuf_accumulate_vecblur_band(void *__restrict userdata,
+                                         const int band,
+                                         const TaskParallelTLS *__restrict /*tls*/)
+{
+  const VecBlurData *data = (const VecBlurData *)userdata;
+  NodeBlurData *nbd = data->nbd;
+  const int xsize = data->xsize, ysize = data->ysize, samples = data->samples;
+  const float(*jit)[2] = data->jit;
+  float *rectz = data->rectz;
+  DrawBufPixel *rectdraw = data->rectdraw, *dr;
+  const char *rectmove = data->rectmove, *dm;
+  const float *zbufrect = data->zbufrect;
+  const float *dimg, *dz, *ro;
+  float *dz1, *dz2;
+  float *rw, *rm, *dacc;
+  float v1[3], v2[3], v3[3], v4[3], fx, fy;
+  int x, y, step;
+  ZSpan zspan;
+
+  const int miny = band * VECBLUR_BAND_SIZE;
+  const int maxy = min_ii(miny + VECBLUR_BAND_SIZE, ysize);
+  const int ofs = miny * xsize, len = (maxy - miny) * xsize;
+
+  zbuf_alloc_span(&zspan, xsize, ysize, 1.0f);
+  zspan.zmulx = ((float)xsize) / 2.0f;
+  zspan.zmuly = ((float)ysize) / 2.0f;
+  zspan.zofsx = 0.0f;
+  zspan.zofsy = 0.0f;
+  zspan.rectz = (int *)rectz;
+  zspan.rectdraw = rectdraw;
+  zspan.miny = miny;
+  zspan.maxy = maxy;
+
+  /* accumulate */
+  for (step = 1; step <= samples; step++) {
+    float speedfac = 0.5f * nbd->fac * (float)step / (float)(samples + 1);
+    int side;
+
+    for (side = 0; side < 2; side++) {
+      float blendfac, ipodata[4], rowfac;
+
+      /* clear zbuf, if we draw future we fill in not moving pixels */
+      for (x = ofs + len - 1; x >= ofs; x--) {
+        if (rectmove[x] == 0) {
+          rectz[x] = zbufrect[x];
+        }
+        else {
+          rectz[x] = 10e16;
+        }
+      }
+
+      /* clear drawing buffer */
+      for (x = ofs + len - 1; x >= ofs; x--) {
+        rectdraw[x].colpoin = NULL;
+      }
+
+      if (side) {
+        speedfac = -speedfac;
+      }
+
+      set_quad_bezier_ipo(0.5f + 0.5f * speedfac, ipodata);
+
+      /* how far the vertices of a face move relative to the largest speed of its row */
+      if (nbd->curved) {
+        rowfac = fabsf(ipodata[0]) + fabsf(ipodata[1]) + fabsf(ipodata[2]);
+      }
+      else {
+        rowfac = fabsf(speedfac);
+      }
+
+      for (fy = -0.5f + jit[step & 255][0], y = 0; y < ysize; y++, fy += 1.0f) {
+        const float rowofs = rowfac * data->rowspeed[y];
+
+        /* skip rows of faces that can not reach this band, with some margin for the jitter */
+        if ((float)y + 3.0f + rowofs < (float)miny || (float)y - 2.0f - rowofs >= (float)maxy) {
+          continue;
+        }
+
+        dimg = data->imgrect + 4 * y * xsize;
+        dm = rectmove + y * xsize;
+        dz = zbufrect + y * xsize;
+        dz1 = data->rectvz + 4 * y * (xsize + 1);
+        dz2 = dz1 + 4 * (xsize + 1);
+
+        if (side && nbd->curved == 0) {
+          dz1 += 2;
+          dz2 += 2;
+        }
+
+        for (fx = -0.5f + jit[step & 255][1], x = 0; x < xsize;
+             x++, fx += 1.0f, dimg += 4, dz1 += 4, dz2 += 4, dm++, dz++) {
+          if (*dm > 1) {
+            float jfx = fx + 0.5f;
+            float jfy = fy + 0.5f;
+            DrawBufPixel col;
+
+            /* make vertices */
+            if (nbd->curved) { /* curved */
+              quad_bezier_2d(v1, dz1, dz1 + 2, ipodata);
+              v1[0] += jfx;
+              v1[1] += jfy;
+              v1[2] = *dz;
+
+              quad_bezier_2d(v2, dz1 + 4, dz1 + 4 + 2, ipodata);
+              v2[0] += jfx + 1.0f;
+              v2[1] += jfy;
+              v2[2] = *dz;
+
+              quad_bezier_2d(v3, dz2 + 4, dz2 + 4 + 2, ipodata);
+              v3[0] += jfx + 1.0f;
+              v3[1] += jfy + 1.0f;
+              v3[2] = *dz;
+
+              quad_bezier_2d(v4, dz2, dz2 + 2, ipodata);
+              v4[0] += jfx;
+              v4[1] += jfy + 1.0f;
+              v4[2] = *dz;
+            }
+            else {
+              ARRAY_SET_ITEMS(v1, speedfac * dz1[0] + jfx, speedfac * dz1[1] + jfy, *dz);
+              ARRAY_SET_ITEMS(v2, speedfac * dz1[4] + jfx + 1.0f, speedfac * dz1[5] + jfy, *dz);
+              ARRAY_SET_ITEMS(
+                  v3, speedfac * dz2[4] + jfx + 1.0f, speedfac * dz2[5] + jfy + 1.0f, *dz);
+              ARRAY_SET_ITEMS(v4, speedfac * dz2[0] + jfx, speedfac * dz2[1] + jfy + 1.0f, *dz);
+            }
+            if (*dm == 255) {
+              col.alpha = 1.0f;
+            }
+            else if (*dm < 2) {
+              col.alpha = 0.0f;
+            }
+            else {
+              col.alpha = ((float)*dm) / 255.0f;
+            }
+            col.colpoin = dimg;
+
+            zbuf_fill_in_rgba(&zspan, &col, v1, v2, v3, v4);
+          }
+        }
+      }
+
+      /* blend with a falloff. this fixes the ugly effect you get with
+       * a fast moving object. then it looks like a solid object overlaid
+       * over a very transparent moving version of itself. in reality, the
+       * whole object should become transparent if it is moving fast, be
+       * we don't know what is behind it so we don't do that. this hack
+       * overestimates the contribution of foreground pixels but looks a
+       * bit better without a sudden cutoff. */
+      blendfac = ((samples - step) / (float)samples);
+      /* smoothstep to make it look a bit nicer as well */
+      blendfac = 3.0f * pow(blendfac, 2.0f) - 2.0f * pow(blendfac, 3.0f);
+
+      /* accum */
+      rw = data->rectweight + ofs;
+      rm = data->rectmax + ofs;
+      for (dr = rectdraw + ofs, dacc = data->newrect + 4 * ofs, x = len - 1; x >= 0;
+           x--, dr++, dacc += 4, rw++, rm++) {
+        if (dr->colpoin) {
+          float bfac = dr->alpha * blendfac;
+
+          dacc[0] += bfac * dr->colpoin[0];
+          dacc[1] += bfac * dr->colpoin[1];
+          dacc[2] += bfac * dr->colpoin[2];
+          dacc[3] += bfac * dr->colpoin[3];
+
+          *rw += bfac;
+          *rm = MAX2(*rm, bfac);
+        }
+      }
+    }
+  }
+
+  /* blend between original images and accumulated image */
+  rw = data->rectweight + ofs;
+  rm = data->rectmax + ofs;
+  ro = data->imgrect + 4 * ofs;
+  for (dacc = data->newrect + 4 * ofs, x = len - 1; x >= 0; x--, dacc += 4, ro += 4, rw++, rm++) {
+    float mfac = *rm;
+    float fac = (*rw == 0.0f) ? 0.0f : mfac / (*rw);
+    float nfac = 1.0f - mfac;
+
+    dacc[0] = fac * dacc[0] + nfac * ro[0];
+    dacc[1] = fac * dacc[1] + nfac * ro[1];
+    dacc[2] = fac * dacc[2] + nfac * ro[2];
+    dacc[3] = fac * dacc[3] + nfac * ro[3];
+  }
+
+  zbuf_free_span(&zspan);
+}
+
 void zbuf_accumulate_vecblur(NodeBlurData *nbd,
                              int xsize,
                              int ysize,
@@ -549,32 +769,22 @@ void zbuf_accumulate_vecblur(NodeBlurData *nbd,
                              float *vecbufrect,
                              const float *zbufrect)
 {
-  ZSpan zspan;
-  DrawBufPixel *rectdraw, *dr;
+  VecBlurData data;
+  DrawBufPixel *rectdraw;
   static float jit[256][2];
-  float v1[3], v2[3], v3[3], v4[3], fx, fy;
-  const float *dimg, *dz, *ro;
-  float *rectvz, *dvz, *dvec1, *dvec2, *dz1, *dz2, *rectz;
-  float *minvecbufrect = NULL, *rectweight, *rw, *rectmax, *rm;
+  float *rectvz, *dvz, *dvec1, *dvec2, *dz1, *dz2, *rectz, *rowspeed;
+  float *minvecbufrect = NULL, *rectweight, *rectmax;
   float maxspeedsq = (float)nbd->maxspeed * nbd->maxspeed;
   int y, x, step, maxspeed = nbd->maxspeed, samples = nbd->samples;
   int tsktsk = 0;
   static int firsttime = 1;
   char *rectmove, *dm;
 
-  zbuf_alloc_span(&zspan, xsize, ysize, 1.0f);
-  zspan.zmulx = ((float)xsize) / 2.0f;
-  zspan.zmuly = ((float)ysize) / 2.0f;
-  zspan.zofsx = 0.0f;
-  zspan.zofsy = 0.0f;
-
   /* the buffers */
   rectz = (float *)MEM_mapallocN(sizeof(float) * xsize * ysize, "zbuf accum");
-  zspan.rectz = (int *)rectz;
 
   rectmove = (char *)MEM_mapallocN(xsize * ysize, "rectmove");
   rectdraw = (DrawBufPixel *)MEM_mapallocN(sizeof(DrawBufPixel) * xsize * ysize, "rect draw");
-  zspan.rectdraw = rectdraw;
 
   rectweight = (float *)MEM_mapallocN(sizeof(float) * xsize * ysize, "rect weight");
   rectmax = (float *)MEM_mapallocN(sizeof(float) * xsize * ysize, "rect max");
@@ -738,155 +948,47 @@ void zbuf_accumulate_vecblur(NodeBlurData *nbd,
 
   memset(newrect, 0, sizeof(float) * xsize * ysize * 4);
 
-  /* accumulate */
-  samples /= 2;
-  for (step = 1; step <= samples; step++) {
-    float speedfac = 0.5f * nbd->fac * (float)step / (float)(samples + 1);
-    int side;
-
-    for (side = 0; side < 2; side++) {
-      float blendfac, ipodata[4];
-
-      /* clear zbuf, if we draw future we fill in not moving pixels */
-      if (0) {
-        for (x = xsize * ysize - 1; x >= 0; x--) {
-          rectz[x] = 10e16;
-        }
-      }
-      else {
-        for (x = xsize * ysize - 1; x >= 0; x--) {
-          if (rectmove[x] == 0) {
-            rectz[x] = zbufrect[x];
-          }
-          else {
-            rectz[x] = 10e16;
-          }
-        }
-      }
-
-      /* clear drawing buffer */
-      for (x = xsize * ysize - 1; x >= 0; x--) {
-        rectdraw[x].colpoin = NULL;
-      }
-
-      dimg = imgrect;
-      dm = rectmove;
-      dz = zbufrect;
-      dz1 = rectvz;
-      dz2 = rectvz + 4 * (xsize + 1);
-
-      if (side) {
-        if (nbd->curved == 0) {
-          dz1 += 2;
-          dz2 += 2;
-        }
-        speedfac = -speedfac;
-      }
-
-      set_quad_bezier_ipo(0.5f + 0.5f * speedfac, ipodata);
-
-      for (fy = -0.5f + jit[step & 255][0], y = 0; y < ysize; y++, fy += 1.0f) {
-        for (fx = -0.5f + jit[step & 255][1], x = 0; x < xsize;
-             x++, fx += 1.0f, dimg += 4, dz1 += 4, dz2 += 4, dm++, dz++) {
-          if (*dm > 1) {
-            float jfx = fx + 0.5f;
-            float jfy = fy + 0.5f;
-            DrawBufPixel col;
-
-            /* make vertices */
-            if (nbd->curved) { /* curved */
-              quad_bezier_2d(v1, dz1, dz1 + 2, ipodata);
-              v1[0] += jfx;
-              v1[1] += jfy;
-              v1[2] = *dz;
-
-              quad_bezier_2d(v2, dz1 + 4, dz1 + 4 + 2, ipodata);
-              v2[0] += jfx + 1.0f;
-              v2[1] += jfy;
-              v2[2] = *dz;
-
-              quad_bezier_2d(v3, dz2 + 4, dz2 + 4 + 2, ipodata);
-              v3[0] += jfx + 1.0f;
-              v3[1] += jfy + 1.0f;
-              v3[2] = *dz;
-
-              quad_bezier_2d(v4, dz2, dz2 + 2, ipodata);
-              v4[0] += jfx;
-              v4[1] += jfy + 1.0f;
-              v4[2] = *dz;
-            }
-            else {
-              ARRAY_SET_ITEMS(v1, speedfac * dz1[0] + jfx, speedfac * dz1[1] + jfy, *dz);
-              ARRAY_SET_ITEMS(v2, speedfac * dz1[4] + jfx + 1.0f, speedfac * dz1[5] + jfy, *dz);
-              ARRAY_SET_ITEMS(
-                  v3, speedfac * dz2[4] + jfx + 1.0f, speedfac * dz2[5] + jfy + 1.0f, *dz);
-              ARRAY_SET_ITEMS(v4, speedfac * dz2[0] + jfx, speedfac * dz2[1] + jfy + 1.0f, *dz);
-            }
-            if (*dm == 255) {
-              col.alpha = 1.0f;
-            }
-            else if (*dm < 2) {
-              col.alpha = 0.0f;
-            }
-            else {
-              col.alpha = ((float)*dm) / 255.0f;
-            }
-            col.colpoin = dimg;
-
-            zbuf_fill_in_rgba(&zspan, &col, v1, v2, v3, v4);
-          }
-        }
-        dz1 += 4;
-        dz2 += 4;
-      }
-
-      /* blend with a falloff. this fixes the ugly effect you get with
-       * a fast moving object. then it looks like a solid object overlaid
-       * over a very transparent moving version of itself. in reality, the
-       * whole object should become transparent if it is moving fast, be
-       * we don't know what is behind it so we don't do that. this hack
-       * overestimates the contribution of foreground pixels but looks a
-       * bit better without a sudden cutoff. */
-      blendfac = ((samples - step) / (float)samples);
-      /* smoothstep to make it look a bit nicer as well */
-      blendfac = 3.0f * pow(blendfac, 2.0f) - 2.0f * pow(blendfac, 3.0f);
-
-      /* accum */
-      rw = rectweight;
-      rm = rectmax;
-      for (dr = rectdraw, dz2 = newrect, x = xsize * ysize - 1; x >= 0;
-           x--, dr++, dz2 += 4, rw++, rm++) {
-        if (dr->colpoin) {
-          float bfac = dr->alpha * blendfac;
-
-          dz2[0] += bfac * dr->colpoin[0];
-          dz2[1] += bfac * dr->colpoin[1];
-          dz2[2] += bfac * dr->colpoin[2];
-          dz2[3] += bfac * dr->colpoin[3];
-
-          *rw += bfac;
-          *rm = MAX2(*rm, bfac);
-        }
-      }
+  /* largest vertical speed of the vertices of every row of faces */
+  rowspeed = (float *)MEM_mallocN(sizeof(float) * ysize, "row speed");
+  dz1 = rectvz;
+  for (y = 0; y < ysize; y++) {
+    float speed = 0.0f;
+    for (x = 0; x < 2 * (xsize + 1); x++, dz1 += 4) {
+      speed = max_ff(speed, max_ff(fabsf(dz1[1]), fabsf(dz1[3])));
     }
-  }
-
-  /* blend between original images and accumulated image */
-  rw = rectweight;
-  rm = rectmax;
-  ro = imgrect;
-  dm = rectmove;
-  for (dz2 = newrect, x = xsize * ysize - 1; x >= 0; x--, dz2 += 4, ro += 4, rw++, rm++, dm++) {
-    float mfac = *rm;
-    float fac = (*rw == 0.0f) ? 0.0f : mfac / (*rw);
-    float nfac = 1.0f - mfac;
-
-    dz2[0] = fac * dz2[0] + nfac * ro[0];
-    dz2[1] = fac * dz2[1] + nfac * ro[1];
-    dz2[2] = fac * dz2[2] + nfac * ro[2];
-    dz2[3] = fac * dz2[3] + nfac * ro[3];
-  }
-
+    dz1 -= 4 * (xsize + 1);
+    rowspeed[y] = speed;
+  }
+
+  data.nbd = nbd;
+  data.xsize = xsize;
+  data.ysize = ysize;
+  data.samples = samples / 2;
+  data.newrect = newrect;
+  data.imgrect = imgrect;
+  data.zbufrect = zbufrect;
+  data.rectvz = rectvz;
+  data.rowspeed = rowspeed;
+  data.rectz = rectz;
+  data.rectdraw = rectdraw;
+  data.rectweight = rectweight;
+  data.rectmax = rectmax;
+  data.rectmove = rectmove;
+  data.jit = jit;
+
+  /* Every band of rows is drawn and accumulated by its own task. A face is drawn by every band
+   * it overlaps, into the rows of that band only, so each pixel sees the faces in the same
+   * order as when drawing the whole image at once. */
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0,
+                          (ysize + VECBLUR_BAND_SIZE - 1) / VECBLUR_BAND_SIZE,
+                          &data,
+                          zbuf_accumulate_vecblur_band,
+                          &settings);
+
+  MEM_freeN(rowspeed);
   MEM_freeN(rectz);
   MEM_freeN(rectmove);
   MEM_freeN(rectdraw);
@@ -896,5 +998,4 @@ void zbuf_accumulate_vecblur(NodeBlurData *nbd,
   if (minvecbufrect) {
     MEM_freeN(vecbufrect); /* rects were swapped! */
   }
-  zbuf_free_span(&zspan);
 }
@@ -17,6 +17,7 @@
  */
 
 #include "COM_ViewerOperation.h"
+#include "COM_AreaExecutor.h"
 #include "BLI_listbase.h"
 #include "BKE_image.h"
 #include "BKE_scene.h"
@@ -98,24 +99,62 @@ void ViewerOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
   int y;
   bool breaked = false;
 
-  for (y = y1; y < y2 && (!breaked); y++) {
-    for (x = x1; x < x2; x++) {
-      this->m_imageInput->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
-      if (this->m_useAlphaInput) {
-        this->m_alphaInput->readSampled(alpha, x, y, COM_PS_NEAREST);
-        buffer[offset4 + 3] = alpha[0];
-      }
-      this->m_depthInput->readSampled(depth, x, y, COM_PS_NEAREST);
-      depthbuffer[offset] = depth[0];
+  NodeOperation *imageOperation = this->getInputOperation(0);
+  NodeOperation *alphaOperation = this->getInputOperation(1);
+  NodeOperation *depthOperation = this->getInputOperation(2);
 
-      offset++;
-      offset4 += 4;
+  if (this->useAreaExecution() && imageOperation && alphaOperation && depthOperation) {
+    /* Calculate the inputs one operation at a time, results they share are calculated once. */
+    AreaExecutor executor(rect);
+    executor.addOutput(imageOperation);
+    if (this->m_useAlphaInput) {
+      executor.addOutput(alphaOperation);
+    }
+    executor.addOutput(depthOperation);
+
+    MemoryBuffer *image = executor.calculate(imageOperation);
+    MemoryBuffer *alphaBuffer = (this->m_useAlphaInput) ? executor.calculate(alphaOperation) :
+                                                          NULL;
+    MemoryBuffer *depthBuffer = executor.calculate(depthOperation);
+
+    for (y = y1; y < y2 && (!breaked); y++) {
+      for (x = x1; x < x2; x++) {
+        copy_v4_v4(&buffer[offset4], image->getElem(x, y));
+        if (alphaBuffer) {
+          buffer[offset4 + 3] = *alphaBuffer->getElem(x, y);
+        }
+        depthbuffer[offset] = *depthBuffer->getElem(x, y);
+
+        offset++;
+        offset4 += 4;
+      }
+      if (isBraked()) {
+        breaked = true;
+      }
+      offset += offsetadd;
+      offset4 += offsetadd4;
     }
-    if (isBraked()) {
-      breaked = true;
+  }
+  else {
+    for (y = y1; y < y2 && (!breaked); y++) {
+      for (x = x1; x < x2; x++) {
+        this->m_imageInput->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
+        if (this->m_useAlphaInput) {
+          this->m_alphaInput->readSampled(alpha, x, y, COM_PS_NEAREST);
+          buffer[offset4 + 3] = alpha[0];
+        }
+        this->m_depthInput->readSampled(depth, x, y, COM_PS_NEAREST);
+        depthbuffer[offset] = depth[0];
+
+        offset++;
+        offset4 += 4;
+      }
+      if (isBraked()) {
+        breaked = true;
+      }
+      offset += offsetadd;
+      offset4 += offsetadd4;
     }
-    offset += offsetadd;
-    offset4 += offsetadd4;
   }
   updateImage(rect);
 }
@@ -17,6 +17,7 @@
  */
 
 #include "COM_WriteBufferOperation.h"
+#include "COM_AreaExecutor.h"
 #include "COM_defines.h"
 #include <stdio.h>
 #include "COM_OpenCLDevice.h"
@@ -47,7 +48,8 @@ void WriteBufferOperation::executePixelSampled(float output[4],
 void WriteBufferOperation::initExecution()
 {
   this->m_input = this->getInputOperation(0);
-  this->m_memoryProxy->allocate(this->m_width, this->m_height);
+  const bool half = this->useHalfBuffers() && !this->m_memoryProxy->needsFloatBuffer();
+  this->m_memoryProxy->allocate(this->m_width, this->m_height, half);
 }
 
 void WriteBufferOperation::deinitExecution()
@@ -59,7 +61,10 @@ void WriteBufferOperation::deinitExecution()
 void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 {
   MemoryBuffer *memoryBuffer = this->m_memoryProxy->getBuffer();
-  float *buffer = memoryBuffer->getBuffer();
+  /* Half float buffers are calculated in floats first and converted when done. */
+  MemoryBuffer *outputBuffer = memoryBuffer->isHalf() ?
+                                   new MemoryBuffer(this->m_memoryProxy->getDataType(), rect) :
+                                   memoryBuffer;
   const int num_channels = memoryBuffer->get_num_channels();
   if (this->m_input->isComplex()) {
     void *data = this->m_input->initializeTileData(rect);
@@ -71,10 +76,10 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
     int y;
     bool breaked = false;
     for (y = y1; y < y2 && (!breaked); y++) {
-      int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
+      float *buffer = outputBuffer->getElem(x1, y);
       for (x = x1; x < x2; x++) {
-        this->m_input->read(&(buffer[offset4]), x, y, data);
-        offset4 += num_channels;
+        this->m_input->read(buffer, x, y, data);
+        buffer += num_channels;
       }
       if (isBraked()) {
         breaked = true;
@@ -85,6 +90,12 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
       data = NULL;
     }
   }
+  else if (this->useAreaExecution()) {
+    /* Calculate the input one operation at a time, directly into the buffer. */
+    AreaExecutor executor(rect);
+    executor.addOutput(this->m_input);
+    executor.calculate(this->m_input, outputBuffer);
+  }
   else {
     int x1 = rect->xmin;
     int y1 = rect->ymin;
@@ -95,16 +106,20 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
     int y;
     bool breaked = false;
     for (y = y1; y < y2 && (!breaked); y++) {
-      int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
+      float *buffer = outputBuffer->getElem(x1, y);
       for (x = x1; x < x2; x++) {
-        this->m_input->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
-        offset4 += num_channels;
+        this->m_input->readSampled(buffer, x, y, COM_PS_NEAREST);
+        buffer += num_channels;
       }
       if (isBraked()) {
         breaked = true;
       }
     }
   }
+  if (outputBuffer != memoryBuffer) {
+    memoryBuffer->copyContentFrom(outputBuffer);
+    delete outputBuffer;
+  }
   memoryBuffer->setCreatedState();
 }
 
@@ -92,6 +92,13 @@ Depsgraph *DEG_graph_new(struct Main *bmain,
                          struct ViewLayer *view_layer,
                          eEvaluationMode mode);
 
+/* Replace the "owner" pointers (currently Main/Scene/ViewLayer) of this depsgraph.
+ * Used by undo, when the scene and view layer are kept but Main is re-allocated. */
+void DEG_graph_replace_owners(struct Depsgraph *depsgraph,
+                              struct Main *bmain,
+                              struct Scene *scene,
+                              struct ViewLayer *view_layer);
+
 /* Free Depsgraph itself and all its data */
 void DEG_graph_free(Depsgraph *graph);
 
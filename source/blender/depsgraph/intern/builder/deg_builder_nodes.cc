@@ -346,6 +346,25 @@ void DepsgraphNodeBuilder::begin_build()
   }
   GSET_FOREACH_END();
 
+  for (OperationNode *op_node : graph_->operations) {
+    if (op_node->stats.num_time_samples == 0) {
+      continue;
+    }
+    ComponentNode *comp_node = op_node->owner;
+    IDNode *id_node = comp_node->owner;
+
+    SavedOperationTime operation_time;
+    operation_time.id_orig = id_node->id_orig;
+    operation_time.component_type = comp_node->type;
+    operation_time.component_name = comp_node->name;
+    operation_time.opcode = op_node->opcode;
+    operation_time.name = op_node->name;
+    operation_time.name_tag = op_node->name_tag;
+    operation_time.average_time = op_node->stats.average_time;
+    operation_time.num_time_samples = op_node->stats.num_time_samples;
+    saved_operation_times_.push_back(operation_time);
+  }
+
   /* Make sure graph has no nodes left from previous state. */
   graph_->clear_all_nodes();
   graph_->operations.clear();
@@ -372,6 +391,24 @@ void DepsgraphNodeBuilder::end_build()
      * that originally node was explicitly tagged for user update. */
     op_node->tag_update(graph_, DEG_UPDATE_SOURCE_USER_EDIT);
   }
+  for (const SavedOperationTime &operation_time : saved_operation_times_) {
+    IDNode *id_node = find_id_node(operation_time.id_orig);
+    if (id_node == NULL) {
+      continue;
+    }
+    ComponentNode *comp_node = id_node->find_component(operation_time.component_type,
+                                                       operation_time.component_name.c_str());
+    if (comp_node == NULL) {
+      continue;
+    }
+    OperationNode *op_node = comp_node->find_operation(
+        operation_time.opcode, operation_time.name.c_str(), operation_time.name_tag);
+    if (op_node == NULL) {
+      continue;
+    }
+    op_node->stats.average_time = operation_time.average_time;
+    op_node->stats.num_time_samples = operation_time.num_time_samples;
+  }
 }
 
 void DepsgraphNodeBuilder::build_id(ID *id)
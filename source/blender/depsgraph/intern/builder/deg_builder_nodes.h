@@ -242,6 +242,20 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   };
   vector<SavedEntryTag> saved_entry_tags_;
 
+  /* Measured evaluation times of operations, kept across relations updates so the evaluation
+   * scheduler doesn't have to learn the cost of all operations again. */
+  struct SavedOperationTime {
+    ID *id_orig;
+    NodeType component_type;
+    string component_name;
+    OperationCode opcode;
+    string name;
+    int name_tag;
+    double average_time;
+    int num_time_samples;
+  };
+  vector<SavedOperationTime> saved_operation_times_;
+
   struct BuilderWalkUserData {
     DepsgraphNodeBuilder *builder;
     /* Denotes whether object the walk is invoked from is visible. */
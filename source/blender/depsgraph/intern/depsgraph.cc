@@ -77,6 +77,7 @@ Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluati
       scene_cow(NULL),
       is_active(false),
       is_evaluating(false),
+      num_evaluations(0),
       is_render_pipeline_depsgraph(false)
 {
   BLI_spin_init(&lock);
@@ -322,6 +323,28 @@ Depsgraph *DEG_graph_new(Main *bmain, Scene *scene, ViewLayer *view_layer, eEval
   return reinterpret_cast<Depsgraph *>(deg_depsgraph);
 }
 
+/* Replace the "owner" pointers (currently Main/Scene/ViewLayer) of this depsgraph. */
+void DEG_graph_replace_owners(struct Depsgraph *depsgraph,
+                              Main *bmain,
+                              Scene *scene,
+                              ViewLayer *view_layer)
+{
+  DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(depsgraph);
+
+  const bool do_update_register = deg_graph->bmain != bmain;
+  if (do_update_register) {
+    DEG::unregister_graph(deg_graph);
+  }
+
+  deg_graph->bmain = bmain;
+  deg_graph->scene = scene;
+  deg_graph->view_layer = view_layer;
+
+  if (do_update_register) {
+    DEG::register_graph(deg_graph);
+  }
+}
+
 /* Free graph's contents and graph itself */
 void DEG_graph_free(Depsgraph *graph)
 {
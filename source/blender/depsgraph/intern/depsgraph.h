@@ -200,6 +200,9 @@ struct Depsgraph {
 
   bool is_evaluating;
 
+  /* Number of evaluations, used to decide when operations are timed. */
+  int num_evaluations;
+
   /* Is set to truth for dependency graph which are used for post-processing (compositor and
    * sequencer).
    * Such dependency graph needs all view layers (so render pipeline can access names), but it
@@ -621,6 +621,10 @@ void id_tag_update(Main *bmain, ID *id, int flag, eUpdateSource update_source)
 void graph_id_tag_update(
     Main *bmain, Depsgraph *graph, ID *id, int flag, eUpdateSource update_source)
 {
+  if (update_source == DEG_UPDATE_SOURCE_USER_EDIT) {
+    /* Memfile undo only keeps IDs which were not edited since the last undo push. */
+    id->recalc_after_undo_push |= (flag != 0) ? flag : ID_RECALC_ALL;
+  }
   const int debug_flags = (graph != NULL) ? DEG_debug_flags_get((::Depsgraph *)graph) : G.debug;
   if (graph != NULL && graph->is_evaluating) {
     if (debug_flags & G_DEBUG_DEPSGRAPH) {
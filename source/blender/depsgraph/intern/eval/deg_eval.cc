@@ -25,11 +25,14 @@
 
 #include "intern/eval/deg_eval.h"
 
+#include <queue>
+
 #include "PIL_time.h"
 
 #include "BLI_compiler_attrs.h"
 #include "BLI_utildefines.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_ghash.h"
 
 #include "BKE_global.h"
@@ -63,24 +66,70 @@ static void schedule_children(TaskPool *pool,
                               OperationNode *node,
                               const int thread_id);
 
+/* Estimated evaluation time of operations which were not evaluated yet. */
+#define DEG_OPERATION_DEFAULT_TIME 1e-5
+
+/* Operations are timed during their first evaluations, after that only on every Nth evaluation
+ * of the graph, which is enough to follow changes of their cost. */
+#define DEG_OPERATION_INITIAL_TIME_SAMPLES 4
+#define DEG_OPERATION_TIME_SAMPLE_INTERVAL 16
+
+struct OperationCriticalPathCompare {
+  bool operator()(const OperationNode *a, const OperationNode *b) const
+  {
+    return a->critical_path_time < b->critical_path_time;
+  }
+};
+
+/* Operations which are ready to be evaluated, the one with the longest critical path first.
+ *
+ * Tasks pushed to the pool do not carry an operation, instead every task evaluates the best
+ * ready operation at the time it runs. A task is pushed for every operation which becomes
+ * ready, so there always is one. */
+typedef std::priority_queue<OperationNode *, vector<OperationNode *>, OperationCriticalPathCompare>
+    OperationReadyQueue;
+
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  bool do_time_samples;
   bool is_cow_stage;
+  OperationReadyQueue ready_queue;
+  SpinLock ready_queue_lock;
 };
 
-static void deg_task_run_func(TaskPool *pool, void *taskdata, int thread_id)
+static OperationNode *ready_queue_pop(DepsgraphEvalState *state)
+{
+  BLI_spin_lock(&state->ready_queue_lock);
+  BLI_assert(!state->ready_queue.empty());
+  OperationNode *node = state->ready_queue.top();
+  state->ready_queue.pop();
+  BLI_spin_unlock(&state->ready_queue_lock);
+  return node;
+}
+
+static void ready_queue_push(DepsgraphEvalState *state, OperationNode *node)
+{
+  BLI_spin_lock(&state->ready_queue_lock);
+  state->ready_queue.push(node);
+  BLI_spin_unlock(&state->ready_queue_lock);
+}
+
+static void deg_task_run_func(TaskPool *pool, void *UNUSED(taskdata), int thread_id)
 {
   void *userdata_v = BLI_task_pool_userdata(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
-  OperationNode *node = (OperationNode *)taskdata;
+  OperationNode *node = ready_queue_pop(state);
   /* Sanity checks. */
   BLI_assert(!node->is_noop() && "NOOP nodes should not actually be scheduled");
-  /* Perform operation. */
-  if (state->do_stats) {
+  /* Perform operation, timing it when needed to estimate its cost in the next evaluations. */
+  if (state->do_stats || state->do_time_samples ||
+      node->stats.num_time_samples < DEG_OPERATION_INITIAL_TIME_SAMPLES) {
     const double start_time = PIL_check_seconds_timer();
     node->evaluate((::Depsgraph *)state->graph);
-    node->stats.current_time += PIL_check_seconds_timer() - start_time;
+    const double time = PIL_check_seconds_timer() - start_time;
+    node->stats.current_time += time;
+    node->stats.add_time_sample(time);
   }
   else {
     node->evaluate((::Depsgraph *)state->graph);
@@ -141,15 +190,82 @@ static void calculate_pending_parents(Depsgraph *graph)
   }
 }
 
-static void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
+static bool is_operation_node_evaluated(const OperationNode *node)
+{
+  return check_operation_node_visible((OperationNode *)node) &&
+         (node->flag & DEPSOP_FLAG_NEEDS_UPDATE) != 0;
+}
+
+static bool is_critical_path_relation(const Relation *rel)
+{
+  if (rel->from->type != NodeType::OPERATION || rel->to->type != NodeType::OPERATION) {
+    return false;
+  }
+  if (rel->flag & RELATION_FLAG_CYCLIC) {
+    return false;
+  }
+  return is_operation_node_evaluated((OperationNode *)rel->from) &&
+         is_operation_node_evaluated((OperationNode *)rel->to);
+}
+
+static double operation_estimated_time(const OperationNode *node)
+{
+  if (node->is_noop()) {
+    return 0.0;
+  }
+  if (node->stats.average_time > 0.0) {
+    return node->stats.average_time;
+  }
+  return DEG_OPERATION_DEFAULT_TIME;
+}
+
+/* Calculate the critical path time of every operation which is to be evaluated: its own
+ * estimated time plus the biggest critical path time of the operations depending on it.
+ *
+ * Operations are visited in reverse topological order, starting from the ones without
+ * evaluated children, using custom_flags as the number of children not visited yet. */
+static void calculate_critical_path_times(Depsgraph *graph)
+{
+  vector<OperationNode *> stack;
+  for (OperationNode *node : graph->operations) {
+    node->critical_path_time = 0.0;
+    node->custom_flags = 0;
+    if (!is_operation_node_evaluated(node)) {
+      continue;
+    }
+    for (Relation *rel : node->outlinks) {
+      if (is_critical_path_relation(rel)) {
+        ++node->custom_flags;
+      }
+    }
+    if (node->custom_flags == 0) {
+      stack.push_back(node);
+    }
+  }
+  while (!stack.empty()) {
+    OperationNode *node = stack.back();
+    stack.pop_back();
+    node->critical_path_time += operation_estimated_time(node);
+    for (Relation *rel : node->inlinks) {
+      if (!is_critical_path_relation(rel)) {
+        continue;
+      }
+      OperationNode *from = (OperationNode *)rel->from;
+      from->critical_path_time = max(from->critical_path_time, node->critical_path_time);
+      if (--from->custom_flags == 0) {
+        stack.push_back(from);
+      }
+    }
+  }
+}
+
+static void initialize_execution(DepsgraphEvalState * /*state*/, Depsgraph *graph)
 {
-  const bool do_stats = state->do_stats;
   calculate_pending_parents(graph);
+  calculate_critical_path_times(graph);
   /* Clear tags and other things which needs to be clear. */
   for (OperationNode *node : graph->operations) {
-    if (do_stats) {
-      node->stats.reset_current();
-    }
+    node->stats.reset_current();
   }
 }
 
@@ -199,8 +315,9 @@ static void schedule_node(
     }
     else {
       /* children are scheduled once this task is completed */
+      ready_queue_push(state, node);
       BLI_task_pool_push_from_thread(
-          pool, deg_task_run_func, node, false, TASK_PRIORITY_HIGH, thread_id);
+          pool, deg_task_run_func, NULL, false, TASK_PRIORITY_HIGH, thread_id);
     }
   }
 }
@@ -263,6 +380,8 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = do_time_debug;
+  state.do_time_samples = (graph->num_evaluations++ % DEG_OPERATION_TIME_SAMPLE_INTERVAL) == 0;
+  BLI_spin_init(&state.ready_queue_lock);
   /* Set up task scheduler and pull for threaded evaluation. */
   TaskScheduler *task_scheduler;
   bool need_free_scheduler;
@@ -287,6 +406,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   schedule_graph(task_pool, graph);
   BLI_task_pool_work_and_wait(task_pool);
   BLI_task_pool_free(task_pool);
+  BLI_spin_end(&state.ready_queue_lock);
   /* Finalize statistics gathering. This is because we only gather single
    * operation timing here, without aggregating anything to avoid any extra
    * synchronization. */
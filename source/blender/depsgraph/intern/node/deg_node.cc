@@ -269,6 +269,8 @@ Node::Stats::Stats()
 void Node::Stats::reset()
 {
   current_time = 0.0;
+  average_time = 0.0;
+  num_time_samples = 0;
 }
 
 void Node::Stats::reset_current()
@@ -276,6 +278,18 @@ void Node::Stats::reset_current()
   current_time = 0.0;
 }
 
+void Node::Stats::add_time_sample(double time)
+{
+  /* Exponential moving average, so the estimate follows changes of the evaluated data. */
+  if (num_time_samples == 0) {
+    average_time = time;
+  }
+  else {
+    average_time = average_time * 0.75 + time * 0.25;
+  }
+  ++num_time_samples;
+}
+
 /*******************************************************************************
  * Node itself.
  */
@@ -154,8 +154,14 @@ struct Node {
     /* Reset counters needed for the current graph evaluation, does not
      * touch averaging accumulators. */
     void reset_current();
+    /* Accumulate a measured evaluation time into the average. */
+    void add_time_sample(double time);
     /* Time spend on this node during current graph evaluation. */
     double current_time;
+    /* Time spend on this node, averaged over the measured graph evaluations. */
+    double average_time;
+    /* Number of evaluations accumulated into the average. */
+    int num_time_samples;
   };
   /* Relationships between nodes
    * The reason why all depsgraph nodes are descended from this type (apart
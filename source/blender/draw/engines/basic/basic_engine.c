@@ -234,6 +234,7 @@ RenderEngineType DRW_engine_viewport_basic_type = {
     NULL,
     NULL,
     NULL,
+    NULL,
     &draw_engine_basic_type,
     {NULL, NULL, NULL},
 };
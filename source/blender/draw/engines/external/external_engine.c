@@ -298,6 +298,7 @@ RenderEngineType DRW_engine_viewport_external_type = {
     NULL,
     NULL,
     NULL,
+    NULL,
     &draw_engine_external_type,
     {NULL, NULL, NULL},
 };
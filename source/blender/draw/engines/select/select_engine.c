@@ -414,6 +414,7 @@ RenderEngineType DRW_engine_viewport_select_type = {
     NULL,
     NULL,
     NULL,
+    NULL,
     &draw_engine_select_type,
     {NULL, NULL, NULL},
 };
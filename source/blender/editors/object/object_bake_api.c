@@ -722,7 +722,7 @@ static Mesh *bake_mesh_new_from_object(Object *object)
 static int bake(Render *re,
                 Main *bmain,
                 Scene *scene,
-                ViewLayer *view_layer,
+                Depsgraph *depsgraph,
                 Object *ob_low,
                 ListBase *selected_objects,
                 ReportList *reports,
@@ -746,11 +746,6 @@ static int bake(Render *re,
                 ScrArea *sa,
                 const char *uv_layer)
 {
-  /* We build a depsgraph for the baking,
-   * so we don't need to change the original data to adjust visibility and modifiers. */
-  Depsgraph *depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
-  DEG_graph_build_from_view_layer(depsgraph, bmain, scene, view_layer);
-
   int op_result = OPERATOR_CANCELLED;
   bool ok = false;
 
@@ -898,6 +893,12 @@ static int bake(Render *re,
     if (mmd_low) {
       mmd_flags_low = mmd_low->flags;
       mmd_low->uv_smooth = SUBSURF_UV_SMOOTH_NONE;
+
+      /* The depsgraph is shared with previously baked objects, so it needs to evaluate the
+       * mesh again, and the render engine to sync it again. */
+      DEG_graph_id_tag_update(bmain, depsgraph, &ob_low->id, ID_RECALC_GEOMETRY);
+      RE_bake_engine_batch_end(re);
+      RE_bake_engine_batch_begin(re);
     }
   }
 
@@ -1275,11 +1276,29 @@ cleanup:
     BKE_id_free(NULL, &me_cage->id);
   }
 
-  DEG_graph_free(depsgraph);
-
   return op_result;
 }
 
+/* All objects baked by one operator call share a depsgraph and a batch of the render engine,
+ * so the engine only has to sync the scene once. */
+static Depsgraph *bake_batch_begin(BakeAPIRender *bkr)
+{
+  /* We build a depsgraph for the baking,
+   * so we don't need to change the original data to adjust visibility and modifiers. */
+  Depsgraph *depsgraph = DEG_graph_new(bkr->main, bkr->scene, bkr->view_layer, DAG_EVAL_RENDER);
+  DEG_graph_build_from_view_layer(depsgraph, bkr->main, bkr->scene, bkr->view_layer);
+
+  RE_bake_engine_batch_begin(bkr->render);
+
+  return depsgraph;
+}
+
+static void bake_batch_end(BakeAPIRender *bkr, Depsgraph *depsgraph)
+{
+  RE_bake_engine_batch_end(bkr->render);
+  DEG_graph_free(depsgraph);
+}
+
 static void bake_init_api_data(wmOperator *op, bContext *C, BakeAPIRender *bkr)
 {
   bool is_save_internal;
@@ -1339,6 +1358,7 @@ static void bake_init_api_data(wmOperator *op, bContext *C, BakeAPIRender *bkr)
 static int bake_exec(bContext *C, wmOperator *op)
 {
   Render *re;
+  Depsgraph *depsgraph;
   int result = OPERATOR_CANCELLED;
   BakeAPIRender bkr = {NULL};
   Scene *scene = CTX_data_scene(C);
@@ -1375,11 +1395,13 @@ static int bake_exec(bContext *C, wmOperator *op)
 
   RE_SetReports(re, bkr.reports);
 
+  depsgraph = bake_batch_begin(&bkr);
+
   if (bkr.is_selected_to_active) {
     result = bake(bkr.render,
                   bkr.main,
                   bkr.scene,
-                  bkr.view_layer,
+                  depsgraph,
                   bkr.ob,
                   &bkr.selected_objects,
                   bkr.reports,
@@ -1411,7 +1433,7 @@ static int bake_exec(bContext *C, wmOperator *op)
       result = bake(bkr.render,
                     bkr.main,
                     bkr.scene,
-                    bkr.view_layer,
+                    depsgraph,
                     ob_iter,
                     NULL,
                     bkr.reports,
@@ -1437,6 +1459,8 @@ static int bake_exec(bContext *C, wmOperator *op)
     }
   }
 
+  bake_batch_end(&bkr, depsgraph);
+
   RE_SetReports(re, NULL);
 
 finally:
@@ -1448,6 +1472,7 @@ finally:
 static void bake_startjob(void *bkv, short *UNUSED(stop), short *do_update, float *progress)
 {
   BakeAPIRender *bkr = (BakeAPIRender *)bkv;
+  Depsgraph *depsgraph;
 
   /* setup new render */
   bkr->do_update = do_update;
@@ -1476,11 +1501,13 @@ static void bake_startjob(void *bkv, short *UNUSED(stop), short *do_update, floa
     bake_images_clear(bkr->main, is_tangent);
   }
 
+  depsgraph = bake_batch_begin(bkr);
+
   if (bkr->is_selected_to_active) {
     bkr->result = bake(bkr->render,
                        bkr->main,
                        bkr->scene,
-                       bkr->view_layer,
+                       depsgraph,
                        bkr->ob,
                        &bkr->selected_objects,
                        bkr->reports,
@@ -1512,7 +1539,7 @@ static void bake_startjob(void *bkv, short *UNUSED(stop), short *do_update, floa
       bkr->result = bake(bkr->render,
                          bkr->main,
                          bkr->scene,
-                         bkr->view_layer,
+                         depsgraph,
                          ob_iter,
                          NULL,
                          bkr->reports,
@@ -1537,11 +1564,13 @@ static void bake_startjob(void *bkv, short *UNUSED(stop), short *do_update, floa
                          bkr->uv_layer);
 
       if (bkr->result == OPERATOR_CANCELLED) {
-        return;
+        break;
       }
     }
   }
 
+  bake_batch_end(bkr, depsgraph);
+
   RE_SetReports(bkr->render, NULL);
 }
 
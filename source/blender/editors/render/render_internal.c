@@ -78,6 +78,7 @@
 #include "RE_engine.h"
 
 #include "IMB_colormanagement.h"
+#include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
 #include "RNA_access.h"
@@ -218,6 +219,7 @@ static void image_buffer_rect_update(RenderJob *rj,
          * as invalid here (sergey)
          */
         ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+        IMB_tag_changed(ibuf);
         return;
       }
       else {
@@ -778,6 +780,7 @@ static void render_endjob(void *rjv)
 
     if (ibuf) {
       ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+      IMB_tag_changed(ibuf);
     }
 
     BKE_image_release_ibuf(ima, ibuf, lock);
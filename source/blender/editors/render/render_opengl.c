@@ -518,6 +518,7 @@ static void screen_opengl_render_apply(const bContext *C, OGLRender *oglrender)
   ibuf = BKE_image_acquire_ibuf(oglrender->ima, &oglrender->iuser, &lock);
   if (ibuf) {
     ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+    IMB_tag_changed(ibuf);
   }
   BKE_image_release_ibuf(oglrender->ima, ibuf, lock);
 
@@ -3077,6 +3077,7 @@ static int image_scale_exec(bContext *C, wmOperator *op)
 
   ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
   IMB_scaleImBuf(ibuf, size[0], size[1]);
+  IMB_tag_changed(ibuf);
   BKE_image_release_ibuf(ima, ibuf, NULL);
 
   ED_image_undo_push_end();
@@ -301,6 +301,7 @@ static void ptile_restore_runtime_list(ListBase *paint_tiles)
       ibuf->userflags |= IB_MIPMAP_INVALID; /* force mip-map recreation. */
     }
     ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+    IMB_tag_changed(ibuf);
 
     BKE_image_release_ibuf(image, ibuf, NULL);
   }
@@ -577,6 +578,7 @@ static void uhandle_restore_list(ListBase *undo_handles, bool use_init)
         ibuf->userflags |= IB_MIPMAP_INVALID; /* force mip-map recreation. */
       }
       ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+      IMB_tag_changed(ibuf);
 
       DEG_id_tag_update(&image->id, 0);
     }
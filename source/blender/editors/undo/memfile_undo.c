@@ -22,8 +22,10 @@
 
 #include "BLI_utildefines.h"
 #include "BLI_sys_types.h"
+#include "BLI_listbase.h"
 
 #include "DNA_object_enums.h"
+#include "DNA_object_types.h"
 
 #include "BKE_blender_undo.h"
 #include "BKE_context.h"
@@ -91,10 +93,42 @@ static bool memfile_undosys_step_encode(struct bContext *UNUSED(C),
 static void memfile_undosys_step_decode(
     struct bContext *C, struct Main *bmain, UndoStep *us_p, int UNUSED(dir), bool UNUSED(is_final))
 {
+  MemFileUndoStep *us = (MemFileUndoStep *)us_p;
+
+  /* The current main is known to be in the state of the active memfile step, except for IDs
+   * tagged as edited since. The memfile written last of it and an adjacent step stores which
+   * IDs are identical in both, other steps can't be compared and are read entirely. */
+  UndoStack *ustack = ED_undo_stack_get();
+  UndoStep *us_active = ustack->step_active_memfile;
+  bool reuse_ids = false;
+  const MemFile *memfile_identical = NULL;
+  if (us_active == us_p) {
+    reuse_ids = true;
+  }
+  else if (us_active != NULL && BKE_undosys_step_same_type_next(us_p) == us_active) {
+    reuse_ids = true;
+    memfile_identical = &((MemFileUndoStep *)us_active)->data->memfile;
+  }
+  else if (us_active != NULL && BKE_undosys_step_same_type_prev(us_p) == us_active) {
+    reuse_ids = true;
+    memfile_identical = &us->data->memfile;
+  }
+
+  if (reuse_ids) {
+    /* Exiting edit and paint modes writes their data back without tagging it. */
+    LISTBASE_FOREACH (Object *, ob, &bmain->objects) {
+      if (ob->mode != OB_MODE_OBJECT) {
+        ob->id.recalc_after_undo_push |= ID_RECALC_ALL;
+        if (ob->data != NULL) {
+          ((ID *)ob->data)->recalc_after_undo_push |= ID_RECALC_ALL;
+        }
+      }
+    }
+  }
+
   ED_editors_exit(bmain, false);
 
-  MemFileUndoStep *us = (MemFileUndoStep *)us_p;
-  BKE_memfile_undo_decode(us->data, C);
+  BKE_memfile_undo_decode(us->data, reuse_ids, memfile_identical, C);
 
   for (UndoStep *us_iter = us_p->next; us_iter; us_iter = us_iter->next) {
     if (BKE_UNDOSYS_TYPE_IS_MEMFILE_SKIP(us_iter->type)) {
@@ -166,6 +166,11 @@ struct ImBuf *IMB_makeSingleUser(struct ImBuf *ibuf);
  */
 struct ImBuf *IMB_dupImBuf(const struct ImBuf *ibuf1);
 
+/**
+ * \attention Defined in allocimbuf.c
+ */
+void IMB_tag_changed(struct ImBuf *ibuf);
+
 /**
  *
  * \attention Defined in allocimbuf.c
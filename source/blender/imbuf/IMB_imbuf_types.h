@@ -221,6 +221,8 @@ typedef struct ImBuf {
   struct MEM_CacheLimiterHandle_s *c_handle;
   /** reference counter for multiple users */
   int refcounter;
+  /** Unique among all buffers and changed along with the pixels, see #IMB_tag_changed. */
+  unsigned int changed_timestamp;
 
   /* some parameters to pass along for packing images */
   /** Compressed image only used with png and exr currently */
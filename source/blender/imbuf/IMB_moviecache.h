@@ -53,6 +53,8 @@ void IMB_moviecache_set_priority_callback(struct MovieCache *cache,
                                           MovieCacheGetPriorityDataFP getprioritydatafp,
                                           MovieCacheGetItemPriorityFP getitempriorityfp,
                                           MovieCachePriorityDeleterFP prioritydeleterfp);
+void IMB_moviecache_set_disk_spill(struct MovieCache *cache, bool use_disk_spill);
+void IMB_moviecache_set_disk_spill_limit(const char *dirpath, size_t size_limit);
 
 void IMB_moviecache_put(struct MovieCache *cache, void *userkey, struct ImBuf *ibuf);
 bool IMB_moviecache_put_if_possible(struct MovieCache *cache, void *userkey, struct ImBuf *ibuf);
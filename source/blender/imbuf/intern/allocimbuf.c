@@ -38,6 +38,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_utildefines.h"
 #include "BLI_threads.h"
 
@@ -497,6 +499,7 @@ bool IMB_initImBuf(
 {
   memset(ibuf, 0, sizeof(ImBuf));
 
+  IMB_tag_changed(ibuf);
   ibuf->x = x;
   ibuf->y = y;
   ibuf->planes = planes;
@@ -538,6 +541,17 @@ bool IMB_initImBuf(
   return true;
 }
 
+static unsigned int imbuf_changed_timestamp = 0;
+
+/**
+ * Give the buffer a timestamp no other buffer had. Call it after modifying the pixels, caches
+ * of results computed from them compare the timestamp instead of the pixels.
+ */
+void IMB_tag_changed(ImBuf *ibuf)
+{
+  ibuf->changed_timestamp = atomic_add_and_fetch_uint32(&imbuf_changed_timestamp, 1);
+}
+
 /* does no zbuffers? */
 ImBuf *IMB_dupImBuf(const ImBuf *ibuf1)
 {
@@ -615,6 +629,7 @@ ImBuf *IMB_dupImBuf(const ImBuf *ibuf1)
   tbuf.mall = ibuf2->mall;
   tbuf.c_handle = NULL;
   tbuf.refcounter = 0;
+  tbuf.changed_timestamp = ibuf2->changed_timestamp;
 
   /* for now don't duplicate metadata */
   tbuf.metadata = NULL;
@@ -23,6 +23,13 @@
 
 #undef DEBUG_MESSAGES
 
+#ifdef _WIN32
+#  include <io.h>
+#  include <stddef.h>
+#  include <sys/types.h>
+#  include "mmap_win.h"
+#endif
+
 #include <stdlib.h> /* for qsort */
 #include <memory.h>
 
@@ -31,14 +38,26 @@
 
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
+#include "BLI_fileops.h"
 #include "BLI_ghash.h"
+#include "BLI_listbase.h"
+#include "BLI_math_base.h"
 #include "BLI_mempool.h"
+#include "BLI_path_util.h"
+#include "BLI_system.h"
 #include "BLI_threads.h"
 
+#include "BKE_appdir.h"
+
 #include "IMB_moviecache.h"
 
+#include "imbuf.h"
+#include "IMB_allocimbuf.h"
 #include "IMB_imbuf_types.h"
 #include "IMB_imbuf.h"
+#include "IMB_metadata.h"
+
+#include BLI_SYSTEM_PID_H
 
 #ifdef DEBUG_MESSAGES
 #  if defined __GNUC__
@@ -74,7 +93,9 @@ typedef struct MovieCache {
   void *last_userkey;
 
   int totseg, *points, proxy, render_flags; /* for visual statistics optimization */
-  int pad;
+
+  /** Write items freed by the cache limiter to disk, see #IMB_moviecache_set_disk_spill. */
+  bool use_disk_spill;
 } MovieCache;
 
 typedef struct MovieCacheKey {
@@ -87,8 +108,457 @@ typedef struct MovieCacheItem {
   ImBuf *ibuf;
   MEM_CacheLimiterHandleC *c_handle;
   void *priority_data;
+  /** Pixels of the buffer stored on disk, can be set while #ibuf is in memory too. */
+  struct MovieCacheDiskFile *disk_file;
 } MovieCacheItem;
 
+/* -------------------------------------------------------------------- */
+/** \name Disk Spill
+ *
+ * Items of caches with disk spill enabled are written to disk when the cache limiter frees
+ * them, and are read back when they are requested again instead of being decoded from their
+ * source. Files contain raw pixels, the rest of the #ImBuf is kept in memory. The disk tier
+ * has its own size limit, least recently used files are removed first.
+ *
+ * The cache limiter frees items while `limitor_lock` is locked, so buffers are only queued
+ * then and written by #moviecache_disk_flush after the lock is released.
+ *
+ * Files are only valid for the current session and are removed together with their items.
+ * \{ */
+
+/* Maximum amount of bytes passed to a single write call. */
+#define DISK_SPILL_IO_CHUNK_SIZE (1 << 30)
+
+typedef struct MovieCacheDiskFile {
+  struct MovieCacheDiskFile *next, *prev;
+  MovieCacheItem *item;
+  /** Buffer without pixels while the pixels are only on disk, NULL otherwise. */
+  ImBuf *ibuf_header;
+  /** Buffer with the pixels until they are written, the file is in `files_pending` then. */
+  ImBuf *ibuf_write;
+  /** The pixels are being written, the file is in no list. */
+  bool is_writing;
+  size_t size;
+  char path[FILE_MAX];
+} MovieCacheDiskFile;
+
+static struct {
+  char dirpath[FILE_MAX];
+  size_t size_limit;
+  size_t size_total;
+  /** Least recently used files first. */
+  ListBase files;
+  /** Files which are not written yet, in the order they were spilled. */
+  ListBase files_pending;
+  unsigned int files_counter;
+} disk_spill = {{0}};
+static ThreadMutex disk_spill_lock = BLI_MUTEX_INITIALIZER;
+
+static bool moviecache_disk_spill_is_supported(const ImBuf *ibuf)
+{
+  if (ibuf->rect == NULL && ibuf->rect_float == NULL) {
+    return false;
+  }
+  /* Only plain pixel buffers are written. */
+  return ibuf->zbuf == NULL && ibuf->zbuf_float == NULL && ibuf->tiles == NULL &&
+         ibuf->dds_data.data == NULL;
+}
+
+static size_t moviecache_disk_rect_size(const ImBuf *ibuf)
+{
+  return (size_t)ibuf->x * (size_t)ibuf->y * sizeof(*ibuf->rect);
+}
+
+static size_t moviecache_disk_rect_float_size(const ImBuf *ibuf)
+{
+  return (size_t)ibuf->x * (size_t)ibuf->y * (size_t)ibuf->channels * sizeof(float);
+}
+
+/* Copy of the buffer without pixels, which is kept in memory while the pixels are on disk. */
+static ImBuf *moviecache_disk_header_new(ImBuf *ibuf)
+{
+  ImBuf *ibuf_header = IMB_allocImBuf(ibuf->x, ibuf->y, ibuf->planes, 0);
+  if (ibuf_header == NULL) {
+    return NULL;
+  }
+
+  ibuf_header->channels = ibuf->channels;
+  ibuf_header->ppm[0] = ibuf->ppm[0];
+  ibuf_header->ppm[1] = ibuf->ppm[1];
+  ibuf_header->dither = ibuf->dither;
+  ibuf_header->index = ibuf->index;
+  ibuf_header->userflags = ibuf->userflags;
+  ibuf_header->ftype = ibuf->ftype;
+  ibuf_header->foptions = ibuf->foptions;
+  BLI_strncpy(ibuf_header->name, ibuf->name, sizeof(ibuf_header->name));
+  BLI_strncpy(ibuf_header->cachename, ibuf->cachename, sizeof(ibuf_header->cachename));
+  ibuf_header->rect_colorspace = ibuf->rect_colorspace;
+  ibuf_header->float_colorspace = ibuf->float_colorspace;
+  ibuf_header->colormanage_flag = ibuf->colormanage_flag;
+  IMB_metadata_copy(ibuf_header, ibuf);
+
+  /* Remember which buffers are stored in the file. */
+  ibuf_header->flags = ibuf->flags & (IB_rect | IB_rectfloat);
+
+  return ibuf_header;
+}
+
+static bool moviecache_disk_write_data(int file, const void *data, size_t size)
+{
+  const char *data_ptr = data;
+
+  while (size > 0) {
+    const size_t chunk = min_zz(size, DISK_SPILL_IO_CHUNK_SIZE);
+    if (write(file, data_ptr, chunk) != (int)chunk) {
+      return false;
+    }
+    data_ptr += chunk;
+    size -= chunk;
+  }
+  return true;
+}
+
+static bool moviecache_disk_write(const char *path, const ImBuf *ibuf)
+{
+  const int file = BLI_open(path, O_BINARY | O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (file == -1) {
+    return false;
+  }
+
+  bool ok = true;
+  if (ibuf->rect) {
+    ok = moviecache_disk_write_data(file, ibuf->rect, moviecache_disk_rect_size(ibuf));
+  }
+  if (ok && ibuf->rect_float) {
+    ok = moviecache_disk_write_data(file, ibuf->rect_float, moviecache_disk_rect_float_size(ibuf));
+  }
+
+  if (close(file) != 0) {
+    ok = false;
+  }
+
+  if (!ok) {
+    BLI_delete(path, false, false);
+  }
+
+  return ok;
+}
+
+/* Allocate pixels of the header and fill them from the memory mapped file. */
+static bool moviecache_disk_read(const char *path, size_t size, ImBuf *ibuf)
+{
+  const int file = BLI_open(path, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    return false;
+  }
+
+  if (BLI_file_descriptor_size(file) != size) {
+    close(file);
+    return false;
+  }
+
+  imb_mmap_lock();
+  const unsigned char *mem = mmap(NULL, size, PROT_READ, MAP_SHARED, file, 0);
+  imb_mmap_unlock();
+
+  close(file);
+
+  if (mem == (unsigned char *)-1) {
+    return false;
+  }
+
+  const int channels = ibuf->channels;
+  const bool has_rect = (ibuf->flags & IB_rect) != 0;
+  const bool has_rect_float = (ibuf->flags & IB_rectfloat) != 0;
+  bool ok = true;
+  size_t offset = 0;
+
+  if (has_rect) {
+    ok = imb_addrectImBuf(ibuf);
+    if (ok) {
+      memcpy(ibuf->rect, mem, moviecache_disk_rect_size(ibuf));
+      offset += moviecache_disk_rect_size(ibuf);
+    }
+  }
+  if (ok && has_rect_float) {
+    ok = imb_addrectfloatImBuf(ibuf);
+    if (ok) {
+      /* Allocation always uses 4 channels, the file may store less. */
+      ibuf->channels = channels;
+      memcpy(ibuf->rect_float, mem + offset, moviecache_disk_rect_float_size(ibuf));
+    }
+  }
+
+  imb_mmap_lock();
+  munmap((void *)mem, size);
+  imb_mmap_unlock();
+
+  if (!ok) {
+    imb_freerectImbuf_all(ibuf);
+    ibuf->channels = channels;
+    ibuf->flags |= (has_rect ? IB_rect : 0) | (has_rect_float ? IB_rectfloat : 0);
+  }
+
+  return ok;
+}
+
+/* Must be called with `disk_spill_lock` locked. */
+static void moviecache_disk_file_delete(MovieCacheDiskFile *disk_file)
+{
+  if (disk_file->item) {
+    disk_file->item->disk_file = NULL;
+    disk_file->item = NULL;
+  }
+  if (disk_file->ibuf_header) {
+    IMB_freeImBuf(disk_file->ibuf_header);
+    disk_file->ibuf_header = NULL;
+  }
+
+  if (disk_file->is_writing) {
+    /* Deleted by #moviecache_disk_flush once the write is done. */
+    return;
+  }
+
+  if (disk_file->ibuf_write) {
+    IMB_freeImBuf(disk_file->ibuf_write);
+    BLI_freelinkN(&disk_spill.files_pending, disk_file);
+    return;
+  }
+
+  PRINT("%s: delete file %s\n", __func__, disk_file->path);
+
+  BLI_delete(disk_file->path, false, false);
+  disk_spill.size_total -= disk_file->size;
+
+  BLI_freelinkN(&disk_spill.files, disk_file);
+}
+
+/* Must be called with `disk_spill_lock` locked. */
+static void moviecache_disk_enforce_limits(void)
+{
+  while (disk_spill.size_total > disk_spill.size_limit && disk_spill.files.first) {
+    moviecache_disk_file_delete(disk_spill.files.first);
+  }
+}
+
+/* Keep pixels of an item which is freed by the cache limiter on disk. The cache limiter is
+ * locked here, so the buffer is only queued for #moviecache_disk_flush. */
+static void moviecache_disk_spill(MovieCacheItem *item)
+{
+  ImBuf *ibuf = item->ibuf;
+
+  if (!moviecache_disk_spill_is_supported(ibuf)) {
+    return;
+  }
+
+  ImBuf *ibuf_header = moviecache_disk_header_new(ibuf);
+  if (ibuf_header == NULL) {
+    return;
+  }
+
+  BLI_mutex_lock(&disk_spill_lock);
+
+  /* Pixels of items which were read back from disk are still in the file. */
+  MovieCacheDiskFile *disk_file = item->disk_file;
+  if (disk_file) {
+    BLI_assert(disk_file->ibuf_header == NULL);
+    disk_file->ibuf_header = ibuf_header;
+    if (disk_file->ibuf_write == NULL) {
+      BLI_remlink(&disk_spill.files, disk_file);
+      BLI_addtail(&disk_spill.files, disk_file);
+    }
+    BLI_mutex_unlock(&disk_spill_lock);
+    return;
+  }
+
+  const size_t size = (ibuf->rect ? moviecache_disk_rect_size(ibuf) : 0) +
+                      (ibuf->rect_float ? moviecache_disk_rect_float_size(ibuf) : 0);
+  if (size > disk_spill.size_limit) {
+    BLI_mutex_unlock(&disk_spill_lock);
+    IMB_freeImBuf(ibuf_header);
+    return;
+  }
+
+  char filename[FILE_MAXFILE];
+  BLI_snprintf(filename,
+               sizeof(filename),
+               "moviecache_%d_%u.raw",
+               (int)getpid(),
+               disk_spill.files_counter++);
+
+  disk_file = MEM_callocN(sizeof(MovieCacheDiskFile), "MovieCacheDiskFile");
+  BLI_path_join(disk_file->path, sizeof(disk_file->path), disk_spill.dirpath, filename, NULL);
+  disk_file->size = size;
+  disk_file->item = item;
+  disk_file->ibuf_header = ibuf_header;
+  disk_file->ibuf_write = ibuf;
+  IMB_refImBuf(ibuf);
+  item->disk_file = disk_file;
+  BLI_addtail(&disk_spill.files_pending, disk_file);
+
+  BLI_mutex_unlock(&disk_spill_lock);
+
+  PRINT("%s: cache '%s' spill item %p to %s\n",
+        __func__,
+        item->cache_owner->name,
+        item,
+        disk_file->path);
+}
+
+/* Write the buffers queued by #moviecache_disk_spill, must be called with `limitor_lock`
+ * unlocked. */
+static void moviecache_disk_flush(void)
+{
+  MovieCacheDiskFile *disk_file;
+
+  BLI_mutex_lock(&disk_spill_lock);
+
+  while ((disk_file = BLI_pophead(&disk_spill.files_pending))) {
+    disk_file->is_writing = true;
+    BLI_mutex_unlock(&disk_spill_lock);
+
+    const bool ok = moviecache_disk_write(disk_file->path, disk_file->ibuf_write);
+
+    BLI_mutex_lock(&disk_spill_lock);
+    IMB_freeImBuf(disk_file->ibuf_write);
+    disk_file->ibuf_write = NULL;
+    disk_file->is_writing = false;
+
+    if (!ok || disk_file->item == NULL) {
+      /* Failed, or the item was removed while writing. */
+      if (disk_file->item) {
+        disk_file->item->disk_file = NULL;
+      }
+      if (disk_file->ibuf_header) {
+        IMB_freeImBuf(disk_file->ibuf_header);
+      }
+      if (ok) {
+        BLI_delete(disk_file->path, false, false);
+      }
+      MEM_freeN(disk_file);
+      continue;
+    }
+
+    BLI_addtail(&disk_spill.files, disk_file);
+    disk_spill.size_total += disk_file->size;
+  }
+
+  moviecache_disk_enforce_limits();
+
+  BLI_mutex_unlock(&disk_spill_lock);
+}
+
+/* Read pixels of an item back from disk, the file is kept for when the item is freed again. */
+static ImBuf *moviecache_disk_load(MovieCacheItem *item)
+{
+  BLI_mutex_lock(&disk_spill_lock);
+
+  MovieCacheDiskFile *disk_file = item->disk_file;
+  if (disk_file == NULL || disk_file->ibuf_header == NULL) {
+    BLI_mutex_unlock(&disk_spill_lock);
+    return NULL;
+  }
+
+  if (disk_file->ibuf_write) {
+    /* Pixels are not written yet, use them again, the file is still written. */
+    ImBuf *ibuf = disk_file->ibuf_write;
+    IMB_refImBuf(ibuf);
+    IMB_freeImBuf(disk_file->ibuf_header);
+    disk_file->ibuf_header = NULL;
+    BLI_mutex_unlock(&disk_spill_lock);
+    return ibuf;
+  }
+
+  /* Unlisted files are not removed by other threads enforcing limits while reading. */
+  BLI_remlink(&disk_spill.files, disk_file);
+  BLI_mutex_unlock(&disk_spill_lock);
+
+  ImBuf *ibuf = disk_file->ibuf_header;
+  const bool ok = moviecache_disk_read(disk_file->path, disk_file->size, ibuf);
+
+  PRINT("%s: cache '%s' load item %p from %s: %s\n",
+        __func__,
+        item->cache_owner->name,
+        item,
+        disk_file->path,
+        ok ? "ok" : "failed");
+
+  BLI_mutex_lock(&disk_spill_lock);
+  BLI_addtail(&disk_spill.files, disk_file);
+  if (ok) {
+    disk_file->ibuf_header = NULL;
+  }
+  else {
+    moviecache_disk_file_delete(disk_file);
+    ibuf = NULL;
+  }
+  BLI_mutex_unlock(&disk_spill_lock);
+
+  return ibuf;
+}
+
+static void moviecache_disk_item_free(MovieCacheItem *item)
+{
+  BLI_mutex_lock(&disk_spill_lock);
+  if (item->disk_file) {
+    moviecache_disk_file_delete(item->disk_file);
+  }
+  BLI_mutex_unlock(&disk_spill_lock);
+}
+
+/* Run the cleanup callback of #IMB_moviecache_cleanup for an item which is only on disk. */
+static bool moviecache_disk_cleanup_check(MovieCacheItem *item,
+                                          void *userkey,
+                                          bool(cleanup_check_cb)(ImBuf *ibuf,
+                                                                 void *userkey,
+                                                                 void *userdata),
+                                          void *userdata)
+{
+  bool remove = true;
+
+  BLI_mutex_lock(&disk_spill_lock);
+  if (item->disk_file && item->disk_file->ibuf_header) {
+    remove = cleanup_check_cb(item->disk_file->ibuf_header, userkey, userdata);
+  }
+  BLI_mutex_unlock(&disk_spill_lock);
+
+  return remove;
+}
+
+/**
+ * Set where and how much data of caches which use disk spill is stored.
+ *
+ * \param dirpath: Directory to store files in, the session temporary directory is used when empty.
+ * \param size_limit: Size limit of all files in bytes, zero disables the disk spill.
+ */
+void IMB_moviecache_set_disk_spill_limit(const char *dirpath, size_t size_limit)
+{
+  BLI_mutex_lock(&disk_spill_lock);
+
+  if (dirpath[0] != '\0') {
+    BLI_strncpy(disk_spill.dirpath, dirpath, sizeof(disk_spill.dirpath));
+  }
+  else {
+    BLI_strncpy(disk_spill.dirpath, BKE_tempdir_session(), sizeof(disk_spill.dirpath));
+  }
+  disk_spill.size_limit = size_limit;
+  moviecache_disk_enforce_limits();
+
+  BLI_mutex_unlock(&disk_spill_lock);
+}
+
+/**
+ * Write items of the cache to disk when they are freed by the cache limiter,
+ * so they are read back from there instead of being created again.
+ * Only use for caches of buffers which don't change while they are cached.
+ */
+void IMB_moviecache_set_disk_spill(MovieCache *cache, bool use_disk_spill)
+{
+  cache->use_disk_spill = use_disk_spill;
+}
+
+/** \} */
+
 static unsigned int moviecache_hashhash(const void *keyv)
 {
   const MovieCacheKey *key = keyv;
@@ -125,6 +595,11 @@ static void moviecache_valfree(void *val)
     IMB_freeImBuf(item->ibuf);
   }
 
+  /* Items removed by #check_unused_keys have no file, `disk_spill_lock` is locked then. */
+  if (item->disk_file) {
+    moviecache_disk_item_free(item);
+  }
+
   if (item->priority_data && cache->prioritydeleterfp) {
     cache->prioritydeleterfp(item->priority_data);
   }
@@ -136,6 +611,10 @@ static void check_unused_keys(MovieCache *cache)
 {
   GHashIterator gh_iter;
 
+  if (cache->use_disk_spill) {
+    BLI_mutex_lock(&disk_spill_lock);
+  }
+
   BLI_ghashIterator_init(&gh_iter, cache->hash);
 
   while (!BLI_ghashIterator_done(&gh_iter)) {
@@ -145,7 +624,7 @@ static void check_unused_keys(MovieCache *cache)
 
     BLI_ghashIterator_step(&gh_iter);
 
-    remove = !item->ibuf;
+    remove = !item->ibuf && !item->disk_file;
 
     if (remove) {
       PRINT("%s: cache '%s' remove item %p without buffer\n", __func__, cache->name, item);
@@ -155,6 +634,10 @@ static void check_unused_keys(MovieCache *cache)
       BLI_ghash_remove(cache->hash, key, moviecache_keyfree, moviecache_valfree);
     }
   }
+
+  if (cache->use_disk_spill) {
+    BLI_mutex_unlock(&disk_spill_lock);
+  }
 }
 
 static int compare_int(const void *av, const void *bv)
@@ -173,6 +656,10 @@ static void IMB_moviecache_destructor(void *p)
 
     PRINT("%s: cache '%s' destroy item %p buffer %p\n", __func__, cache->name, item, item->ibuf);
 
+    if (cache->use_disk_spill && disk_spill.size_limit != 0) {
+      moviecache_disk_spill(item);
+    }
+
     IMB_freeImBuf(item->ibuf);
 
     item->ibuf = NULL;
@@ -328,6 +815,7 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
   item->cache_owner = cache;
   item->c_handle = NULL;
   item->priority_data = NULL;
+  item->disk_file = NULL;
 
   if (cache->getprioritydatafp) {
     item->priority_data = cache->getprioritydatafp(userkey);
@@ -351,6 +839,7 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
 
   if (need_lock) {
     BLI_mutex_unlock(&limitor_lock);
+    moviecache_disk_flush();
   }
 
   /* cache limiter can't remove unused keys which points to destroyed values */
@@ -385,6 +874,8 @@ bool IMB_moviecache_put_if_possible(MovieCache *cache, void *userkey, ImBuf *ibu
 
   BLI_mutex_unlock(&limitor_lock);
 
+  moviecache_disk_flush();
+
   return result;
 }
 
@@ -415,6 +906,31 @@ ImBuf *IMB_moviecache_get(MovieCache *cache, void *userkey)
 
       return item->ibuf;
     }
+
+    if (item->disk_file) {
+      ImBuf *ibuf = moviecache_disk_load(item);
+      if (ibuf) {
+        item->ibuf = ibuf;
+
+        BLI_mutex_lock(&limitor_lock);
+        item->c_handle = MEM_CacheLimiter_insert(limitor, item);
+        MEM_CacheLimiter_ref(item->c_handle);
+        MEM_CacheLimiter_enforce_limits(limitor);
+        MEM_CacheLimiter_unref(item->c_handle);
+        BLI_mutex_unlock(&limitor_lock);
+
+        moviecache_disk_flush();
+
+        if (cache->points) {
+          MEM_freeN(cache->points);
+          cache->points = NULL;
+        }
+
+        IMB_refImBuf(item->ibuf);
+
+        return item->ibuf;
+      }
+    }
   }
 
   return NULL;
@@ -469,7 +985,15 @@ void IMB_moviecache_cleanup(MovieCache *cache,
 
     BLI_ghashIterator_step(&gh_iter);
 
-    if (cleanup_check_cb(item->ibuf, key->userkey, userdata)) {
+    bool remove;
+    if (item->ibuf) {
+      remove = cleanup_check_cb(item->ibuf, key->userkey, userdata);
+    }
+    else {
+      remove = moviecache_disk_cleanup_check(item, key->userkey, cleanup_check_cb, userdata);
+    }
+
+    if (remove) {
       PRINT("%s: cache '%s' remove item %p\n", __func__, cache->name, item);
 
       BLI_ghash_remove(cache->hash, key, moviecache_keyfree, moviecache_valfree);
@@ -568,12 +1092,25 @@ void IMB_moviecache_get_cache_segments(
   }
 }
 
+/* Items which are only stored on disk are skipped by iterators. */
+static void moviecache_iter_skip_unloaded(GHashIterator *iter)
+{
+  while (!BLI_ghashIterator_done(iter)) {
+    const MovieCacheItem *item = BLI_ghashIterator_getValue(iter);
+    if (item->ibuf) {
+      break;
+    }
+    BLI_ghashIterator_step(iter);
+  }
+}
+
 struct MovieCacheIter *IMB_moviecacheIter_new(MovieCache *cache)
 {
   GHashIterator *iter;
 
   check_unused_keys(cache);
   iter = BLI_ghashIterator_new(cache->hash);
+  moviecache_iter_skip_unloaded(iter);
 
   return (struct MovieCacheIter *)iter;
 }
@@ -591,6 +1128,7 @@ bool IMB_moviecacheIter_done(struct MovieCacheIter *iter)
 void IMB_moviecacheIter_step(struct MovieCacheIter *iter)
 {
   BLI_ghashIterator_step((GHashIterator *)iter);
+  moviecache_iter_skip_unloaded((GHashIterator *)iter);
 }
 
 ImBuf *IMB_moviecacheIter_getImBuf(struct MovieCacheIter *iter)
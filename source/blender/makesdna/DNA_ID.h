@@ -261,7 +261,11 @@ typedef struct ID {
   int us;
   int icon_id;
   int recalc;
-  char _pad[4];
+  /**
+   * Recalc flags accumulated since the last memfile undo push, non-zero when the ID may differ
+   * from its state stored in that undo step.
+   */
+  int recalc_after_undo_push;
   IDProperty *properties;
 
   /** Reference linked ID which this one overrides. */
@@ -558,6 +562,10 @@ enum {
   /* Datablock was not allocated by standard system (BKE_libblock_alloc), do not free its memory
    * (usual type-specific freeing is called though). */
   LIB_TAG_NOT_ALLOCATED = 1 << 18,
+
+  /* RESET_AFTER_USE Used by undo, the datablock was unchanged and kept from the previous state
+   * instead of being read again. */
+  LIB_TAG_UNDO_OLD_ID_REUSED = 1 << 19,
 };
 
 /* Tag given ID for an update in all the dependency graphs. */
@@ -508,6 +508,9 @@ typedef struct bNodeTree {
 
 /* tree is localized copy, free when deleting node groups */
 /* #define NTREE_IS_LOCALIZED           (1 << 5) */
+#define NTREE_COM_AREA_EXECUTION (1 << 6) /* calculate areas one operation at a time */
+#define NTREE_COM_RESULT_CACHE (1 << 7)   /* keep buffers of unchanged nodes between executions */
+#define NTREE_COM_HALF_BUFFERS (1 << 8)   /* store intermediate buffers as half floats */
 
 /* ntree->update */
 typedef enum eNodeTreeUpdate {
@@ -276,6 +276,9 @@ typedef struct Editing {
   int cache_flag;
 
   struct PrefetchJob *prefetch_job;
+
+  /** Time stamp of the disk cache directory, changed whenever cached images are invalidated. */
+  int64_t disk_cache_timestamp;
 } Editing;
 
 /* ************* Effect Variable Structs ********* */
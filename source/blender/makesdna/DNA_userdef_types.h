@@ -853,7 +853,23 @@ typedef struct UserDef {
 
   char render_display_type;      /* eUserpref_RenderDisplayType */
   char filebrowser_display_type; /* eUserpref_TempSpaceDisplayType */
-  char _pad5[4];
+  /** #eUserpref_SeqDiskCacheFlag. */
+  char sequencer_disk_cache_flag;
+  /** #eUserpref_SeqDiskCacheCompression. */
+  char sequencer_disk_cache_compression;
+  /** #eUserpref_MovieDiskCacheFlag. */
+  char movie_disk_cache_flag;
+  char _pad5[1];
+  /** Sequencer disk cache size limit (in gigabytes). */
+  int sequencer_disk_cache_size_limit;
+  /** Sequencer disk cache directory, the temporary directory is used when empty. */
+  char sequencer_disk_cache_dir[1024];
+  /** Movie clip and image cache disk spill size limit (in gigabytes). */
+  int movie_disk_cache_size_limit;
+  /** Movie clip and image cache disk spill directory,
+   * the session temporary directory is used when empty. */
+  char movie_disk_cache_dir[1024];
+  char _pad6[8];
 
   struct WalkNavigation walk_navigation;
 
@@ -1279,6 +1295,23 @@ typedef enum eUserpref_TempSpaceDisplayType {
   USER_TEMP_SPACE_DISPLAY_WINDOW,
 } eUserpref_TempSpaceDisplayType;
 
+/** #UserDef.sequencer_disk_cache_flag */
+typedef enum eUserpref_SeqDiskCacheFlag {
+  USER_SEQ_DISK_CACHE_ENABLE = (1 << 0),
+} eUserpref_SeqDiskCacheFlag;
+
+/** #UserDef.movie_disk_cache_flag */
+typedef enum eUserpref_MovieDiskCacheFlag {
+  USER_MOVIE_DISK_CACHE_ENABLE = (1 << 0),
+} eUserpref_MovieDiskCacheFlag;
+
+/** #UserDef.sequencer_disk_cache_compression */
+typedef enum eUserpref_SeqDiskCacheCompression {
+  USER_SEQ_DISK_CACHE_COMPRESSION_NONE = 0,
+  USER_SEQ_DISK_CACHE_COMPRESSION_LOW = 1,
+  USER_SEQ_DISK_CACHE_COMPRESSION_HIGH = 2,
+} eUserpref_SeqDiskCacheCompression;
+
 typedef enum eUserpref_EmulateMMBMod {
   USER_EMU_MMB_MOD_ALT = 0,
   USER_EMU_MMB_MOD_OSKEY = 1,
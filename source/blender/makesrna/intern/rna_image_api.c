@@ -205,6 +205,7 @@ static void rna_Image_update(Image *image, ReportList *reports)
   }
 
   ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+  IMB_tag_changed(ibuf);
 
   BKE_image_release_ibuf(image, ibuf, NULL);
 }
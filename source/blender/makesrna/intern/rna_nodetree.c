@@ -9354,6 +9354,28 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
                            "Use two pass execution during editing: first calculate fast nodes, "
                            "second pass calculate all nodes");
 
+  prop = RNA_def_property(srna, "use_area_execution", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_AREA_EXECUTION);
+  RNA_def_property_ui_text(prop,
+                           "Area Execution",
+                           "Calculate whole areas one operation at a time instead of pixel by "
+                           "pixel, for operations that support it");
+
+  prop = RNA_def_property(srna, "use_result_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_RESULT_CACHE);
+  RNA_def_property_ui_text(prop,
+                           "Cache Results",
+                           "Keep the results of nodes between executions, so that nodes whose "
+                           "settings and inputs did not change are not calculated again "
+                           "(limited by the memory cache limit in the preferences)");
+
+  prop = RNA_def_property(srna, "use_half_buffers", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_HALF_BUFFERS);
+  RNA_def_property_ui_text(prop,
+                           "Half Float Buffers",
+                           "Store the buffers between nodes as half floats, using half the "
+                           "memory at the cost of precision (values above 65504 are clamped)");
+
   prop = RNA_def_property(srna, "use_viewer_border", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_VIEWER_BORDER);
   RNA_def_property_ui_text(
@@ -206,6 +206,22 @@ static void engine_bake(RenderEngine *engine,
   RNA_parameter_list_free(&list);
 }
 
+static void engine_bake_batch_end(RenderEngine *engine)
+{
+  extern FunctionRNA rna_RenderEngine_bake_batch_end_func;
+  PointerRNA ptr;
+  ParameterList list;
+  FunctionRNA *func;
+
+  RNA_pointer_create(NULL, engine->type->ext.srna, engine, &ptr);
+  func = &rna_RenderEngine_bake_batch_end_func;
+
+  RNA_parameter_list_create(&list, &ptr, func);
+  engine->type->ext.call(NULL, &ptr, func, &list);
+
+  RNA_parameter_list_free(&list);
+}
+
 static void engine_view_update(RenderEngine *engine,
                                const struct bContext *context,
                                Depsgraph *depsgraph)
@@ -363,6 +379,7 @@ static StructRNA *rna_RenderEngine_register(Main *bmain,
   et->view_draw = (have_function[4]) ? engine_view_draw : NULL;
   et->update_script_node = (have_function[5]) ? engine_update_script_node : NULL;
   et->update_render_passes = (have_function[6]) ? engine_update_render_passes : NULL;
+  et->bake_batch_end = (have_function[7]) ? engine_bake_batch_end : NULL;
 
   RE_engines_register(et);
 
@@ -589,6 +606,11 @@ static void rna_def_render_engine(BlenderRNA *brna)
   parm = RNA_def_pointer(func, "scene", "Scene", "", "");
   parm = RNA_def_pointer(func, "renderlayer", "ViewLayer", "", "");
 
+  func = RNA_def_function(srna, "bake_batch_end", NULL);
+  RNA_def_function_ui_description(
+      func, "Free data kept for the bakes of a batch, when the engine is kept afterwards");
+  RNA_def_function_flag(func, FUNC_REGISTER_OPTIONAL | FUNC_ALLOW_WRITE);
+
   /* tag for redraw */
   func = RNA_def_function(srna, "tag_redraw", "engine_tag_redraw");
   RNA_def_function_ui_description(func, "Request redraw for viewport rendering");
@@ -785,6 +807,9 @@ static void rna_def_render_engine(BlenderRNA *brna)
   prop = RNA_def_property(srna, "is_preview", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", RE_ENGINE_PREVIEW);
 
+  prop = RNA_def_property(srna, "is_bake_batch", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", RE_ENGINE_BAKE_BATCH);
+
   prop = RNA_def_property(srna, "camera_override", PROP_POINTER, PROP_NONE);
   RNA_def_property_pointer_funcs(prop, "rna_RenderEngine_camera_override_get", NULL, NULL, NULL);
   RNA_def_property_struct_type(prop, "Object");
@@ -195,6 +195,8 @@ static const EnumPropertyItem rna_enum_userdef_viewport_aa_items[] = {
 #  include "MEM_guardedalloc.h"
 #  include "MEM_CacheLimiterC-Api.h"
 
+#  include "IMB_moviecache.h"
+
 #  include "UI_interface.h"
 
 #  ifdef WITH_OPENSUBDIV
@@ -536,6 +538,18 @@ static void rna_Userdef_memcache_update(Main *UNUSED(bmain),
   USERDEF_TAG_DIRTY;
 }
 
+static void rna_Userdef_movie_disk_cache_update(Main *UNUSED(bmain),
+                                                Scene *UNUSED(scene),
+                                                PointerRNA *UNUSED(ptr))
+{
+  IMB_moviecache_set_disk_spill_limit(
+      U.movie_disk_cache_dir,
+      (U.movie_disk_cache_flag & USER_MOVIE_DISK_CACHE_ENABLE) ?
+          ((size_t)U.movie_disk_cache_size_limit) * 1024 * 1024 * 1024 :
+          0);
+  USERDEF_TAG_DIRTY;
+}
+
 static void rna_UserDef_weight_color_update(Main *bmain, Scene *scene, PointerRNA *ptr)
 {
   Object *ob;
@@ -5024,6 +5038,25 @@ static void rna_def_userdef_system(BlenderRNA *brna)
       {0, NULL, 0, NULL, NULL},
   };
 
+  static const EnumPropertyItem seq_disk_cache_compression_levels[] = {
+      {USER_SEQ_DISK_CACHE_COMPRESSION_NONE,
+       "NONE",
+       0,
+       "None",
+       "Requires fast storage, but uses minimum CPU resources"},
+      {USER_SEQ_DISK_CACHE_COMPRESSION_LOW,
+       "LOW",
+       0,
+       "Low",
+       "Doesn't require fast storage and uses less CPU resources"},
+      {USER_SEQ_DISK_CACHE_COMPRESSION_HIGH,
+       "HIGH",
+       0,
+       "High",
+       "Works on slower storage devices and uses most CPU resources"},
+      {0, NULL, 0, NULL, NULL},
+  };
+
   srna = RNA_def_struct(brna, "PreferencesSystem", NULL);
   RNA_def_struct_sdna(srna, "UserDef");
   RNA_def_struct_nested(brna, srna, "Preferences");
@@ -5074,6 +5107,58 @@ static void rna_def_userdef_system(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Memory Cache Limit", "Memory cache limit (in megabytes)");
   RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
 
+  prop = RNA_def_property(srna, "use_sequencer_disk_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(
+      prop, NULL, "sequencer_disk_cache_flag", USER_SEQ_DISK_CACHE_ENABLE);
+  RNA_def_property_ui_text(prop,
+                           "Sequencer Disk Cache",
+                           "Store cached sequencer images on disk, so they are kept when the "
+                           "memory cache is full or the file is opened again");
+
+  prop = RNA_def_property(srna, "sequencer_disk_cache_dir", PROP_STRING, PROP_DIRPATH);
+  RNA_def_property_string_sdna(prop, NULL, "sequencer_disk_cache_dir");
+  RNA_def_property_ui_text(prop,
+                           "Disk Cache Directory",
+                           "Override default directory (the temporary directory is used when "
+                           "empty)");
+
+  prop = RNA_def_property(srna, "sequencer_disk_cache_size_limit", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "sequencer_disk_cache_size_limit");
+  RNA_def_property_range(prop, 1, INT_MAX);
+  RNA_def_property_ui_text(prop, "Disk Cache Limit", "Disk cache limit of a scene (in gigabytes)");
+
+  prop = RNA_def_property(srna, "sequencer_disk_cache_compression", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_items(prop, seq_disk_cache_compression_levels);
+  RNA_def_property_enum_sdna(prop, NULL, "sequencer_disk_cache_compression");
+  RNA_def_property_ui_text(
+      prop,
+      "Disk Cache Compression Level",
+      "Smaller compression will result in larger files, but less decoding time");
+
+  prop = RNA_def_property(srna, "use_movie_disk_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "movie_disk_cache_flag", USER_MOVIE_DISK_CACHE_ENABLE);
+  RNA_def_property_ui_text(prop,
+                           "Movie Disk Cache",
+                           "Store movie clip and image sequence frames on disk when they are "
+                           "freed from the memory cache, so they are loaded from there instead of "
+                           "being read and decoded again");
+  RNA_def_property_update(prop, 0, "rna_Userdef_movie_disk_cache_update");
+
+  prop = RNA_def_property(srna, "movie_disk_cache_dir", PROP_STRING, PROP_DIRPATH);
+  RNA_def_property_string_sdna(prop, NULL, "movie_disk_cache_dir");
+  RNA_def_property_ui_text(prop,
+                           "Movie Disk Cache Directory",
+                           "Override default directory (the temporary directory is used when "
+                           "empty), preferably on fast local storage");
+  RNA_def_property_update(prop, 0, "rna_Userdef_movie_disk_cache_update");
+
+  prop = RNA_def_property(srna, "movie_disk_cache_size_limit", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "movie_disk_cache_size_limit");
+  RNA_def_property_range(prop, 1, INT_MAX);
+  RNA_def_property_ui_text(
+      prop, "Movie Disk Cache Limit", "Disk cache limit of movie frames (in gigabytes)");
+  RNA_def_property_update(prop, 0, "rna_Userdef_movie_disk_cache_update");
+
   prop = RNA_def_property(srna, "scrollback", PROP_INT, PROP_UNSIGNED);
   RNA_def_property_int_sdna(prop, NULL, "scrollback");
   RNA_def_property_range(prop, 32, 32768);
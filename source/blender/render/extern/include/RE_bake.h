@@ -62,6 +62,9 @@ typedef struct BakeHighPolyData {
 /* external_engine.c */
 bool RE_bake_has_engine(struct Render *re);
 
+void RE_bake_engine_batch_begin(struct Render *re);
+void RE_bake_engine_batch_end(struct Render *re);
+
 bool RE_bake_engine(struct Render *re,
                     struct Depsgraph *depsgraph,
                     struct Object *object,
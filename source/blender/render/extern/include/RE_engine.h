@@ -67,6 +67,7 @@ struct bNodeTree;
 #define RE_ENGINE_RENDERING 16
 #define RE_ENGINE_HIGHLIGHT_TILES 32
 #define RE_ENGINE_USED_FOR_VIEWPORT 64
+#define RE_ENGINE_BAKE_BATCH 128
 
 extern ListBase R_engines;
 
@@ -90,6 +91,7 @@ typedef struct RenderEngineType {
                const int num_pixels,
                const int depth,
                void *result);
+  void (*bake_batch_end)(struct RenderEngine *engine);
 
   void (*view_update)(struct RenderEngine *engine,
                       const struct bContext *context,
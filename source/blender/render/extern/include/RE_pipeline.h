@@ -144,6 +144,9 @@ typedef struct RenderResult {
   /* for render results in Image, verify validity for sequences */
   int framenr;
 
+  /* unique among all results and changed along with their passes, for caches of them */
+  unsigned int changed_timestamp;
+
   /* for acquire image, to indicate if it there is a combined layer */
   int have_combined;
 
@@ -164,5 +164,6 @@ struct Render {
 
 /* R.flag */
 #define R_ANIMATION 1
+#define R_BAKE_BATCH 2
 
 #endif /* __RENDER_TYPES_H__ */
@@ -569,6 +569,43 @@ bool RE_bake_has_engine(Render *re)
   return (type->bake != NULL);
 }
 
+/* Bakes between begin and end share the engine, so it can keep the scene it synced for the first
+ * bake instead of syncing it again for every object. The depsgraph passed to them must be the
+ * same and not change in between. */
+void RE_bake_engine_batch_begin(Render *re)
+{
+  re->flag |= R_BAKE_BATCH;
+}
+
+void RE_bake_engine_batch_end(Render *re)
+{
+  RenderEngine *engine = re->engine;
+  bool persistent_data = (re->r.mode & R_PERSISTENT_DATA) != 0;
+
+  re->flag &= ~R_BAKE_BATCH;
+
+  if (!engine) {
+    return;
+  }
+
+  /* A persistent engine outlives the batch, let it free the data it kept for it. */
+  if (persistent_data && (engine->flag & RE_ENGINE_BAKE_BATCH) && engine->type->bake_batch_end) {
+    engine->type->bake_batch_end(engine);
+  }
+
+  BLI_rw_mutex_lock(&re->partsmutex, THREAD_LOCK_WRITE);
+
+  if (persistent_data) {
+    engine->flag &= ~RE_ENGINE_BAKE_BATCH;
+  }
+  else {
+    RE_engine_free(engine);
+    re->engine = NULL;
+  }
+
+  BLI_rw_mutex_unlock(&re->partsmutex);
+}
+
 bool RE_bake_engine(Render *re,
                     Depsgraph *depsgraph,
                     Object *object,
@@ -583,6 +620,7 @@ bool RE_bake_engine(Render *re,
   RenderEngineType *type = RE_engines_find(re->r.engine);
   RenderEngine *engine;
   bool persistent_data = (re->r.mode & R_PERSISTENT_DATA) != 0;
+  bool is_batch = (re->flag & R_BAKE_BATCH) != 0;
 
   /* set render info */
   re->i.cfra = re->scene->r.cfra;
@@ -612,11 +650,16 @@ bool RE_bake_engine(Render *re,
   if (type->bake) {
     engine->depsgraph = depsgraph;
 
-    /* update is only called so we create the engine.session */
-    if (type->update) {
+    /* update is only called so we create the engine.session, within a batch
+     * the session created for the first bake is used for all of them */
+    if (type->update && !(engine->flag & RE_ENGINE_BAKE_BATCH)) {
       type->update(engine, re->main, engine->depsgraph);
     }
 
+    if (is_batch) {
+      engine->flag |= RE_ENGINE_BAKE_BATCH;
+    }
+
     type->bake(engine,
                engine->depsgraph,
                object,
@@ -638,7 +681,7 @@ bool RE_bake_engine(Render *re,
   BLI_rw_mutex_lock(&re->partsmutex, THREAD_LOCK_WRITE);
 
   /* re->engine becomes zero if user changed active render engine during render */
-  if (!persistent_data || !re->engine) {
+  if ((!persistent_data && !is_batch) || !re->engine) {
     RE_engine_free(engine);
     re->engine = NULL;
   }
@@ -893,6 +893,7 @@ void RE_InitState(Render *re,
     /* make empty render result, so display callbacks can initialize */
     render_result_free(re->result);
     re->result = MEM_callocN(sizeof(RenderResult), "new render result");
+    render_result_tag_changed(re->result);
     re->result->rectx = re->rectx;
     re->result->recty = re->recty;
     render_result_view_new(re->result, "");
@@ -28,6 +28,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
 #include "BLI_listbase.h"
@@ -303,6 +305,7 @@ RenderResult *render_result_new(Render *re,
   }
 
   rr = MEM_callocN(sizeof(RenderResult), "new render result");
+  render_result_tag_changed(rr);
   rr->rectx = rectx;
   rr->recty = recty;
   rr->renrect.xmin = 0;
@@ -744,6 +747,7 @@ RenderResult *render_result_new_from_exr(
   const char *to_colorspace = IMB_colormanagement_role_colorspace_name_get(
       COLOR_ROLE_SCENE_LINEAR);
 
+  render_result_tag_changed(rr);
   rr->rectx = rectx;
   rr->recty = recty;
 
@@ -855,6 +859,8 @@ void render_result_merge(RenderResult *rr, RenderResult *rrpart)
   RenderLayer *rl, *rlp;
   RenderPass *rpass, *rpassp;
 
+  render_result_tag_changed(rr);
+
   for (rl = rr->layers.first; rl; rl = rl->next) {
     rlp = RE_GetRenderLayer(rrpart, rl->name);
     if (rlp) {
@@ -879,6 +885,14 @@ void render_result_merge(RenderResult *rr, RenderResult *rrpart)
   }
 }
 
+static unsigned int render_result_changed_timestamp = 0;
+
+/* Give the result a timestamp no other result had, call it when its passes change. */
+void render_result_tag_changed(RenderResult *rr)
+{
+  rr->changed_timestamp = atomic_add_and_fetch_uint32(&render_result_changed_timestamp, 1);
+}
+
 /* Called from the UI and render pipeline, to save multilayer and multiview
  * images, optionally isolating a specific, view, layer or RGBA/Z pass. */
 bool RE_WriteRenderResult(ReportList *reports,
@@ -1097,6 +1111,7 @@ void render_result_single_layer_end(Render *re)
 
   RE_FreeRenderResult(re->pushedresult);
   re->pushedresult = NULL;
+  render_result_tag_changed(re->result);
 }
 
 /************************* EXR Tile File Rendering ***************************/
@@ -1372,6 +1387,7 @@ int render_result_exr_file_read_path(RenderResult *rr,
 
   IMB_exr_read_channels(exrhandle);
   IMB_exr_close(exrhandle);
+  render_result_tag_changed(rr);
 
   return 1;
 }
@@ -1690,5 +1706,6 @@ RenderResult *RE_DuplicateRenderResult(RenderResult *rr)
     new_rr->rectz = MEM_dupallocN(new_rr->rectz);
   }
   new_rr->stamp_data = BKE_stamp_data_copy(new_rr->stamp_data);
+  render_result_tag_changed(new_rr);
   return new_rr;
 }
@@ -96,6 +96,7 @@
 
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
+#include "IMB_moviecache.h"
 #include "IMB_thumbs.h"
 
 #include "ED_datafiles.h"
@@ -372,6 +373,13 @@ static void wm_init_userdef(Main *bmain)
 
   /* update tempdir from user preferences */
   BKE_tempdir_init(U.tempdir);
+
+  /* after tempdir, which is used when no directory is set */
+  IMB_moviecache_set_disk_spill_limit(
+      U.movie_disk_cache_dir,
+      (U.movie_disk_cache_flag & USER_MOVIE_DISK_CACHE_ENABLE) ?
+          ((size_t)U.movie_disk_cache_size_limit) * 1024 * 1024 * 1024 :
+          0);
 }
 
 /* return codes */
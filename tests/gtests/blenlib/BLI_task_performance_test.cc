@@ -122,6 +122,118 @@ TEST(task, RangeIter1000k)
   task_parallel_range_test_do("Range parallel iteration - Threaded - 1000K items", 1000000, true);
 }
 
+/* *** Nested parallel iterations over range of indices. *** */
+
+static void task_parallel_range_nested_func(void *userdata,
+                                            int index,
+                                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const int num_items_inner = *(int *)userdata;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  BLI_task_parallel_range(
+      index, index + num_items_inner, NULL, task_parallel_range_func, &settings);
+}
+
+static void task_parallel_range_nested_test_do(const char *id,
+                                               const int num_items_outer,
+                                               int num_items_inner)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  double averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const double init_time = PIL_check_seconds_timer();
+    BLI_task_parallel_range(
+        0, num_items_outer, &num_items_inner, task_parallel_range_nested_func, &settings);
+    averaged_timing += PIL_check_seconds_timer() - init_time;
+  }
+
+  printf("\t%s: done in %fs on average over %d runs\n",
+         id,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+}
+
+TEST(task, RangeIterNested16x10k)
+{
+  task_parallel_range_nested_test_do(
+      "Nested range parallel iteration - 16 x 10K items", 16, 10000);
+}
+
+TEST(task, RangeIterNested256x1k)
+{
+  task_parallel_range_nested_test_do(
+      "Nested range parallel iteration - 256 x 1K items", 256, 1000);
+}
+
+/* *** Task pool with many small tasks pushed from worker threads. *** */
+
+static void task_pool_tree_func(TaskPool *__restrict pool, void *taskdata, int thread_id)
+{
+  const int depth = POINTER_AS_INT(taskdata);
+  uint *num_tasks_done = (uint *)BLI_task_pool_userdata(pool);
+
+  /* Small amount of work, so scheduling overhead dominates, similar to depsgraph evaluation. */
+  task_parallel_range_func(NULL, depth, NULL);
+  atomic_add_and_fetch_uint32(num_tasks_done, 1);
+
+  if (depth > 0) {
+    for (int i = 0; i < 4; i++) {
+      BLI_task_pool_push_from_thread(pool,
+                                     task_pool_tree_func,
+                                     POINTER_FROM_INT(depth - 1),
+                                     false,
+                                     TASK_PRIORITY_HIGH,
+                                     thread_id);
+    }
+  }
+}
+
+static void task_pool_tree_test_do(const char *id, const int depth)
+{
+  TaskScheduler *scheduler = BLI_task_scheduler_get();
+
+  uint num_tasks_expected = 0;
+  for (int i = 0, num_level = 1; i <= depth; i++, num_level *= 4) {
+    num_tasks_expected += (uint)num_level;
+  }
+
+  double averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    uint num_tasks_done = 0;
+    const double init_time = PIL_check_seconds_timer();
+    TaskPool *pool = BLI_task_pool_create(scheduler, &num_tasks_done);
+    BLI_task_pool_push(
+        pool, task_pool_tree_func, POINTER_FROM_INT(depth), false, TASK_PRIORITY_HIGH);
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+    averaged_timing += PIL_check_seconds_timer() - init_time;
+
+    EXPECT_EQ(num_tasks_done, num_tasks_expected);
+  }
+
+  printf("\t%s: done in %fs on average over %d runs\n",
+         id,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+}
+
+TEST(task, PoolTree5k)
+{
+  task_pool_tree_test_do("Task pool - Tree of 5461 tasks", 6);
+}
+
+TEST(task, PoolTree87k)
+{
+  task_pool_tree_test_do("Task pool - Tree of 87381 tasks", 8);
+}
+
 /* *** Parallel iterations over double-linked list items. *** */
 
 static void task_listbase_light_iter_func(void *UNUSED(userdata),
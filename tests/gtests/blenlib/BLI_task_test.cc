@@ -253,3 +253,82 @@ TEST(task, ListBaseIter)
   MEM_freeN(items_buffer);
   BLI_threadapi_exit();
 }
+
+/* *** Nested waiting on task pools sharing a thread's queue. *** */
+
+#define NUM_NESTED_TASKS 64
+#define NUM_NESTED_ITERATIONS 100
+
+typedef struct NestedPoolsData {
+  TaskScheduler *scheduler;
+  uint32_t outer_started;
+  uint32_t num_outer_done;
+  uint32_t num_inner_done;
+  uint32_t num_inner_done_after_wait;
+} NestedPoolsData;
+
+static void task_nested_count_func(TaskPool *__restrict UNUSED(pool),
+                                   void *taskdata,
+                                   int UNUSED(threadid))
+{
+  atomic_add_and_fetch_uint32((uint32_t *)taskdata, 1);
+}
+
+static void task_nested_outer_func(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+  NestedPoolsData *data = (NestedPoolsData *)taskdata;
+  TaskPool *inner_pool = BLI_task_pool_create(data->scheduler, NULL);
+
+  atomic_add_and_fetch_uint32(&data->outer_started, 1);
+
+  /* Tasks of the outer pool end up on top of the ones of the inner pool in this thread's queue,
+   * while the main thread waits for the outer pool and can only steal inner tasks. */
+  for (int i = 0; i < NUM_NESTED_TASKS; i++) {
+    BLI_task_pool_push_from_thread(inner_pool,
+                                   task_nested_count_func,
+                                   &data->num_inner_done,
+                                   false,
+                                   TASK_PRIORITY_HIGH,
+                                   threadid);
+  }
+  for (int i = 0; i < NUM_NESTED_TASKS; i++) {
+    BLI_task_pool_push_from_thread(
+        pool, task_nested_count_func, &data->num_outer_done, false, TASK_PRIORITY_HIGH, threadid);
+  }
+
+  BLI_task_pool_work_and_wait(inner_pool);
+  data->num_inner_done_after_wait = atomic_load_uint32(&data->num_inner_done);
+
+  BLI_task_pool_free(inner_pool);
+}
+
+TEST(task, NestedPoolsInterleaved)
+{
+  BLI_threadapi_init();
+
+  /* Main thread and a single worker thread, both waiting on a different pool. */
+  TaskScheduler *scheduler = BLI_task_scheduler_create(2);
+
+  for (int iter = 0; iter < NUM_NESTED_ITERATIONS; iter++) {
+    NestedPoolsData data = {scheduler, 0, 0, 0, 0};
+    TaskPool *pool = BLI_task_pool_create(scheduler, NULL);
+
+    BLI_task_pool_push_from_thread(
+        pool, task_nested_outer_func, &data, false, TASK_PRIORITY_HIGH, 0);
+
+    /* Let the worker thread run the outer task. */
+    while (atomic_load_uint32(&data.outer_started) == 0) {
+    }
+
+    BLI_task_pool_work_and_wait(pool);
+
+    EXPECT_EQ(NUM_NESTED_TASKS, data.num_inner_done_after_wait);
+    EXPECT_EQ(NUM_NESTED_TASKS, data.num_inner_done);
+    EXPECT_EQ(NUM_NESTED_TASKS, data.num_outer_done);
+
+    BLI_task_pool_free(pool);
+  }
+
+  BLI_task_scheduler_free(scheduler);
+  BLI_threadapi_exit();
+}
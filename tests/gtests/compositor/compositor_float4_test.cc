@@ -0,0 +1,173 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include "COM_ConvertOperation.h"
+#include "COM_MixOperation.h"
+
+/* Areas are converted and mixed with the Float4 kernels, pixels with the per pixel functions.
+ * Both have to give the same results, also for values outside of the 0..1 range. */
+
+static const float INF = std::numeric_limits<float>::infinity();
+static const float NAN_VALUE = std::numeric_limits<float>::quiet_NaN();
+
+static const float edge_values[] = {0.0f, 0.25f, 1.0f, -0.5f, -3.0f, 2.5f, INF, -INF, NAN_VALUE};
+static const int edge_values_len = sizeof(edge_values) / sizeof(*edge_values);
+
+static void expect_color_eq(const float expected[4], const float result[4])
+{
+  for (int i = 0; i < 4; i++) {
+    if (std::isnan(expected[i])) {
+      EXPECT_TRUE(std::isnan(result[i])) << "channel " << i << " is " << result[i];
+    }
+    else if (std::isinf(expected[i])) {
+      EXPECT_EQ(expected[i], result[i]) << "channel " << i;
+    }
+    else {
+      const float tolerance = 1e-5f * std::max(1.0f, std::fabs(expected[i]));
+      EXPECT_NEAR(expected[i], result[i], tolerance) << "channel " << i;
+    }
+  }
+}
+
+static void print_color(std::ostream &stream, const float color[4])
+{
+  stream << "(" << color[0] << ", " << color[1] << ", " << color[2] << ", " << color[3] << ")";
+}
+
+template<typename T> static void test_convert_float4()
+{
+  /* Every combination of edge values for the four channels. */
+  const int size = edge_values_len * edge_values_len;
+  rcti rect;
+  rect.xmin = 0;
+  rect.xmax = size;
+  rect.ymin = 0;
+  rect.ymax = size;
+
+  MemoryBuffer input(COM_DT_COLOR, &rect);
+  MemoryBuffer output(COM_DT_COLOR, &rect);
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      float *color = input.getElem(x, y);
+      color[0] = edge_values[x % edge_values_len];
+      color[1] = edge_values[x / edge_values_len];
+      color[2] = edge_values[y % edge_values_len];
+      color[3] = edge_values[y / edge_values_len];
+    }
+  }
+
+  T operation;
+  MemoryBuffer *inputs[1] = {&input};
+  operation.executeArea(&output, &rect, inputs);
+
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      const float *color = input.getElem(x, y);
+      float expected[4];
+      operation.convertPixel(expected, color);
+
+      std::ostringstream trace;
+      trace << "input ";
+      print_color(trace, color);
+      SCOPED_TRACE(trace.str());
+      expect_color_eq(expected, output.getElem(x, y));
+    }
+  }
+}
+
+template<typename T> static void test_mix_float4()
+{
+  const int width = edge_values_len * edge_values_len;
+  const int height = edge_values_len;
+  rcti rect;
+  rect.xmin = 0;
+  rect.xmax = width;
+  rect.ymin = 0;
+  rect.ymax = height;
+
+  MemoryBuffer value(COM_DT_VALUE, &rect);
+  MemoryBuffer color1(COM_DT_COLOR, &rect);
+  MemoryBuffer color2(COM_DT_COLOR, &rect);
+  MemoryBuffer output(COM_DT_COLOR, &rect);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const int i = y, j = x / edge_values_len, k = x % edge_values_len;
+      value.getElem(x, y)[0] = edge_values[i];
+      float *c1 = color1.getElem(x, y);
+      c1[0] = edge_values[j];
+      c1[1] = edge_values[k];
+      c1[2] = edge_values[i];
+      c1[3] = edge_values[(j + k) % edge_values_len];
+      float *c2 = color2.getElem(x, y);
+      c2[0] = edge_values[k];
+      c2[1] = edge_values[i];
+      c2[2] = edge_values[j];
+      c2[3] = edge_values[(i + k) % edge_values_len];
+    }
+  }
+
+  for (int flags = 0; flags < 4; flags++) {
+    T operation;
+    operation.setUseValueAlphaMultiply((flags & 1) != 0);
+    operation.setUseClamp((flags & 2) != 0);
+    MemoryBuffer *inputs[3] = {&value, &color1, &color2};
+    operation.executeArea(&output, &rect, inputs);
+
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        const float *v = value.getElem(x, y);
+        const float *c1 = color1.getElem(x, y);
+        const float *c2 = color2.getElem(x, y);
+        float expected[4];
+        operation.mixPixel(expected, v, c1, c2);
+
+        std::ostringstream trace;
+        trace << "alpha multiply " << (flags & 1) << ", clamp " << ((flags & 2) >> 1)
+              << ", value " << v[0] << ", color1 ";
+        print_color(trace, c1);
+        trace << ", color2 ";
+        print_color(trace, c2);
+        SCOPED_TRACE(trace.str());
+        expect_color_eq(expected, output.getElem(x, y));
+      }
+    }
+  }
+}
+
+#define CONVERT_FLOAT4_TEST(name) \
+  TEST(compositor_float4, name) \
+  { \
+    test_convert_float4<name##Operation>(); \
+  }
+
+#define MIX_FLOAT4_TEST(name) \
+  TEST(compositor_float4, name) \
+  { \
+    test_mix_float4<name##Operation>(); \
+  }
+
+CONVERT_FLOAT4_TEST(ConvertRGBToYUV)
+CONVERT_FLOAT4_TEST(ConvertYUVToRGB)
+CONVERT_FLOAT4_TEST(ConvertPremulToStraight)
+CONVERT_FLOAT4_TEST(ConvertStraightToPremul)
+
+MIX_FLOAT4_TEST(MixAdd)
+MIX_FLOAT4_TEST(MixBlend)
+MIX_FLOAT4_TEST(MixColorBurn)
+MIX_FLOAT4_TEST(MixDarken)
+MIX_FLOAT4_TEST(MixDifference)
+MIX_FLOAT4_TEST(MixDivide)
+MIX_FLOAT4_TEST(MixDodge)
+MIX_FLOAT4_TEST(MixLighten)
+MIX_FLOAT4_TEST(MixLinearLight)
+MIX_FLOAT4_TEST(MixMultiply)
+MIX_FLOAT4_TEST(MixOverlay)
+MIX_FLOAT4_TEST(MixScreen)
+MIX_FLOAT4_TEST(MixSoftLight)
+MIX_FLOAT4_TEST(MixSubtract)
@@ -0,0 +1,111 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <string.h>
+
+#include "COM_ResultCache.h"
+#include "COM_SetValueOperation.h"
+#include "COM_WriteBufferOperation.h"
+
+extern "C" {
+#include "DNA_node_types.h"
+#include "DNA_userdef_types.h"
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+}
+
+class CompositorResultCacheTest : public testing::Test {
+ protected:
+  bNodeTree ntree;
+  CompositorContext context;
+  SetValueOperation value;
+  WriteBufferOperation write;
+
+  CompositorResultCacheTest() : write(COM_DT_VALUE)
+  {
+    memset(&ntree, 0, sizeof(ntree));
+    context.setbNodeTree(&ntree);
+
+    unsigned int resolution[2] = {4, 4};
+    value.setResolution(resolution);
+    write.setResolution(resolution);
+    write.getInputSocket(0)->setLink(value.getOutputSocket());
+  }
+
+  void SetUp()
+  {
+    U.memcachelimit = 1;
+    write.getMemoryProxy()->allocate(write.getWidth(), write.getHeight(), false);
+  }
+
+  void TearDown()
+  {
+    write.getMemoryProxy()->free();
+    ResultCache::free();
+  }
+
+  uint64_t determineKey()
+  {
+    /* Keys are determined once per execution, every execution has its own keys. */
+    ResultCacheKeys keys(context);
+    uint64_t key;
+    EXPECT_TRUE(keys.determineKey(&write, &key));
+    return key;
+  }
+};
+
+TEST_F(CompositorResultCacheTest, UnchangedInputRestores)
+{
+  value.setValue(0.5f);
+  const uint64_t key = determineKey();
+  ResultCache::store(key, write.getMemoryProxy());
+
+  EXPECT_EQ(determineKey(), key);
+  EXPECT_TRUE(ResultCache::restore(key, write.getMemoryProxy()));
+}
+
+TEST_F(CompositorResultCacheTest, ChangedInputInvalidates)
+{
+  value.setValue(0.5f);
+  const uint64_t key = determineKey();
+  ResultCache::store(key, write.getMemoryProxy());
+
+  value.setValue(0.25f);
+  const uint64_t changed_key = determineKey();
+  EXPECT_NE(changed_key, key);
+  EXPECT_FALSE(ResultCache::restore(changed_key, write.getMemoryProxy()));
+}
+
+class CompositorImBufTest : public testing::Test {
+ protected:
+  static void SetUpTestCase()
+  {
+    IMB_init();
+  }
+
+  static void TearDownTestCase()
+  {
+    IMB_exit();
+  }
+};
+
+TEST_F(CompositorImBufTest, TagChanged)
+{
+  ImBuf *ibuf1 = IMB_allocImBuf(4, 4, 32, IB_rect);
+  ImBuf *ibuf2 = IMB_allocImBuf(4, 4, 32, IB_rect);
+  const unsigned int timestamp = ibuf1->changed_timestamp;
+  EXPECT_NE(ibuf2->changed_timestamp, timestamp);
+
+  IMB_tag_changed(ibuf1);
+  EXPECT_NE(ibuf1->changed_timestamp, timestamp);
+  EXPECT_NE(ibuf1->changed_timestamp, ibuf2->changed_timestamp);
+
+  /* A copy can be modified on its own, it is a different buffer. */
+  ImBuf *ibuf3 = IMB_dupImBuf(ibuf1);
+  EXPECT_NE(ibuf3->changed_timestamp, ibuf1->changed_timestamp);
+
+  IMB_freeImBuf(ibuf1);
+  IMB_freeImBuf(ibuf2);
+  IMB_freeImBuf(ibuf3);
+}